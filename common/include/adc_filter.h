@@ -0,0 +1,33 @@
+#pragma once
+// Deutsche Dokumentation
+// Auswertung eines ADC-Bursts (viele Rohwerte in kurzer Zeit), ohne Hardware-Abhängigkeit.
+//
+// Einzelne Störspitzen (z. B. Anlauf der Pumpenmotoren) verschieben einen einfachen
+// Mittelwert deutlich. Robuste Alternativen:
+// - getrimmter Mittelwert: sortieren, param % an beiden Enden verwerfen, Rest mitteln
+// - Median der Mittelwerte: Burst in param Gruppen teilen, je Gruppe mitteln, Median
+//   der Gruppenmittel (eine Spitze verdirbt nur ihre Gruppe)
+// Zusätzlich wird die Streuung als robuste Standardabweichung (IQR / 1,349) geliefert.
+
+#include <cstddef>
+#include <cstdint>
+
+enum AdcReduceMode : uint8_t
+{
+    ADC_REDUCE_MEAN = 0,          // einfacher Mittelwert (bisheriges Verfahren)
+    ADC_REDUCE_TRIMMED_MEAN,      // param = Prozent je Seite (0..49)
+    ADC_REDUCE_MEDIAN_OF_MEANS,   // param = Anzahl Gruppen (1..n)
+};
+
+struct AdcReduceResult
+{
+    float value;      // Ergebnis in der Einheit der Eingangswerte
+    float spread;     // robuste Standardabweichung (IQR / 1,349)
+    uint16_t min;
+    uint16_t max;
+    uint16_t count;   // Anzahl Eingangswerte
+};
+
+// Wertet n Rohwerte aus. Der Puffer wird dabei umsortiert.
+// false bei n == 0 oder ungültigem param.
+bool adcReduce(uint16_t* samples, size_t n, AdcReduceMode mode, uint8_t param, AdcReduceResult* out);
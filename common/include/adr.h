@@ -0,0 +1,49 @@
+#pragma once
+// Deutsche Dokumentation
+// Adaptive Datenrate (ADR), ohne Hardware-Abhängigkeit.
+//
+// Pro Sensor werden RSSI/SNR der letzten LINK_STATS_WINDOW Uplinks gehalten. Die
+// Linkreserve ist das beste SNR des Fensters minus Mindest-SNR des aktuellen SF minus
+// Installationsreserve. Jede volle 3-dB-Stufe Reserve senkt zuerst den SF (etwa halbe
+// Sendedauer je Stufe), danach die Sendeleistung; fehlende Reserve erhöht zuerst die
+// Leistung, dann den SF (Verfahren wie beim LoRaWAN-Netzwerkserver).
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t LINK_STATS_WINDOW = 20;
+static const float  ADR_STEP_DB = 3.0f;
+
+struct LinkStats
+{
+    float snr[LINK_STATS_WINDOW];
+    int16_t rssi[LINK_STATS_WINDOW];
+    uint8_t count;
+    uint8_t head;
+};
+
+void linkStatsReset(LinkStats* s);
+void linkStatsAdd(LinkStats* s, int16_t rssi, float snr);
+float linkStatsMaxSnr(const LinkStats& s);   // 0 bei leerem Fenster
+float linkStatsMeanSnr(const LinkStats& s);
+int16_t linkStatsMeanRssi(const LinkStats& s);
+
+struct RadioSettings
+{
+    uint8_t sf;
+    int8_t txPowerDbm;
+};
+
+struct AdrPolicy
+{
+    float installMarginDb;   // Reserve für Schwund, Regen, Schachtdeckel ...
+    uint8_t minSf, maxSf;    // minSf == maxSf: SF fest, nur Leistung anpassen
+    int8_t minTxPowerDbm, maxTxPowerDbm;
+    uint8_t minFrames;       // erst ab so vielen Messwerten im Fenster entscheiden
+};
+
+// Linkreserve in dB bezogen auf den aktuellen SF
+float adrLinkMarginDb(const AdrPolicy& p, const LinkStats& s, uint8_t sf);
+
+// Empfohlene Einstellung. false = zu wenige Daten oder keine Änderung nötig.
+bool adrRecommend(const AdrPolicy& p, const LinkStats& s, const RadioSettings& current, RadioSettings* out);
@@ -0,0 +1,82 @@
+#pragma once
+// Deutsche Dokumentation
+// Alarmregeln je Sensor, ohne Hardware-Abhängigkeit: eine Tabelle aus Pegel-, Anstiegs- und
+// Stille-Regeln, ausgewertet mit jedem Messwert (O(Regeln), ohne Speicher je Messwert).
+//
+// Eine Regel schlägt an, wenn der Wert debounce Auswertungen in Folge die Schwelle erreicht,
+// und fällt erst zurück, wenn er debounce Auswertungen in Folge unter Schwelle - Hysterese
+// liegt. Ein einzelner Ausreißer oder Wellenschlag an der Schwelle erzeugt so keine Wechsel.
+//   ALERT_LEVEL: Pegel in mm (jeder Messwert, auch rückdatierte Batch-Werte)
+//   ALERT_RISE:  Anstiegsrate in mm/h (Pegelfilter des Sensors, je Uplink)
+//   ALERT_STALE: Sekunden seit dem letzten Uplink (zyklisch geprüft, ein Uplink löscht sofort)
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint8_t ALERT_MAX_RULES = 16;
+
+enum AlertKind : uint8_t
+{
+    ALERT_LEVEL = 0,
+    ALERT_RISE,
+    ALERT_STALE,
+};
+
+enum AlertSeverity : uint8_t
+{
+    ALERT_INFO = 0,
+    ALERT_WARNING,
+    ALERT_CRITICAL,
+};
+
+struct AlertRule
+{
+    uint8_t kind;           // AlertKind
+    uint8_t severity;       // AlertSeverity
+    uint8_t debounce;       // Auswertungen in Folge für einen Wechsel (0 = 1)
+    int32_t threshold;      // mm, mm/h bzw. s
+    int32_t hysteresis;     // zurück erst unter threshold - hysteresis (nicht bei ALERT_STALE)
+};
+
+// Eingaben einer Auswertung; Regeln ohne passende Eingabe behalten ihren Zustand
+struct AlertInput
+{
+    bool hasLevel;
+    int32_t levelMm;
+    bool hasRate;
+    int32_t rateMmPerH;
+    bool hasSilence;
+    uint32_t silentS;       // seit dem letzten Uplink (0 = gerade empfangen)
+};
+
+struct AlertRuleState
+{
+    bool active;
+    uint8_t count;          // Auswertungen in Folge jenseits der Schwelle
+};
+
+struct AlertState
+{
+    AlertRuleState rule[ALERT_MAX_RULES];
+};
+
+struct AlertTransition
+{
+    uint8_t rule;           // Index in der Tabelle
+    bool active;            // true = angeschlagen, false = zurückgefallen
+    int32_t value;          // auslösender Wert (mm, mm/h bzw. s)
+};
+
+void alertReset(AlertState* s);
+
+// Regeln auswerten, Wechsel nach out (höchstens maxOut, weitere folgen bei der nächsten
+// Auswertung). Rückgabe: Anzahl der Wechsel.
+size_t alertEvaluate(const AlertRule* rules, size_t count, AlertState* s, const AlertInput& in,
+                     AlertTransition* out, size_t maxOut);
+
+// Index der aktiven Regel mit der höchsten Stufe (bei Gleichstand die spätere), -1 = keine
+int alertHighestActive(const AlertRule* rules, size_t count, const AlertState& s);
+
+// Kurznamen für MQTT ("level", "rise", "stale" bzw. "info", "warning", "critical")
+const char* alertKindName(uint8_t kind);
+const char* alertSeverityName(uint8_t severity);
@@ -0,0 +1,106 @@
+#pragma once
+// Deutsche Dokumentation
+// Begrenzungsgeprüftes Lesen/Schreiben von Binärdaten (Little Endian) auf
+// fremden Puffern, ohne Kopie und ohne Heap. Jeder Zugriff über das Ende
+// hinaus setzt ok() dauerhaft auf false und liefert 0 bzw. nullptr, sodass
+// eine Folge von Lesezugriffen am Ende nur einmal geprüft werden muss.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Zig-Zag-Abbildung: kleine Beträge (positiv wie negativ) -> kleine Zahlen
+inline uint32_t zigzagEncode(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t zigzagDecode(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+class ByteReader
+{
+public:
+    ByteReader(const uint8_t* data, size_t len) : p_(data), len_(len), pos_(0), ok_(true) {}
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return ok_ ? len_ - pos_ : 0; }
+    size_t position() const { return pos_; }
+    bool atEnd() const { return remaining() == 0; }
+
+    uint8_t u8() { const uint8_t* b = take(1); return b ? b[0] : 0; }
+    uint16_t u16() { const uint8_t* b = take(2); return b ? (uint16_t)(b[0] | (b[1] << 8)) : 0; }
+    int16_t i16() { return (int16_t)u16(); }
+    uint32_t u32()
+    {
+        const uint8_t* b = take(4);
+        return b ? ((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24)) : 0;
+    }
+    uint64_t u64() { const uint64_t lo = u32(); return lo | ((uint64_t)u32() << 32); }
+    // Varint (LEB128, 7 Bit je Byte), höchstens 5 Byte für uint32
+    uint32_t varint()
+    {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t* b = take(1);
+            if (!b) return 0;
+            v |= (uint32_t)(b[0] & 0x7F) << shift;
+            if (!(b[0] & 0x80)) return v;
+        }
+        ok_ = false; // zu lang
+        return 0;
+    }
+    int32_t svarint() { return zigzagDecode(varint()); }
+    // Zeiger auf n Bytes im Quellpuffer (keine Kopie)
+    const uint8_t* bytes(size_t n) { return take(n); }
+
+private:
+    const uint8_t* take(size_t n)
+    {
+        if (!ok_ || n > len_ - pos_) { ok_ = false; return nullptr; }
+        const uint8_t* b = p_ + pos_;
+        pos_ += n;
+        return b;
+    }
+
+    const uint8_t* p_;
+    size_t len_;
+    size_t pos_;
+    bool ok_;
+};
+
+class ByteWriter
+{
+public:
+    ByteWriter(uint8_t* buf, size_t cap) : p_(buf), cap_(cap), len_(0), ok_(true) {}
+
+    bool ok() const { return ok_; }
+    size_t length() const { return len_; }
+    size_t remaining() const { return ok_ ? cap_ - len_ : 0; }
+
+    void u8(uint8_t v) { uint8_t* b = take(1); if (b) b[0] = v; }
+    void u16(uint16_t v) { uint8_t* b = take(2); if (b) { b[0] = (uint8_t)v; b[1] = (uint8_t)(v >> 8); } }
+    void i16(int16_t v) { u16((uint16_t)v); }
+    void u32(uint32_t v)
+    {
+        uint8_t* b = take(4);
+        if (b) { b[0] = (uint8_t)v; b[1] = (uint8_t)(v >> 8); b[2] = (uint8_t)(v >> 16); b[3] = (uint8_t)(v >> 24); }
+    }
+    void u64(uint64_t v) { u32((uint32_t)v); u32((uint32_t)(v >> 32)); }
+    void varint(uint32_t v)
+    {
+        while (v >= 0x80) { u8((uint8_t)(v | 0x80)); v >>= 7; }
+        u8((uint8_t)v);
+    }
+    void svarint(int32_t v) { varint(zigzagEncode(v)); }
+    void bytes(const uint8_t* src, size_t n) { uint8_t* b = take(n); if (b && n) memcpy(b, src, n); }
+
+private:
+    uint8_t* take(size_t n)
+    {
+        if (!ok_ || n > cap_ - len_) { ok_ = false; return nullptr; }
+        uint8_t* b = p_ + len_;
+        len_ += n;
+        return b;
+    }
+
+    uint8_t* p_;
+    size_t cap_;
+    size_t len_;
+    bool ok_;
+};
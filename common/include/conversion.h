@@ -0,0 +1,71 @@
+#pragma once
+// Deutsche Dokumentation
+// Umrechnung Sensor-Spannung (mV) -> Wassertiefe (cm), ohne Hardware-Abhängigkeit
+
+#include <cstddef>
+#include <cstdint>
+
+// Mehrpunkt-Kalibrierung: stückweise linear durch Paare { Roh-mV, echte Tiefe cm }
+// (z. B. mit dem Zollstock gemessen, mv_raw aus dem Log). Damit werden Gain, Offset und
+// die Krümmung des ESP32-ADC nahe den Rändern zugleich korrigiert.
+//
+// Zur Übersetzungszeit entsteht daraus eine Festkomma-Tabelle mit einer Stützstelle je
+// CAL_LUT_STEP_MV mV (Tiefe in 0,1 mm); zur Laufzeit bleibt ein Tabellenzugriff und eine
+// ganzzahlige Interpolation. Außerhalb der Kalibrierpunkte wird das erste bzw. letzte
+// Segment verlängert, negative Tiefen werden erst nach der Interpolation auf 0 begrenzt.
+// Die constexpr-Funktionen brauchen C++14 (Schleifen); der Sensor baut mit -std=gnu++17.
+// Abweichung zur exakten Stückweise-Linearen nur in Tabellenzellen mit einem Kalibrierpunkt
+// (höchstens Steigungsänderung x CAL_LUT_STEP_MV / 4, bei typischen Tabellen unter 1 mm).
+
+static const uint8_t CAL_LUT_SHIFT = 4;                              // 16 mV je Stützstelle
+static const uint32_t CAL_LUT_STEP_MV = 1u << CAL_LUT_SHIFT;
+static const uint32_t CAL_LUT_MAX_MV = 4095;                         // darüber wird begrenzt
+static const size_t CAL_LUT_SIZE = (CAL_LUT_MAX_MV >> CAL_LUT_SHIFT) + 2;
+
+struct CalibrationLut
+{
+    int32_t depthMmX10[CAL_LUT_SIZE];   // Tiefe an der Stützstelle i * CAL_LUT_STEP_MV in 0,1 mm (auch < 0)
+};
+
+// true = mindestens zwei Punkte, Roh-mV streng steigend (für static_assert)
+template <size_t N>
+constexpr bool calibrationPointsValid(const float (&points)[N][2])
+{
+    if (N < 2) return false;
+    for (size_t i = 1; i < N; ++i)
+        if (!(points[i][0] > points[i - 1][0])) return false;
+    return true;
+}
+
+// Stückweise lineare Kennlinie in cm, ohne Begrenzung (Tabellenaufbau)
+template <size_t N>
+constexpr float calibrationCmUnclamped(const float (&points)[N][2], float mv)
+{
+    size_t s = 1;
+    while (s < N - 1 && mv > points[s][0]) ++s;
+    const float x0 = points[s - 1][0], y0 = points[s - 1][1];
+    const float x1 = points[s][0], y1 = points[s][1];
+    return y0 + (y1 - y0) * (mv - x0) / (x1 - x0);
+}
+
+// Exakte Kennlinie in cm (Float-Referenz, negative Tiefen auf 0 begrenzt)
+template <size_t N>
+constexpr float calibrationCm(const float (&points)[N][2], float mv)
+{
+    const float cm = calibrationCmUnclamped(points, mv);
+    return cm > 0.0f ? cm : 0.0f;
+}
+
+template <size_t N>
+constexpr CalibrationLut calibrationLutBuild(const float (&points)[N][2])
+{
+    CalibrationLut lut{};
+    for (size_t i = 0; i < CAL_LUT_SIZE; ++i) {
+        const float mmX10 = calibrationCmUnclamped(points, (float)(i * CAL_LUT_STEP_MV)) * 100.0f;
+        lut.depthMmX10[i] = (int32_t)(mmX10 < 0.0f ? mmX10 - 0.5f : mmX10 + 0.5f);
+    }
+    return lut;
+}
+
+// Tiefe in 0,1 mm für einen Roh-mV-Wert (nur Ganzzahl-Arithmetik)
+int32_t calibrationDepthMmX10(const CalibrationLut& lut, uint32_t mv);
@@ -0,0 +1,11 @@
+#pragma once
+// Deutsche Dokumentation
+// CRC-32 (IEEE 802.3, wie zlib) für gesicherte Zustände und Datensätze, ohne Tabelle
+// (spart 1 KB Flash/RAM; die geschützten Blöcke sind klein).
+
+#include <cstddef>
+#include <cstdint>
+
+// Fortsetzbar: crc32Update(crc32Update(0, a, n), b, m) == CRC über a|b
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len);
+inline uint32_t crc32(const uint8_t* data, size_t len) { return crc32Update(0, data, len); }
@@ -5,13 +5,25 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <mbedtls/aes.h>
+#include <mbedtls/md.h>
+
+// Länge der pro Sensor abgeleiteten Schlüssel
+static const size_t CRYPTO_AES_KEY_LEN  = 16;
+static const size_t CRYPTO_HMAC_KEY_LEN = 32;
+
+// IV-Layout (16 Byte): [nonce8][sensorId][Richtung][0 x 5][Blockzähler].
+// Die Nonce ist der Frame-Zähler eines Sensors und beginnt bei jedem Sensor bei 1; mit
+// gemeinsamem Schlüssel (PER_SENSOR_KEYS = false) trennt erst die Sensor-ID im IV die
+// Schlüsselströme. Richtung = Bit 63 der Nonce (1 = Downlink), der Blockzähler läuft im
+// letzten Byte (ein Frame hat höchstens 16 Blöcke).
 
 // AES-128 im CTR-Modus, in-place Verschlüsselung/Entschlüsselung.
 // - key: 16-Byte Schlüssel
-// - nonce8: 8-Byte Nonce (wird auf 16-Byte IV erweitert)
+// - nonce8: 8-Byte Nonce, sensorId: Sender bzw. Empfänger (beide bilden das IV)
 // - data: Datenpuffer (wird in-place bearbeitet)
 // - len: Länge des Puffers
-bool aesCtrCrypt(const uint8_t key[16], const uint8_t nonce8[8], uint8_t* data, size_t len);
+bool aesCtrCrypt(const uint8_t key[16], const uint8_t nonce8[8], uint8_t sensorId, uint8_t* data, size_t len);
 
 // HMAC-SHA256 berechnen und auf outLen Bytes kürzen.
 // - key/keyLen: HMAC-Schlüssel
@@ -20,3 +32,64 @@ bool aesCtrCrypt(const uint8_t key[16], const uint8_t nonce8[8], uint8_t* data,
 bool hmacSha256Trunc(const uint8_t* key, size_t keyLen,
                      const uint8_t* msg, size_t msgLen,
                      uint8_t* out, size_t outLen);
+
+// HKDF-SHA256 (RFC 5869): Extract + Expand in einem Aufruf.
+// - salt darf nullptr sein (dann 32 Null-Bytes laut RFC)
+// - okmLen maximal 255 * 32 Bytes
+bool hkdfSha256(const uint8_t* salt, size_t saltLen,
+                const uint8_t* ikm, size_t ikmLen,
+                const uint8_t* info, size_t infoLen,
+                uint8_t* okm, size_t okmLen);
+
+// Leitet die Schlüssel eines Sensors aus dem Master-Schlüssel ab.
+// info = "lwlm-sensor-v1" || sensorId, Ausgabe: 16 Byte AES + 32 Byte HMAC.
+// Gateway und Sensor kommen so ohne gemeinsamen Flotten-Schlüssel aus.
+bool deriveSensorKeys(const uint8_t* masterKey, size_t masterKeyLen, uint8_t sensorId,
+                      uint8_t aesKey[CRYPTO_AES_KEY_LEN], uint8_t hmacKey[CRYPTO_HMAC_KEY_LEN]);
+
+// Vergleich in konstanter Zeit (für MAC-Prüfung)
+bool constTimeEqual(const uint8_t* a, const uint8_t* b, size_t len);
+
+// Vorbereiteter Krypto-Kontext für einen Schlüsselsatz.
+// begin() berechnet einmalig den AES-Key-Schedule sowie den HMAC-Innen- und
+// Außenzustand (Schlüssel XOR ipad/opad bereits in SHA-256 eingerechnet).
+// Pro Frame bleiben damit nur CTR-Blöcke und die Nachrichten-Hashes übrig.
+// Nicht threadsicher: eine Session gehört genau einem Aufrufer/Task.
+class CryptoSession
+{
+public:
+    CryptoSession();
+    ~CryptoSession();
+    CryptoSession(const CryptoSession&) = delete;
+    CryptoSession& operator=(const CryptoSession&) = delete;
+
+    // Schlüssel setzen (kann erneut aufgerufen werden, z. B. nach Schlüsselwechsel)
+    bool begin(const uint8_t aesKey[16], const uint8_t* hmacKey, size_t hmacKeyLen);
+    // Kontexte freigeben und Schlüsselmaterial löschen
+    void end();
+    bool ready() const { return ready_; }
+
+    // AES-128-CTR in-place (gleiches IV-Layout wie aesCtrCrypt)
+    bool ctrCrypt(const uint8_t nonce8[8], uint8_t sensorId, uint8_t* data, size_t len);
+
+    // HMAC-SHA256 über msg, auf outLen (<= 32) Bytes gekürzt
+    bool mac(const uint8_t* msg, size_t msgLen, uint8_t* out, size_t outLen);
+
+    // Inkrementelle Variante (für den Frame-Codec): CTR-Strom und MAC laufen
+    // blockweise verschränkt, sodass die Payload nur einmal durchlaufen wird.
+    bool ctrBegin(const uint8_t nonce8[8], uint8_t sensorId);
+    bool ctrUpdate(uint8_t* data, size_t len);
+    bool macBegin();
+    bool macUpdate(const uint8_t* data, size_t len);
+    bool macFinish(uint8_t* out, size_t outLen);
+
+private:
+    mbedtls_aes_context aes_;
+    mbedtls_md_context_t inner_;  // SHA-256 nach (K ^ ipad)
+    mbedtls_md_context_t outer_;  // SHA-256 nach (K ^ opad)
+    mbedtls_md_context_t work_;   // Arbeitskopie pro Nachricht
+    uint8_t ctrIv_[16];           // laufender Zähler (inkrementeller CTR)
+    uint8_t ctrStream_[16];
+    size_t ctrOff_;
+    bool ready_;
+};
@@ -0,0 +1,55 @@
+#pragma once
+// Deutsche Dokumentation
+// Downlink-Befehle (Gateway -> Sensor) und ihre Quittungen, ohne Heap.
+//
+// Befehls-Payload (Klartext innerhalb des LoRa-Frames), Little Endian:
+//   [0]    Version (DOWNLINK_VERSION)
+//   [1..2] Befehls-ID (uint16, vom Gateway vergeben; Wiederholungen behalten die ID)
+//   [3]    Opcode (DL_OP_*)
+//   [4..]  Argumente (opcodeabhängig, höchstens DOWNLINK_MAX_ARGS Byte)
+//
+// Quittungen reisen im nächsten Uplink als TLV PAYLOAD_TLV_ACK mit je
+// [Befehls-ID u16][Status u8] (DL_ACK_*).
+
+#include <cstddef>
+#include <cstdint>
+#include "payload.h"
+
+static const uint8_t DOWNLINK_VERSION  = 0x01;
+static const size_t  DOWNLINK_HDR_LEN  = 4;
+static const size_t  DOWNLINK_MAX_ARGS = 8;
+static const size_t  DOWNLINK_ACK_LEN  = 3;
+
+// Opcodes
+static const uint8_t DL_OP_OTA_AP     = 0x01; // arg[0]: 1 = WLAN-AP/OTA ein, 0 = aus
+static const uint8_t DL_OP_RADIO      = 0x02; // arg[0]: SF, arg[1]: Sendeleistung dBm (int8), siehe adr.h
+static const uint8_t DL_OP_LINK_CHECK = 0x03; // ohne Argumente: Gateway hört den Sensor mit neuen Funkparametern
+
+// Quittungs-Status
+static const uint8_t DL_ACK_OK       = 0x00; // ausgeführt
+static const uint8_t DL_ACK_REJECTED = 0x01; // verstanden, aber abgelehnt (z. B. per config.h gesperrt)
+static const uint8_t DL_ACK_UNKNOWN  = 0x02; // Opcode unbekannt
+
+struct DownlinkCommand
+{
+    uint16_t id;
+    uint8_t opcode;
+    uint8_t argLen;
+    uint8_t args[DOWNLINK_MAX_ARGS];
+};
+
+struct DownlinkAck
+{
+    uint16_t id;
+    uint8_t status;
+};
+
+// Befehl kodieren. Rückgabe: Länge oder 0.
+size_t downlinkEncode(const DownlinkCommand& cmd, uint8_t* buf, size_t cap);
+// Befehl dekodieren. Rückgabe false bei falscher Version oder Länge.
+bool downlinkDecode(const uint8_t* buf, size_t len, DownlinkCommand* out);
+
+// Quittungen als ACK-TLV an eine Uplink-Payload anhängen. Rückgabe: neue Länge oder 0.
+size_t payloadAppendAcks(uint8_t* buf, size_t cap, size_t len, const DownlinkAck* acks, size_t count);
+// Iteriert über die Quittungen eines ACK-TLV. *pos beginnt bei 0.
+bool payloadNextAck(const PayloadTlv& tlv, size_t* pos, DownlinkAck* out);
@@ -0,0 +1,57 @@
+#pragma once
+// Deutsche Dokumentation
+// Downlink-Warteschlange eines Sensors (Gateway-Seite), ohne Hardware-Abhängigkeit.
+//
+// Ablauf: Befehl einreihen -> bei jedem Uplink des Sensors wird der älteste offene
+// Befehl im Empfangsfenster des Sensors gesendet (ein Versuch je Uplink) -> die
+// Quittung kommt im nächsten Uplink und entfernt den Befehl. Befehle, die nach
+// maxAttempts Versuchen oder expiryMs nicht quittiert sind, laufen ab.
+// Ein neuer Befehl mit gleichem Opcode ersetzt einen noch offenen (letzter Wunsch gilt).
+
+#include <cstddef>
+#include <cstdint>
+#include "downlink.h"
+
+static const size_t DOWNLINK_QUEUE_DEPTH = 4;
+
+struct DownlinkPolicy
+{
+    uint8_t maxAttempts;   // Sendeversuche bis zum Ablauf
+    uint32_t expiryMs;     // Höchstalter eines Befehls
+};
+
+struct DownlinkEntry
+{
+    DownlinkCommand cmd;
+    uint32_t queuedMs;
+    uint32_t lastSentMs;
+    uint8_t attempts;
+};
+
+// FIFO, ältester Befehl an Index 0
+struct DownlinkQueue
+{
+    DownlinkEntry entries[DOWNLINK_QUEUE_DEPTH];
+    uint8_t count;
+};
+
+void downlinkQueueReset(DownlinkQueue* q);
+
+// Befehl einreihen (ersetzt offenen Befehl mit gleichem Opcode). false, wenn voll.
+bool downlinkQueuePush(DownlinkQueue* q, const DownlinkCommand& cmd, uint32_t nowMs);
+
+// Entfernt abgelaufene Befehle und kopiert sie nach expired (höchstens cap).
+// Rückgabe: Anzahl der in expired abgelegten Befehle (darüber hinaus wird still entfernt).
+size_t downlinkQueueExpire(DownlinkQueue* q, const DownlinkPolicy& p, uint32_t nowMs,
+                           DownlinkCommand* expired, size_t cap);
+
+// Nächster zu sendender Befehl (zählt den Versuch) oder nullptr.
+// Vorher downlinkQueueExpire() aufrufen.
+const DownlinkEntry* downlinkQueueTake(DownlinkQueue* q, uint32_t nowMs);
+
+// Quittung verarbeiten: entfernt den Befehl mit dieser ID und liefert ihn in *done.
+// false, wenn die ID nicht (mehr) offen ist (z. B. doppelte Quittung).
+bool downlinkQueueAck(DownlinkQueue* q, uint16_t id, DownlinkCommand* done);
+
+// Offener Befehl mit diesem Opcode oder nullptr (für die Anzeige)
+const DownlinkEntry* downlinkQueueFind(const DownlinkQueue* q, uint8_t opcode);
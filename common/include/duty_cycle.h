@@ -0,0 +1,39 @@
+#pragma once
+// Deutsche Dokumentation
+// Sendezeit-Konto für den Duty-Cycle (EU868: 1 % je Teilband und Stunde), ohne
+// Hardware-Abhängigkeit. Jede Sendung wird mit ihrer Sendedauer (lora_airtime.h)
+// gebucht; passt eine Sendung nicht mehr ins gleitende Fenster, wird sie abgelehnt
+// und der Aufrufer verschiebt sie.
+//
+// Das Fenster ist in DUTY_CYCLE_SLOTS Zeitscheiben geteilt (bei 1 h: je 1 min). Eine
+// Buchung zählt, bis ihre ganze Scheibe aus dem Fenster gefallen ist, also höchstens
+// eine Scheibe länger als nötig (sichere Seite, 240 Byte statt einer Liste je Frame).
+
+#include <cstdint>
+
+static const uint8_t DUTY_CYCLE_SLOTS = 60;
+
+struct DutyCycle
+{
+    uint32_t budgetUs;                  // erlaubte Sendezeit je Fenster
+    uint32_t slotMs;                    // Länge einer Zeitscheibe
+    uint32_t slotUs[DUTY_CYCLE_SLOTS];  // gebuchte Sendezeit je Scheibe
+    uint32_t slotStartMs;               // Beginn der aktuellen Scheibe
+    uint8_t head;                       // aktuelle Scheibe
+    bool started;
+    uint32_t usedUs;                    // Summe über alle Scheiben
+    uint32_t deferred;                  // abgelehnte Sendungen seit dem Start
+};
+
+// dutyPermille: 10 = 1 %; windowMs: Bezugszeitraum (EU868: 1 h)
+void dutyCycleInit(DutyCycle* d, uint16_t dutyPermille, uint32_t windowMs);
+
+// Im Fenster verbrauchte bzw. noch freie Sendezeit
+uint32_t dutyCycleUsedUs(DutyCycle* d, uint32_t nowMs);
+uint32_t dutyCycleRemainingUs(DutyCycle* d, uint32_t nowMs);
+
+// Bucht toaUs, wenn es ins Budget passt. false = abgelehnt (nicht gebucht, deferred + 1).
+bool dutyCycleTryConsume(DutyCycle* d, uint32_t nowMs, uint32_t toaUs);
+
+// Wartezeit in ms, bis toaUs wieder ins Budget passt (0 = sofort möglich)
+uint32_t dutyCycleWaitMs(DutyCycle* d, uint32_t nowMs, uint32_t toaUs);
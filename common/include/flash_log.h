@@ -0,0 +1,113 @@
+#pragma once
+// Deutsche Dokumentation
+// Absturzsicheres Messwert-Log im Flash (nur Anhängen), ohne Hardware-Abhängigkeit:
+// Lesen/Schreiben/Löschen stellt der Aufrufer (FlashLogIo), auf dem Gateway eine rohe
+// Flash-Partition, im Host-Test ein RAM-Abbild, im Host-Werkzeug eine Abbild-Datei.
+//
+// Format (Little Endian), Sektoren zu 4 KB als Ring, je Sektor 256 Einträge zu 16 Byte:
+//   Eintrag 0:  Kopf   [Magic "HLOG" u32][Version u8][0 u8 x3][Sektornummer u32][CRC-32 u32]
+//   Eintrag 1+: Satz   [Magic 0xA7 u8][Art u8][Sensor-ID u8][Flags u8][Zeit s u32][Wert i32][CRC-32 u32]
+// Die Sektornummer steigt mit jedem neu begonnenen Sektor; der Sektor mit der höchsten ist
+// der aktuelle, die ältesten Daten liegen im Ring direkt dahinter. Gelöschter Flash (0xFF)
+// ist frei. Geschrieben wird seitenweise (256 Byte = 16 Einträge) aus einem RAM-Puffer; der
+// Kopf geht mit der ersten Seite eines Sektors auf den Flash. Gleichmäßige Abnutzung
+// ergibt sich aus dem Ring (jeder Sektor wird einmal je Umlauf gelöscht).
+//
+// Stromausfall: ein halb geschriebener Satz fällt durch die CRC und wird beim Einhängen
+// abgeschnitten (Schreiben geht an der nächsten Seitengrenze weiter); ein gelöschter Sektor
+// ohne Kopf gilt als leer. Verloren gehen höchstens die noch nicht geschriebenen Sätze im Puffer.
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint32_t FLASH_LOG_MAGIC = 0x474F4C48u; // "HLOG"
+static const uint8_t FLASH_LOG_VERSION = 1;
+static const uint8_t FLASH_LOG_RECORD_MAGIC = 0xA7;
+static const size_t FLASH_LOG_SECTOR_BYTES = 4096;
+static const size_t FLASH_LOG_PAGE_BYTES = 256;
+static const size_t FLASH_LOG_ENTRY_BYTES = 16;
+static const uint16_t FLASH_LOG_SLOTS = FLASH_LOG_SECTOR_BYTES / FLASH_LOG_ENTRY_BYTES;    // inkl. Kopf
+static const uint16_t FLASH_LOG_PAGE_SLOTS = FLASH_LOG_PAGE_BYTES / FLASH_LOG_ENTRY_BYTES;
+
+enum FlashLogKind : uint8_t
+{
+    FLASH_LOG_DEPTH_MM = 1,   // Wasserstand in mm
+};
+
+struct FlashLogRecord
+{
+    uint32_t tSec;            // Unixzeit
+    int32_t value;
+    uint8_t sid;
+    uint8_t kind;             // FlashLogKind
+    uint8_t flags;            // reserviert (0)
+};
+
+// Zugriff auf den Speicher; Offsets relativ zum Log-Anfang. write darf nur gelöschte
+// Bytes beschreiben (NOR-Flash), erase löscht einen Sektor auf 0xFF.
+// Zum Lesen (Host-Werkzeug) genügt read, write/erase dürfen nullptr sein.
+struct FlashLogIo
+{
+    void* ctx;
+    bool (*read)(void* ctx, uint32_t offset, void* buf, size_t len);
+    bool (*write)(void* ctx, uint32_t offset, const void* buf, size_t len);
+    bool (*erase)(void* ctx, uint32_t offset);
+    uint32_t size;            // Bytes, wird auf ganze Sektoren abgerundet
+};
+
+// Dünner Index: je Sektor Nummer (0 = frei) und Zeit des ersten Satzes
+struct FlashLogSectorInfo
+{
+    uint32_t seq;
+    uint32_t firstTSec;
+};
+
+struct FlashLog
+{
+    FlashLogIo io;
+    FlashLogSectorInfo* index;    // sectors Einträge, vom Aufrufer
+    uint16_t sectors;
+    uint16_t head;                // aktueller Sektor (sectors = noch keiner)
+    uint32_t headSeq;
+    uint16_t fill;                // nächster freier Eintrag im aktuellen Sektor
+    uint16_t written;             // Einträge bis hier stehen im Flash
+    uint8_t page[FLASH_LOG_PAGE_BYTES];   // aktuelle Seite (Einträge ab fill/16*16)
+    uint32_t appended;            // seit dem Einhängen angehängte Sätze
+    uint16_t torn;                // beim Einhängen abgeschnittene (unvollständige) Einträge
+    uint16_t usedSectors;
+    bool ioError;
+};
+
+// Sektoren anhand der Köpfe einlesen (ein Lesezugriff je Sektor plus der aktuelle Sektor),
+// Schreibposition und Index wiederherstellen. Schreibt nichts. false = Lesefehler/zu klein.
+bool flashLogMount(FlashLog* log, const FlashLogIo& io, FlashLogSectorInfo* index, uint16_t indexCount);
+
+// Anzahl Sektoren für io.size (Größe des Index)
+uint16_t flashLogSectorCount(const FlashLogIo& io);
+
+// Satz puffern; volle Seiten werden geschrieben, bei vollem Sektor wird der älteste gelöscht
+bool flashLogAppend(FlashLog* log, const FlashLogRecord& rec);
+// Gepufferte Sätze sofort schreiben (z. B. vor Neustart/OTA, zeitgesteuert)
+bool flashLogFlush(FlashLog* log);
+// Sätze im Puffer, die bei Stromausfall verloren gingen
+uint16_t flashLogPending(const FlashLog* log);
+
+// Lesen in Schreibreihenfolge (älteste zuerst), nur was im Flash steht
+struct FlashLogCursor
+{
+    const FlashLog* log;
+    uint32_t fromTSec;
+    uint16_t sector;
+    uint16_t sectorsLeft;
+    uint16_t slot;
+    uint8_t page[FLASH_LOG_PAGE_BYTES];
+    uint32_t invalid;             // übersprungene beschädigte Einträge
+};
+
+// Sektoren, deren Nachfolger schon vor fromTSec beginnt, werden über den Index übersprungen
+void flashLogScan(const FlashLog* log, uint32_t fromTSec, FlashLogCursor* c);
+bool flashLogNext(FlashLogCursor* c, FlashLogRecord* out);
+
+// Kodierung eines Eintrags (16 Byte), für Tests und Werkzeuge
+void flashLogEncodeRecord(const FlashLogRecord& rec, uint8_t* out);
+bool flashLogDecodeRecord(const uint8_t* in, FlashLogRecord* out);
@@ -0,0 +1,93 @@
+#pragma once
+// Deutsche Dokumentation
+// Hochwasser-Prognose je Sensor, ohne Hardware-Abhängigkeit: wie lange bis der Pegel eine
+// kritische Höhe erreicht (z. B. Kellerfenster, Wassereintritt)?
+//
+// Lineare Regression über ein gleitendes Fenster der letzten Messwerte. Gehalten werden nur
+// die Stützstellen und die Summen (t, t², y, y², t·y) als Ganzzahlen; ein neuer Wert wird
+// addiert, ein herausfallender abgezogen, also O(1) je Messwert und ohne Rundungsdrift.
+// Die Stützstellen haben mindestens windowS / slots Abstand; dichtere Werte (Hochwasser-
+// Schnellpfad, Batch) ersetzen die jüngste Stützstelle, so bleibt der neueste Wert im Fenster.
+//
+// Aus der Streuung um die Gerade folgen Standardfehler von Anstieg und Pegel; die ETA je
+// Höhe wird mit Pegel +/- k Standardfehler und Anstieg -/+ k Standardfehler zu einem Band
+// [früh, spät] aufgespannt. Ist der Anstieg nicht sicher positiv, bleibt "spät" offen.
+// Fällt der Pegel sprunghaft (Pumpe springt an) oder fehlen Messwerte länger als maxGapS,
+// beginnt das Fenster neu.
+
+#include <cstdint>
+
+static const uint8_t FORECAST_MAX_SLOTS = 32;
+static const uint8_t FORECAST_MAX_LEVELS = 4;
+// ETA bzw. Grenze nicht absehbar (kein Anstieg, jenseits horizonS)
+static const uint32_t FORECAST_OPEN = 0xFFFFFFFFUL;
+
+struct ForecastConfig
+{
+    int32_t levelsMm[FORECAST_MAX_LEVELS]; // kritische Höhen, aufsteigend
+    uint8_t levelCount;
+    uint32_t windowS;       // Fensterlänge
+    uint8_t slots;          // Stützstellen im Fenster (höchstens FORECAST_MAX_SLOTS)
+    uint8_t minSamples;     // ab so vielen Stützstellen (mindestens 3) ...
+    uint32_t minSpanS;      // ... über mindestens diese Zeit gibt es eine Prognose
+    int32_t minRiseMmPerH;  // langsamerer Anstieg: keine ETA
+    int32_t resetDropMm;    // fällt der Pegel so weit unter den letzten Wert: neu beginnen (0 = aus)
+    uint32_t maxGapS;       // längere Messpause: neu beginnen
+    uint32_t horizonS;      // weiter entfernte ETA gilt als nicht absehbar
+    float confidenceK;      // Breite des Bands in Standardfehlern (2 = ca. 95 %)
+};
+
+struct ForecastPoint
+{
+    uint32_t t;
+    int32_t mm;
+};
+
+struct ForecastState
+{
+    uint8_t head;           // älteste Stützstelle
+    uint8_t count;
+    uint32_t baseT;         // Bezug der Summen (hält die Quadrate klein)
+    uint32_t lastT;
+    int32_t lastMm;
+    ForecastPoint pt[FORECAST_MAX_SLOTS];
+    int64_t sumT, sumTT, sumY, sumYY, sumTY; // t relativ zu baseT, y in mm
+};
+
+enum ForecastStatus : uint8_t
+{
+    FORECAST_NONE = 0,      // kein (sicherer) Anstieg bzw. ETA jenseits horizonS
+    FORECAST_ETA,           // Höhe wird voraussichtlich in etaS erreicht
+    FORECAST_REACHED,       // Höhe schon erreicht
+};
+
+struct ForecastEta
+{
+    uint8_t status;         // ForecastStatus
+    uint32_t etaS;          // nur mit FORECAST_ETA
+    uint32_t earlyS;        // frühestens (untere Grenze des Bands)
+    uint32_t lateS;         // spätestens, FORECAST_OPEN = nicht absehbar
+};
+
+struct ForecastResult
+{
+    bool valid;             // genug Stützstellen über genug Zeit
+    uint8_t samples;
+    uint32_t spanS;
+    uint32_t t;             // Zeitpunkt des letzten Messwerts (ETA ab hier)
+    int32_t levelMm;        // Pegel der Ausgleichsgeraden beim letzten Messwert
+    int32_t rateMmPerH;     // Anstieg (= 0,1 cm/h)
+    int32_t rateSeMmPerH;   // Standardfehler des Anstiegs
+    ForecastEta eta[FORECAST_MAX_LEVELS];
+};
+
+void forecastReset(ForecastState* s);
+
+// Messwert (mm) zum Zeitpunkt tSec einarbeiten; ältere Zeitpunkte als der letzte werden ignoriert
+void forecastAdd(const ForecastConfig& c, ForecastState* s, uint32_t tSec, int32_t levelMm);
+
+// Regression und ETA je Höhe aus dem aktuellen Fenster (O(Höhen))
+void forecastCompute(const ForecastConfig& c, const ForecastState& s, ForecastResult* r);
+
+// Kurznamen für MQTT ("none", "eta", "reached")
+const char* forecastStatusName(uint8_t status);
@@ -0,0 +1,39 @@
+#pragma once
+// Deutsche Dokumentation
+// Frame-Zähler als Nonce und Replay-Schutz per gleitendem Bitmap-Fenster
+// (Verfahren wie IPsec/ESP, RFC 4303): Prüfung und Aktualisierung in O(1).
+//
+// Nonce-Layout (8 Byte): 64-Bit-Zähler, Little Endian. Bit 63 kennzeichnet
+// Downlinks (Gateway -> Sensor), damit Up- und Downlink mit demselben
+// Sensor-Schlüssel nie dieselbe Nonce verwenden. Zähler 0 ist ungültig.
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint64_t FRAME_COUNTER_DOWNLINK = 1ULL << 63;
+static const uint64_t FRAME_COUNTER_MAX      = FRAME_COUNTER_DOWNLINK - 1;
+static const uint32_t REPLAY_WINDOW_BITS     = 64;
+
+// Zähler (inkl. Richtungsbit) als 8-Byte-Nonce schreiben bzw. lesen
+void frameCounterToNonce(uint64_t counter, uint8_t nonce[8]);
+uint64_t frameCounterFromNonce(const uint8_t nonce[8]);
+
+// Empfangsfenster eines Senders.
+// top = höchster akzeptierter Zähler, Bit i in bitmap = (top - i) bereits gesehen.
+struct ReplayWindow
+{
+    uint64_t top;
+    uint64_t bitmap;
+};
+
+// Frisches Fenster (noch nichts gesehen)
+void replayWindowReset(ReplayWindow& w);
+
+// Fenster nach Neustart: alles bis einschließlich top gilt als gesehen
+void replayWindowRestore(ReplayWindow& w, uint64_t top);
+
+// true = Zähler ist neu und liegt nicht zu weit zurück (ändert nichts)
+bool replayWindowCheck(const ReplayWindow& w, uint64_t counter);
+
+// Zähler als gesehen markieren (erst nach erfolgreicher MAC-Prüfung aufrufen)
+void replayWindowUpdate(ReplayWindow& w, uint64_t counter);
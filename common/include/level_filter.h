@@ -0,0 +1,74 @@
+#pragma once
+// Deutsche Dokumentation
+// Pegelfilter des Sensors: Alpha-Beta-Filter (stationärer Kalman-Filter für Pegel und
+// Anstiegsrate) in Festkomma, ohne Hardware-Abhängigkeit.
+//
+// Die Verstärkungen alpha/beta werden einmal beim Start aus Messrauschen und erwarteter
+// Änderung der Anstiegsrate bestimmt (Tracking-Index nach Kalata); je Messwert bleibt nur
+// Ganzzahl-Arithmetik. Ausreißer (Störspitze, Spritzwasser am Drucksensor) werden an der
+// Innovation erkannt: weicht ein Messwert um mehr als gateSigma Standardabweichungen der
+// erwarteten Innovation von der Vorhersage ab, wird er verworfen. Folgen maxRejects
+// Ausreißer aufeinander, hat sich der Pegel wirklich sprunghaft geändert (z. B. Pumpe
+// leert den Schacht) und der Filter rastet auf den neuen Wert ein.
+
+#include <cstdint>
+
+// Ab so vielen angenommenen Messwerten gilt die Anstiegsrate als belastbar
+static const uint8_t LEVEL_FILTER_SETTLE_SAMPLES = 3;
+
+struct LevelFilterConfig
+{
+    float noiseMm;          // Streuung einer Einzelmessung (1 Sigma)
+    float accelMmPerH2;     // erwartete Änderung der Anstiegsrate (Prozessrauschen)
+    uint32_t intervalMs;    // nominaler Messabstand
+    uint8_t gateSigma;      // Ausreißerschwelle in Sigma der erwarteten Innovation
+    uint16_t gateMinMm;     // ... mindestens aber so viele mm
+    uint8_t maxRejects;     // so viele Ausreißer in Folge: auf den Messwert einrasten
+    uint32_t maxGapMs;      // längere Messpause: Filter neu starten
+};
+
+// Aus LevelFilterConfig berechnete Festkomma-Parameter (levelFilterParams, einmal beim Start)
+struct LevelFilterParams
+{
+    uint16_t alphaQ16;      // Gewicht der Innovation im Pegel (65536 = 1)
+    uint16_t betaQ16;       // Gewicht der Innovation in der Rate
+    uint32_t minVarQ4;      // erwartete Innovationsvarianz in mm² x 16 (Untergrenze der Schätzung)
+    uint8_t gateSigma;
+    uint16_t gateMinMm;
+    uint8_t maxRejects;
+    uint32_t maxGapMs;
+};
+
+// Zustand (klein und flach, damit er den Deep-Sleep im RTC-Speicher überdauert)
+struct LevelFilter
+{
+    bool valid;
+    uint8_t samples;        // angenommene Messwerte seit dem Start (sättigt bei 255)
+    uint8_t rejects;        // Ausreißer in Folge
+    uint16_t rejectedTotal; // verworfene Messwerte insgesamt
+    int32_t levelQ8;        // Pegel in mm x 256
+    int32_t rateQ8;         // Anstiegsrate in mm/h x 256
+    uint32_t varQ4;         // geschätzte Innovationsvarianz in mm² x 16
+    uint32_t lastMs;
+};
+
+enum LevelFilterResult : uint8_t
+{
+    LEVEL_ACCEPTED = 0,
+    LEVEL_REJECTED,         // Ausreißer, Pegel folgt der Vorhersage
+    LEVEL_RESTARTED,        // erster Wert, nach langer Pause oder nach maxRejects Ausreißern
+};
+
+LevelFilterParams levelFilterParams(const LevelFilterConfig& c);
+
+void levelFilterReset(LevelFilter* f);
+
+// Messwert (mm) zum Zeitpunkt nowMs einarbeiten
+LevelFilterResult levelFilterUpdate(const LevelFilterParams& p, LevelFilter* f, int32_t depthMm, uint32_t nowMs);
+
+// Geglätteter Pegel in mm und Anstiegsrate in mm/h (= 0,1 cm/h)
+int32_t levelFilterLevelMm(const LevelFilter& f);
+int32_t levelFilterRateMmPerH(const LevelFilter& f);
+
+// true = genug Messwerte für eine belastbare Anstiegsrate
+bool levelFilterSettled(const LevelFilter& f);
@@ -0,0 +1,27 @@
+#pragma once
+// Deutsche Dokumentation
+// LoRa-Sendedauer (Time on Air) nach Semtech AN1200.13 und Demodulationsgrenzen,
+// ohne Hardware-Abhängigkeit (für ADR, Duty-Cycle-Rechnung und Empfangsfenster).
+
+#include <cstddef>
+#include <cstdint>
+
+struct LoRaModulation
+{
+    uint8_t sf;          // Spreading Factor 7..12
+    uint32_t bwHz;       // Bandbreite, z. B. 125000
+    uint8_t cr;          // Coding Rate 4/cr, cr = 5..8
+    uint16_t preamble;   // Präambel-Symbole (Standard 8)
+    bool crc;            // CRC am Paketende
+    bool explicitHeader; // expliziter Header (Standard)
+};
+
+// Standard der LoRa-Bibliothek: 125 kHz, 4/5, 8 Symbole, CRC aus, expliziter Header
+LoRaModulation loraModulationDefault(uint8_t sf);
+
+// Sendedauer eines Pakets mit payloadLen Byte in Mikrosekunden.
+// Low-Data-Rate-Optimierung wird wie im Funkmodul ab 16 ms Symboldauer angenommen.
+uint32_t loraTimeOnAirUs(const LoRaModulation& m, size_t payloadLen);
+
+// Mindest-SNR (dB) für den Empfang bei diesem SF (Datenblatt SX1276)
+float loraRequiredSnrDb(uint8_t sf);
@@ -0,0 +1,45 @@
+#pragma once
+// Deutsche Dokumentation
+// Gemeinsamer LoRa-Frame-Codec (Sensor und Gateway)
+// Aufbau: [sid(1)][nonce(8)][ciphertext(n)][mac(8)]
+// MAC = HMAC-SHA256 über (sid | nonce | ciphertext), auf 8 Byte gekürzt.
+// Alle Funktionen arbeiten in-place auf einem vom Aufrufer gestellten Puffer
+// (kein Heap) und laufen in einem Durchgang über die Payload.
+
+#include <cstddef>
+#include <cstdint>
+#include "crypto.h"
+
+static const size_t LORA_FRAME_NONCE_LEN = 8;
+static const size_t LORA_FRAME_MAC_LEN   = 8;
+static const size_t LORA_FRAME_HDR_LEN   = 1 + LORA_FRAME_NONCE_LEN;
+static const size_t LORA_FRAME_OVERHEAD  = LORA_FRAME_HDR_LEN + LORA_FRAME_MAC_LEN;
+// SX127x: maximal 255 Byte Payload pro LoRa-Paket
+static const size_t LORA_FRAME_MAX_LEN     = 255;
+static const size_t LORA_FRAME_MAX_PAYLOAD = LORA_FRAME_MAX_LEN - LORA_FRAME_OVERHEAD;
+
+// Zeiger auf den Payload-Bereich innerhalb eines Frame-Puffers.
+// Dort abgelegte Klartextdaten werden von loraFrameSeal() in-place verschlüsselt.
+inline uint8_t* loraFramePayload(uint8_t* frame) { return frame + LORA_FRAME_HDR_LEN; }
+
+// Versiegelt einen Frame in-place: Header schreiben, die bereits im Payload-Bereich
+// liegenden ptLen Bytes verschlüsseln und den MAC anhängen.
+// Rückgabe: Gesamtlänge des Frames, 0 bei Fehler (z. B. Puffer zu klein).
+size_t loraFrameSeal(CryptoSession& session, uint8_t sensorId, const uint8_t nonce[LORA_FRAME_NONCE_LEN],
+                     uint8_t* frame, size_t frameCap, size_t ptLen);
+
+// Wie loraFrameSeal(), kopiert den Klartext vorher aus einem beliebigen Byte-Bereich.
+size_t loraFrameEncode(CryptoSession& session, uint8_t sensorId, const uint8_t nonce[LORA_FRAME_NONCE_LEN],
+                       const uint8_t* pt, size_t ptLen, uint8_t* frame, size_t frameCap);
+
+// Sensor-ID eines empfangenen Frames (vor dem Öffnen zur Schlüsselwahl)
+// Rückgabe: false, wenn der Frame zu kurz ist.
+bool loraFrameSensorId(const uint8_t* frame, size_t len, uint8_t* sensorId);
+
+// Nonce eines Frames (zeigt in den Puffer)
+inline const uint8_t* loraFrameNonce(const uint8_t* frame) { return frame + 1; }
+
+// Prüft den MAC und entschlüsselt in-place. Bei Erfolg zeigt *pt in den Puffer.
+// Bei ungültigem MAC wird der Payload-Bereich gelöscht und false geliefert.
+bool loraFrameOpen(CryptoSession& session, uint8_t* frame, size_t len,
+                   const uint8_t** pt, size_t* ptLen);
@@ -0,0 +1,105 @@
+#pragma once
+// Deutsche Dokumentation
+// Messwert-Payload (Klartext innerhalb des LoRa-Frames), ohne Arduino-String und ohne Heap.
+//
+// Binärformat v2 (Sensor -> Gateway), alle Werte Little Endian:
+//   [0]    Version (PAYLOAD_VERSION_V2)
+//   [1]    Flags (PAYLOAD_FLAG_*)
+//   [2..3] Sequenznummer (uint16, läuft über)
+//   [4..5] Wasserstand in mm (int16, Festkomma)
+//   [6..]  optionale TLV-Erweiterungen: [Typ(1)][Länge(1)][Wert(Länge)]
+// Unbekannte TLV-Typen werden vom Empfänger übersprungen.
+//
+// Alt-Formate (ASCII, weiterhin lesbar für ältere Sensoren):
+// - Zahl, optional mit "cm"-Suffix, z. B. "18.6" oder "18.6cm"
+// - "WATER_CM:<wert>;STATUS:<OK|ERR>;MID:<id>"
+// ASCII-Payloads beginnen nie mit einem Byte < 0x20, daran wird unterschieden.
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint8_t PAYLOAD_VERSION_ASCII = 0x00; // nur intern: Alt-Format erkannt
+static const uint8_t PAYLOAD_VERSION_V2    = 0x02;
+static const size_t  PAYLOAD_V2_HDR_LEN    = 6;
+
+// Flags
+static const uint8_t PAYLOAD_FLAG_ERR = 0x01; // Messwert außerhalb der Plausibilitätsgrenzen
+
+// TLV-Typen
+static const uint8_t PAYLOAD_TLV_RAW_MV = 0x01; // uint16: gemittelte Roh-Spannung in mV
+static const uint8_t PAYLOAD_TLV_BATCH  = 0x02; // ältere Messwerte, siehe payloadAppendBatch()
+static const uint8_t PAYLOAD_TLV_ACK    = 0x03; // Quittungen für Downlink-Befehle, siehe downlink.h
+static const uint8_t PAYLOAD_TLV_RADIO  = 0x04; // [SF u8][Sendeleistung dBm i8]: aktuelle Funkparameter des Sensors
+static const uint8_t PAYLOAD_TLV_AIRTIME = 0x05; // [Sendezeit der letzten Stunde ms u16][verschobene Uplinks u16]
+static const uint8_t PAYLOAD_TLV_NOISE  = 0x06; // uint16: Streuung im ADC-Burst in 0,1 mV
+static const uint8_t PAYLOAD_TLV_WAKE   = 0x07; // uint16: Dauer Aufwachen aus dem Deep-Sleep bis Uplink gesendet in ms
+static const uint8_t PAYLOAD_TLV_TREND  = 0x08; // [gefilterter Pegel mm i16][Anstiegsrate mm/h (0,1 cm/h) i16], siehe level_filter.h
+
+// Höchstzahl älterer Messwerte in einem BATCH-TLV (passt auch im ungünstigsten Fall in 255 Byte)
+static const size_t PAYLOAD_BATCH_MAX = 24;
+
+struct PayloadReading
+{
+    bool valid;            // true = Wasserstand erkannt
+    uint8_t version;       // PAYLOAD_VERSION_ASCII oder PAYLOAD_VERSION_V2
+    int32_t depthMm;       // Wasserstand in mm (ASCII: auf mm gerundet)
+    uint8_t flags;         // nur v2
+    uint16_t seq;          // nur v2
+    char status[16];       // "OK"/"ERR" (v2 aus Flags, ASCII aus STATUS:), sonst leer
+    const uint8_t* ext;    // TLV-Bereich (zeigt in den Eingangspuffer), nur v2
+    size_t extLen;
+};
+
+// Wertet data/len aus (v2 oder ASCII). Rückgabe entspricht out->valid.
+bool parsePayload(const uint8_t* data, size_t len, PayloadReading* out);
+
+// Ein TLV-Eintrag (value zeigt in den Eingangspuffer)
+struct PayloadTlv
+{
+    uint8_t type;
+    uint8_t len;
+    const uint8_t* value;
+};
+
+// Iteriert über die TLV-Erweiterungen. *pos beginnt bei 0.
+// Rückgabe false am Ende oder bei abgeschnittenem Eintrag.
+bool payloadNextTlv(const uint8_t* ext, size_t extLen, size_t* pos, PayloadTlv* tlv);
+
+// Schreibt den v2-Kopf. Rückgabe: Länge oder 0, wenn cap zu klein ist.
+size_t payloadEncodeV2(uint8_t* buf, size_t cap, uint8_t flags, uint16_t seq, int16_t depthMm);
+
+// Hängt einen TLV-Eintrag an (len = bisherige Länge). Rückgabe: neue Länge oder 0.
+size_t payloadAppendTlv(uint8_t* buf, size_t cap, size_t len, uint8_t type, const uint8_t* value, uint8_t valueLen);
+
+// Älterer Messwert eines Batches, relativ zum Messwert im v2-Kopf
+struct BatchSample
+{
+    int32_t depthMm;
+    uint32_t ageSec;   // wie viele Sekunden vor dem Kopf-Messwert erfasst
+};
+
+// Hängt bis zu PAYLOAD_BATCH_MAX ältere Messwerte (neueste zuerst) als BATCH-TLV an.
+// Kodierung je Messwert: varint(Alter - Alter des Vorgängers), zigzag-varint(Tiefe - Vorgänger);
+// der erste Vorgänger ist der Kopf-Messwert (Alter 0, Tiefe headDepthMm).
+// Es gibt kein Fehler-Flag je Messwert: nur gültige Werte anhängen (ERR weglassen).
+// Rückgabe: neue Länge oder 0.
+size_t payloadAppendBatch(uint8_t* buf, size_t cap, size_t len, int32_t headDepthMm,
+                          const BatchSample* older, size_t count);
+
+// Lesezeiger über einen BATCH-TLV
+struct BatchCursor
+{
+    const uint8_t* data;
+    size_t len;
+    size_t pos;
+    int32_t depthMm;   // zuletzt gelieferter Wert (Start: Kopf-Messwert)
+    uint32_t ageSec;
+};
+
+void payloadBatchBegin(BatchCursor* c, const PayloadTlv& tlv, int32_t headDepthMm);
+// Liefert den nächstälteren Messwert. false am Ende oder bei beschädigten Daten.
+bool payloadBatchNext(BatchCursor* c, BatchSample* out);
+
+// Strikte Dezimalzahl (optionales Vorzeichen, Ziffern, höchstens ein '.')
+// nach mm wandeln. Rückgabe false bei ungültiger Eingabe.
+bool parseDecimalCmToMm(const char* s, size_t len, int32_t* mm);
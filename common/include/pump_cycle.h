@@ -0,0 +1,112 @@
+#pragma once
+// Deutsche Dokumentation
+// Pumpzyklen im Schacht aus dem Pegelverlauf erkennen, ohne Hardware-Abhängigkeit.
+//
+// Je Sensor ein kleiner Zustand, je Messwert O(1): der Pegel steigt (Zulauf füllt den Schacht)
+// bis eine Pumpe anspringt und ihn absenkt, dann steigt er wieder. Gefolgt wird dem laufenden
+// Hoch- bzw. Tiefpunkt; fällt der Pegel um swingMm unter den Hochpunkt, ist dort eine Pumpe
+// angesprungen, steigt er um swingMm über den Tiefpunkt, hat sie dort abgeschaltet. Daraus:
+//   - Zulauf in mm/h aus jeder vollständigen Füllphase (Tiefpunkt bis Hochpunkt)
+//   - je Pumpe Zyklusdauer (Start bis nächster Start), Laufzeit (Hoch- bis Tiefpunkt) und
+//     Absinkgeschwindigkeit (netto, der Zulauf läuft weiter); wird sie langsamer oder die
+//     Laufzeit länger, lässt die Pumpe nach
+//   - "springt nicht an": der Pegel steigt um failMarginMm über den Einschaltpegel einer Pumpe,
+//     ohne dass er fällt, und zwar ohne langsamer zu werden: der Anstieg seit dem Einschaltpegel
+//     erreicht mindestens 3/4 des Anstiegs davor (bzw. des gemessenen Zulaufs). Steigt er
+//     deutlich langsamer, läuft die Pumpe und kommt nur gegen den Zulauf nicht an (Starkregen,
+//     bis die nächste Pumpe übernimmt). Gelöscht, sobald die Pumpe wieder anspringt oder der
+//     Pegel beim Abpumpen unter den Ausschaltpegel aller höheren Pumpen sinkt (dann lief sie mit).
+//     Beginnt eine Füllphase schon über dem Einschaltpegel, wird die Pumpe darin nicht beurteilt.
+//
+// Ein Lauf gehört zur höchsten Pumpe, deren Einschaltpegel höchstens failMarginMm über dem
+// Hochpunkt liegt (sonst zur untersten). Zeitauflösung = Messabstand: Start und Ende liegen
+// zwischen zwei Messwerten. Laufen zwei Pumpen nacheinander ohne Wiederanstieg, zählt das als
+// ein Lauf der oberen.
+
+#include <cstdint>
+
+static const uint8_t PUMP_CYCLE_MAX_PUMPS = 4;
+
+struct PumpLevels
+{
+    int32_t startMm;        // Einschaltpegel
+    int32_t stopMm;         // Ausschaltpegel
+};
+
+struct PumpCycleConfig
+{
+    PumpLevels pumps[PUMP_CYCLE_MAX_PUMPS]; // nach Einschaltpegel aufsteigend
+    uint8_t pumpCount;
+    int32_t swingMm;        // Richtungswechsel erst ab dieser Änderung (deutlich über dem Messrauschen)
+    int32_t failMarginMm;   // so weit über dem Einschaltpegel ohne Absinken: springt nicht an
+    uint32_t maxGapS;       // längere Messpause: Zyklus verwerfen, neu ansetzen
+};
+
+enum PumpPhase : uint8_t
+{
+    PUMP_PHASE_UNKNOWN = 0, // noch kein Messwert
+    PUMP_PHASE_FILLING,     // Pegel steigt oder steht
+    PUMP_PHASE_DRAINING,    // eine Pumpe senkt den Pegel
+};
+
+struct PumpStats
+{
+    uint32_t cycles;        // beobachtete Läufe (bis zum Abschalten)
+    uint16_t failures;      // Einschaltpegel überschritten, ohne anzuspringen
+    bool failed;            // seitdem nicht wieder angesprungen
+    bool startValid;        // lastStartT gilt (seit Start bzw. Messpause schon gelaufen)
+    uint16_t periodCount;   // gemessene Zyklusdauern
+    uint32_t lastStartT;    // Zeitpunkt des letzten Einschaltens (s)
+    int32_t lastStartMm;    // Pegel beim letzten Einschalten
+    int32_t lastStopMm;     // Pegel beim letzten Abschalten
+    uint32_t lastPeriodS;   // Start bis Start
+    uint32_t periodS;       // gleitendes Mittel
+    uint32_t lastRunS;      // Laufzeit
+    uint32_t runS;          // gleitendes Mittel
+    int32_t drainMmPerH;    // Absinkgeschwindigkeit beim Abpumpen (netto), gleitendes Mittel
+};
+
+struct PumpCycleState
+{
+    uint8_t phase;          // PumpPhase
+    uint8_t drainPump;      // Pumpe des laufenden Abpumpens
+    bool fillValid;         // laufende Füllphase begann an einem Tiefpunkt
+    uint16_t fills;         // vollständige Füllphasen (Zulauf gemessen)
+    uint32_t lastT;
+    uint32_t extT;          // Hochpunkt (Füllen) bzw. Tiefpunkt (Abpumpen)
+    int32_t extMm;
+    uint32_t fillT;         // Beginn der Füllphase
+    int32_t fillMm;
+    uint32_t drainT;        // Beginn des Abpumpens
+    int32_t drainMm;
+    int32_t lastInflowMmPerH;
+    int32_t inflowMmPerH;   // gleitendes Mittel
+    uint8_t crossed;        // Bitmaske: Einschaltpegel in dieser Füllphase überschritten
+    uint32_t crossT[PUMP_CYCLE_MAX_PUMPS]; // erster Messwert am/über dem Einschaltpegel
+    int32_t crossMm[PUMP_CYCLE_MAX_PUMPS];
+    PumpStats pump[PUMP_CYCLE_MAX_PUMPS];
+};
+
+enum PumpEventKind : uint8_t
+{
+    PUMP_EVENT_NONE = 0,
+    PUMP_EVENT_STARTED,     // Pumpe angesprungen (Zulauf der Füllphase gemessen)
+    PUMP_EVENT_STOPPED,     // Pumpe abgeschaltet (Laufzeit gemessen)
+    PUMP_EVENT_FAILED,      // Einschaltpegel + Marge überschritten
+    PUMP_EVENT_RECOVERED,   // lief beim Abpumpen doch mit
+};
+
+struct PumpEvent
+{
+    uint8_t kind;           // PumpEventKind
+    uint8_t pump;
+};
+
+void pumpCycleReset(PumpCycleState* s);
+
+// Messwert (mm) zum Zeitpunkt tSec einarbeiten; ältere Zeitpunkte als der letzte werden ignoriert
+PumpEvent pumpCycleUpdate(const PumpCycleConfig& c, PumpCycleState* s, uint32_t tSec, int32_t levelMm);
+
+// Kurznamen für MQTT ("filling", "draining", "unknown" bzw. "started", "stopped", ...)
+const char* pumpPhaseName(uint8_t phase);
+const char* pumpEventName(uint8_t kind);
@@ -0,0 +1,66 @@
+#pragma once
+// Deutsche Dokumentation
+// Adaptiver Sende-Zeitplan des Sensors (Report-on-Change), ohne Hardware-Abhängigkeit.
+//
+// Nach jeder Messung entscheidet reportDecide(), ob gesendet wird:
+// - erster Messwert nach dem Start
+// - Hochwasser-Schnellpfad: Pegel >= floodLevelMm oder Anstieg >= floodRateMmPerMin
+//   -> Senden im Abstand fastIntervalMs (Alarm-Latenz = Messintervall)
+// - Änderung gegenüber dem zuletzt gesendeten Wert größer als deadbandMm
+// - Heartbeat: spätestens nach heartbeatMs, damit das Gateway den Sensor als lebendig sieht
+// Ansonsten wird nicht gesendet (ruhige Phasen kosten kaum Sendezeit).
+
+#include <cstdint>
+
+// Die Anstiegsrate wird über so viele Messwerte bestimmt (Basis = n-1 Messintervalle).
+// Aufeinanderfolgende Einzelwerte wären zu verrauscht: ±2 mm in 10 s sind schon ±12 mm/min.
+static const uint8_t REPORT_RATE_SAMPLES = 6;
+static const uint8_t REPORT_RATE_MIN_SAMPLES = 3;
+
+struct ReportPolicy
+{
+    int32_t deadbandMm;          // Änderungen bis zu diesem Betrag werden unterdrückt
+    uint32_t heartbeatMs;        // spätestens nach dieser Zeit senden
+    uint32_t fastIntervalMs;     // Mindestabstand im Hochwasser-Modus
+    int32_t floodLevelMm;        // ab diesem Pegel Schnellpfad
+    int32_t floodRateMmPerMin;   // ab diesem Anstieg Schnellpfad
+};
+
+enum ReportReason : uint8_t
+{
+    REPORT_NONE = 0,
+    REPORT_FIRST,
+    REPORT_FLOOD,
+    REPORT_DELTA,
+    REPORT_HEARTBEAT,
+    REPORT_ACK,        // vom Aufrufer gesetzt: Quittung eines Downlink-Befehls steht an
+};
+
+struct ReportState
+{
+    bool sent;             // mindestens einmal gesendet
+    bool fast;             // Hochwasser-Modus aktiv
+    int32_t lastSentMm;
+    uint32_t lastSentMs;
+    // letzte Messwerte für die Anstiegsrate (Ringpuffer)
+    int32_t histMm[REPORT_RATE_SAMPLES];
+    uint32_t histMs[REPORT_RATE_SAMPLES];
+    uint8_t histCount;
+    uint8_t histHead;
+    int32_t rateMmPerMin;  // Anstieg über die gepufferten Messwerte
+};
+
+void reportStateReset(ReportState* st);
+
+// Verarbeitet einen Messwert und liefert den Sendegrund (REPORT_NONE = nicht senden).
+// Der Aufrufer meldet einen tatsächlich erfolgten Versand mit reportSent().
+ReportReason reportDecide(const ReportPolicy& p, ReportState* st, int32_t depthMm, uint32_t nowMs);
+
+// Wie reportDecide(), die Anstiegsrate kommt aber vom Aufrufer (z. B. Pegelfilter) statt
+// aus den gepufferten Messwerten; der Ringpuffer wird dabei nicht fortgeschrieben.
+ReportReason reportDecideWithRate(const ReportPolicy& p, ReportState* st, int32_t depthMm,
+                                  int32_t rateMmPerMin, uint32_t nowMs);
+void reportSent(ReportState* st, int32_t depthMm, uint32_t nowMs);
+
+// Kurzname für Logs ("first", "flood", ...)
+const char* reportReasonName(ReportReason r);
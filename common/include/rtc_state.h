@@ -0,0 +1,80 @@
+#pragma once
+// Deutsche Dokumentation
+// Zustand des Sensors, der den Deep-Sleep im RTC-Speicher überdauert, und seine
+// Serialisierung (ohne Hardware-Abhängigkeit).
+//
+// Im RTC-Speicher liegt nicht die Struktur selbst, sondern ein Block
+// [Magic "LWLM" u32][Version u8][Länge u16][Felder, Little Endian][CRC-32 u32].
+// Nach einem OTA-Update mit geändertem Layout, einem Brownout oder einem Kaltstart
+// (RTC-Speicher undefiniert) scheitert das Einlesen, und der Sensor startet frisch
+// (Frame-Zähler dann wie bisher aus NVS).
+
+#include <cstddef>
+#include <cstdint>
+#include "adr.h"
+#include "downlink.h"
+#include "duty_cycle.h"
+#include "frame_counter.h"
+#include "level_filter.h"
+#include "payload.h"
+#include "report_policy.h"
+
+static const uint32_t RTC_STATE_MAGIC = 0x4D4C574Cu; // "LWLM"
+static const uint8_t RTC_STATE_VERSION = 2;
+static const uint8_t RTC_STATE_MAX_SAMPLES = PAYLOAD_BATCH_MAX + 1;
+static const uint8_t RTC_STATE_MAX_ACKS = 4;
+// Obergrenze des serialisierten Blocks (tatsächlich ~700 Byte)
+static const size_t RTC_STATE_MAX_LEN = 1024;
+
+// Gepufferter Messwert (noch nicht gesendet)
+struct RtcSample
+{
+    int16_t depthMm;
+    bool ok;
+    uint32_t ms;
+};
+
+struct SensorRtcState
+{
+    uint32_t bootCount;        // Aufwachvorgänge seit dem Kaltstart
+    uint32_t lastMeasureMs;    // Zeitpunkt der letzten Messung (Uhr über den Schlaf hinweg)
+    uint16_t seq;              // Sequenznummer der Messwert-Payload
+    uint16_t bootToTxMs;       // letzte Dauer Aufwachen -> Uplink gesendet (0 = unbekannt)
+
+    // Frame-Zähler (Nonce) samt reserviertem Block in NVS, Replay-Fenster der Downlinks
+    uint64_t frameCounter;
+    uint64_t counterReserved;
+    ReplayWindow downWindow;
+
+    RtcSample samples[RTC_STATE_MAX_SAMPLES];
+    uint8_t sampleCount;
+
+    // Sende-Zeitplan (letzter gesendeter Wert, Anstiegsrate), Pegelfilter und Duty-Cycle-Konto
+    ReportState report;
+    LevelFilter filter;
+    DutyCycle duty;
+
+    // Funkparameter (siehe radio_settings.h)
+    RadioSettings radioCurrent;
+    RadioSettings radioPrevious;
+    RadioSettings radioStaged;
+    bool radioHaveStaged;
+    bool radioStagedArmed;
+    bool radioProbation;
+    bool radioReportDue;
+    uint8_t radioProbationUplinks;
+
+    // Downlink-Befehle: offene Quittungen und zuletzt ausgeführter Befehl
+    DownlinkAck acks[RTC_STATE_MAX_ACKS];
+    uint8_t ackCount;
+    bool haveLastCommand;
+    uint16_t lastCommandId;
+    uint8_t lastCommandStatus;
+};
+
+// Serialisiert st nach buf. Rückgabe: Länge des Blocks, 0 wenn cap nicht reicht.
+size_t rtcStateSerialize(const SensorRtcState& st, uint8_t* buf, size_t cap);
+
+// Liest einen Block ein. false bei falschem Magic/Version/Länge, CRC-Fehler oder
+// unplausiblen Zählern (out ist dann unbestimmt).
+bool rtcStateDeserialize(const uint8_t* buf, size_t len, SensorRtcState* out);
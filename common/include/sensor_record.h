@@ -0,0 +1,76 @@
+#pragma once
+// Deutsche Dokumentation
+// Zustand eines Sensors im Gateway (letzter Wert, Verlauf, Linkwerte, Sequenz, Zustand),
+// ohne Hardware-Abhängigkeit. Das Gateway hält je Sensor-ID einen Eintrag.
+//
+// Verluste werden aus Lücken in der Sequenznummer (Payload v2, +1 je Uplink) gezählt.
+// Springt die Sequenz zurück oder weit nach vorn, gilt das als Neustart des Sensors.
+
+#include <cstdint>
+
+// Verlauf je Sensor (neueste zuerst)
+static const uint8_t SENSOR_HISTORY_LEN = 4;
+// Größere Sprünge der Sequenznummer werden nicht als Verlust gezählt (Neustart)
+static const uint16_t SENSOR_SEQ_MAX_GAP = 1024;
+
+enum SensorHealth : uint8_t
+{
+    SENSOR_UNKNOWN = 0,   // noch nichts empfangen
+    SENSOR_OK,
+    SENSOR_ERROR,         // letzter Messwert vom Sensor als Fehler markiert/unlesbar
+    SENSOR_LOSSY,         // Paketverlust über dem Grenzwert
+    SENSOR_STALE,         // länger nichts gehört
+};
+
+struct SensorSample
+{
+    int32_t depthMm;
+    uint32_t ms;          // Messzeitpunkt (Gateway-millis, bei Batches rückdatiert)
+    bool ok;
+};
+
+struct SensorRecord
+{
+    uint32_t lastRxMs;
+    int16_t rssi;
+    int16_t snrX4;        // SNR in 0,25 dB
+    uint16_t seq;
+    bool seqValid;
+    bool ok;              // letzter Messwert gültig
+    uint32_t received;    // gültige Uplinks
+    uint32_t lost;        // aus Sequenzlücken
+    uint16_t restarts;    // Sequenz zurückgesprungen
+    uint16_t airtimeMs;   // vom Sensor gemeldete Sendezeit der letzten Stunde (PAYLOAD_TLV_AIRTIME)
+    uint16_t txDeferred;  // vom Sensor gemeldete, wegen Duty-Cycle verschobene Uplinks
+    uint16_t noiseMvX10;  // vom Sensor gemeldete Streuung im ADC-Burst (0,1 mV)
+    uint16_t bootToTxMs;  // vom Sensor gemeldete Dauer Aufwachen -> Uplink (PAYLOAD_TLV_WAKE, 0 = unbekannt)
+    bool trendValid;      // Pegelfilter des Sensors eingeschwungen (PAYLOAD_TLV_TREND im letzten Uplink)
+    int16_t filteredMm;   // geglätteter Pegel
+    int16_t trendMmPerH;  // Anstiegsrate in mm/h (= 0,1 cm/h), positiv = steigend
+    SensorSample hist[SENSOR_HISTORY_LEN];
+    uint8_t histCount;
+};
+
+void sensorRecordReset(SensorRecord* r);
+
+// Gültigen Uplink eintragen. hasSeq = false bei ASCII-Altformat.
+// Rückgabe: Anzahl der seit dem letzten Uplink verlorenen Frames.
+uint16_t sensorRecordUplink(SensorRecord* r, uint32_t ms, int16_t rssi, float snr,
+                            bool hasSeq, uint16_t seq);
+
+// Messwert in den Verlauf übernehmen. Ältere Werte (Batch) vor dem aktuellen eintragen,
+// ältester zuerst; der letzte Aufruf bestimmt den aktuellen Wert.
+void sensorRecordSample(SensorRecord* r, int32_t depthMm, bool ok, uint32_t ms);
+
+const SensorSample* sensorRecordLatest(const SensorRecord* r);
+
+// Verlustrate in Promille über alle erwarteten Frames
+uint16_t sensorRecordLossPermille(const SensorRecord* r);
+
+// staleMs: ab dieser Stille gilt der Sensor als verstummt;
+// lossPermille: ab dieser Verlustrate als gestört (0 = nicht bewerten)
+SensorHealth sensorRecordHealth(const SensorRecord* r, uint32_t nowMs, uint32_t staleMs,
+                                uint16_t lossPermille);
+
+// Kurzname für Logs/MQTT ("ok", "stale", ...)
+const char* sensorHealthName(SensorHealth h);
@@ -0,0 +1,77 @@
+#pragma once
+// Deutsche Dokumentation
+// Lock-freier Ringpuffer für genau einen Erzeuger und einen Verbraucher (SPSC),
+// z. B. ISR -> loop() oder Task -> Task. Header-only, ohne Heap.
+//
+// Der Erzeuger schreibt direkt in den Slot (claim/publish), der Verbraucher liest
+// direkt daraus (front/pop): große Einträge werden so nicht doppelt kopiert.
+// Indizes laufen frei über; N muss eine Zweierpotenz sein.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N muss eine Zweierpotenz sein");
+
+public:
+    // --- Erzeuger ---
+    // Freier Slot zum Befüllen oder nullptr, wenn der Ring voll ist
+    T* claim()
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= N) return nullptr;
+        return &slots_[head & (N - 1)];
+    }
+    // Den mit claim() befüllten Slot für den Verbraucher freigeben
+    void publish()
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed) + 1;
+        head_.store(head, std::memory_order_release);
+        const uint32_t depth = head - tail_.load(std::memory_order_relaxed);
+        if (depth > highWater_.load(std::memory_order_relaxed)) highWater_.store(depth, std::memory_order_relaxed);
+    }
+    bool push(const T& v)
+    {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = v;
+        publish();
+        return true;
+    }
+
+    // --- Verbraucher ---
+    // Ältester Eintrag oder nullptr, wenn leer
+    T* front()
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) return nullptr;
+        return &slots_[tail & (N - 1)];
+    }
+    // Eintrag aus front() verwerfen
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    bool pop(T* out)
+    {
+        T* slot = front();
+        if (!slot) return false;
+        *out = *slot;
+        pop();
+        return true;
+    }
+
+    // --- Statistik (von beiden Seiten lesbar, Momentaufnahme) ---
+    size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return N; }
+    size_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> head_{0};      // nur vom Erzeuger geschrieben
+    std::atomic<uint32_t> tail_{0};      // nur vom Verbraucher geschrieben
+    std::atomic<uint32_t> highWater_{0}; // größte beobachtete Füllung
+    T slots_[N];
+};
@@ -0,0 +1,122 @@
+#pragma once
+// Deutsche Dokumentation
+// Komprimierter Zeitreihen-Speicher mit fester Größe (nach Gorilla, Facebook 2015),
+// ohne Hardware-Abhängigkeit und ohne Heap.
+//
+// Eine Reihe (TsSeries) speichert Punkte { Zeit, Mittel, Min, Max } einer Auflösung
+// (z. B. 60 s) in einem Ring aus Blöcken zu TS_BLOCK_BYTES. Im Blockkopf stehen erster
+// Zeitpunkt und erster Mittelwert; danach je Punkt bitweise:
+//   - Zeit als Delta-of-Delta in Einheiten der Auflösung (regelmäßige Punkte: 1 Bit)
+//   - Mittelwert als Differenz zum Vorgänger (unverändert: 1 Bit)
+//   - Mittel - Min und Max - Mittel (ein Messwert je Intervall: je 1 Bit)
+// Ist der Ring voll, fällt der älteste Block heraus. Anhängen ist O(1), Bereichsabfragen
+// überspringen Blöcke über ihren Kopf und dekodieren nur die betroffenen Blöcke.
+//
+// TsStore fasst Rohwerte automatisch zu Minute/Stunde/Tag zusammen (je Stufe eigener
+// Akkumulator, der bei einem Wert aus einem späteren Intervall als Punkt abgelegt wird).
+
+#include <cstddef>
+#include <cstdint>
+
+static const size_t TS_BLOCK_BYTES = 256;
+
+struct TsPoint
+{
+    uint32_t t;     // Beginn des Intervalls in s
+    int32_t avg;
+    int32_t min;
+    int32_t max;
+};
+
+struct TsBlockHeader
+{
+    uint32_t firstT;    // Intervallnummer (t / Auflösung) des ersten Punkts
+    uint32_t lastT;     // ... des letzten Punkts (Überspringen bei Abfragen)
+    int32_t firstAvg;
+    uint16_t bits;      // belegte Bits im Block
+    uint16_t count;     // Punkte im Block
+};
+
+struct TsSeries
+{
+    uint8_t* data;              // blockCount * TS_BLOCK_BYTES
+    TsBlockHeader* headers;     // blockCount
+    uint16_t blockCount;
+    uint16_t head;              // aktueller Block
+    uint16_t used;              // belegte Blöcke (bis blockCount)
+    uint32_t resolutionS;
+    // Kodierzustand des aktuellen Blocks
+    uint32_t prevT;
+    int64_t prevDeltaT;
+    int32_t prevAvg;
+    uint32_t points;            // Punkte in allen Blöcken
+};
+
+// data/headers werden vom Aufrufer gestellt (blockCount >= 2)
+void tsSeriesInit(TsSeries* s, uint8_t* data, TsBlockHeader* headers, uint16_t blockCount, uint32_t resolutionS);
+
+// Punkt anhängen. Zeitpunkte vor dem letzten Punkt werden auf diesen angehoben.
+void tsSeriesAppend(TsSeries* s, const TsPoint& p);
+
+// Ältester gespeicherter Zeitpunkt in s (0 = leer)
+uint32_t tsSeriesOldest(const TsSeries* s);
+// Jüngster gespeicherter Zeitpunkt in s (0 = leer)
+uint32_t tsSeriesNewest(const TsSeries* s);
+// Belegte Bytes (Blockköpfe nicht mitgezählt)
+size_t tsSeriesBytesUsed(const TsSeries* s);
+
+// Akkumulator eines noch offenen Intervalls
+struct TsAccumulator
+{
+    bool open;
+    uint32_t bucket;    // Intervallnummer
+    int64_t sum;
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+};
+
+enum TsTier : uint8_t
+{
+    TS_MINUTE = 0,
+    TS_HOUR,
+    TS_DAY,
+    TS_TIER_COUNT,
+};
+
+// Auflösung je Stufe in s
+static const uint32_t TS_TIER_SECONDS[TS_TIER_COUNT] = { 60, 3600, 86400 };
+
+struct TsStore
+{
+    TsSeries tier[TS_TIER_COUNT];
+    TsAccumulator acc[TS_TIER_COUNT];
+};
+
+// blocks[i] Blöcke für Stufe i; buffers[i]/headers[i] vom Aufrufer
+void tsStoreInit(TsStore* st, uint8_t* const buffers[TS_TIER_COUNT], TsBlockHeader* const headers[TS_TIER_COUNT],
+                 const uint16_t blocks[TS_TIER_COUNT]);
+
+// Rohwert (z. B. Tiefe in mm) zum Zeitpunkt tSec in alle Stufen einarbeiten
+void tsStoreAdd(TsStore* st, uint32_t tSec, int32_t value);
+
+// Lesezeiger für Bereichsabfragen [fromS, toS]; liefert zuletzt auch das offene Intervall
+struct TsCursor
+{
+    const TsSeries* s;
+    const TsAccumulator* open;  // nullptr = nur abgeschlossene Punkte
+    uint32_t from, to;          // Intervallnummern
+    uint16_t block;             // aktueller Block
+    uint16_t blocksLeft;        // inkl. aktuellem
+    uint16_t index;             // nächster Punkt im Block
+    uint16_t bitPos;
+    uint32_t t;
+    int64_t deltaT;
+    int32_t avg;
+    bool openDone;
+};
+
+void tsSeriesScan(const TsSeries* s, uint32_t fromS, uint32_t toS, TsCursor* c);
+void tsStoreScan(const TsStore* st, TsTier tier, uint32_t fromS, uint32_t toS, TsCursor* c);
+// Nächster Punkt in zeitlicher Reihenfolge. false am Ende.
+bool tsCursorNext(TsCursor* c, TsPoint* out);
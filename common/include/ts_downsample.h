@@ -0,0 +1,32 @@
+#pragma once
+// Deutsche Dokumentation
+// Bereichsabfrage mit Ausdünnung auf eine Punktzahl (Largest-Triangle-Three-Buckets,
+// Steinarsson 2013) direkt auf dem Zeitreihen-Speicher, ohne Zwischenpuffer:
+// zwei Lesezeiger laufen je einmal über den Bereich (einer wählt im aktuellen Eimer den Punkt
+// mit der größten Dreiecksfläche, der andere mittelt den nächsten Eimer), dazu ein
+// Zählvorlauf. Erster und letzter Punkt bleiben immer erhalten, Spitzen ebenfalls.
+
+#include <cstdint>
+#include "timeseries.h"
+
+// Feinste Stufe, die [fromS, toS] abdeckt und höchstens maxFactor * points Punkte liefert
+// (sonst die gröbste mit Daten)
+TsTier tsPickTier(const TsStore* st, uint32_t fromS, uint32_t toS, uint32_t points, uint32_t maxFactor);
+
+struct TsDownsampler
+{
+    TsCursor cur;         // Kandidaten des aktuellen Eimers
+    TsCursor ahead;       // nächster Eimer (Mittelwert)
+    uint32_t total;       // Punkte im Bereich
+    uint32_t points;      // Zielanzahl (alle, wenn total <= points)
+    uint32_t emitted;
+    uint32_t bucket;      // aktueller Eimer (0 = erster Punkt)
+    uint32_t curIndex;    // Index des nächsten Punkts von cur
+    uint32_t aheadIndex;
+    uint32_t t0;          // Bezug für x, hält die Produkte in int64
+    int64_t ax, ay;       // zuletzt gewählter Punkt
+};
+
+void tsDownsampleBegin(TsDownsampler* d, const TsStore* st, TsTier tier, uint32_t fromS, uint32_t toS, uint32_t points);
+// Nächster Punkt in zeitlicher Reihenfolge, false am Ende
+bool tsDownsampleNext(TsDownsampler* d, TsPoint* out);
@@ -0,0 +1,45 @@
+// Deutsche Dokumentation
+// Auswertung eines ADC-Bursts: Implementierung
+
+#include "adc_filter.h"
+#include <algorithm>
+
+// Mittelwert über s[from, to)
+static float meanOf(const uint16_t* s, size_t from, size_t to)
+{
+    uint32_t acc = 0;
+    for (size_t i = from; i < to; ++i) acc += s[i];
+    return (float)acc / (float)(to - from);
+}
+
+// Median der Gruppenmittel; die Gruppen liegen zusammenhängend im (unsortierten) Burst
+static float medianOfMeans(const uint16_t* s, size_t n, uint8_t groups)
+{
+    float means[256];
+    for (uint8_t g = 0; g < groups; ++g)
+        means[g] = meanOf(s, n * g / groups, n * (g + 1) / groups);
+    std::sort(means, means + groups);
+    return (groups & 1) ? means[groups / 2] : (means[groups / 2 - 1] + means[groups / 2]) * 0.5f;
+}
+
+bool adcReduce(uint16_t* samples, size_t n, AdcReduceMode mode, uint8_t param, AdcReduceResult* out)
+{
+    if (!n || n > UINT16_MAX) return false;
+    if (mode == ADC_REDUCE_TRIMMED_MEAN && param >= 50) return false;
+    if (mode == ADC_REDUCE_MEDIAN_OF_MEANS && (!param || param > n)) return false;
+
+    // Gruppenmittel vor dem Sortieren (braucht die zeitliche Reihenfolge)
+    if (mode == ADC_REDUCE_MEDIAN_OF_MEANS) out->value = medianOfMeans(samples, n, param);
+    else if (mode == ADC_REDUCE_MEAN) out->value = meanOf(samples, 0, n);
+
+    std::sort(samples, samples + n);
+    if (mode == ADC_REDUCE_TRIMMED_MEAN) {
+        const size_t cut = n * param / 100;
+        out->value = meanOf(samples, cut, n - cut);
+    }
+    out->spread = (float)(samples[(3 * n) / 4] - samples[n / 4]) / 1.349f;
+    out->min = samples[0];
+    out->max = samples[n - 1];
+    out->count = (uint16_t)n;
+    return true;
+}
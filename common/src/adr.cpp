@@ -0,0 +1,70 @@
+// Deutsche Dokumentation
+// Implementierung der adaptiven Datenrate
+
+#include "adr.h"
+#include <cmath>
+#include <cstring>
+#include "lora_airtime.h"
+
+void linkStatsReset(LinkStats* s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+void linkStatsAdd(LinkStats* s, int16_t rssi, float snr)
+{
+    s->snr[s->head] = snr;
+    s->rssi[s->head] = rssi;
+    s->head = (uint8_t)((s->head + 1) % LINK_STATS_WINDOW);
+    if (s->count < LINK_STATS_WINDOW) ++s->count;
+}
+
+float linkStatsMaxSnr(const LinkStats& s)
+{
+    if (!s.count) return 0.0f;
+    float m = s.snr[0];
+    for (size_t i = 1; i < s.count; ++i) if (s.snr[i] > m) m = s.snr[i];
+    return m;
+}
+
+float linkStatsMeanSnr(const LinkStats& s)
+{
+    if (!s.count) return 0.0f;
+    float sum = 0.0f;
+    for (size_t i = 0; i < s.count; ++i) sum += s.snr[i];
+    return sum / s.count;
+}
+
+int16_t linkStatsMeanRssi(const LinkStats& s)
+{
+    if (!s.count) return 0;
+    int32_t sum = 0;
+    for (size_t i = 0; i < s.count; ++i) sum += s.rssi[i];
+    return (int16_t)(sum / (int32_t)s.count);
+}
+
+float adrLinkMarginDb(const AdrPolicy& p, const LinkStats& s, uint8_t sf)
+{
+    return linkStatsMaxSnr(s) - loraRequiredSnrDb(sf) - p.installMarginDb;
+}
+
+bool adrRecommend(const AdrPolicy& p, const LinkStats& s, const RadioSettings& current, RadioSettings* out)
+{
+    if (s.count < p.minFrames) return false;
+    int steps = (int)floorf(adrLinkMarginDb(p, s, current.sf) / ADR_STEP_DB);
+    int sf = current.sf;
+    int power = current.txPowerDbm;
+    // Reserve: erst schneller senden, dann leiser
+    while (steps > 0 && sf > p.minSf) { --sf; --steps; }
+    while (steps > 0 && power > p.minTxPowerDbm) { power -= 3; --steps; }
+    // Zu wenig Reserve: erst lauter, dann langsamer
+    while (steps < 0 && power < p.maxTxPowerDbm) { power += 3; ++steps; }
+    while (steps < 0 && sf < p.maxSf) { ++sf; ++steps; }
+    if (power < p.minTxPowerDbm) power = p.minTxPowerDbm;
+    if (power > p.maxTxPowerDbm) power = p.maxTxPowerDbm;
+    if (sf < p.minSf) sf = p.minSf;
+    if (sf > p.maxSf) sf = p.maxSf;
+    out->sf = (uint8_t)sf;
+    out->txPowerDbm = (int8_t)power;
+    return out->sf != current.sf || out->txPowerDbm != current.txPowerDbm;
+}
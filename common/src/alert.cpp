@@ -0,0 +1,79 @@
+// Deutsche Dokumentation
+// Alarmregeln: Implementierung
+
+#include "alert.h"
+#include <cstring>
+
+void alertReset(AlertState* s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+// Eingabe für die Regel, false = in dieser Auswertung nicht vorhanden
+static bool ruleValue(const AlertRule& r, const AlertInput& in, int32_t* value)
+{
+    switch (r.kind) {
+    case ALERT_LEVEL: *value = in.levelMm; return in.hasLevel;
+    case ALERT_RISE: *value = in.rateMmPerH; return in.hasRate;
+    case ALERT_STALE:
+        *value = in.silentS > 0x7FFFFFFFUL ? 0x7FFFFFFF : (int32_t)in.silentS;
+        return in.hasSilence;
+    default: return false;
+    }
+}
+
+size_t alertEvaluate(const AlertRule* rules, size_t count, AlertState* s, const AlertInput& in,
+                     AlertTransition* out, size_t maxOut)
+{
+    size_t n = 0;
+    if (count > ALERT_MAX_RULES) count = ALERT_MAX_RULES;
+    for (size_t i = 0; i < count && n < maxOut; ++i) {
+        const AlertRule& r = rules[i];
+        AlertRuleState& st = s->rule[i];
+        int32_t value;
+        if (!ruleValue(r, in, &value)) continue;
+        // Stille fällt mit dem nächsten Uplink sofort zurück
+        const int32_t clearBelow = r.kind == ALERT_STALE ? r.threshold : r.threshold - r.hysteresis;
+        const bool beyond = st.active ? value < clearBelow : value >= r.threshold;
+        if (!beyond) { st.count = 0; continue; }
+        const uint8_t need = r.kind == ALERT_STALE || !r.debounce ? 1 : r.debounce;
+        if (st.count < 0xFF) st.count++;
+        if (st.count < need) continue;
+        st.active = !st.active;
+        st.count = 0;
+        out[n].rule = (uint8_t)i;
+        out[n].active = st.active;
+        out[n].value = value;
+        ++n;
+    }
+    return n;
+}
+
+int alertHighestActive(const AlertRule* rules, size_t count, const AlertState& s)
+{
+    int best = -1;
+    if (count > ALERT_MAX_RULES) count = ALERT_MAX_RULES;
+    for (size_t i = 0; i < count; ++i)
+        if (s.rule[i].active && (best < 0 || rules[i].severity >= rules[best].severity)) best = (int)i;
+    return best;
+}
+
+const char* alertKindName(uint8_t kind)
+{
+    switch (kind) {
+    case ALERT_LEVEL: return "level";
+    case ALERT_RISE: return "rise";
+    case ALERT_STALE: return "stale";
+    default: return "?";
+    }
+}
+
+const char* alertSeverityName(uint8_t severity)
+{
+    switch (severity) {
+    case ALERT_INFO: return "info";
+    case ALERT_WARNING: return "warning";
+    case ALERT_CRITICAL: return "critical";
+    default: return "?";
+    }
+}
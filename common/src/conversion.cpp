@@ -0,0 +1,15 @@
+// Deutsche Dokumentation
+// Implementierung der mV -> cm Umrechnung
+
+#include "conversion.h"
+
+int32_t calibrationDepthMmX10(const CalibrationLut& lut, uint32_t mv)
+{
+    if (mv > CAL_LUT_MAX_MV) mv = CAL_LUT_MAX_MV;
+    const uint32_t i = mv >> CAL_LUT_SHIFT;
+    const int32_t frac = (int32_t)(mv & (CAL_LUT_STEP_MV - 1));
+    const int32_t a = lut.depthMmX10[i];
+    const int32_t b = lut.depthMmX10[i + 1];
+    const int32_t d = a + ((b - a) * frac + (int32_t)(CAL_LUT_STEP_MV / 2)) / (int32_t)CAL_LUT_STEP_MV;
+    return d > 0 ? d : 0;
+}
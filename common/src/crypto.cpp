@@ -6,10 +6,19 @@
 #include <mbedtls/md.h>
 #include <cstring>
 
-bool aesCtrCrypt(const uint8_t key[16], const uint8_t nonce8[8], uint8_t* data, size_t len)
+// IV aus Nonce, Sensor-ID und Richtung (Layout in crypto.h)
+static void ctrIv(const uint8_t nonce8[8], uint8_t sensorId, uint8_t iv[16])
 {
-    uint8_t iv[16] = {0};
+    memset(iv, 0, 16);
     memcpy(iv, nonce8, 8);
+    iv[8] = sensorId;
+    iv[9] = (uint8_t)(nonce8[7] >> 7);
+}
+
+bool aesCtrCrypt(const uint8_t key[16], const uint8_t nonce8[8], uint8_t sensorId, uint8_t* data, size_t len)
+{
+    uint8_t iv[16];
+    ctrIv(nonce8, sensorId, iv);
     size_t nc_off = 0;
     uint8_t stream_block[16] = {0};
 
@@ -40,3 +49,173 @@ bool hmacSha256Trunc(const uint8_t* key, size_t keyLen,
     memcpy(out, full, outLen);
     return true;
 }
+
+bool hkdfSha256(const uint8_t* salt, size_t saltLen,
+                const uint8_t* ikm, size_t ikmLen,
+                const uint8_t* info, size_t infoLen,
+                uint8_t* okm, size_t okmLen)
+{
+    static const size_t HASH_LEN = 32;
+    if (okmLen > 255 * HASH_LEN) return false;
+    const uint8_t zeroSalt[HASH_LEN] = {0};
+    if (!salt || saltLen == 0) { salt = zeroSalt; saltLen = HASH_LEN; }
+
+    // Extract: PRK = HMAC(salt, IKM)
+    uint8_t prk[HASH_LEN];
+    if (!hmacSha256Trunc(salt, saltLen, ikm, ikmLen, prk, HASH_LEN)) return false;
+
+    // Expand: T(i) = HMAC(PRK, T(i-1) | info | i)
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md) return false;
+    mbedtls_md_context_t ctx; mbedtls_md_init(&ctx);
+    bool ok = mbedtls_md_setup(&ctx, md, 1) == 0 &&
+              mbedtls_md_hmac_starts(&ctx, prk, HASH_LEN) == 0;
+    uint8_t t[HASH_LEN];
+    size_t tLen = 0, done = 0;
+    for (uint8_t i = 1; ok && done < okmLen; ++i) {
+        ok = mbedtls_md_hmac_reset(&ctx) == 0 &&
+             mbedtls_md_hmac_update(&ctx, t, tLen) == 0 &&
+             mbedtls_md_hmac_update(&ctx, info, infoLen) == 0 &&
+             mbedtls_md_hmac_update(&ctx, &i, 1) == 0 &&
+             mbedtls_md_hmac_finish(&ctx, t) == 0;
+        tLen = HASH_LEN;
+        size_t take = (okmLen - done < HASH_LEN) ? (okmLen - done) : HASH_LEN;
+        if (ok) memcpy(okm + done, t, take);
+        done += take;
+    }
+    mbedtls_md_free(&ctx);
+    memset(prk, 0, sizeof(prk));
+    memset(t, 0, sizeof(t));
+    return ok;
+}
+
+bool deriveSensorKeys(const uint8_t* masterKey, size_t masterKeyLen, uint8_t sensorId,
+                      uint8_t aesKey[CRYPTO_AES_KEY_LEN], uint8_t hmacKey[CRYPTO_HMAC_KEY_LEN])
+{
+    static const char LABEL[] = "lwlm-sensor-v1";
+    uint8_t info[sizeof(LABEL)];
+    memcpy(info, LABEL, sizeof(LABEL) - 1);
+    info[sizeof(LABEL) - 1] = sensorId;
+
+    uint8_t okm[CRYPTO_AES_KEY_LEN + CRYPTO_HMAC_KEY_LEN];
+    if (!hkdfSha256(nullptr, 0, masterKey, masterKeyLen, info, sizeof(info), okm, sizeof(okm))) return false;
+    memcpy(aesKey, okm, CRYPTO_AES_KEY_LEN);
+    memcpy(hmacKey, okm + CRYPTO_AES_KEY_LEN, CRYPTO_HMAC_KEY_LEN);
+    memset(okm, 0, sizeof(okm));
+    return true;
+}
+
+// ---------------- CryptoSession ----------------
+
+CryptoSession::CryptoSession() : ctrOff_(0), ready_(false)
+{
+    mbedtls_aes_init(&aes_);
+    mbedtls_md_init(&inner_);
+    mbedtls_md_init(&outer_);
+    mbedtls_md_init(&work_);
+}
+
+CryptoSession::~CryptoSession()
+{
+    end();
+}
+
+bool CryptoSession::begin(const uint8_t aesKey[16], const uint8_t* hmacKey, size_t hmacKeyLen)
+{
+    end();
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md) return false;
+    if (mbedtls_aes_setkey_enc(&aes_, aesKey, 128) != 0) { end(); return false; }
+    if (mbedtls_md_setup(&inner_, md, 0) != 0 ||
+        mbedtls_md_setup(&outer_, md, 0) != 0 ||
+        mbedtls_md_setup(&work_, md, 0) != 0) { end(); return false; }
+
+    // HMAC-Schlüssel auf Blockgröße bringen (RFC 2104)
+    uint8_t k[64] = {0};
+    if (hmacKeyLen > sizeof(k)) {
+        if (mbedtls_md_starts(&work_) != 0 ||
+            mbedtls_md_update(&work_, hmacKey, hmacKeyLen) != 0 ||
+            mbedtls_md_finish(&work_, k) != 0) { end(); return false; }
+    } else {
+        memcpy(k, hmacKey, hmacKeyLen);
+    }
+    uint8_t pad[64];
+    for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = k[i] ^ 0x36;
+    bool ok = mbedtls_md_starts(&inner_) == 0 && mbedtls_md_update(&inner_, pad, sizeof(pad)) == 0;
+    for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = k[i] ^ 0x5c;
+    ok = ok && mbedtls_md_starts(&outer_) == 0 && mbedtls_md_update(&outer_, pad, sizeof(pad)) == 0;
+    memset(k, 0, sizeof(k));
+    memset(pad, 0, sizeof(pad));
+    if (!ok) { end(); return false; }
+    ready_ = true;
+    return true;
+}
+
+void CryptoSession::end()
+{
+    mbedtls_aes_free(&aes_);
+    mbedtls_md_free(&inner_);
+    mbedtls_md_free(&outer_);
+    mbedtls_md_free(&work_);
+    mbedtls_aes_init(&aes_);
+    mbedtls_md_init(&inner_);
+    mbedtls_md_init(&outer_);
+    mbedtls_md_init(&work_);
+    ready_ = false;
+}
+
+bool CryptoSession::ctrCrypt(const uint8_t nonce8[8], uint8_t sensorId, uint8_t* data, size_t len)
+{
+    return ctrBegin(nonce8, sensorId) && ctrUpdate(data, len);
+}
+
+bool CryptoSession::mac(const uint8_t* msg, size_t msgLen, uint8_t* out, size_t outLen)
+{
+    return macBegin() && macUpdate(msg, msgLen) && macFinish(out, outLen);
+}
+
+bool CryptoSession::ctrBegin(const uint8_t nonce8[8], uint8_t sensorId)
+{
+    if (!ready_) return false;
+    ctrIv(nonce8, sensorId, ctrIv_);
+    memset(ctrStream_, 0, sizeof(ctrStream_));
+    ctrOff_ = 0;
+    return true;
+}
+
+bool CryptoSession::ctrUpdate(uint8_t* data, size_t len)
+{
+    if (!ready_) return false;
+    return mbedtls_aes_crypt_ctr(&aes_, len, &ctrOff_, ctrIv_, ctrStream_, data, data) == 0;
+}
+
+bool CryptoSession::macBegin()
+{
+    // inner = H((K ^ ipad) | msg): vorberechneten Zustand übernehmen
+    return ready_ && mbedtls_md_clone(&work_, &inner_) == 0;
+}
+
+bool CryptoSession::macUpdate(const uint8_t* data, size_t len)
+{
+    return ready_ && mbedtls_md_update(&work_, data, len) == 0;
+}
+
+bool CryptoSession::macFinish(uint8_t* out, size_t outLen)
+{
+    if (!ready_ || outLen > 32) return false;
+    uint8_t h[32];
+    if (mbedtls_md_finish(&work_, h) != 0) return false;
+    // outer = H((K ^ opad) | inner)
+    if (mbedtls_md_clone(&work_, &outer_) != 0 ||
+        mbedtls_md_update(&work_, h, sizeof(h)) != 0 ||
+        mbedtls_md_finish(&work_, h) != 0) return false;
+    memcpy(out, h, outLen);
+    return true;
+}
+
+bool constTimeEqual(const uint8_t* a, const uint8_t* b, size_t len)
+{
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; ++i) diff |= (uint8_t)(a[i] ^ b[i]);
+    return diff == 0;
+}
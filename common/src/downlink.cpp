@@ -0,0 +1,51 @@
+// Deutsche Dokumentation
+// Implementierung des Downlink-Befehlsformats
+
+#include "downlink.h"
+#include <cstring>
+#include "byte_io.h"
+
+size_t downlinkEncode(const DownlinkCommand& cmd, uint8_t* buf, size_t cap)
+{
+    if (cmd.argLen > DOWNLINK_MAX_ARGS) return 0;
+    ByteWriter w(buf, cap);
+    w.u8(DOWNLINK_VERSION);
+    w.u16(cmd.id);
+    w.u8(cmd.opcode);
+    w.bytes(cmd.args, cmd.argLen);
+    return w.ok() ? w.length() : 0;
+}
+
+bool downlinkDecode(const uint8_t* buf, size_t len, DownlinkCommand* out)
+{
+    ByteReader r(buf, len);
+    if (r.u8() != DOWNLINK_VERSION) return false;
+    out->id = r.u16();
+    out->opcode = r.u8();
+    if (!r.ok() || r.remaining() > DOWNLINK_MAX_ARGS) return false;
+    out->argLen = (uint8_t)r.remaining();
+    memcpy(out->args, r.bytes(out->argLen), out->argLen);
+    return r.ok();
+}
+
+size_t payloadAppendAcks(uint8_t* buf, size_t cap, size_t len, const DownlinkAck* acks, size_t count)
+{
+    uint8_t value[255];
+    if (count == 0 || count * DOWNLINK_ACK_LEN > sizeof(value)) return 0;
+    ByteWriter w(value, sizeof(value));
+    for (size_t i = 0; i < count; ++i) {
+        w.u16(acks[i].id);
+        w.u8(acks[i].status);
+    }
+    return payloadAppendTlv(buf, cap, len, PAYLOAD_TLV_ACK, value, (uint8_t)w.length());
+}
+
+bool payloadNextAck(const PayloadTlv& tlv, size_t* pos, DownlinkAck* out)
+{
+    if (*pos + DOWNLINK_ACK_LEN > tlv.len) return false;
+    ByteReader r(tlv.value + *pos, DOWNLINK_ACK_LEN);
+    out->id = r.u16();
+    out->status = r.u8();
+    *pos += DOWNLINK_ACK_LEN;
+    return true;
+}
@@ -0,0 +1,75 @@
+// Deutsche Dokumentation
+// Implementierung der Downlink-Warteschlange
+
+#include "downlink_queue.h"
+#include <cstring>
+
+void downlinkQueueReset(DownlinkQueue* q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+static void removeAt(DownlinkQueue* q, size_t i)
+{
+    memmove(&q->entries[i], &q->entries[i + 1], (q->count - i - 1) * sizeof(DownlinkEntry));
+    --q->count;
+}
+
+bool downlinkQueuePush(DownlinkQueue* q, const DownlinkCommand& cmd, uint32_t nowMs)
+{
+    for (size_t i = 0; i < q->count; ++i) {
+        if (q->entries[i].cmd.opcode == cmd.opcode) { removeAt(q, i); break; }
+    }
+    if (q->count >= DOWNLINK_QUEUE_DEPTH) return false;
+    DownlinkEntry& e = q->entries[q->count++];
+    e.cmd = cmd;
+    e.queuedMs = nowMs;
+    e.lastSentMs = 0;
+    e.attempts = 0;
+    return true;
+}
+
+size_t downlinkQueueExpire(DownlinkQueue* q, const DownlinkPolicy& p, uint32_t nowMs,
+                           DownlinkCommand* expired, size_t cap)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < q->count;) {
+        const DownlinkEntry& e = q->entries[i];
+        if (e.attempts >= p.maxAttempts || nowMs - e.queuedMs >= p.expiryMs) {
+            if (n < cap) expired[n] = e.cmd;
+            ++n;
+            removeAt(q, i);
+        } else {
+            ++i;
+        }
+    }
+    return n < cap ? n : cap;
+}
+
+const DownlinkEntry* downlinkQueueTake(DownlinkQueue* q, uint32_t nowMs)
+{
+    if (q->count == 0) return nullptr;
+    DownlinkEntry& e = q->entries[0];
+    ++e.attempts;
+    e.lastSentMs = nowMs;
+    return &e;
+}
+
+bool downlinkQueueAck(DownlinkQueue* q, uint16_t id, DownlinkCommand* done)
+{
+    for (size_t i = 0; i < q->count; ++i) {
+        if (q->entries[i].cmd.id != id) continue;
+        if (done) *done = q->entries[i].cmd;
+        removeAt(q, i);
+        return true;
+    }
+    return false;
+}
+
+const DownlinkEntry* downlinkQueueFind(const DownlinkQueue* q, uint8_t opcode)
+{
+    for (size_t i = 0; i < q->count; ++i) {
+        if (q->entries[i].cmd.opcode == opcode) return &q->entries[i];
+    }
+    return nullptr;
+}
@@ -0,0 +1,77 @@
+// Deutsche Dokumentation
+// Sendezeit-Konto für den Duty-Cycle: Implementierung
+
+#include "duty_cycle.h"
+#include <cstring>
+
+void dutyCycleInit(DutyCycle* d, uint16_t dutyPermille, uint32_t windowMs)
+{
+    memset(d, 0, sizeof(*d));
+    d->budgetUs = (uint32_t)((uint64_t)windowMs * 1000u * dutyPermille / 1000u);
+    d->slotMs = windowMs / DUTY_CYCLE_SLOTS;
+    if (!d->slotMs) d->slotMs = 1;
+}
+
+// Abgelaufene Scheiben freigeben und die aktuelle Scheibe nachziehen
+static void advance(DutyCycle* d, uint32_t nowMs)
+{
+    if (!d->started) {
+        d->started = true;
+        d->slotStartMs = nowMs;
+        return;
+    }
+    uint32_t elapsed = (nowMs - d->slotStartMs) / d->slotMs;
+    if (!elapsed) return;
+    if (elapsed >= DUTY_CYCLE_SLOTS) {
+        // ganzes Fenster verstrichen
+        memset(d->slotUs, 0, sizeof(d->slotUs));
+        d->usedUs = 0;
+        d->slotStartMs = nowMs;
+        return;
+    }
+    for (uint32_t i = 0; i < elapsed; ++i) {
+        d->head = (uint8_t)((d->head + 1) % DUTY_CYCLE_SLOTS);
+        d->usedUs -= d->slotUs[d->head];
+        d->slotUs[d->head] = 0;
+    }
+    d->slotStartMs += elapsed * d->slotMs;
+}
+
+uint32_t dutyCycleUsedUs(DutyCycle* d, uint32_t nowMs)
+{
+    advance(d, nowMs);
+    return d->usedUs;
+}
+
+uint32_t dutyCycleRemainingUs(DutyCycle* d, uint32_t nowMs)
+{
+    advance(d, nowMs);
+    return d->usedUs < d->budgetUs ? d->budgetUs - d->usedUs : 0;
+}
+
+bool dutyCycleTryConsume(DutyCycle* d, uint32_t nowMs, uint32_t toaUs)
+{
+    advance(d, nowMs);
+    if (d->usedUs + (uint64_t)toaUs > d->budgetUs) {
+        ++d->deferred;
+        return false;
+    }
+    d->slotUs[d->head] += toaUs;
+    d->usedUs += toaUs;
+    return true;
+}
+
+uint32_t dutyCycleWaitMs(DutyCycle* d, uint32_t nowMs, uint32_t toaUs)
+{
+    advance(d, nowMs);
+    if (toaUs > d->budgetUs) return UINT32_MAX;
+    uint64_t used = d->usedUs;
+    if (used + toaUs <= d->budgetUs) return 0;
+    // Scheiben von der ältesten an freigeben, bis die Sendung passt
+    const uint32_t intoSlot = nowMs - d->slotStartMs;
+    for (uint8_t k = 1; k <= DUTY_CYCLE_SLOTS; ++k) {
+        used -= d->slotUs[(d->head + k) % DUTY_CYCLE_SLOTS];
+        if (used + toaUs <= d->budgetUs) return k * d->slotMs - intoSlot;
+    }
+    return DUTY_CYCLE_SLOTS * d->slotMs - intoSlot;
+}
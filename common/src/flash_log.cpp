@@ -0,0 +1,264 @@
+// Deutsche Dokumentation
+// Absturzsicheres Messwert-Log im Flash: Implementierung
+
+#include "flash_log.h"
+#include <cstring>
+#include "byte_io.h"
+#include "crc32.h"
+
+static const uint16_t FLASH_LOG_PAGES = FLASH_LOG_SLOTS / FLASH_LOG_PAGE_SLOTS;
+static const size_t FLASH_LOG_BODY_BYTES = FLASH_LOG_ENTRY_BYTES - 4;  // ohne CRC
+
+static bool erased(const uint8_t* entry)
+{
+    for (size_t i = 0; i < FLASH_LOG_ENTRY_BYTES; ++i)
+        if (entry[i] != 0xFF) return false;
+    return true;
+}
+
+static bool crcOk(const uint8_t* entry)
+{
+    ByteReader r(entry + FLASH_LOG_BODY_BYTES, 4);
+    return r.u32() == crc32(entry, FLASH_LOG_BODY_BYTES);
+}
+
+static void sealEntry(uint8_t* entry)
+{
+    ByteWriter w(entry + FLASH_LOG_BODY_BYTES, 4);
+    w.u32(crc32(entry, FLASH_LOG_BODY_BYTES));
+}
+
+static void encodeHeader(uint32_t seq, uint8_t* out)
+{
+    ByteWriter w(out, FLASH_LOG_BODY_BYTES);
+    w.u32(FLASH_LOG_MAGIC);
+    w.u8(FLASH_LOG_VERSION);
+    w.u8(0);
+    w.u8(0);
+    w.u8(0);
+    w.u32(seq);
+    sealEntry(out);
+}
+
+// Sektornummer aus einem gültigen Kopf, sonst 0
+static uint32_t decodeHeader(const uint8_t* in)
+{
+    if (!crcOk(in)) return 0;
+    ByteReader r(in, FLASH_LOG_BODY_BYTES);
+    if (r.u32() != FLASH_LOG_MAGIC || r.u8() != FLASH_LOG_VERSION) return 0;
+    r.bytes(3);
+    return r.u32();
+}
+
+void flashLogEncodeRecord(const FlashLogRecord& rec, uint8_t* out)
+{
+    ByteWriter w(out, FLASH_LOG_BODY_BYTES);
+    w.u8(FLASH_LOG_RECORD_MAGIC);
+    w.u8(rec.kind);
+    w.u8(rec.sid);
+    w.u8(rec.flags);
+    w.u32(rec.tSec);
+    w.u32((uint32_t)rec.value);
+    sealEntry(out);
+}
+
+bool flashLogDecodeRecord(const uint8_t* in, FlashLogRecord* out)
+{
+    if (in[0] != FLASH_LOG_RECORD_MAGIC || !crcOk(in)) return false;
+    ByteReader r(in + 1, FLASH_LOG_BODY_BYTES - 1);
+    out->kind = r.u8();
+    out->sid = r.u8();
+    out->flags = r.u8();
+    out->tSec = r.u32();
+    out->value = (int32_t)r.u32();
+    return true;
+}
+
+static uint32_t sectorOffset(uint16_t sector)
+{
+    return (uint32_t)sector * FLASH_LOG_SECTOR_BYTES;
+}
+
+uint16_t flashLogSectorCount(const FlashLogIo& io)
+{
+    const uint32_t n = io.size / FLASH_LOG_SECTOR_BYTES;
+    return (uint16_t)(n > 0xFFFF ? 0xFFFF : n);
+}
+
+bool flashLogMount(FlashLog* log, const FlashLogIo& io, FlashLogSectorInfo* index, uint16_t indexCount)
+{
+    memset(log, 0, sizeof(*log));
+    log->io = io;
+    log->index = index;
+    log->sectors = flashLogSectorCount(io) < indexCount ? flashLogSectorCount(io) : indexCount;
+    log->head = log->sectors;
+    log->fill = log->written = FLASH_LOG_SLOTS;  // erster Satz beginnt einen Sektor
+    if (log->sectors < 2 || !io.read) return false;
+
+    // Index aus Kopf und erstem Satz je Sektor
+    uint8_t buf[2 * FLASH_LOG_ENTRY_BYTES];
+    for (uint16_t i = 0; i < log->sectors; ++i) {
+        if (!io.read(io.ctx, sectorOffset(i), buf, sizeof(buf))) return false;
+        FlashLogRecord first;
+        index[i].seq = decodeHeader(buf);
+        index[i].firstTSec = index[i].seq && flashLogDecodeRecord(buf + FLASH_LOG_ENTRY_BYTES, &first) ? first.tSec : 0;
+        if (!index[i].seq) continue;
+        ++log->usedSectors;
+        if (index[i].seq > log->headSeq) {
+            log->headSeq = index[i].seq;
+            log->head = i;
+        }
+    }
+    if (log->head == log->sectors) return true;
+
+    // Im aktuellen Sektor von hinten den letzten beschriebenen Eintrag suchen
+    uint16_t last = 0;
+    for (uint16_t p = FLASH_LOG_PAGES; p-- > 0 && !last;) {
+        if (!io.read(io.ctx, sectorOffset(log->head) + p * FLASH_LOG_PAGE_BYTES, log->page, FLASH_LOG_PAGE_BYTES))
+            return false;
+        for (uint16_t s = FLASH_LOG_PAGE_SLOTS; s-- > 0;) {
+            if (!erased(log->page + s * FLASH_LOG_ENTRY_BYTES)) {
+                last = (uint16_t)(p * FLASH_LOG_PAGE_SLOTS + s);
+                break;
+            }
+        }
+        if (!p) break;  // Seite 0 enthält mindestens den Kopf
+    }
+    // Unvollständige Einträge in der letzten Seite (Stromausfall beim Schreiben) abschneiden:
+    // weiter erst an der nächsten Seitengrenze, der Rest der Seite bleibt ungenutzt
+    const uint16_t pageStart = (uint16_t)(last / FLASH_LOG_PAGE_SLOTS * FLASH_LOG_PAGE_SLOTS);
+    for (uint16_t s = pageStart ? pageStart : 1; s <= last; ++s) {
+        const uint8_t* entry = log->page + (s - pageStart) * FLASH_LOG_ENTRY_BYTES;
+        FlashLogRecord r;
+        if (!erased(entry) && !flashLogDecodeRecord(entry, &r)) ++log->torn;
+    }
+    uint16_t resume = (uint16_t)(last + 1);
+    if (log->torn) resume = (uint16_t)(pageStart + FLASH_LOG_PAGE_SLOTS);
+    if (resume % FLASH_LOG_PAGE_SLOTS == 0) memset(log->page, 0xFF, sizeof(log->page));
+    log->fill = log->written = resume;
+    return true;
+}
+
+static bool startSector(FlashLog* log)
+{
+    if (!log->io.erase || !log->io.write) return false;
+    const uint16_t next = log->head == log->sectors ? 0 : (uint16_t)((log->head + 1) % log->sectors);
+    if (!log->io.erase(log->io.ctx, sectorOffset(next))) {
+        log->ioError = true;
+        return false;
+    }
+    if (!log->index[next].seq) ++log->usedSectors;
+    log->index[next] = { ++log->headSeq, 0 };
+    log->head = next;
+    memset(log->page, 0xFF, sizeof(log->page));
+    encodeHeader(log->headSeq, log->page);
+    log->fill = 1;
+    log->written = 0;
+    return true;
+}
+
+bool flashLogFlush(FlashLog* log)
+{
+    if (log->head == log->sectors || log->written == log->fill) return true;
+    const uint16_t from = log->written;
+    const size_t len = (size_t)(log->fill - from) * FLASH_LOG_ENTRY_BYTES;
+    // Auch bei Fehler nicht erneut schreiben: NOR-Flash darf nur gelöschte Bytes programmieren
+    log->written = log->fill;
+    const bool ok = log->io.write(log->io.ctx, sectorOffset(log->head) + from * FLASH_LOG_ENTRY_BYTES,
+                                  log->page + (from % FLASH_LOG_PAGE_SLOTS) * FLASH_LOG_ENTRY_BYTES, len);
+    if (!ok) log->ioError = true;
+    return ok;
+}
+
+bool flashLogAppend(FlashLog* log, const FlashLogRecord& rec)
+{
+    if (log->sectors < 2) return false;
+    if (log->fill >= FLASH_LOG_SLOTS && !startSector(log)) return false;
+    if (log->fill == 1) log->index[log->head].firstTSec = rec.tSec;
+    flashLogEncodeRecord(rec, log->page + (log->fill % FLASH_LOG_PAGE_SLOTS) * FLASH_LOG_ENTRY_BYTES);
+    ++log->fill;
+    ++log->appended;
+    if (log->fill % FLASH_LOG_PAGE_SLOTS) return true;
+    // Seite voll: schreiben, Puffer für die nächste Seite leeren
+    const bool ok = flashLogFlush(log);
+    memset(log->page, 0xFF, sizeof(log->page));
+    return ok;
+}
+
+uint16_t flashLogPending(const FlashLog* log)
+{
+    return log->head == log->sectors ? 0 : (uint16_t)(log->fill - log->written);
+}
+
+static bool loadPage(FlashLogCursor* c)
+{
+    const FlashLogIo& io = c->log->io;
+    const uint32_t offset = sectorOffset(c->sector) + (c->slot / FLASH_LOG_PAGE_SLOTS) * FLASH_LOG_PAGE_BYTES;
+    if (io.read(io.ctx, offset, c->page, FLASH_LOG_PAGE_BYTES)) return true;
+    c->sectorsLeft = 0;
+    return false;
+}
+
+// Zum nächsten belegten Sektor (ab c->sector einschließlich), false = keiner mehr
+static bool seekUsed(FlashLogCursor* c)
+{
+    while (c->sectorsLeft && !c->log->index[c->sector].seq) {
+        c->sector = (uint16_t)((c->sector + 1) % c->log->sectors);
+        --c->sectorsLeft;
+    }
+    return c->sectorsLeft != 0;
+}
+
+static void nextSector(FlashLogCursor* c)
+{
+    c->sector = (uint16_t)((c->sector + 1) % c->log->sectors);
+    --c->sectorsLeft;
+}
+
+void flashLogScan(const FlashLog* log, uint32_t fromTSec, FlashLogCursor* c)
+{
+    memset(c, 0, sizeof(*c));
+    c->log = log;
+    c->fromTSec = fromTSec;
+    if (log->head == log->sectors) return;
+    // Ältester Sektor liegt im Ring hinter dem aktuellen
+    c->sector = (uint16_t)((log->head + 1) % log->sectors);
+    c->sectorsLeft = log->sectors;
+    if (!seekUsed(c)) return;
+    // Sektoren überspringen, deren Nachfolger schon vor fromTSec beginnt
+    for (;;) {
+        FlashLogCursor probe = *c;
+        nextSector(&probe);
+        if (!seekUsed(&probe)) break;
+        const uint32_t nextFirst = log->index[probe.sector].firstTSec;
+        if (!nextFirst || nextFirst >= fromTSec) break;
+        c->sector = probe.sector;
+        c->sectorsLeft = probe.sectorsLeft;
+    }
+    c->slot = 1;
+    loadPage(c);
+}
+
+bool flashLogNext(FlashLogCursor* c, FlashLogRecord* out)
+{
+    while (c->sectorsLeft) {
+        if (c->slot >= FLASH_LOG_SLOTS) {
+            nextSector(c);
+            if (!seekUsed(c)) return false;
+            c->slot = 1;
+            if (!loadPage(c)) return false;
+        } else if (c->slot % FLASH_LOG_PAGE_SLOTS == 0 && !loadPage(c)) {
+            return false;
+        }
+        const uint8_t* entry = c->page + (c->slot % FLASH_LOG_PAGE_SLOTS) * FLASH_LOG_ENTRY_BYTES;
+        ++c->slot;
+        if (erased(entry)) continue;
+        if (!flashLogDecodeRecord(entry, out)) {
+            ++c->invalid;
+            continue;
+        }
+        if (out->tSec < c->fromTSec) continue;
+        return true;
+    }
+    return false;
+}
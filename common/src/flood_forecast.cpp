@@ -0,0 +1,143 @@
+// Deutsche Dokumentation
+// Hochwasser-Prognose: Implementierung
+
+#include "flood_forecast.h"
+#include <cmath>
+#include <cstring>
+
+// Ab diesem Abstand zu baseT werden die Summen auf die älteste Stützstelle neu bezogen
+// (selten, O(Stützstellen)); so bleiben n·Σt² und n·Σt·y weit unter int64
+static const uint32_t FORECAST_REBASE_S = 1UL << 20;
+
+static const double SEC_PER_HOUR = 3600.0;
+
+void forecastReset(ForecastState* s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+static uint8_t slotAt(const ForecastState* s, uint8_t i)
+{
+    return (uint8_t)((s->head + i) % FORECAST_MAX_SLOTS);
+}
+
+static void addSums(ForecastState* s, const ForecastPoint& p, int sign)
+{
+    const int64_t t = (int64_t)(p.t - s->baseT);
+    const int64_t y = p.mm;
+    s->sumT += sign * t;
+    s->sumTT += sign * t * t;
+    s->sumY += sign * y;
+    s->sumYY += sign * y * y;
+    s->sumTY += sign * t * y;
+}
+
+static void dropOldest(ForecastState* s)
+{
+    addSums(s, s->pt[s->head], -1);
+    s->head = slotAt(s, 1);
+    s->count--;
+}
+
+static void rebase(ForecastState* s)
+{
+    s->baseT = s->pt[s->head].t;
+    s->sumT = s->sumTT = s->sumY = s->sumYY = s->sumTY = 0;
+    for (uint8_t i = 0; i < s->count; ++i) addSums(s, s->pt[slotAt(s, i)], 1);
+}
+
+void forecastAdd(const ForecastConfig& c, ForecastState* s, uint32_t tSec, int32_t levelMm)
+{
+    if (s->count && tSec < s->lastT) return;
+    if (s->count && (tSec - s->lastT > c.maxGapS || (c.resetDropMm && levelMm < s->lastMm - c.resetDropMm)))
+        forecastReset(s);
+    if (!s->count) s->baseT = tSec;
+    else if (tSec - s->baseT > FORECAST_REBASE_S) rebase(s);
+    s->lastT = tSec;
+    s->lastMm = levelMm;
+
+    uint8_t slots = c.slots > FORECAST_MAX_SLOTS ? FORECAST_MAX_SLOTS : c.slots;
+    if (slots < 2) slots = 2;
+    const uint32_t spacing = c.windowS / slots;
+    const ForecastPoint p = { tSec, levelMm };
+    if (s->count >= 2 && tSec - s->pt[slotAt(s, s->count - 2)].t < spacing) {
+        // Jüngste Stützstelle ist noch offen: durch den neuen Wert ersetzen
+        ForecastPoint& newest = s->pt[slotAt(s, s->count - 1)];
+        addSums(s, newest, -1);
+        newest = p;
+        addSums(s, newest, 1);
+    } else {
+        if (s->count >= slots) dropOldest(s);
+        s->pt[slotAt(s, s->count)] = p;
+        s->count++;
+        addSums(s, p, 1);
+    }
+    while (s->count > 1 && tSec - s->pt[s->head].t > c.windowS) dropOldest(s);
+}
+
+void forecastCompute(const ForecastConfig& c, const ForecastState& s, ForecastResult* r)
+{
+    memset(r, 0, sizeof(*r));
+    for (uint8_t i = 0; i < FORECAST_MAX_LEVELS; ++i)
+        r->eta[i].etaS = r->eta[i].earlyS = r->eta[i].lateS = FORECAST_OPEN;
+    r->samples = s.count;
+    r->t = s.lastT;
+    r->levelMm = s.lastMm;
+    if (!s.count) return;
+    r->spanS = s.pt[slotAt(&s, s.count - 1)].t - s.pt[s.head].t;
+    if (s.count < 3 || s.count < c.minSamples || r->spanS < c.minSpanS) return;
+
+    // Normalgleichungen mit n multipliziert: exakt in Ganzzahlen, erst danach Gleitkomma
+    const int64_t n = s.count;
+    const int64_t sxx = n * s.sumTT - s.sumT * s.sumT;
+    if (sxx <= 0) return;
+    const int64_t sxy = n * s.sumTY - s.sumT * s.sumY;
+    const int64_t syy = n * s.sumYY - s.sumY * s.sumY;
+    const double b = (double)sxy / (double)sxx; // mm/s
+    const double dt = (double)(s.lastT - s.baseT) - (double)s.sumT / (double)n;
+    const double level = (double)s.sumY / (double)n + b * dt;
+    double sse = ((double)syy - (double)sxy * (double)sxy / (double)sxx) / (double)n;
+    if (sse < 0) sse = 0;
+    const double s2 = sse / (double)(n - 2);
+    const double seB = std::sqrt(s2 * (double)n / (double)sxx);
+    const double seLevel = std::sqrt(s2 * (1.0 / (double)n + dt * dt * (double)n / (double)sxx));
+
+    r->valid = true;
+    r->levelMm = (int32_t)std::lround(level);
+    r->rateMmPerH = (int32_t)std::lround(b * SEC_PER_HOUR);
+    r->rateSeMmPerH = (int32_t)std::lround(seB * SEC_PER_HOUR);
+
+    const double k = c.confidenceK;
+    const double minRise = c.minRiseMmPerH / SEC_PER_HOUR;
+    const uint8_t levels = c.levelCount > FORECAST_MAX_LEVELS ? FORECAST_MAX_LEVELS : c.levelCount;
+    for (uint8_t i = 0; i < levels; ++i) {
+        ForecastEta& e = r->eta[i];
+        const double rest = c.levelsMm[i] - level;
+        if (s.lastMm >= c.levelsMm[i] || rest <= 0) {
+            e.status = FORECAST_REACHED;
+            e.etaS = e.earlyS = e.lateS = 0;
+            continue;
+        }
+        if (b < minRise || b <= 0) continue;
+        const double eta = rest / b;
+        if (eta > c.horizonS) continue;
+        e.status = FORECAST_ETA;
+        e.etaS = (uint32_t)std::lround(eta);
+        const double nearRest = rest - k * seLevel;
+        e.earlyS = nearRest > 0 ? (uint32_t)std::lround(nearRest / (b + k * seB)) : 0;
+        // Anstieg nach unten offen (kann auch null sein): spätestens nicht absehbar
+        const double bLow = b - k * seB;
+        const double late = bLow > 0 ? (rest + k * seLevel) / bLow : -1;
+        e.lateS = late >= 0 && late <= c.horizonS ? (uint32_t)std::lround(late) : FORECAST_OPEN;
+    }
+}
+
+const char* forecastStatusName(uint8_t status)
+{
+    switch (status) {
+    case FORECAST_NONE: return "none";
+    case FORECAST_ETA: return "eta";
+    case FORECAST_REACHED: return "reached";
+    default: return "?";
+    }
+}
@@ -0,0 +1,49 @@
+// Deutsche Dokumentation
+// Implementierung Frame-Zähler / Replay-Fenster
+
+#include "frame_counter.h"
+
+void frameCounterToNonce(uint64_t counter, uint8_t nonce[8])
+{
+    for (int i = 0; i < 8; ++i) nonce[i] = (uint8_t)(counter >> (8 * i));
+}
+
+uint64_t frameCounterFromNonce(const uint8_t nonce[8])
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | nonce[i];
+    return v;
+}
+
+void replayWindowReset(ReplayWindow& w)
+{
+    w.top = 0;
+    w.bitmap = 0;
+}
+
+void replayWindowRestore(ReplayWindow& w, uint64_t top)
+{
+    w.top = top;
+    w.bitmap = ~0ULL;
+}
+
+bool replayWindowCheck(const ReplayWindow& w, uint64_t counter)
+{
+    if (counter == 0 || counter > FRAME_COUNTER_MAX) return false;
+    if (counter > w.top) return true;
+    const uint64_t age = w.top - counter;
+    if (age >= REPLAY_WINDOW_BITS) return false; // zu alt
+    return ((w.bitmap >> age) & 1ULL) == 0;
+}
+
+void replayWindowUpdate(ReplayWindow& w, uint64_t counter)
+{
+    if (counter > w.top) {
+        const uint64_t shift = counter - w.top;
+        w.bitmap = (shift >= REPLAY_WINDOW_BITS) ? 1ULL : ((w.bitmap << shift) | 1ULL);
+        w.top = counter;
+    } else {
+        const uint64_t age = w.top - counter;
+        if (age < REPLAY_WINDOW_BITS) w.bitmap |= 1ULL << age;
+    }
+}
@@ -0,0 +1,106 @@
+// Deutsche Dokumentation
+// Pegelfilter (Alpha-Beta, Festkomma): Implementierung
+
+#include "level_filter.h"
+#include <cmath>
+#include <cstring>
+
+static const int64_t MS_PER_HOUR = 3600000;
+
+LevelFilterParams levelFilterParams(const LevelFilterConfig& c)
+{
+    // Tracking-Index lambda = Prozessrauschen * T² / Messrauschen (T in Stunden), daraus
+    // die stationären Kalman-Verstärkungen des Alpha-Beta-Filters (Kalata 1984)
+    const float noise = c.noiseMm > 0.1f ? c.noiseMm : 0.1f;
+    const float t = c.intervalMs / (float)MS_PER_HOUR;
+    const float lambda = c.accelMmPerH2 * t * t / noise;
+    const float r = (4.0f + lambda - sqrtf(8.0f * lambda + lambda * lambda)) / 4.0f;
+    float alpha = 1.0f - r * r;
+    if (alpha < 0.01f) alpha = 0.01f;
+    if (alpha > 0.99f) alpha = 0.99f;
+    float beta = 2.0f * (2.0f - alpha) - 4.0f * sqrtf(1.0f - alpha);
+    if (beta < 0.0001f) beta = 0.0001f;
+
+    LevelFilterParams p;
+    p.alphaQ16 = (uint16_t)lroundf(alpha * 65536.0f);
+    p.betaQ16 = (uint16_t)lroundf(beta * 65536.0f);
+    // erwartete Innovationsvarianz im eingeschwungenen Zustand: R / (1 - alpha)
+    p.minVarQ4 = (uint32_t)lroundf(noise * noise / (1.0f - alpha) * 16.0f);
+    p.gateSigma = c.gateSigma;
+    p.gateMinMm = c.gateMinMm;
+    p.maxRejects = c.maxRejects ? c.maxRejects : 1;
+    p.maxGapMs = c.maxGapMs;
+    return p;
+}
+
+void levelFilterReset(LevelFilter* f)
+{
+    memset(f, 0, sizeof(*f));
+}
+
+static void restart(const LevelFilterParams& p, LevelFilter* f, int32_t depthMm, uint32_t nowMs)
+{
+    f->valid = true;
+    f->samples = 1;
+    f->rejects = 0;
+    f->levelQ8 = depthMm * 256;
+    f->rateQ8 = 0;
+    f->varQ4 = p.minVarQ4;
+    f->lastMs = nowMs;
+}
+
+LevelFilterResult levelFilterUpdate(const LevelFilterParams& p, LevelFilter* f, int32_t depthMm, uint32_t nowMs)
+{
+    uint32_t dt = nowMs - f->lastMs;
+    if (!f->valid || dt > p.maxGapMs) {
+        restart(p, f, depthMm, nowMs);
+        return LEVEL_RESTARTED;
+    }
+    if (!dt) dt = 1;
+
+    // Vorhersage mit der bisherigen Rate, Innovation gegen den Messwert
+    const int64_t pred = f->levelQ8 + (int64_t)f->rateQ8 * dt / MS_PER_HOUR;
+    const int64_t e = (int64_t)depthMm * 256 - pred;
+    const int64_t eMm = e / 256;
+    const int64_t var = f->varQ4 > p.minVarQ4 ? f->varQ4 : p.minVarQ4;
+    const int64_t absMm = eMm < 0 ? -eMm : eMm;
+    f->lastMs = nowMs;
+
+    if (absMm > p.gateMinMm && eMm * eMm * 16 > (int64_t)p.gateSigma * p.gateSigma * var) {
+        f->levelQ8 = (int32_t)pred;
+        if (f->rejectedTotal < UINT16_MAX) ++f->rejectedTotal;
+        if (++f->rejects >= p.maxRejects) {
+            restart(p, f, depthMm, nowMs);
+            return LEVEL_RESTARTED;
+        }
+        return LEVEL_REJECTED;
+    }
+
+    f->levelQ8 = (int32_t)(pred + e * p.alphaQ16 / 65536);
+    f->rateQ8 = (int32_t)(f->rateQ8 + e * p.betaQ16 / 256 * MS_PER_HOUR / ((int64_t)dt * 256));
+    const int64_t v = f->varQ4 + (eMm * eMm * 16 - (int64_t)f->varQ4) / 16;
+    f->varQ4 = v > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+    f->rejects = 0;
+    if (f->samples < UINT8_MAX) ++f->samples;
+    return LEVEL_ACCEPTED;
+}
+
+static int32_t roundQ8(int32_t v)
+{
+    return v >= 0 ? (v + 128) / 256 : -((-v + 128) / 256);
+}
+
+int32_t levelFilterLevelMm(const LevelFilter& f)
+{
+    return roundQ8(f.levelQ8);
+}
+
+int32_t levelFilterRateMmPerH(const LevelFilter& f)
+{
+    return roundQ8(f.rateQ8);
+}
+
+bool levelFilterSettled(const LevelFilter& f)
+{
+    return f.valid && f.samples >= LEVEL_FILTER_SETTLE_SAMPLES;
+}
@@ -0,0 +1,48 @@
+// Deutsche Dokumentation
+// Implementierung der LoRa-Sendedauer
+
+#include "lora_airtime.h"
+
+LoRaModulation loraModulationDefault(uint8_t sf)
+{
+    LoRaModulation m;
+    m.sf = sf;
+    m.bwHz = 125000;
+    m.cr = 5;
+    m.preamble = 8;
+    m.crc = false;
+    m.explicitHeader = true;
+    return m;
+}
+
+uint32_t loraTimeOnAirUs(const LoRaModulation& m, size_t payloadLen)
+{
+    if (m.sf < 6 || m.sf > 12 || m.bwHz == 0 || m.cr < 5 || m.cr > 8) return 0;
+    const uint64_t symNs = ((uint64_t)1000000000ULL << m.sf) / m.bwHz; // Symboldauer in ns
+    const int de = (symNs >= 16000000ULL) ? 1 : 0;
+    const int ih = m.explicitHeader ? 0 : 1;
+    const int crc = m.crc ? 1 : 0;
+
+    // Payload-Symbole: 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * CR, 0)
+    const int num = 8 * (int)payloadLen - 4 * m.sf + 28 + 16 * crc - 20 * ih;
+    const int den = 4 * (m.sf - 2 * de);
+    int blocks = (num > 0) ? (num + den - 1) / den : 0;
+    const uint32_t payloadSym = 8 + (uint32_t)blocks * m.cr;
+
+    // Präambel: npreamble + 4,25 Symbole -> alles in Viertelsymbolen rechnen
+    const uint64_t quarterSyms = (uint64_t)m.preamble * 4 + 17 + (uint64_t)payloadSym * 4;
+    return (uint32_t)((quarterSyms * symNs / 4 + 500) / 1000);
+}
+
+float loraRequiredSnrDb(uint8_t sf)
+{
+    switch (sf) {
+    case 6: return -5.0f;
+    case 7: return -7.5f;
+    case 8: return -10.0f;
+    case 9: return -12.5f;
+    case 10: return -15.0f;
+    case 11: return -17.5f;
+    default: return -20.0f;
+    }
+}
@@ -0,0 +1,71 @@
+// Deutsche Dokumentation
+// Implementierung des LoRa-Frame-Codecs
+
+#include "lora_frame.h"
+#include <cstring>
+
+// Blockgröße der Verschränkung: ein AES-Block, danach MAC über denselben Block
+static const size_t CHUNK = 16;
+
+size_t loraFrameSeal(CryptoSession& session, uint8_t sensorId, const uint8_t nonce[LORA_FRAME_NONCE_LEN],
+                     uint8_t* frame, size_t frameCap, size_t ptLen)
+{
+    const size_t frameLen = ptLen + LORA_FRAME_OVERHEAD;
+    if (ptLen == 0 || frameLen > frameCap || frameLen > LORA_FRAME_MAX_LEN) return 0;
+
+    frame[0] = sensorId;
+    memcpy(frame + 1, nonce, LORA_FRAME_NONCE_LEN);
+    if (!session.ctrBegin(nonce, sensorId) || !session.macBegin() ||
+        !session.macUpdate(frame, LORA_FRAME_HDR_LEN)) return 0;
+
+    uint8_t* p = loraFramePayload(frame);
+    for (size_t off = 0; off < ptLen; off += CHUNK) {
+        size_t n = (ptLen - off < CHUNK) ? (ptLen - off) : CHUNK;
+        if (!session.ctrUpdate(p + off, n) || !session.macUpdate(p + off, n)) return 0;
+    }
+    if (!session.macFinish(p + ptLen, LORA_FRAME_MAC_LEN)) return 0;
+    return frameLen;
+}
+
+size_t loraFrameEncode(CryptoSession& session, uint8_t sensorId, const uint8_t nonce[LORA_FRAME_NONCE_LEN],
+                       const uint8_t* pt, size_t ptLen, uint8_t* frame, size_t frameCap)
+{
+    if (ptLen + LORA_FRAME_OVERHEAD > frameCap) return 0;
+    memmove(loraFramePayload(frame), pt, ptLen);
+    return loraFrameSeal(session, sensorId, nonce, frame, frameCap, ptLen);
+}
+
+bool loraFrameSensorId(const uint8_t* frame, size_t len, uint8_t* sensorId)
+{
+    if (len <= LORA_FRAME_OVERHEAD) return false;
+    *sensorId = frame[0];
+    return true;
+}
+
+bool loraFrameOpen(CryptoSession& session, uint8_t* frame, size_t len,
+                   const uint8_t** pt, size_t* ptLen)
+{
+    if (len <= LORA_FRAME_OVERHEAD || len > LORA_FRAME_MAX_LEN) return false;
+    const size_t ctLen = len - LORA_FRAME_OVERHEAD;
+    uint8_t* p = loraFramePayload(frame);
+
+    if (!session.ctrBegin(loraFrameNonce(frame), frame[0]) || !session.macBegin() ||
+        !session.macUpdate(frame, LORA_FRAME_HDR_LEN)) return false;
+    // Pro Block erst MAC über den Ciphertext, dann entschlüsseln
+    for (size_t off = 0; off < ctLen; off += CHUNK) {
+        size_t n = (ctLen - off < CHUNK) ? (ctLen - off) : CHUNK;
+        if (!session.macUpdate(p + off, n) || !session.ctrUpdate(p + off, n)) {
+            memset(p, 0, ctLen);
+            return false;
+        }
+    }
+    uint8_t calc[LORA_FRAME_MAC_LEN];
+    if (!session.macFinish(calc, sizeof(calc)) ||
+        !constTimeEqual(calc, p + ctLen, LORA_FRAME_MAC_LEN)) {
+        memset(p, 0, ctLen); // ungeprüften Klartext nicht liegen lassen
+        return false;
+    }
+    *pt = p;
+    *ptLen = ctLen;
+    return true;
+}
@@ -0,0 +1,192 @@
+// Deutsche Dokumentation
+// Implementierung der Payload-Auswertung
+
+#include "payload.h"
+#include <cstring>
+#include "byte_io.h"
+
+static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+static void trim(const char*& s, size_t& len)
+{
+    while (len && isSpace(*s)) { ++s; --len; }
+    while (len && isSpace(s[len - 1])) --len;
+}
+
+// Sucht key in s[0..len) und liefert den Wert bis ';' bzw. Ende
+static bool findField(const char* s, size_t len, const char* key, const char** val, size_t* valLen)
+{
+    const size_t keyLen = strlen(key);
+    for (size_t i = 0; i + keyLen <= len; ++i) {
+        if (memcmp(s + i, key, keyLen) != 0) continue;
+        const char* v = s + i + keyLen;
+        const char* end = (const char*)memchr(v, ';', len - i - keyLen);
+        size_t n = end ? (size_t)(end - v) : (len - i - keyLen);
+        trim(v, n);
+        *val = v; *valLen = n;
+        return true;
+    }
+    return false;
+}
+
+bool parseDecimalCmToMm(const char* s, size_t len, int32_t* mm)
+{
+    if (len == 0) return false;
+    bool neg = false;
+    size_t i = 0;
+    if (s[0] == '+' || s[0] == '-') { neg = (s[0] == '-'); i = 1; }
+    int64_t intPart = 0;   // ganze cm
+    int32_t frac = 0;      // Nachkommastellen (skaliert auf 1/100 cm)
+    int fracDigits = 0;
+    bool dotSeen = false, digitSeen = false;
+    for (; i < len; ++i) {
+        char c = s[i];
+        if (c == '.') { if (dotSeen) return false; dotSeen = true; continue; }
+        if (c < '0' || c > '9') return false;
+        digitSeen = true;
+        if (!dotSeen) {
+            intPart = intPart * 10 + (c - '0');
+            if (intPart > 100000000) return false;
+        } else if (fracDigits < 2) {
+            frac = frac * 10 + (c - '0');
+            ++fracDigits;
+        }
+    }
+    if (!digitSeen) return false;
+    while (fracDigits < 2) { frac *= 10; ++fracDigits; }
+    // 1/100 cm -> mm (kaufmännisch gerundet)
+    int64_t v = (intPart * 100 + frac + 5) / 10;
+    *mm = (int32_t)(neg ? -v : v);
+    return true;
+}
+
+static bool parseAscii(const char* s, size_t len, PayloadReading* out)
+{
+    trim(s, len);
+
+    const char* val; size_t valLen;
+    if (findField(s, len, "WATER_CM:", &val, &valLen)) {
+        out->valid = parseDecimalCmToMm(val, valLen, &out->depthMm);
+        const char* st; size_t stLen;
+        if (findField(s, len, "STATUS:", &st, &stLen)) {
+            if (stLen >= sizeof(out->status)) stLen = sizeof(out->status) - 1;
+            memcpy(out->status, st, stLen);
+            out->status[stLen] = 0;
+        }
+        return out->valid;
+    }
+
+    // reine Zahl, evtl. "cm" Suffix
+    if (len >= 2 && s[len - 2] == 'c' && s[len - 1] == 'm') {
+        len -= 2;
+        trim(s, len);
+    }
+    out->valid = parseDecimalCmToMm(s, len, &out->depthMm);
+    return out->valid;
+}
+
+static bool parseV2(const uint8_t* data, size_t len, PayloadReading* out)
+{
+    ByteReader r(data, len);
+    out->version = r.u8();
+    out->flags = r.u8();
+    out->seq = r.u16();
+    out->depthMm = r.i16();
+    if (!r.ok()) return false;
+    out->ext = data + r.position();
+    out->extLen = r.remaining();
+    // TLV-Bereich muss vollständig sein, sonst gilt die Payload als beschädigt
+    size_t pos = 0; PayloadTlv tlv;
+    while (payloadNextTlv(out->ext, out->extLen, &pos, &tlv)) {}
+    if (pos != out->extLen) return false;
+    strcpy(out->status, (out->flags & PAYLOAD_FLAG_ERR) ? "ERR" : "OK");
+    out->valid = true;
+    return true;
+}
+
+bool parsePayload(const uint8_t* data, size_t len, PayloadReading* out)
+{
+    memset(out, 0, sizeof(*out));
+    if (len == 0) return false;
+    if (data[0] == PAYLOAD_VERSION_V2) return parseV2(data, len, out);
+    if (data[0] < 0x20) return false; // unbekannte Binärversion
+    return parseAscii((const char*)data, len, out);
+}
+
+bool payloadNextTlv(const uint8_t* ext, size_t extLen, size_t* pos, PayloadTlv* tlv)
+{
+    if (*pos >= extLen) return false;
+    ByteReader r(ext + *pos, extLen - *pos);
+    tlv->type = r.u8();
+    tlv->len = r.u8();
+    tlv->value = r.bytes(tlv->len);
+    if (!r.ok()) return false;
+    *pos += r.position();
+    return true;
+}
+
+size_t payloadEncodeV2(uint8_t* buf, size_t cap, uint8_t flags, uint16_t seq, int16_t depthMm)
+{
+    ByteWriter w(buf, cap);
+    w.u8(PAYLOAD_VERSION_V2);
+    w.u8(flags);
+    w.u16(seq);
+    w.i16(depthMm);
+    return w.ok() ? w.length() : 0;
+}
+
+size_t payloadAppendTlv(uint8_t* buf, size_t cap, size_t len, uint8_t type, const uint8_t* value, uint8_t valueLen)
+{
+    if (len > cap) return 0;
+    ByteWriter w(buf + len, cap - len);
+    w.u8(type);
+    w.u8(valueLen);
+    w.bytes(value, valueLen);
+    return w.ok() ? len + w.length() : 0;
+}
+
+size_t payloadAppendBatch(uint8_t* buf, size_t cap, size_t len, int32_t headDepthMm,
+                          const BatchSample* older, size_t count)
+{
+    if (count == 0 || count > PAYLOAD_BATCH_MAX || len + 2 > cap) return 0;
+    // Wert direkt hinter den TLV-Kopf schreiben, Länge danach eintragen
+    const size_t maxValue = (cap - len - 2 < 255) ? cap - len - 2 : 255;
+    ByteWriter w(buf + len + 2, maxValue);
+    int32_t prevDepth = headDepthMm;
+    uint32_t prevAge = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (older[i].ageSec < prevAge) return 0; // muss neueste zuerst sortiert sein
+        w.varint(older[i].ageSec - prevAge);
+        w.svarint(older[i].depthMm - prevDepth);
+        prevAge = older[i].ageSec;
+        prevDepth = older[i].depthMm;
+    }
+    if (!w.ok()) return 0;
+    buf[len] = PAYLOAD_TLV_BATCH;
+    buf[len + 1] = (uint8_t)w.length();
+    return len + 2 + w.length();
+}
+
+void payloadBatchBegin(BatchCursor* c, const PayloadTlv& tlv, int32_t headDepthMm)
+{
+    c->data = tlv.value;
+    c->len = tlv.len;
+    c->pos = 0;
+    c->depthMm = headDepthMm;
+    c->ageSec = 0;
+}
+
+bool payloadBatchNext(BatchCursor* c, BatchSample* out)
+{
+    if (c->pos >= c->len) return false;
+    ByteReader r(c->data + c->pos, c->len - c->pos);
+    uint32_t dAge = r.varint();
+    int32_t dDepth = r.svarint();
+    if (!r.ok()) { c->pos = c->len; return false; }
+    c->pos += r.position();
+    c->ageSec += dAge;
+    c->depthMm += dDepth;
+    out->ageSec = c->ageSec;
+    out->depthMm = c->depthMm;
+    return true;
+}
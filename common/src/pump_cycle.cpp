@@ -0,0 +1,197 @@
+// Deutsche Dokumentation
+// Pumpzyklen aus dem Pegelverlauf: Implementierung
+
+#include "pump_cycle.h"
+#include <cstring>
+
+// Kürzere Füllphasen ergeben keinen belastbaren Zulauf
+static const uint32_t PUMP_MIN_FILL_S = 60;
+
+static const uint32_t SEC_PER_HOUR = 3600;
+
+// Steigt der Pegel über dem Einschaltpegel mit mindestens diesem Anteil (%) des Anstiegs
+// davor, senkt die Pumpe nichts ab: sie springt nicht an (sonst läuft sie, überlastet)
+static const int32_t PUMP_FAIL_RATE_PCT = 75;
+
+// Gleitendes Mittel mit Gewicht 1/4, der erste Wert setzt es
+static int32_t smooth(int32_t avg, int32_t x, uint32_t n)
+{
+    return n <= 1 ? x : avg + (x - avg) / 4;
+}
+
+static int32_t ratePerHour(int32_t deltaMm, uint32_t dtS)
+{
+    return (int32_t)((int64_t)deltaMm * SEC_PER_HOUR / (int64_t)dtS);
+}
+
+// Höchste Pumpe, deren Einschaltpegel der Hochpunkt (fast) erreicht hat, sonst die unterste
+static uint8_t pumpForPeak(const PumpCycleConfig& c, int32_t peakMm)
+{
+    uint8_t p = 0;
+    for (uint8_t i = 1; i < c.pumpCount; ++i)
+        if (c.pumps[i].startMm <= peakMm + c.failMarginMm) p = i;
+    return p;
+}
+
+static void beginFill(PumpCycleState* s, uint32_t t, int32_t mm, bool valid)
+{
+    s->phase = PUMP_PHASE_FILLING;
+    s->fillValid = valid;
+    s->fillT = s->extT = t;
+    s->fillMm = s->extMm = mm;
+    s->crossed = 0;
+}
+
+void pumpCycleReset(PumpCycleState* s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+static PumpEvent pumpStarted(const PumpCycleConfig& c, PumpCycleState* s, uint32_t t, int32_t mm)
+{
+    const uint8_t p = pumpForPeak(c, s->extMm);
+    PumpStats& ps = s->pump[p];
+    // Zulauf der Füllphase (Tiefpunkt bis Hochpunkt)
+    if (s->fillValid && s->extT - s->fillT >= PUMP_MIN_FILL_S) {
+        s->lastInflowMmPerH = ratePerHour(s->extMm - s->fillMm, s->extT - s->fillT);
+        if (s->fills < 0xFFFF) s->fills++;
+        s->inflowMmPerH = smooth(s->inflowMmPerH, s->lastInflowMmPerH, s->fills);
+    }
+    if (ps.startValid && s->extT > ps.lastStartT) {
+        ps.lastPeriodS = s->extT - ps.lastStartT;
+        if (ps.periodCount < 0xFFFF) ps.periodCount++;
+        ps.periodS = (uint32_t)smooth((int32_t)ps.periodS, (int32_t)ps.lastPeriodS, ps.periodCount);
+    }
+    ps.startValid = true;
+    ps.failed = false;
+    ps.lastStartT = s->extT;
+    ps.lastStartMm = s->extMm;
+
+    s->phase = PUMP_PHASE_DRAINING;
+    s->drainPump = p;
+    s->drainT = s->extT;
+    s->drainMm = s->extMm;
+    s->extT = t;
+    s->extMm = mm;
+    return { PUMP_EVENT_STARTED, p };
+}
+
+static PumpEvent pumpStopped(PumpCycleState* s, uint32_t t, int32_t mm)
+{
+    PumpStats& ps = s->pump[s->drainPump];
+    ps.cycles++;
+    ps.lastRunS = s->extT - s->drainT;
+    ps.lastStopMm = s->extMm;
+    ps.runS = (uint32_t)smooth((int32_t)ps.runS, (int32_t)ps.lastRunS, ps.cycles);
+    if (ps.lastRunS)
+        ps.drainMmPerH = smooth(ps.drainMmPerH, ratePerHour(s->drainMm - s->extMm, ps.lastRunS), ps.cycles);
+    const PumpEvent ev = { PUMP_EVENT_STOPPED, s->drainPump };
+    // Der Tiefpunkt beginnt die neue Füllphase, der aktuelle Wert ist ihr erster Hochpunkt
+    beginFill(s, s->extT, s->extMm, true);
+    s->extT = t;
+    s->extMm = mm;
+    return ev;
+}
+
+// Pumpe unter dem Ausschaltpegel aller höheren Pumpen: sie läuft
+static PumpEvent checkRecovered(const PumpCycleConfig& c, PumpCycleState* s, int32_t mm)
+{
+    for (uint8_t i = 0; i + 1 < c.pumpCount; ++i) {
+        if (!s->pump[i].failed) continue;
+        int32_t below = c.pumps[i + 1].stopMm;
+        for (uint8_t j = i + 2; j < c.pumpCount; ++j)
+            if (c.pumps[j].stopMm < below) below = c.pumps[j].stopMm;
+        if (mm < below - c.failMarginMm) {
+            s->pump[i].failed = false;
+            return { PUMP_EVENT_RECOVERED, i };
+        }
+    }
+    return { PUMP_EVENT_NONE, 0 };
+}
+
+// Anstieg unterhalb des Einschaltpegels von Pumpe i in dieser Füllphase: ab dem zuletzt
+// überschrittenen Einschaltpegel einer unteren Pumpe (bzw. Beginn der Füllphase) bis dorthin.
+// Zu kurz: gemessener Zulauf; noch keiner: 0 (jeder Anstieg gilt als ungebremst).
+static int32_t rateBelow(const PumpCycleState* s, uint8_t i)
+{
+    uint32_t t0 = s->fillT;
+    int32_t mm0 = s->fillMm;
+    for (uint8_t j = 0; j < i; ++j)
+        if (s->crossed & (1u << j)) { t0 = s->crossT[j]; mm0 = s->crossMm[j]; }
+    if (s->crossT[i] - t0 >= PUMP_MIN_FILL_S) return ratePerHour(s->crossMm[i] - mm0, s->crossT[i] - t0);
+    return s->fills ? s->inflowMmPerH : 0;
+}
+
+static PumpEvent checkFailed(const PumpCycleConfig& c, PumpCycleState* s, uint32_t t, int32_t mm)
+{
+    for (uint8_t i = 0; i < c.pumpCount; ++i) {
+        PumpStats& ps = s->pump[i];
+        // Füllphase begann schon darüber: kein Urteil über diese Pumpe
+        if (ps.failed || s->fillMm >= c.pumps[i].startMm || mm < c.pumps[i].startMm) continue;
+        if (!(s->crossed & (1u << i))) {
+            s->crossed |= (uint8_t)(1u << i);
+            s->crossT[i] = t;
+            s->crossMm[i] = mm;
+        }
+        if (mm < c.pumps[i].startMm + c.failMarginMm || t <= s->crossT[i]) continue;
+        const int32_t above = ratePerHour(mm - s->crossMm[i], t - s->crossT[i]);
+        if ((int64_t)above * 100 < (int64_t)rateBelow(s, i) * PUMP_FAIL_RATE_PCT) continue; // läuft, überlastet
+        ps.failed = true;
+        if (ps.failures < 0xFFFF) ps.failures++;
+        return { PUMP_EVENT_FAILED, i };
+    }
+    return { PUMP_EVENT_NONE, 0 };
+}
+
+PumpEvent pumpCycleUpdate(const PumpCycleConfig& c, PumpCycleState* s, uint32_t tSec, int32_t levelMm)
+{
+    const PumpEvent none = { PUMP_EVENT_NONE, 0 };
+    if (s->phase != PUMP_PHASE_UNKNOWN && tSec < s->lastT) return none;
+    if (s->phase == PUMP_PHASE_UNKNOWN || (c.maxGapS && tSec - s->lastT > c.maxGapS)) {
+        // Erster Wert oder nach einer Pause: Füllphase ohne Tiefpunkt, Zyklusdauer neu ansetzen
+        for (uint8_t i = 0; i < PUMP_CYCLE_MAX_PUMPS; ++i) s->pump[i].startValid = false;
+        beginFill(s, tSec, levelMm, false);
+        s->lastT = tSec;
+        return none;
+    }
+    s->lastT = tSec;
+
+    if (s->phase == PUMP_PHASE_FILLING) {
+        if (levelMm >= s->extMm) {
+            s->extT = tSec;
+            s->extMm = levelMm;
+            return checkFailed(c, s, tSec, levelMm);
+        }
+        if (s->extMm - levelMm >= c.swingMm) return pumpStarted(c, s, tSec, levelMm);
+        return none;
+    }
+
+    // Abpumpen
+    if (levelMm <= s->extMm) {
+        s->extT = tSec;
+        s->extMm = levelMm;
+        return checkRecovered(c, s, levelMm);
+    }
+    if (levelMm - s->extMm >= c.swingMm) return pumpStopped(s, tSec, levelMm);
+    return none;
+}
+
+const char* pumpPhaseName(uint8_t phase)
+{
+    switch (phase) {
+    case PUMP_PHASE_FILLING: return "filling";
+    case PUMP_PHASE_DRAINING: return "draining";
+    default: return "unknown";
+    }
+}
+
+const char* pumpEventName(uint8_t kind)
+{
+    switch (kind) {
+    case PUMP_EVENT_STARTED: return "started";
+    case PUMP_EVENT_STOPPED: return "stopped";
+    case PUMP_EVENT_FAILED: return "failed";
+    case PUMP_EVENT_RECOVERED: return "recovered";
+    default: return "none";
+    }
+}
@@ -0,0 +1,71 @@
+// Deutsche Dokumentation
+// Implementierung des adaptiven Sende-Zeitplans
+
+#include "report_policy.h"
+#include <cstring>
+
+void reportStateReset(ReportState* st)
+{
+    memset(st, 0, sizeof(*st));
+}
+
+static int32_t absMm(int32_t v) { return v < 0 ? -v : v; }
+
+// Entscheidung mit der aktuellen Anstiegsrate in st->rateMmPerMin
+static ReportReason decide(const ReportPolicy& p, ReportState* st, int32_t depthMm, uint32_t nowMs)
+{
+    // Hochwasser-Modus mit Hysterese: Eintritt an den Schwellen, Austritt erst
+    // deutlich darunter, damit der Modus an der Grenze nicht flattert
+    const bool floodNow = depthMm >= p.floodLevelMm || st->rateMmPerMin >= p.floodRateMmPerMin;
+    const bool calmNow = depthMm < p.floodLevelMm - p.deadbandMm && st->rateMmPerMin < p.floodRateMmPerMin / 2;
+    if (floodNow) st->fast = true;
+    else if (calmNow) st->fast = false;
+
+    if (!st->sent) return REPORT_FIRST;
+    const uint32_t since = nowMs - st->lastSentMs;
+    if (st->fast && since >= p.fastIntervalMs) return REPORT_FLOOD;
+    if (absMm(depthMm - st->lastSentMm) > p.deadbandMm) return REPORT_DELTA;
+    if (since >= p.heartbeatMs) return REPORT_HEARTBEAT;
+    return REPORT_NONE;
+}
+
+ReportReason reportDecide(const ReportPolicy& p, ReportState* st, int32_t depthMm, uint32_t nowMs)
+{
+    // Anstiegsrate gegen den ältesten gepufferten Messwert
+    const uint8_t oldest = (st->histCount < REPORT_RATE_SAMPLES) ? 0 : st->histHead;
+    if (st->histCount + 1 >= REPORT_RATE_MIN_SAMPLES && nowMs != st->histMs[oldest]) {
+        st->rateMmPerMin = (int32_t)((int64_t)(depthMm - st->histMm[oldest]) * 60000
+                                     / (int64_t)(uint32_t)(nowMs - st->histMs[oldest]));
+    }
+    st->histMm[st->histHead] = depthMm;
+    st->histMs[st->histHead] = nowMs;
+    st->histHead = (uint8_t)((st->histHead + 1) % REPORT_RATE_SAMPLES);
+    if (st->histCount < REPORT_RATE_SAMPLES) ++st->histCount;
+    return decide(p, st, depthMm, nowMs);
+}
+
+ReportReason reportDecideWithRate(const ReportPolicy& p, ReportState* st, int32_t depthMm,
+                                  int32_t rateMmPerMin, uint32_t nowMs)
+{
+    st->rateMmPerMin = rateMmPerMin;
+    return decide(p, st, depthMm, nowMs);
+}
+
+void reportSent(ReportState* st, int32_t depthMm, uint32_t nowMs)
+{
+    st->sent = true;
+    st->lastSentMm = depthMm;
+    st->lastSentMs = nowMs;
+}
+
+const char* reportReasonName(ReportReason r)
+{
+    switch (r) {
+    case REPORT_FIRST: return "first";
+    case REPORT_FLOOD: return "flood";
+    case REPORT_DELTA: return "delta";
+    case REPORT_HEARTBEAT: return "heartbeat";
+    case REPORT_ACK: return "ack";
+    default: return "none";
+    }
+}
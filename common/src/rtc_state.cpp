@@ -0,0 +1,202 @@
+// Deutsche Dokumentation
+// RTC-Zustand des Sensors: Serialisierung
+
+#include "rtc_state.h"
+#include <cstring>
+#include "byte_io.h"
+#include "crc32.h"
+
+static const size_t HEADER_LEN = 7; // Magic, Version, Länge
+static const size_t CRC_LEN = 4;
+
+static void writeRadio(ByteWriter& w, const RadioSettings& r)
+{
+    w.u8(r.sf);
+    w.u8((uint8_t)r.txPowerDbm);
+}
+
+static RadioSettings readRadio(ByteReader& r)
+{
+    RadioSettings s;
+    s.sf = r.u8();
+    s.txPowerDbm = (int8_t)r.u8();
+    return s;
+}
+
+static void writeBody(ByteWriter& w, const SensorRtcState& st)
+{
+    w.u32(st.bootCount);
+    w.u32(st.lastMeasureMs);
+    w.u16(st.seq);
+    w.u16(st.bootToTxMs);
+
+    w.u64(st.frameCounter);
+    w.u64(st.counterReserved);
+    w.u64(st.downWindow.top);
+    w.u64(st.downWindow.bitmap);
+
+    w.u8(st.sampleCount);
+    for (uint8_t i = 0; i < st.sampleCount; ++i) {
+        w.i16(st.samples[i].depthMm);
+        w.u8(st.samples[i].ok ? 1 : 0);
+        w.u32(st.samples[i].ms);
+    }
+
+    const ReportState& rp = st.report;
+    w.u8((rp.sent ? 1 : 0) | (rp.fast ? 2 : 0));
+    w.u32((uint32_t)rp.lastSentMm);
+    w.u32(rp.lastSentMs);
+    w.u8(rp.histCount);
+    w.u8(rp.histHead);
+    for (uint8_t i = 0; i < REPORT_RATE_SAMPLES; ++i) {
+        w.u32((uint32_t)rp.histMm[i]);
+        w.u32(rp.histMs[i]);
+    }
+    w.u32((uint32_t)rp.rateMmPerMin);
+
+    const LevelFilter& f = st.filter;
+    w.u8(f.valid ? 1 : 0);
+    w.u8(f.samples);
+    w.u8(f.rejects);
+    w.u16(f.rejectedTotal);
+    w.u32((uint32_t)f.levelQ8);
+    w.u32((uint32_t)f.rateQ8);
+    w.u32(f.varQ4);
+    w.u32(f.lastMs);
+
+    const DutyCycle& d = st.duty;
+    w.u32(d.budgetUs);
+    w.u32(d.slotMs);
+    w.u32(d.slotStartMs);
+    w.u8(d.head);
+    w.u8(d.started ? 1 : 0);
+    w.u32(d.deferred);
+    for (uint8_t i = 0; i < DUTY_CYCLE_SLOTS; ++i) w.u32(d.slotUs[i]);
+
+    writeRadio(w, st.radioCurrent);
+    writeRadio(w, st.radioPrevious);
+    writeRadio(w, st.radioStaged);
+    w.u8((st.radioHaveStaged ? 1 : 0) | (st.radioStagedArmed ? 2 : 0) |
+         (st.radioProbation ? 4 : 0) | (st.radioReportDue ? 8 : 0));
+    w.u8(st.radioProbationUplinks);
+
+    w.u8(st.ackCount);
+    for (uint8_t i = 0; i < st.ackCount; ++i) {
+        w.u16(st.acks[i].id);
+        w.u8(st.acks[i].status);
+    }
+    w.u8(st.haveLastCommand ? 1 : 0);
+    w.u16(st.lastCommandId);
+    w.u8(st.lastCommandStatus);
+}
+
+size_t rtcStateSerialize(const SensorRtcState& st, uint8_t* buf, size_t cap)
+{
+    if (st.sampleCount > RTC_STATE_MAX_SAMPLES || st.ackCount > RTC_STATE_MAX_ACKS) return 0;
+    if (cap < HEADER_LEN + CRC_LEN) return 0;
+
+    ByteWriter body(buf + HEADER_LEN, cap - HEADER_LEN - CRC_LEN);
+    writeBody(body, st);
+    if (!body.ok() || body.length() > 0xFFFF) return 0;
+
+    ByteWriter head(buf, HEADER_LEN);
+    head.u32(RTC_STATE_MAGIC);
+    head.u8(RTC_STATE_VERSION);
+    head.u16((uint16_t)body.length());
+
+    const size_t len = HEADER_LEN + body.length();
+    ByteWriter tail(buf + len, CRC_LEN);
+    tail.u32(crc32(buf, len));
+    return len + CRC_LEN;
+}
+
+bool rtcStateDeserialize(const uint8_t* buf, size_t len, SensorRtcState* out)
+{
+    ByteReader head(buf, len);
+    if (head.u32() != RTC_STATE_MAGIC || head.u8() != RTC_STATE_VERSION) return false;
+    const size_t bodyLen = head.u16();
+    if (!head.ok() || bodyLen > head.remaining() || head.remaining() - bodyLen < CRC_LEN) return false;
+    ByteReader tail(buf + HEADER_LEN + bodyLen, CRC_LEN);
+    if (tail.u32() != crc32(buf, HEADER_LEN + bodyLen)) return false;
+
+    memset(out, 0, sizeof(*out));
+    ByteReader r(buf + HEADER_LEN, bodyLen);
+    out->bootCount = r.u32();
+    out->lastMeasureMs = r.u32();
+    out->seq = r.u16();
+    out->bootToTxMs = r.u16();
+
+    out->frameCounter = r.u64();
+    out->counterReserved = r.u64();
+    out->downWindow.top = r.u64();
+    out->downWindow.bitmap = r.u64();
+
+    out->sampleCount = r.u8();
+    if (out->sampleCount > RTC_STATE_MAX_SAMPLES) return false;
+    for (uint8_t i = 0; i < out->sampleCount; ++i) {
+        out->samples[i].depthMm = r.i16();
+        out->samples[i].ok = r.u8() != 0;
+        out->samples[i].ms = r.u32();
+    }
+
+    ReportState& rp = out->report;
+    const uint8_t reportFlags = r.u8();
+    rp.sent = reportFlags & 1;
+    rp.fast = reportFlags & 2;
+    rp.lastSentMm = (int32_t)r.u32();
+    rp.lastSentMs = r.u32();
+    rp.histCount = r.u8();
+    rp.histHead = r.u8();
+    if (rp.histCount > REPORT_RATE_SAMPLES || rp.histHead >= REPORT_RATE_SAMPLES) return false;
+    for (uint8_t i = 0; i < REPORT_RATE_SAMPLES; ++i) {
+        rp.histMm[i] = (int32_t)r.u32();
+        rp.histMs[i] = r.u32();
+    }
+    rp.rateMmPerMin = (int32_t)r.u32();
+
+    LevelFilter& f = out->filter;
+    f.valid = r.u8() != 0;
+    f.samples = r.u8();
+    f.rejects = r.u8();
+    f.rejectedTotal = r.u16();
+    f.levelQ8 = (int32_t)r.u32();
+    f.rateQ8 = (int32_t)r.u32();
+    f.varQ4 = r.u32();
+    f.lastMs = r.u32();
+
+    DutyCycle& d = out->duty;
+    d.budgetUs = r.u32();
+    d.slotMs = r.u32();
+    d.slotStartMs = r.u32();
+    d.head = r.u8();
+    d.started = r.u8() != 0;
+    d.deferred = r.u32();
+    if (d.head >= DUTY_CYCLE_SLOTS) return false;
+    d.usedUs = 0;
+    for (uint8_t i = 0; i < DUTY_CYCLE_SLOTS; ++i) {
+        d.slotUs[i] = r.u32();
+        d.usedUs += d.slotUs[i];
+    }
+
+    out->radioCurrent = readRadio(r);
+    out->radioPrevious = readRadio(r);
+    out->radioStaged = readRadio(r);
+    const uint8_t radioFlags = r.u8();
+    out->radioHaveStaged = radioFlags & 1;
+    out->radioStagedArmed = radioFlags & 2;
+    out->radioProbation = radioFlags & 4;
+    out->radioReportDue = radioFlags & 8;
+    out->radioProbationUplinks = r.u8();
+
+    out->ackCount = r.u8();
+    if (out->ackCount > RTC_STATE_MAX_ACKS) return false;
+    for (uint8_t i = 0; i < out->ackCount; ++i) {
+        out->acks[i].id = r.u16();
+        out->acks[i].status = r.u8();
+    }
+    out->haveLastCommand = r.u8() != 0;
+    out->lastCommandId = r.u16();
+    out->lastCommandStatus = r.u8();
+
+    return r.ok() && r.atEnd();
+}
@@ -0,0 +1,73 @@
+// Deutsche Dokumentation
+// Zustand eines Sensors im Gateway: Implementierung
+
+#include "sensor_record.h"
+#include <cstring>
+
+void sensorRecordReset(SensorRecord* r)
+{
+    memset(r, 0, sizeof(*r));
+}
+
+uint16_t sensorRecordUplink(SensorRecord* r, uint32_t ms, int16_t rssi, float snr,
+                            bool hasSeq, uint16_t seq)
+{
+    r->lastRxMs = ms;
+    r->rssi = rssi;
+    r->snrX4 = (int16_t)(snr * 4.0f + (snr < 0 ? -0.5f : 0.5f));
+    ++r->received;
+
+    uint16_t gap = 0;
+    if (hasSeq) {
+        if (r->seqValid) {
+            const uint16_t delta = (uint16_t)(seq - r->seq);
+            if (delta == 0 || delta > SENSOR_SEQ_MAX_GAP) ++r->restarts;
+            else gap = (uint16_t)(delta - 1);
+        }
+        r->seq = seq;
+        r->seqValid = true;
+        r->lost += gap;
+    }
+    return gap;
+}
+
+void sensorRecordSample(SensorRecord* r, int32_t depthMm, bool ok, uint32_t ms)
+{
+    const uint8_t n = r->histCount < SENSOR_HISTORY_LEN ? r->histCount : SENSOR_HISTORY_LEN - 1;
+    memmove(&r->hist[1], &r->hist[0], n * sizeof(r->hist[0]));
+    r->hist[0] = { depthMm, ms, ok };
+    if (r->histCount < SENSOR_HISTORY_LEN) ++r->histCount;
+    r->ok = ok;
+}
+
+const SensorSample* sensorRecordLatest(const SensorRecord* r)
+{
+    return r->histCount ? &r->hist[0] : nullptr;
+}
+
+uint16_t sensorRecordLossPermille(const SensorRecord* r)
+{
+    const uint64_t expected = (uint64_t)r->received + r->lost;
+    return expected ? (uint16_t)((uint64_t)r->lost * 1000 / expected) : 0;
+}
+
+SensorHealth sensorRecordHealth(const SensorRecord* r, uint32_t nowMs, uint32_t staleMs,
+                                uint16_t lossPermille)
+{
+    if (!r->received) return SENSOR_UNKNOWN;
+    if (nowMs - r->lastRxMs >= staleMs) return SENSOR_STALE;
+    if (!r->ok) return SENSOR_ERROR;
+    if (lossPermille && sensorRecordLossPermille(r) >= lossPermille) return SENSOR_LOSSY;
+    return SENSOR_OK;
+}
+
+const char* sensorHealthName(SensorHealth h)
+{
+    switch (h) {
+    case SENSOR_OK: return "ok";
+    case SENSOR_ERROR: return "error";
+    case SENSOR_LOSSY: return "lossy";
+    case SENSOR_STALE: return "stale";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,296 @@
+// Deutsche Dokumentation
+// Komprimierter Zeitreihen-Speicher: Implementierung
+//
+// Variable Längen (Präfix, dann Wert MSB zuerst), vorzeichenbehaftete Werte per Zigzag:
+//   '0'            Wert 0
+//   '10'   + w0    Bits
+//   '110'  + w1    Bits
+//   '1110' + w2    Bits
+//   '1111' + 33    Bits (jede Differenz zweier int32/uint32)
+
+#include "timeseries.h"
+#include <cstring>
+
+static const uint8_t TS_WIDTH_DOD[3] = { 7, 9, 12 };
+static const uint8_t TS_WIDTH_VALUE[3] = { 4, 8, 16 };
+static const uint8_t TS_WIDTH_ESCAPE = 33;
+static const uint32_t TS_BLOCK_BITS = TS_BLOCK_BYTES * 8;
+// Zeitabstand, mit dem jeder Block startet (regelmäßige Reihe kostet ab dem 2. Punkt 1 Bit)
+static const int64_t TS_START_DELTA = 1;
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t u)
+{
+    return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+}
+
+static uint32_t varBits(uint64_t u, const uint8_t w[3])
+{
+    if (!u) return 1;
+    for (uint8_t i = 0; i < 3; ++i) {
+        if (u < (1ULL << w[i])) return (uint32_t)(i + 2) + w[i];
+    }
+    return 4 + TS_WIDTH_ESCAPE;
+}
+
+static void putBits(uint8_t* buf, uint32_t* pos, uint64_t v, uint8_t n)
+{
+    while (n--) {
+        const uint32_t p = (*pos)++;
+        const uint8_t mask = (uint8_t)(0x80 >> (p & 7));
+        if ((v >> n) & 1) buf[p >> 3] |= mask;
+        else buf[p >> 3] &= (uint8_t)~mask;
+    }
+}
+
+static uint64_t getBits(const uint8_t* buf, uint32_t* pos, uint8_t n)
+{
+    uint64_t v = 0;
+    while (n--) {
+        const uint32_t p = (*pos)++;
+        v = (v << 1) | ((buf[p >> 3] >> (7 - (p & 7))) & 1);
+    }
+    return v;
+}
+
+static void putVar(uint8_t* buf, uint32_t* pos, uint64_t u, const uint8_t w[3])
+{
+    if (!u) {
+        putBits(buf, pos, 0, 1);
+        return;
+    }
+    for (uint8_t i = 0; i < 3; ++i) {
+        if (u < (1ULL << w[i])) {
+            // i+1 Einsen, dann eine Null
+            putBits(buf, pos, ((1u << (i + 2)) - 2), (uint8_t)(i + 2));
+            putBits(buf, pos, u, w[i]);
+            return;
+        }
+    }
+    putBits(buf, pos, 0xF, 4);
+    putBits(buf, pos, u, TS_WIDTH_ESCAPE);
+}
+
+static uint64_t getVar(const uint8_t* buf, uint32_t* pos, const uint8_t w[3])
+{
+    uint8_t ones = 0;
+    while (ones < 4 && getBits(buf, pos, 1)) ++ones;
+    if (!ones) return 0;
+    return getBits(buf, pos, ones < 4 ? w[ones - 1] : TS_WIDTH_ESCAPE);
+}
+
+static uint8_t* blockData(const TsSeries* s, uint16_t block)
+{
+    return s->data + (size_t)block * TS_BLOCK_BYTES;
+}
+
+static uint16_t oldestBlock(const TsSeries* s)
+{
+    return (uint16_t)((s->head + s->blockCount + 1 - s->used) % s->blockCount);
+}
+
+void tsSeriesInit(TsSeries* s, uint8_t* data, TsBlockHeader* headers, uint16_t blockCount, uint32_t resolutionS)
+{
+    memset(s, 0, sizeof(*s));
+    s->data = data;
+    s->headers = headers;
+    s->blockCount = blockCount;
+    s->resolutionS = resolutionS ? resolutionS : 1;
+}
+
+static void startBlock(TsSeries* s, uint32_t t, int32_t avg)
+{
+    if (s->used) {
+        s->head = (uint16_t)((s->head + 1) % s->blockCount);
+        if (s->used < s->blockCount) ++s->used;
+        else s->points -= s->headers[s->head].count;   // ältesten Block überschreiben
+    } else {
+        s->head = 0;
+        s->used = 1;
+    }
+    TsBlockHeader& h = s->headers[s->head];
+    h.firstT = t;
+    h.lastT = t;
+    h.firstAvg = avg;
+    h.bits = 0;
+    h.count = 0;
+    s->prevT = t;
+    s->prevDeltaT = TS_START_DELTA;
+    s->prevAvg = avg;
+}
+
+void tsSeriesAppend(TsSeries* s, const TsPoint& p)
+{
+    if (!s->blockCount) return;
+    uint32_t t = p.t / s->resolutionS;
+    if (s->used && t < s->prevT) t = s->prevT;
+    const int32_t avg = p.avg;
+    const uint64_t lo = (uint64_t)((int64_t)avg - (p.min < avg ? p.min : avg));
+    const uint64_t hi = (uint64_t)((p.max > avg ? p.max : avg) - (int64_t)avg);
+    const uint32_t spreadBits = varBits(lo, TS_WIDTH_VALUE) + varBits(hi, TS_WIDTH_VALUE);
+
+    // Passt der Punkt nicht mehr in den Block, wird er erster Punkt eines neuen Blocks
+    // (Zeit und Mittelwert stehen dann im Kopf)
+    uint64_t dod = 0, dAvg = 0;
+    if (s->used) {
+        dod = zigzag((int64_t)(t - s->prevT) - s->prevDeltaT);
+        dAvg = zigzag((int64_t)avg - s->prevAvg);
+        const uint32_t need = varBits(dod, TS_WIDTH_DOD) + varBits(dAvg, TS_WIDTH_VALUE) + spreadBits;
+        if (s->headers[s->head].bits + need > TS_BLOCK_BITS) startBlock(s, t, avg);
+    } else {
+        startBlock(s, t, avg);
+    }
+
+    TsBlockHeader& h = s->headers[s->head];
+    uint8_t* buf = blockData(s, s->head);
+    uint32_t pos = h.bits;
+    if (h.count) {
+        putVar(buf, &pos, dod, TS_WIDTH_DOD);
+        putVar(buf, &pos, dAvg, TS_WIDTH_VALUE);
+        s->prevDeltaT = (int64_t)(t - s->prevT);
+    }
+    putVar(buf, &pos, lo, TS_WIDTH_VALUE);
+    putVar(buf, &pos, hi, TS_WIDTH_VALUE);
+    h.bits = (uint16_t)pos;
+    h.lastT = t;
+    ++h.count;
+    s->prevT = t;
+    s->prevAvg = avg;
+    ++s->points;
+}
+
+uint32_t tsSeriesOldest(const TsSeries* s)
+{
+    return s->used ? s->headers[oldestBlock(s)].firstT * s->resolutionS : 0;
+}
+
+uint32_t tsSeriesNewest(const TsSeries* s)
+{
+    return s->used ? s->prevT * s->resolutionS : 0;
+}
+
+size_t tsSeriesBytesUsed(const TsSeries* s)
+{
+    size_t bytes = 0;
+    for (uint16_t i = 0, b = s->used ? oldestBlock(s) : 0; i < s->used; ++i, b = (uint16_t)((b + 1) % s->blockCount)) {
+        bytes += (s->headers[b].bits + 7) / 8;
+    }
+    return bytes;
+}
+
+static int32_t roundedMean(int64_t sum, uint32_t count)
+{
+    return (int32_t)(sum >= 0 ? (sum + count / 2) / count : -((-sum + count / 2) / count));
+}
+
+static TsPoint accumulatorPoint(const TsAccumulator& a, uint32_t resolutionS)
+{
+    return { a.bucket * resolutionS, roundedMean(a.sum, a.count), a.min, a.max };
+}
+
+void tsStoreInit(TsStore* st, uint8_t* const buffers[TS_TIER_COUNT], TsBlockHeader* const headers[TS_TIER_COUNT],
+                 const uint16_t blocks[TS_TIER_COUNT])
+{
+    memset(st->acc, 0, sizeof(st->acc));
+    for (uint8_t i = 0; i < TS_TIER_COUNT; ++i) {
+        tsSeriesInit(&st->tier[i], buffers[i], headers[i], blocks[i], TS_TIER_SECONDS[i]);
+    }
+}
+
+void tsStoreAdd(TsStore* st, uint32_t tSec, int32_t value)
+{
+    for (uint8_t i = 0; i < TS_TIER_COUNT; ++i) {
+        TsAccumulator& a = st->acc[i];
+        const uint32_t bucket = tSec / TS_TIER_SECONDS[i];
+        if (a.open && bucket > a.bucket) {
+            tsSeriesAppend(&st->tier[i], accumulatorPoint(a, TS_TIER_SECONDS[i]));
+            a.open = false;
+        }
+        if (!a.open) {
+            a = { true, bucket, 0, 0, value, value };
+        }
+        // verspätete Werte (bucket < a.bucket) zählen zum offenen Intervall
+        a.sum += value;
+        ++a.count;
+        if (value < a.min) a.min = value;
+        if (value > a.max) a.max = value;
+    }
+}
+
+void tsSeriesScan(const TsSeries* s, uint32_t fromS, uint32_t toS, TsCursor* c)
+{
+    memset(c, 0, sizeof(*c));
+    c->s = s;
+    c->from = fromS / s->resolutionS;
+    c->to = toS / s->resolutionS;
+    c->openDone = true;
+    if (!s->used) return;
+    c->block = oldestBlock(s);
+    c->blocksLeft = s->used;
+    // Blöcke vollständig vor dem Bereich über den Kopf überspringen
+    while (c->blocksLeft > 1 && s->headers[c->block].lastT < c->from) {
+        c->block = (uint16_t)((c->block + 1) % s->blockCount);
+        --c->blocksLeft;
+    }
+}
+
+void tsStoreScan(const TsStore* st, TsTier tier, uint32_t fromS, uint32_t toS, TsCursor* c)
+{
+    tsSeriesScan(&st->tier[tier], fromS, toS, c);
+    c->open = &st->acc[tier];
+    c->openDone = false;
+}
+
+static bool nextOpen(TsCursor* c, TsPoint* out)
+{
+    if (c->openDone) return false;
+    c->openDone = true;
+    if (!c->open || !c->open->open) return false;
+    if (c->open->bucket < c->from || c->open->bucket > c->to) return false;
+    *out = accumulatorPoint(*c->open, c->s->resolutionS);
+    return true;
+}
+
+bool tsCursorNext(TsCursor* c, TsPoint* out)
+{
+    const TsSeries* s = c->s;
+    while (c->blocksLeft) {
+        const TsBlockHeader& h = s->headers[c->block];
+        if (c->index >= h.count) {
+            c->block = (uint16_t)((c->block + 1) % s->blockCount);
+            --c->blocksLeft;
+            c->index = 0;
+            c->bitPos = 0;
+            continue;
+        }
+        const uint8_t* buf = blockData(s, c->block);
+        uint32_t pos = c->bitPos;
+        if (!c->index) {
+            c->t = h.firstT;
+            c->deltaT = TS_START_DELTA;
+            c->avg = h.firstAvg;
+        } else {
+            c->deltaT += unzigzag(getVar(buf, &pos, TS_WIDTH_DOD));
+            c->t += (uint32_t)c->deltaT;
+            c->avg = (int32_t)(c->avg + unzigzag(getVar(buf, &pos, TS_WIDTH_VALUE)));
+        }
+        const int64_t lo = (int64_t)getVar(buf, &pos, TS_WIDTH_VALUE);
+        const int64_t hi = (int64_t)getVar(buf, &pos, TS_WIDTH_VALUE);
+        c->bitPos = (uint16_t)pos;
+        ++c->index;
+        if (c->t > c->to) {
+            // zeitlich geordnet: danach kommt nichts mehr im Bereich
+            c->blocksLeft = 0;
+            c->openDone = true;
+            return false;
+        }
+        if (c->t < c->from) continue;
+        *out = { c->t * s->resolutionS, c->avg, (int32_t)(c->avg - lo), (int32_t)(c->avg + hi) };
+        return true;
+    }
+    return nextOpen(c, out);
+}
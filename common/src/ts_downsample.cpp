@@ -0,0 +1,99 @@
+// Deutsche Dokumentation
+// Ausdünnung (LTTB) auf dem Zeitreihen-Speicher: Implementierung
+
+#include "ts_downsample.h"
+#include <cstring>
+
+TsTier tsPickTier(const TsStore* st, uint32_t fromS, uint32_t toS, uint32_t points, uint32_t maxFactor)
+{
+    const uint32_t span = toS > fromS ? toS - fromS : 0;
+    TsTier pick = TS_MINUTE;
+    bool havePick = false;
+    for (uint8_t i = 0; i < TS_TIER_COUNT; ++i) {
+        const TsSeries& s = st->tier[i];
+        const bool hasData = s.used || st->acc[i].open;
+        if (!hasData) continue;
+        // ohne abgeschlossene Punkte deckt die Stufe nur das offene Intervall ab
+        const uint32_t oldest = s.used ? tsSeriesOldest(&s) : st->acc[i].bucket * s.resolutionS;
+        const bool covers = oldest <= fromS;
+        const bool fewEnough = span / s.resolutionS <= (uint64_t)points * maxFactor;
+        pick = (TsTier)i;
+        havePick = true;
+        if (covers && fewEnough) return pick;
+    }
+    return havePick ? pick : TS_MINUTE;
+}
+
+// Beginn (Index) des Eimers k: Eimer 0 ist der erste Punkt, dann points-2 gleich große,
+// der letzte Eimer ist der letzte Punkt
+static uint32_t bucketStart(const TsDownsampler* d, uint32_t k)
+{
+    if (!k) return 0;
+    if (k >= d->points - 1) return d->total - 1 + (k - (d->points - 1));
+    return (uint32_t)((uint64_t)(k - 1) * (d->total - 2) / (d->points - 2)) + 1;
+}
+
+void tsDownsampleBegin(TsDownsampler* d, const TsStore* st, TsTier tier, uint32_t fromS, uint32_t toS, uint32_t points)
+{
+    memset(d, 0, sizeof(*d));
+    TsPoint p;
+    tsStoreScan(st, tier, fromS, toS, &d->cur);
+    TsCursor count = d->cur;
+    while (tsCursorNext(&count, &p)) ++d->total;
+    d->ahead = d->cur;
+    d->points = points < 3 || d->total <= points ? d->total : points;
+}
+
+bool tsDownsampleNext(TsDownsampler* d, TsPoint* out)
+{
+    if (d->emitted >= d->points) return false;
+    // ohne Ausdünnung einfach durchreichen (auch erster und letzter Eimer: genau ein Punkt)
+    if (d->points == d->total || d->bucket == 0 || d->bucket == d->points - 1) {
+        if (!tsCursorNext(&d->cur, out)) return false;
+        ++d->curIndex;
+        if (d->bucket == 0) {
+            d->t0 = out->t;
+            // nächster Eimer beginnt hinter dem ersten Punkt
+            d->ahead = d->cur;
+            d->aheadIndex = d->curIndex;
+        }
+        d->ax = (int64_t)out->t - d->t0;
+        d->ay = out->avg;
+        ++d->bucket;
+        ++d->emitted;
+        return true;
+    }
+
+    // Mittelwert des nächsten Eimers (ahead läuft jeden Punkt genau einmal ab)
+    const uint32_t curEnd = bucketStart(d, d->bucket + 1);
+    const uint32_t nextEnd = bucketStart(d, d->bucket + 2) < d->total ? bucketStart(d, d->bucket + 2) : d->total;
+    TsPoint p;
+    while (d->aheadIndex < curEnd && tsCursorNext(&d->ahead, &p)) ++d->aheadIndex;
+    int64_t sx = 0, sy = 0, n = 0;
+    while (d->aheadIndex < nextEnd && tsCursorNext(&d->ahead, &p)) {
+        ++d->aheadIndex;
+        sx += (int64_t)p.t - d->t0;
+        sy += p.avg;
+        ++n;
+    }
+    const int64_t cx = n ? sx / n : d->ax, cy = n ? sy / n : d->ay;
+
+    // Punkt mit der größten Dreiecksfläche (a, Kandidat, Mittel des nächsten Eimers)
+    int64_t best = -1;
+    while (d->curIndex < curEnd && tsCursorNext(&d->cur, &p)) {
+        ++d->curIndex;
+        const int64_t bx = (int64_t)p.t - d->t0;
+        int64_t area = (d->ax - cx) * (p.avg - d->ay) - (d->ax - bx) * (cy - d->ay);
+        if (area < 0) area = -area;
+        if (area > best) {
+            best = area;
+            *out = p;
+        }
+    }
+    if (best < 0) return false;
+    d->ax = (int64_t)out->t - d->t0;
+    d->ay = out->avg;
+    ++d->bucket;
+    ++d->emitted;
+    return true;
+}
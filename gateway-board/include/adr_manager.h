@@ -0,0 +1,41 @@
+#pragma once
+// Deutsche Dokumentation
+// Adaptive Datenrate (Gateway): Linkstatistik pro Sensor, Sendedauer und
+// SF-/Leistungsvorgaben per Downlink (DL_OP_RADIO).
+//
+// Einschränkung Einkanal-Gateway: Das Funkmodul empfängt nur auf einem SF. Der SF wird
+// daher nur angepasst, wenn genau ein Sensor freigegeben ist (das Gateway zieht nach
+// der Quittung mit). Bei mehreren Sensoren bleibt der SF fest (LORA_SF) und nur die
+// Sendeleistung wird pro Sensor angepasst.
+#include <stddef.h>
+#include <stdint.h>
+#include "adr.h"
+#include "downlink.h"
+
+struct AdrStatus
+{
+    bool known;            // Sensor hat seine Funkparameter gemeldet
+    RadioSettings current; // zuletzt gemeldete/quittierte Werte des Sensors
+    uint8_t frames;        // Uplinks im Statistikfenster
+    int16_t meanRssi;
+    float meanSnr;
+    float maxSnr;
+    float marginDb;        // Linkreserve beim aktuellen SF
+    uint32_t lastToaUs;    // Sendedauer des letzten Uplinks
+    bool pending;          // Vorgabe unterwegs oder Wechsel noch unbestätigt
+};
+
+// Gesicherten Empfangs-SF laden und setzen (nach LoRa.begin())
+void adrInit();
+uint8_t adrGatewaySf();
+
+// Nach jedem gültigen Uplink (vor der Downlink-Zustellung)
+void adrOnUplink(uint8_t sid, int16_t rssi, float snr, size_t frameLen);
+// Funkparameter aus PAYLOAD_TLV_RADIO
+void adrOnRadioReport(uint8_t sid, const RadioSettings& r);
+// Quittung für DL_OP_RADIO / DL_OP_LINK_CHECK
+void adrOnAck(uint8_t sid, const DownlinkCommand& done, uint8_t status);
+// Im loop(): Empfangs-SF zurücksetzen, wenn der Sensor nach einem Wechsel verstummt
+void adrLoop();
+
+AdrStatus adrStatus(uint8_t sid);
@@ -0,0 +1,20 @@
+#pragma once
+// Deutsche Dokumentation
+// Alarme (Gateway): Regeltabelle aus config.h (ALERT_LEVELS_CM, ALERT_RISE_*, ALERT_STALE_*),
+// ausgewertet mit common/include/alert.h. Pegelregeln zuerst in der Reihenfolge der Tabelle,
+// dann Anstieg und Stille (soweit aktiviert). Zustand je Sensor wird bei der ersten Auswertung
+// angelegt. Läuft im Logik-Task unter pipelineLock().
+#include <stddef.h>
+#include <stdint.h>
+#include "alert.h"
+
+const AlertRule* alertManagerRules();
+size_t alertManagerRuleCount();
+// Kurzname einer Regel für MQTT-Topics und Home Assistant ("level_180", "rise", "stale")
+const char* alertManagerKey(uint8_t rule);
+
+// Regeln eines Sensors auswerten (siehe alertEvaluate)
+size_t alertManagerEvaluate(uint8_t sid, const AlertInput& in, AlertTransition* out, size_t maxOut);
+
+// Zustand eines Sensors (nullptr = noch nicht ausgewertet)
+const AlertState* alertManagerFind(uint8_t sid);
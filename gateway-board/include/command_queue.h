@@ -0,0 +1,38 @@
+#pragma once
+// Deutsche Dokumentation
+// Bestätigte Downlink-Befehle (Gateway): eine Warteschlange pro Sensor-ID.
+// Befehle werden nur im Empfangsfenster direkt nach einem Uplink des Sensors gesendet
+// und gelten erst mit der Quittung im folgenden Uplink als bestätigt.
+#include <stddef.h>
+#include <stdint.h>
+#include "downlink.h"
+
+// Zustand des OTA-AP eines Sensors (für Web-UI und MQTT)
+struct OtaApStatus
+{
+    int8_t confirmed;          // -1 unbekannt, 0 aus, 1 ein (vom Sensor quittiert)
+    int8_t pending;            // -1 nichts offen, sonst angeforderter Zustand
+    uint8_t attempts;          // Sendeversuche des offenen Befehls
+    bool lastExpired;          // letzter Befehl ohne Quittung abgelaufen
+    uint8_t lastAckStatus;     // DL_ACK_* der letzten Quittung
+    unsigned long confirmedMs; // millis() der letzten Quittung
+};
+
+// Befehl einreihen. Rückgabe: Befehls-ID, 0 = nicht möglich (Sensor unbekannt, voll).
+uint16_t commandQueue(uint8_t sid, uint8_t opcode, const uint8_t* args, uint8_t argLen);
+// OTA-AP ein-/ausschalten anfordern
+uint16_t commandQueueOtaAp(uint8_t sid, bool on);
+// true = ein Befehl mit diesem Opcode ist noch offen
+bool commandPending(uint8_t sid, uint8_t opcode);
+// true = irgendein Befehl an diesen Sensor ist noch offen
+bool commandQueued(uint8_t sid);
+
+// Quittung aus einem Uplink verarbeiten. true = offener Befehl quittiert, Kopie in *done
+// (auch bei Status != DL_ACK_OK). Der OTA-AP-Zustand wird hier bereits nachgeführt.
+bool commandHandleAck(uint8_t sid, const DownlinkAck& ack, DownlinkCommand* done);
+
+// Nächsten offenen Befehl für das Empfangsfenster kodieren (zählt als Versuch).
+// Rückgabe: Länge in buf oder 0, wenn nichts ansteht.
+size_t commandNextDownlink(uint8_t sid, uint32_t nowMs, uint8_t* buf, size_t cap);
+
+OtaApStatus commandOtaApStatus(uint8_t sid);
@@ -0,0 +1,21 @@
+#pragma once
+// Deutsche Dokumentation
+// Hochwasser-Prognose je Sensor (Gateway): jeder gültige Messwert geht wie in den Verlauf auch
+// in die gleitende Regression (common/include/flood_forecast.h); nach dem letzten Wert eines
+// Uplinks wird die ETA je Höhe neu gerechnet. Höhen und Fenster aus config.h (FORECAST_*);
+// Zustand wird beim ersten Messwert eines Sensors angelegt. Läuft im Logik-Task unter
+// pipelineLock().
+#include <stdint.h>
+#include "flood_forecast.h"
+
+// Messwert eintragen; tSec nach historyNowSec() (Batch-Werte rückdatiert, älteste zuerst)
+void forecastMonitorAdd(uint8_t sid, uint32_t tSec, int32_t depthMm);
+
+// Prognose aus dem aktuellen Fenster neu rechnen (nullptr = noch kein Messwert)
+const ForecastResult* forecastMonitorUpdate(uint8_t sid);
+
+// Zuletzt gerechnete Prognose eines Sensors (nullptr = noch kein Messwert)
+const ForecastResult* forecastMonitorFind(uint8_t sid);
+
+const ForecastConfig& forecastMonitorConfig();
+const char* forecastMonitorName(uint8_t level);
@@ -0,0 +1,32 @@
+#pragma once
+// Deutsche Dokumentation
+// Messwert-Verlauf (Gateway): je Sensor ein komprimierter Zeitreihen-Speicher
+// (common/include/timeseries.h) mit Minuten-, Stunden- und Tageswerten (Mittel/Min/Max).
+// Speicher wird beim ersten Messwert eines Sensors angelegt, Größe aus config.h
+// (HISTORY_MINUTE_KB, HISTORY_HOUR_KB, HISTORY_DAY_KB).
+//
+// Mit FLASH_LOG_ENABLED geht jeder Messwert mit NTP-Zeit zusätzlich in ein Log auf einer
+// rohen Flash-Partition (common/include/flash_log.h); beim Start wird der RAM-Verlauf daraus
+// wieder aufgebaut, er übersteht so Neustarts und OTA-Updates.
+#include <stdint.h>
+#include "flash_log.h"
+#include "timeseries.h"
+
+// Flash-Log einhängen und den Verlauf daraus wiederherstellen (in setup(), vor dem Empfang)
+void historyBegin();
+// Gepufferte Log-Sätze zeitgesteuert schreiben (FLASH_LOG_FLUSH_MS), in loop()
+void historyLoop();
+// Gepufferte Log-Sätze sofort schreiben (vor Neustart/OTA)
+void historyFlush();
+// Eingehängtes Log (nullptr = aus/keine Partition)
+const FlashLog* historyLog();
+
+// Zeitbasis in s: Unixzeit, sobald NTP die Uhr gestellt hat, vorher Sekunden seit Start
+uint32_t historyNowSec();
+
+// Gültigen Messwert eintragen; tSec nach historyNowSec() (Batch-Werte rückdatiert).
+// false = kein Speicher für den Sensor.
+bool historyAdd(uint8_t sid, uint32_t tSec, int32_t depthMm);
+
+// Verlauf eines Sensors (nullptr = noch nichts gespeichert)
+const TsStore* historyFind(uint8_t sid);
@@ -0,0 +1,15 @@
+#pragma once
+// Deutsche Dokumentation
+// HTTP-Export des Messwert-Verlaufs (Gateway):
+//   GET /api/history?sid=<id>[&from=<s>][&to=<s>][&points=<n>][&tier=minute|hour|day][&format=json|csv]
+// from/to in der Zeitbasis des Verlaufs (Unixzeit nach NTP), Vorgabe: die letzten 24 h.
+// Ohne tier wird die feinste Stufe gewählt, die den Bereich abdeckt; mehr Punkte als
+// points werden per LTTB ausgedünnt (common/include/ts_downsample.h). Die Antwort wird
+// in kleinen Stücken (Chunked Transfer, WebWriter aus webui.h) direkt aus dem Speicher erzeugt, ohne String der
+// ganzen Antwort, der Heap-Bedarf hängt also nicht vom Zeitraum ab.
+//   JSON: {"sid":1,"tier":"hour","resolution_s":3600,"from":..,"to":..,"total":N,
+//          "points":[[unixzeit,cm,min_cm,max_cm],...]}
+//   CSV:  ts,cm,min_cm,max_cm
+#include <WebServer.h>
+
+void historyApiHandle(WebServer &web);
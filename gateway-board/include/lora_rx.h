@@ -0,0 +1,49 @@
+#pragma once
+// Deutsche Dokumentation
+// Interrupt-gesteuerter LoRa-Empfang (Gateway): die DIO0-ISR (RxDone) nimmt nur den
+// Zeitstempel und weckt den Funk-Task (pipeline.h); dieser liest das Paket samt RSSI/SNR
+// per SPI in einen festen Ringpuffer und wertet es aus. Kein SPI und kein Gleitkomma in der ISR.
+#include <stddef.h>
+#include <stdint.h>
+#include "lora_frame.h"
+
+// Anzahl Pakete, die anfallen dürfen, bevor der Funk-Task sie abholt (Zweierpotenz)
+static const size_t LORA_RX_RING_SLOTS = 8;
+
+struct LoRaRxPacket
+{
+    uint32_t ms;        // millis() beim Empfang (in der ISR)
+    uint32_t us;        // micros() beim Empfang, für die Latenzmessung
+    int16_t rssi;
+    float snr;
+    uint8_t len;
+    uint8_t data[LORA_FRAME_MAX_LEN];
+};
+
+struct LoRaRxStats
+{
+    uint32_t received;  // in den Ring übernommen
+    uint32_t overruns;  // verworfen: Ring voll bzw. im Modul überschrieben, bevor der Funk-Task las
+    uint32_t oversize;  // verworfen, weil länger als LORA_FRAME_MAX_LEN
+    uint32_t highWater; // größte Ring-Füllung
+};
+
+// DIO0-Interrupt anmelden und Dauerempfang starten (nach LoRa.begin())
+void loraRxBegin(int dio0Pin);
+// Nach einem RxDone das Paket aus dem Modul in den Ring lesen (nur Funk-Task)
+void loraRxPoll();
+
+// Nächstes Paket oder nullptr; darf in-place ausgewertet werden (Entschlüsselung),
+// danach loraRxPop() aufrufen
+LoRaRxPacket* loraRxFront();
+void loraRxPop();
+// Aufrufenden Task schlafen legen, bis die ISR ein Paket ablegt oder timeoutMs vergeht.
+// Nur von einem Task aus verwenden (Funk-Task); dessen Task-Benachrichtigung wird benutzt.
+void loraRxWait(uint32_t timeoutMs);
+
+// Empfang für einen Sendevorgang bzw. eine Umstellung anhalten und wieder aufnehmen
+// (nur Funk-Task).
+void loraRxSuspend();
+void loraRxResume();
+
+LoRaRxStats loraRxStats();
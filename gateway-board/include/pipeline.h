@@ -0,0 +1,160 @@
+#pragma once
+// Deutsche Dokumentation
+// Aufteilung des Gateways auf drei FreeRTOS-Tasks, verbunden über lock-freie SPSC-Ringe
+// (common/include/spsc_ring.h, je ein Erzeuger und ein Verbraucher):
+//
+//   DIO0-ISR --Weck--> Funk --Uplinks--> Logik --Ereignisse--> Netz
+//                        ^                 |  \---Alarme------^
+//                        +--Funkaufträge---+
+//
+// Funk (höchste Priorität, eigener Kern): Frame prüfen (Sensor-ID, Replay, MAC), entschlüsseln,
+//   Klartext an die Logik; Downlinks verschlüsseln und senden, SF umstellen. Besitzt das
+//   Funkmodul (SPI), die Sessions, den Replay-Schutz und den Downlink-Zähler.
+// Logik: Uplinks auswerten (Sensor-Register, ADR, Befehle, Duty-Cycle, Verlauf, OLED, Taster),
+//   Downlinks als Funkaufträge, Ergebnisse als Ereignisse ans Netz.
+// Netz: WLAN, MQTT, OTA und Web-UI; veröffentlicht die Ereignisse, Alarme vor allem anderen
+//   (eigener Ring, die Logik weckt den Netz-Task).
+//
+// Kein Task wartet auf einen Ring: ist er voll, wird verworfen und gezählt. Der Funk-Task nimmt
+// keine Sperre; ein hängender HTTP-Client oder MQTT-Broker verzögert so weder den Empfang
+// noch die Entschlüsselung. Die Web-UI liest den Logik-Zustand unter pipelineLock(), die
+// Logik hält die Sperre nur während der Auswertung.
+#include <stddef.h>
+#include <stdint.h>
+#include "adr_manager.h"
+#include "downlink.h"
+#include "flood_forecast.h"
+#include "lora_frame.h"
+#include "payload.h"
+#include "pump_cycle.h"
+#include "sensor_record.h"
+
+// Ringgrößen (Zweierpotenz)
+static const size_t PIPELINE_UPLINK_SLOTS = 8;
+static const size_t PIPELINE_RADIO_JOB_SLOTS = 4;
+static const size_t PIPELINE_EVENT_SLOTS = 8;
+static const size_t PIPELINE_ALARM_SLOTS = 8;
+
+// Funk -> Logik: geprüfter, entschlüsselter Uplink
+struct RadioUplink
+{
+    uint32_t ms;        // millis() beim Empfang (ISR)
+    uint32_t us;        // micros() beim Empfang (ISR)
+    int16_t rssi;
+    float snr;
+    uint8_t sid;        // ohne Verschlüsselung 0
+    uint8_t frameLen;   // Länge des Funkframes (Sendedauer)
+    uint8_t len;        // Klartext
+    uint8_t data[LORA_FRAME_MAX_LEN];
+};
+
+enum RadioJobKind : uint8_t
+{
+    RADIO_JOB_DOWNLINK, // data an sid senden, wenn vor deadlineMs
+    RADIO_JOB_SET_SF,   // Empfangs-SF umstellen (data[0])
+};
+
+// Logik -> Funk
+struct RadioJob
+{
+    uint8_t kind;
+    uint8_t sid;
+    uint8_t len;
+    uint32_t deadlineMs;  // millis(): danach ist das Empfangsfenster des Sensors zu
+    uint8_t data[DOWNLINK_HDR_LEN + DOWNLINK_MAX_ARGS];
+};
+
+enum NetEventKind : uint8_t
+{
+    NET_UPLINK,   // Messwerte, Zustand und Linkqualität eines Sensors
+    NET_AIRTIME,  // Sendezeit des Gateways
+    NET_HEALTH,   // Zustand eines Sensors hat gewechselt (auch ohne Uplink, z. B. "stale")
+};
+
+// Logik -> Netz: alles, was zum Veröffentlichen nötig ist, als Kopie
+struct NetEvent
+{
+    uint8_t kind;
+    uint8_t sid;
+    uint32_t ms;                 // Empfang des Uplinks (millis())
+    SensorRecord rec;            // Stand nach dem Uplink
+    AdrStatus adr;
+    int8_t otaConfirmed;         // mit diesem Uplink quittierter OTA-AP-Zustand, -1 = keiner
+    uint8_t sampleCount;         // ältere Batch-Werte, älteste zuerst
+    BatchSample samples[PAYLOAD_BATCH_MAX];
+    PumpEvent pumpEvent;         // letzter Pumpenwechsel dieses Uplinks (PUMP_EVENT_NONE = keiner)
+    PumpCycleState pumps;        // Pumpzyklen nach dem Uplink (nur mit pumpEvent)
+    bool hasForecast;
+    ForecastResult forecast;     // Hochwasser-Prognose nach dem Uplink
+    uint8_t health;              // NET_HEALTH: SensorHealth
+    uint32_t usedMs;             // NET_AIRTIME
+    uint32_t remainingMs;
+    uint32_t deferred;
+};
+
+// Logik -> Netz: Alarmwechsel (Regel aus alert_manager.h), mit Zeitstempeln für die Latenz
+struct AlarmEvent
+{
+    uint8_t sid;
+    uint8_t rule;
+    bool active;
+    int32_t value;      // auslösender Wert (mm, mm/h bzw. s)
+    uint32_t rxUs;      // micros() beim Empfang des auslösenden Uplinks, 0 = zyklisch erkannt (Stille)
+    uint32_t detectUs;  // micros() bei der Erkennung
+};
+
+enum PipelineTask : uint8_t { PIPELINE_RADIO, PIPELINE_LOGIC, PIPELINE_NET, PIPELINE_TASK_COUNT };
+
+struct PipelineQueueStats
+{
+    uint16_t depth;     // aktuelle Füllung
+    uint16_t highWater; // größte Füllung
+    uint16_t slots;
+    uint32_t dropped;   // verworfen, weil voll
+};
+
+struct PipelineStats
+{
+    PipelineQueueStats uplinks, radioJobs, events, alarms;
+    uint32_t stackFree[PIPELINE_TASK_COUNT]; // kleinster freier Stack in Byte (ESP-IDF)
+    uint32_t rxLatencyMaxUs;     // ISR -> Uplink-Ring (Funk-Task)
+    uint32_t logicLatencyMaxUs;  // ISR -> ausgewertet (Logik-Task)
+    uint32_t rejected;           // ungültige oder fremde Frames
+    uint32_t downlinksLate;      // Empfangsfenster schon zu, nicht gesendet
+};
+
+typedef void (*PipelineLoopFn)();
+
+// In setup() nach LoRa.begin()/loraRxBegin(): Sperre anlegen und Tasks starten (Kerne,
+// Prioritäten und Stacks aus config.h). logic und net werden endlos aufgerufen; logic wartet
+// selbst mit pipelineWaitUplink(), net mit delay().
+void pipelineBegin(PipelineLoopFn logic, PipelineLoopFn net);
+
+// --- Logik-Task ---
+// Schlafen, bis ein Uplink ansteht oder timeoutMs vergeht
+void pipelineWaitUplink(uint32_t timeoutMs);
+RadioUplink* pipelineUplinkFront();
+// Eintrag verwerfen und Auswertelatenz erfassen
+void pipelineUplinkPop();
+// Funkauftrag einreihen und den Funk-Task wecken; false = Ring voll
+bool pipelineDownlink(uint8_t sid, uint32_t deadlineMs, const uint8_t* cmd, size_t len);
+bool pipelineSetSpreadingFactor(uint8_t sf);
+// Ereignis fürs Netz: claim, befüllen, publish (false = voll, gezählt)
+NetEvent* pipelineEventClaim();
+void pipelineEventPublish();
+// Alarmwechsel einreihen und den Netz-Task sofort wecken; false = Ring voll (gezählt)
+bool pipelineAlarm(const AlarmEvent& alarm);
+
+// --- Netz-Task ---
+// Schlafen, bis die Logik ein Ereignis oder einen Alarm einreiht oder timeoutMs vergeht
+void pipelineWaitEvent(uint32_t timeoutMs);
+NetEvent* pipelineEventFront();
+void pipelineEventPop();
+AlarmEvent* pipelineAlarmFront();
+void pipelineAlarmPop();
+
+// Zustand der Logik (Register, ADR, Befehle, Duty-Cycle, Verlauf) über Tasks hinweg
+void pipelineLock();
+void pipelineUnlock();
+
+PipelineStats pipelineStats();
@@ -0,0 +1,17 @@
+#pragma once
+// Deutsche Dokumentation
+// Pumpzyklen je Sensor (Gateway): jeder gültige Messwert geht wie in den Verlauf auch in die
+// Zyklenerkennung (common/include/pump_cycle.h). Pumpen und Schwellen aus config.h
+// (PUMP_LEVELS_CM, PUMP_NAMES, PUMP_SWING_CM, PUMP_FAIL_MARGIN_CM); Zustand wird beim ersten
+// Messwert eines Sensors angelegt. Läuft im Logik-Task unter pipelineLock().
+#include <stdint.h>
+#include "pump_cycle.h"
+
+// Messwert eintragen; tSec nach historyNowSec() (Batch-Werte rückdatiert, älteste zuerst)
+PumpEvent pumpMonitorAdd(uint8_t sid, uint32_t tSec, int32_t depthMm);
+
+// Zustand eines Sensors (nullptr = noch kein Messwert)
+const PumpCycleState* pumpMonitorFind(uint8_t sid);
+
+const PumpCycleConfig& pumpMonitorConfig();
+const char* pumpMonitorName(uint8_t pump);
@@ -0,0 +1,23 @@
+#pragma once
+// Deutsche Dokumentation
+// Replay-Schutz (Gateway): ein Bitmap-Fenster pro Sensor-ID (1..255),
+// Zählerstände werden in NVS gesichert, damit ein Neustart keine Lücke öffnet.
+#include <stdint.h>
+
+// Gesicherte Zählerstände aus NVS laden (einmal in setup())
+void replayGuardInit();
+
+// O(1)-Prüfung eines Uplink-Zählers, ändert nichts
+bool replayCheck(uint8_t sid, uint64_t counter);
+
+// Zähler nach gültigem MAC übernehmen (Funk-Task); reicht ihn alle REPLAY_PERSIST_EVERY
+// Frames zum Sichern weiter, ohne selbst in NVS zu schreiben
+void replayCommit(uint8_t sid, uint64_t counter);
+
+// Weitergereichte Zählerstände in NVS schreiben (Netz-Task, nicht im Funk-Pfad)
+void replayGuardPersist();
+
+// Nächster Downlink-Zähler (Funk-Task; Richtungsbit gesetzt, monoton auch über Neustarts).
+// Schreibt nicht in NVS; false, solange der Netz-Task die nächste Reservierung nicht
+// gesichert hat (erst nach 32 Downlinks ohne replayGuardPersist())
+bool nextDownlinkCounter(uint64_t* counter);
@@ -0,0 +1,21 @@
+#pragma once
+// Deutsche Dokumentation
+// Sensor-Register (Gateway): ein SensorRecord je Sensor-ID (1..255), angelegt beim
+// ersten gültigen Uplink eines freigegebenen Sensors. Grundlage für die MQTT-Topics,
+// die Home-Assistant-Discovery und die Sensortabelle der Web-UI.
+#include <stdint.h>
+#include "sensor_record.h"
+
+// Eintrag eines Sensors, bei Bedarf anlegen (nullptr = nicht freigegeben / kein Speicher).
+// Ohne Verschlüsselung gibt es keine Sensor-ID im Frame, dort steht alles unter ID 0.
+SensorRecord* sensorRegistryGet(uint8_t sid);
+// Nur nachschlagen, nichts anlegen
+const SensorRecord* sensorRegistryFind(uint8_t sid);
+
+// Iteration über bekannte Sensoren in aufsteigender ID:
+// for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+int sensorRegistryNext(int afterSid);
+uint8_t sensorRegistryCount();
+
+// Zustand mit den Grenzwerten aus config.h (SENSOR_STALE_MS, SENSOR_LOSS_WARN_PERMILLE)
+SensorHealth sensorRegistryHealth(const SensorRecord* r, uint32_t nowMs);
@@ -0,0 +1,16 @@
+#pragma once
+// Deutsche Dokumentation
+// Krypto-Sessions pro Sensor (Gateway): Schlüssel je Sensor-ID ableiten und cachen
+#include <stdint.h>
+#include "crypto.h"
+
+// Prüft die Sensor-ID gegen die Whitelist aus config.h
+bool isAllowedSensor(uint8_t sid);
+
+// Liefert die vorbereitete Session einer Sensor-ID (beim ersten Zugriff erzeugt).
+// nullptr, wenn die ID nicht freigegeben ist oder die Initialisierung scheitert.
+CryptoSession* sensorSession(uint8_t sid);
+
+// Zyklen pro Frame messen: alter Pfad (Key-Setup je Aufruf) gegen CryptoSession.
+// Ausgabe über Serial; nur mit Build-Flag -D CRYPTO_BENCH aktiv, sonst leer.
+void cryptoBenchmark();
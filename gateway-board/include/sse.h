@@ -0,0 +1,25 @@
+#pragma once
+// Deutsche Dokumentation
+// Server-Sent Events (Gateway): /events hält die HTTP-Verbindung offen und schiebt jedem
+// verbundenen Browser kleine JSON-Ereignisse zu ("event: <name>\ndata: <json>\n\n").
+// Die Statusseite aktualisiert sich damit ohne Neuladen.
+//
+// Läuft komplett im Netz-Task. Ein Browser, dessen Socket nicht mehr annimmt (Schreiben
+// scheitert oder bricht ab), wird getrennt; er verbindet sich nach "retry" selbst neu.
+// Hinweis: Der WebServer wartet nach der Übernahme noch bis zu 2 s auf das Schließen der
+// Verbindung, bevor er die nächste Anfrage bearbeitet (nur beim Verbindungsaufbau).
+#include <WebServer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static const uint8_t SSE_MAX_CLIENTS = 4;
+static const size_t SSE_EVENT_BYTES = 384;          // größtes Ereignis samt "event:"/"data:"
+static const unsigned long SSE_KEEPALIVE_MS = 15000; // Kommentarzeile, wenn so lange nichts kam
+
+// Route /events: Verbindung übernehmen (503, wenn alle Plätze belegt sind)
+void sseHandle(WebServer &web);
+// An alle Browser senden; json ist eine Zeile ohne Zeilenumbruch
+void ssePublish(const char *event, const char *json);
+// Im Netz-Task: getrennte Browser austragen, Keepalive-Kommentar senden
+void sseLoop();
+uint8_t sseClientCount();
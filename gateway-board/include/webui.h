@@ -1,11 +1,81 @@
 #pragma once
 // Deutsche Dokumentation
-// Mini Web-GUI (Gateway): Statusseite und einfache Aktionen
-#include <WString.h>
+// Web-UI (Gateway): Ausgabe von Seiten in Stücken, ohne die ganze Seite als String.
+//
+// Eine Seite ist eine Vorlage im Flash mit Platzhaltern {{name}}. Der feste Text wird direkt
+// aus dem Flash gesendet, nur die Platzhalter werden über einen Rückruf formatiert.
+// Die formatierten Felder werden in einem festen Puffer (WEBUI_CACHE_BYTES, kein Heap)
+// zwischengespeichert, gültig bis sich die Datenversion ändert (webuiTouch(), z. B. bei jedem
+// empfangenen Paket) bzw. höchstens WEBUI_CACHE_MS lang (Uhrzeiten, WLAN-Zustand).
+// Die Version steht im ETag; fragt der Browser mit If-None-Match nach, genügt ein 304.
+// Passt die Ausgabe nicht in den Puffer, wird ohne Zwischenspeicher direkt gestreamt (bis die
+// Felder wieder hineinpassen, ohne vorherigen Versuch im Zwischenspeicher).
+// Formatiert wird immer unter der Sperre der Seite (lock/unlock), gesendet nie: beim direkten
+// Streamen wird sie vor jedem Chunk gelöst und danach neu genommen, wie im Verlauf-Export.
+// Ein gestreamtes Feld kann daher über Chunk-Grenzen hinweg schon neuere Werte zeigen; die
+// Einträge selbst werden nie freigegeben, Zeiger darauf bleiben gültig.
+#include <WebServer.h>
+#include <stddef.h>
+#include <stdint.h>
 
-// Erzeugt HTML für die Statusseite
-String buildStatusPageHtml();
+static const size_t WEBUI_CHUNK_BYTES = 512;
 
-// Verarbeitet POST /sensor/ota
-// Rückgabe: true = gültig verarbeitet
-bool handleSensorOtaPost(int sid, bool enable);
+// Sammelt Text in einem festen Puffer. Mit web wird ein voller Puffer als Chunk gesendet,
+// ohne web (Zwischenspeicher) wird der Überlauf vermerkt.
+class WebWriter
+{
+public:
+  WebWriter(char *buf, size_t cap, WebServer *web)
+    : buf_(buf), cap_(cap), len_(0), total_(0), web_(web), overflow_(false), lock_(nullptr), unlock_(nullptr) {}
+
+  void write(const char *s, size_t n);
+  void print(const char *s);
+  void print(const __FlashStringHelper *s) { print((const char *)s); }
+  void print(long v);
+  void print(int v) { print((long)v); }
+  void print(unsigned long v);
+  void print(unsigned v) { print((unsigned long)v); }
+  // Zahl mit festen Nachkommastellen (wie String(v, digits))
+  void print(float v, uint8_t digits);
+  void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  // &, <, > und ' maskiert
+  void printEscaped(const char *s);
+  void flush();
+  // Sperre, die der Aufrufer gerade hält: flush() löst sie für das Senden (nullptr = keine)
+  void holdLock(void (*lock)(), void (*unlock)()) { lock_ = lock; unlock_ = unlock; }
+
+  size_t length() const { return len_; }
+  // Insgesamt geschriebene Bytes (auch bereits gesendete)
+  size_t total() const { return total_; }
+  bool overflow() const { return overflow_; }
+
+private:
+  char *buf_;
+  size_t cap_;
+  size_t len_;
+  size_t total_;
+  WebServer *web_;
+  bool overflow_;
+  void (*lock_)();
+  void (*unlock_)();
+};
+
+// Formatiert Platzhalter Nr. field (Index in WebPage::fields)
+typedef void (*WebFieldFn)(uint8_t field, WebWriter &out);
+
+struct WebPage
+{
+  const char *tmpl;             // Vorlage (im Flash)
+  const char *const *fields;    // Namen der Platzhalter
+  uint8_t fieldCount;
+  WebFieldFn render;
+  void (*lock)();               // Zugriff auf die angezeigten Daten (nullptr = ohne Sperre)
+  void (*unlock)();
+};
+
+// In setup() vor web.begin(): If-None-Match mitlesen
+void webuiBegin(WebServer &web);
+// Angezeigte Daten haben sich geändert
+void webuiTouch();
+// Seite mit ETag/304 und Zwischenspeicher senden
+void webuiServe(WebServer &web, const WebPage &page);
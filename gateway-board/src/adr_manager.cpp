@@ -0,0 +1,181 @@
+// Deutsche Dokumentation
+// Adaptive Datenrate (Gateway): Implementierung
+#include "adr_manager.h"
+#include <Arduino.h>
+#include <LoRa.h>
+#include <Preferences.h>
+#include <new>
+#include "config.h"
+#include "lora_airtime.h"
+#include "pipeline.h"
+#include "command_queue.h"
+#include "sensor_sessions.h"
+
+struct SensorLink
+{
+    LinkStats stats;
+    RadioSettings current;
+    bool known;
+    bool applyDue;        // Vorgabe quittiert, Umstellung nach dem aktuellen Empfangsfenster
+    uint32_t lastToaUs;
+};
+
+static SensorLink* s_links[256] = {nullptr};
+static uint8_t s_gatewaySf = LORA_SF;
+
+// Laufender SF-Wechsel (nur Einzel-Sensor-Betrieb)
+static bool s_switching = false;
+static uint8_t s_switchSid = 0;
+static uint8_t s_previousSf = LORA_SF;
+static unsigned long s_switchMs = 0;
+
+static bool adaptSf()
+{
+    return ADR_ADAPT_SF && ALLOWED_SENSOR_IDS_COUNT == 1;
+}
+
+static SensorLink* link(uint8_t sid)
+{
+    if (s_links[sid]) return s_links[sid];
+    if (!isAllowedSensor(sid)) return nullptr;
+    SensorLink* l = new (std::nothrow) SensorLink();
+    if (!l) return nullptr;
+    linkStatsReset(&l->stats);
+    l->current = { s_gatewaySf, 0 };
+    l->known = false;
+    l->applyDue = false;
+    l->lastToaUs = 0;
+    s_links[sid] = l;
+    return l;
+}
+
+static void setGatewaySf(uint8_t sf)
+{
+    if (sf == s_gatewaySf) return;
+    // Das Funkmodul gehört dem Funk-Task: Umstellung als Auftrag (nächster Durchlauf)
+    if (!pipelineSetSpreadingFactor(sf)) return;
+    s_gatewaySf = sf;
+    Preferences prefs;
+    if (prefs.begin("adr", false)) { prefs.putUChar("sf", sf); prefs.end(); }
+    Serial.printf("ADR: Gateway empfängt jetzt auf SF%u\n", (unsigned)sf);
+}
+
+static AdrPolicy policy()
+{
+    AdrPolicy p;
+    p.installMarginDb = ADR_MARGIN_DB;
+    p.minSf = adaptSf() ? ADR_MIN_SF : s_gatewaySf;
+    p.maxSf = adaptSf() ? ADR_MAX_SF : s_gatewaySf;
+    p.minTxPowerDbm = ADR_MIN_TX_POWER_DBM;
+    p.maxTxPowerDbm = ADR_MAX_TX_POWER_DBM;
+    p.minFrames = ADR_MIN_FRAMES;
+    return p;
+}
+
+void adrInit()
+{
+    Preferences prefs;
+    uint8_t sf = LORA_SF;
+    if (adaptSf() && prefs.begin("adr", true)) { sf = prefs.getUChar("sf", LORA_SF); prefs.end(); }
+    if (sf < 7 || sf > 12) sf = LORA_SF;
+    LoRa.setSpreadingFactor(sf);
+    s_gatewaySf = sf;
+    s_previousSf = sf;
+    Serial.printf("ADR: Empfang auf SF%u\n", (unsigned)sf);
+}
+
+uint8_t adrGatewaySf()
+{
+    return s_gatewaySf;
+}
+
+void adrOnUplink(uint8_t sid, int16_t rssi, float snr, size_t frameLen)
+{
+    SensorLink* l = link(sid);
+    if (!l) return;
+    linkStatsAdd(&l->stats, rssi, snr);
+    l->lastToaUs = loraTimeOnAirUs(loraModulationDefault(s_gatewaySf), frameLen);
+
+    if (s_switching && sid == s_switchSid) {
+        // Sensor ist auf dem neuen SF zu hören; DL_OP_LINK_CHECK geht in diesem Fenster raus
+        s_switching = false;
+        s_previousSf = s_gatewaySf;
+    }
+
+    if (!ADR_ENABLED || !l->known || s_switching) return;
+    if (commandPending(sid, DL_OP_RADIO) || commandPending(sid, DL_OP_LINK_CHECK)) return;
+    RadioSettings next;
+    if (!adrRecommend(policy(), l->stats, l->current, &next)) return;
+    const uint8_t args[2] = { next.sf, (uint8_t)next.txPowerDbm };
+    if (commandQueue(sid, DL_OP_RADIO, args, sizeof(args))) {
+        Serial.printf("ADR: Sensor %u SF%u/%d dBm -> SF%u/%d dBm (Reserve %.1f dB)\n",
+                      (unsigned)sid, (unsigned)l->current.sf, (int)l->current.txPowerDbm,
+                      (unsigned)next.sf, (int)next.txPowerDbm,
+                      adrLinkMarginDb(policy(), l->stats, l->current.sf));
+    }
+}
+
+void adrOnRadioReport(uint8_t sid, const RadioSettings& r)
+{
+    SensorLink* l = link(sid);
+    if (!l) return;
+    if (l->known && (l->current.sf != r.sf || l->current.txPowerDbm != r.txPowerDbm))
+        linkStatsReset(&l->stats); // Werte gelten nur für die gemessenen Parameter
+    l->current = r;
+    l->known = true;
+}
+
+void adrOnAck(uint8_t sid, const DownlinkCommand& done, uint8_t status)
+{
+    SensorLink* l = link(sid);
+    if (!l || done.opcode != DL_OP_RADIO || status != DL_ACK_OK || done.argLen < 2) return;
+    // Der Sensor stellt nach dem Empfangsfenster dieses Uplinks um: Statistik neu beginnen.
+    // Gateway-SF und DL_OP_LINK_CHECK erst in adrLoop(), sonst ginge der Check noch im
+    // alten Fenster raus (Sensor hört dort noch mit den alten Werten).
+    l->current = { done.args[0], (int8_t)done.args[1] };
+    linkStatsReset(&l->stats);
+    l->applyDue = true;
+}
+
+void adrLoop()
+{
+    for (unsigned sid = 1; sid < 256; ++sid) {
+        SensorLink* l = s_links[sid];
+        if (!l || !l->applyDue) continue;
+        l->applyDue = false;
+        if (adaptSf() && l->current.sf != s_gatewaySf) {
+            s_previousSf = s_gatewaySf;
+            s_switchSid = (uint8_t)sid;
+            s_switchMs = millis();
+            s_switching = true;
+            setGatewaySf(l->current.sf);
+        }
+        commandQueue((uint8_t)sid, DL_OP_LINK_CHECK, nullptr, 0);
+    }
+
+    if (!s_switching || millis() - s_switchMs < ADR_REVERT_MS) return;
+    // Sensor nach dem Wechsel nicht gehört: er kehrt nach ADR_PROBATION_UPLINKS selbst zurück
+    Serial.println("ADR: Sensor nach SF-Wechsel nicht gehört, zurück zum alten SF");
+    s_switching = false;
+    setGatewaySf(s_previousSf);
+    SensorLink* l = link(s_switchSid);
+    if (l) { l->current.sf = s_previousSf; linkStatsReset(&l->stats); }
+}
+
+AdrStatus adrStatus(uint8_t sid)
+{
+    AdrStatus st = {};
+    SensorLink* l = s_links[sid];
+    if (!l) return st;
+    st.known = l->known;
+    st.current = l->current;
+    st.frames = l->stats.count;
+    st.meanRssi = linkStatsMeanRssi(l->stats);
+    st.meanSnr = linkStatsMeanSnr(l->stats);
+    st.maxSnr = linkStatsMaxSnr(l->stats);
+    st.marginDb = adrLinkMarginDb(policy(), l->stats, l->current.sf);
+    st.lastToaUs = l->lastToaUs;
+    st.pending = l->applyDue || (s_switching && sid == s_switchSid) || commandPending(sid, DL_OP_RADIO) ||
+                 commandPending(sid, DL_OP_LINK_CHECK);
+    return st;
+}
@@ -0,0 +1,93 @@
+// Deutsche Dokumentation
+// Alarme (Gateway): Implementierung
+#include "alert_manager.h"
+#include <Arduino.h>
+#include <new>
+#include "config.h"
+
+static const size_t ALERT_LEVEL_COUNT = sizeof(ALERT_LEVELS_CM) / sizeof(ALERT_LEVELS_CM[0]);
+static_assert(ALERT_LEVEL_COUNT + 2 <= ALERT_MAX_RULES, "ALERT_LEVELS_CM: zu viele Regeln");
+
+struct AlertTable
+{
+    AlertRule rules[ALERT_MAX_RULES];
+    char keys[ALERT_MAX_RULES][16];
+    size_t count;
+};
+
+static int32_t tenths(float v)
+{
+    return (int32_t)lroundf(v * 10.0f);
+}
+
+static void addRule(AlertTable* t, uint8_t kind, uint8_t severity, uint8_t debounce, int32_t threshold, int32_t hysteresis)
+{
+    AlertRule& r = t->rules[t->count];
+    r.kind = kind;
+    r.severity = severity > ALERT_CRITICAL ? (uint8_t)ALERT_CRITICAL : severity;
+    r.debounce = debounce;
+    r.threshold = threshold;
+    r.hysteresis = hysteresis;
+    if (kind == ALERT_LEVEL)
+        snprintf(t->keys[t->count], sizeof(t->keys[0]), "level_%ld", (long)lroundf(threshold / 10.0f));
+    else
+        snprintf(t->keys[t->count], sizeof(t->keys[0]), "%s", alertKindName(kind));
+    t->count++;
+}
+
+static AlertTable makeTable()
+{
+    AlertTable t = {};
+    for (size_t i = 0; i < ALERT_LEVEL_COUNT; ++i)
+        addRule(&t, ALERT_LEVEL, (uint8_t)ALERT_LEVELS_CM[i][3], (uint8_t)ALERT_LEVELS_CM[i][2],
+                tenths(ALERT_LEVELS_CM[i][0]), tenths(ALERT_LEVELS_CM[i][1]));
+    if (ALERT_RISE_CM_PER_H > 0.0f)
+        addRule(&t, ALERT_RISE, ALERT_RISE_SEVERITY, ALERT_RISE_DEBOUNCE, tenths(ALERT_RISE_CM_PER_H),
+                tenths(ALERT_RISE_HYSTERESIS_CM_PER_H));
+    if (ALERT_STALE_MS)
+        addRule(&t, ALERT_STALE, ALERT_STALE_SEVERITY, 1, (int32_t)(ALERT_STALE_MS / 1000UL), 0);
+    return t;
+}
+
+// Beim Start aufgebaut, danach nur gelesen (aus Logik- und Netz-Task)
+static const AlertTable s_table = makeTable();
+
+// Wie das Sensor-Register: nur Zeiger, Speicher erst bei der ersten Auswertung
+static AlertState* s_state[256] = {nullptr};
+static bool s_allocFailed = false;
+
+const AlertRule* alertManagerRules()
+{
+    return s_table.rules;
+}
+
+size_t alertManagerRuleCount()
+{
+    return s_table.count;
+}
+
+const char* alertManagerKey(uint8_t rule)
+{
+    return rule < s_table.count ? s_table.keys[rule] : "?";
+}
+
+size_t alertManagerEvaluate(uint8_t sid, const AlertInput& in, AlertTransition* out, size_t maxOut)
+{
+    AlertState* s = s_state[sid];
+    if (!s) {
+        s = new (std::nothrow) AlertState();
+        if (!s) {
+            if (!s_allocFailed) Serial.printf("Alarme: kein Speicher fuer Sensor %u\n", (unsigned)sid);
+            s_allocFailed = true;
+            return 0;
+        }
+        alertReset(s);
+        s_state[sid] = s;
+    }
+    return alertEvaluate(s_table.rules, s_table.count, s, in, out, maxOut);
+}
+
+const AlertState* alertManagerFind(uint8_t sid)
+{
+    return s_state[sid];
+}
@@ -0,0 +1,123 @@
+// Deutsche Dokumentation
+// Bestätigte Downlink-Befehle (Gateway): Implementierung
+#include "command_queue.h"
+#include <Arduino.h>
+#include <new>
+#include <cstring>
+#include "config.h"
+#include "downlink_queue.h"
+#include "sensor_sessions.h"
+
+struct SensorCommands
+{
+    DownlinkQueue queue;
+    OtaApStatus ota;
+};
+
+// Wie die Krypto-Sessions: nur Zeiger, angelegt beim ersten Befehl an einen Sensor
+static SensorCommands* s_sensors[256] = {nullptr};
+static uint16_t s_nextId = 0;
+
+static const DownlinkPolicy POLICY = { DOWNLINK_MAX_ATTEMPTS, DOWNLINK_EXPIRY_MS };
+
+static SensorCommands* sensorCommands(uint8_t sid, bool create)
+{
+    if (s_sensors[sid] || !create) return s_sensors[sid];
+    if (!isAllowedSensor(sid)) return nullptr;
+    SensorCommands* c = new (std::nothrow) SensorCommands();
+    if (!c) return nullptr;
+    downlinkQueueReset(&c->queue);
+    c->ota = { -1, -1, 0, false, DL_ACK_OK, 0 };
+    s_sensors[sid] = c;
+    return c;
+}
+
+static uint16_t nextCommandId()
+{
+    // Zufälliger Start je Boot: der Sensor erkennt Wiederholungen an der ID und
+    // darf einen neuen Befehl nach einem Gateway-Neustart nicht für eine halten
+    if (s_nextId == 0) s_nextId = (uint16_t)esp_random();
+    if (++s_nextId == 0) ++s_nextId;
+    return s_nextId;
+}
+
+static void expire(uint8_t sid, SensorCommands* c, uint32_t nowMs)
+{
+    DownlinkCommand expired[DOWNLINK_QUEUE_DEPTH];
+    size_t n = downlinkQueueExpire(&c->queue, POLICY, nowMs, expired, DOWNLINK_QUEUE_DEPTH);
+    for (size_t i = 0; i < n; ++i) {
+        Serial.printf("Downlink an Sensor %u abgelaufen: id=%u op=0x%02x\n",
+                      (unsigned)sid, (unsigned)expired[i].id, (unsigned)expired[i].opcode);
+        if (expired[i].opcode == DL_OP_OTA_AP) c->ota.lastExpired = true;
+    }
+}
+
+uint16_t commandQueue(uint8_t sid, uint8_t opcode, const uint8_t* args, uint8_t argLen)
+{
+    SensorCommands* c = sensorCommands(sid, true);
+    if (!c || argLen > DOWNLINK_MAX_ARGS) return 0;
+    DownlinkCommand cmd = {};
+    cmd.id = nextCommandId();
+    cmd.opcode = opcode;
+    cmd.argLen = argLen;
+    if (argLen) memcpy(cmd.args, args, argLen);
+    if (!downlinkQueuePush(&c->queue, cmd, millis())) return 0;
+    if (opcode == DL_OP_OTA_AP) c->ota.lastExpired = false;
+    return cmd.id;
+}
+
+uint16_t commandQueueOtaAp(uint8_t sid, bool on)
+{
+    const uint8_t arg = on ? 1 : 0;
+    return commandQueue(sid, DL_OP_OTA_AP, &arg, 1);
+}
+
+bool commandPending(uint8_t sid, uint8_t opcode)
+{
+    SensorCommands* c = sensorCommands(sid, false);
+    return c && downlinkQueueFind(&c->queue, opcode) != nullptr;
+}
+
+bool commandQueued(uint8_t sid)
+{
+    SensorCommands* c = sensorCommands(sid, false);
+    return c && c->queue.count > 0;
+}
+
+bool commandHandleAck(uint8_t sid, const DownlinkAck& ack, DownlinkCommand* done)
+{
+    SensorCommands* c = sensorCommands(sid, false);
+    if (!c || !downlinkQueueAck(&c->queue, ack.id, done)) return false;
+    Serial.printf("Downlink an Sensor %u quittiert: id=%u status=%u\n",
+                  (unsigned)sid, (unsigned)ack.id, (unsigned)ack.status);
+    if (done->opcode == DL_OP_OTA_AP) {
+        c->ota.lastAckStatus = ack.status;
+        c->ota.confirmedMs = millis();
+        if (ack.status == DL_ACK_OK) c->ota.confirmed = done->args[0] ? 1 : 0;
+    }
+    return true;
+}
+
+size_t commandNextDownlink(uint8_t sid, uint32_t nowMs, uint8_t* buf, size_t cap)
+{
+    SensorCommands* c = sensorCommands(sid, false);
+    if (!c) return 0;
+    expire(sid, c, nowMs);
+    const DownlinkEntry* e = downlinkQueueTake(&c->queue, nowMs);
+    if (!e) return 0;
+    Serial.printf("Downlink an Sensor %u: id=%u Versuch %u\n",
+                  (unsigned)sid, (unsigned)e->cmd.id, (unsigned)e->attempts);
+    return downlinkEncode(e->cmd, buf, cap);
+}
+
+OtaApStatus commandOtaApStatus(uint8_t sid)
+{
+    SensorCommands* c = sensorCommands(sid, false);
+    if (!c) return { -1, -1, 0, false, DL_ACK_OK, 0 };
+    expire(sid, c, millis());
+    OtaApStatus s = c->ota;
+    const DownlinkEntry* e = downlinkQueueFind(&c->queue, DL_OP_OTA_AP);
+    s.pending = e ? (e->cmd.args[0] ? 1 : 0) : -1;
+    s.attempts = e ? e->attempts : 0;
+    return s;
+}
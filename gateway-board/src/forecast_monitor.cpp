@@ -0,0 +1,86 @@
+// Deutsche Dokumentation
+// Hochwasser-Prognose je Sensor (Gateway): Implementierung
+#include "forecast_monitor.h"
+#include <Arduino.h>
+#include <new>
+#include "config.h"
+
+static const size_t FORECAST_CONFIG_COUNT = sizeof(FORECAST_LEVELS_CM) / sizeof(FORECAST_LEVELS_CM[0]);
+static_assert(FORECAST_CONFIG_COUNT <= FORECAST_MAX_LEVELS, "FORECAST_LEVELS_CM: hoechstens 4 Hoehen");
+static_assert(sizeof(FORECAST_NAMES) / sizeof(FORECAST_NAMES[0]) == FORECAST_CONFIG_COUNT, "FORECAST_NAMES passt nicht zu FORECAST_LEVELS_CM");
+static_assert(FORECAST_SLOTS >= 3 && FORECAST_SLOTS <= FORECAST_MAX_SLOTS, "FORECAST_SLOTS: 3 bis 32");
+
+static int32_t cmToMm(float cm)
+{
+    return (int32_t)lroundf(cm * 10.0f);
+}
+
+static ForecastConfig makeConfig()
+{
+    ForecastConfig c = {};
+    for (size_t i = 0; i < FORECAST_CONFIG_COUNT; ++i) c.levelsMm[i] = cmToMm(FORECAST_LEVELS_CM[i]);
+    c.levelCount = (uint8_t)FORECAST_CONFIG_COUNT;
+    c.windowS = FORECAST_WINDOW_MIN * 60UL;
+    c.slots = FORECAST_SLOTS;
+    c.minSamples = 4;
+    c.minSpanS = FORECAST_MIN_SPAN_MIN * 60UL;
+    c.minRiseMmPerH = cmToMm(FORECAST_MIN_RISE_CM_PER_H);
+    // Pumpe springt an: derselbe Richtungswechsel wie in der Zyklenerkennung
+    c.resetDropMm = cmToMm(PUMP_SWING_CM);
+    c.maxGapS = SENSOR_STALE_MS / 1000UL;
+    c.horizonS = FORECAST_HORIZON_H * 3600UL;
+    c.confidenceK = FORECAST_CONFIDENCE_K;
+    return c;
+}
+
+static const ForecastConfig s_config = makeConfig();
+
+struct ForecastEntry
+{
+    ForecastState state;
+    ForecastResult result;
+};
+
+// Wie das Sensor-Register: nur Zeiger, Speicher erst beim ersten Messwert
+static ForecastEntry* s_entry[256] = {nullptr};
+static bool s_allocFailed = false;
+
+void forecastMonitorAdd(uint8_t sid, uint32_t tSec, int32_t depthMm)
+{
+    ForecastEntry* e = s_entry[sid];
+    if (!e) {
+        e = new (std::nothrow) ForecastEntry();
+        if (!e) {
+            if (!s_allocFailed) Serial.printf("Prognose: kein Speicher fuer Sensor %u\n", (unsigned)sid);
+            s_allocFailed = true;
+            return;
+        }
+        forecastReset(&e->state);
+        forecastCompute(s_config, e->state, &e->result);
+        s_entry[sid] = e;
+    }
+    forecastAdd(s_config, &e->state, tSec, depthMm);
+}
+
+const ForecastResult* forecastMonitorUpdate(uint8_t sid)
+{
+    ForecastEntry* e = s_entry[sid];
+    if (!e) return nullptr;
+    forecastCompute(s_config, e->state, &e->result);
+    return &e->result;
+}
+
+const ForecastResult* forecastMonitorFind(uint8_t sid)
+{
+    return s_entry[sid] ? &s_entry[sid]->result : nullptr;
+}
+
+const ForecastConfig& forecastMonitorConfig()
+{
+    return s_config;
+}
+
+const char* forecastMonitorName(uint8_t level)
+{
+    return level < FORECAST_CONFIG_COUNT ? FORECAST_NAMES[level] : "?";
+}
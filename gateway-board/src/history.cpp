@@ -0,0 +1,171 @@
+// Deutsche Dokumentation
+// Messwert-Verlauf (Gateway): Implementierung
+#include "history.h"
+#include <Arduino.h>
+#include <new>
+#include <time.h>
+#include <esp_partition.h>
+#include "config.h"
+
+// Unixzeit gilt ab hier als von NTP gestellt
+static const uint32_t HISTORY_EPOCH_MIN = 1600000000UL;
+
+struct SensorHistory
+{
+    TsStore store;
+    uint8_t* data;
+    TsBlockHeader* headers;
+};
+
+// Wie das Sensor-Register: nur Zeiger, Speicher erst beim ersten Messwert
+static SensorHistory* s_history[256] = {nullptr};
+static bool s_allocFailed = false;
+
+static const esp_partition_t* s_partition = nullptr;
+static FlashLog s_log;
+static bool s_logMounted = false;
+// Verlauf aus dem Log wiederhergestellt: Werte ohne NTP-Zeit passen nicht mehr dazu
+static bool s_restored = false;
+static unsigned long s_lastFlushMs = 0;
+
+static uint16_t blocksFor(uint32_t kb)
+{
+    const uint32_t n = kb * 1024UL / TS_BLOCK_BYTES;
+    return (uint16_t)(n < 2 ? 2 : n > 0xFFFF ? 0xFFFF : n);
+}
+
+static SensorHistory* historyGet(uint8_t sid)
+{
+    if (s_history[sid]) return s_history[sid];
+
+    const uint16_t blocks[TS_TIER_COUNT] = {
+        blocksFor(HISTORY_MINUTE_KB), blocksFor(HISTORY_HOUR_KB), blocksFor(HISTORY_DAY_KB),
+    };
+    const size_t total = (size_t)blocks[TS_MINUTE] + blocks[TS_HOUR] + blocks[TS_DAY];
+    SensorHistory* h = new (std::nothrow) SensorHistory();
+    uint8_t* data = new (std::nothrow) uint8_t[total * TS_BLOCK_BYTES];
+    TsBlockHeader* headers = new (std::nothrow) TsBlockHeader[total];
+    if (!h || !data || !headers) {
+        delete h;
+        delete[] data;
+        delete[] headers;
+        if (!s_allocFailed) Serial.printf("Verlauf: kein Speicher fuer Sensor %u (%u Byte)\n",
+                                          (unsigned)sid, (unsigned)(total * (TS_BLOCK_BYTES + sizeof(TsBlockHeader))));
+        s_allocFailed = true;
+        return nullptr;
+    }
+
+    h->data = data;
+    h->headers = headers;
+    uint8_t* const buffers[TS_TIER_COUNT] = {
+        data, data + (size_t)blocks[TS_MINUTE] * TS_BLOCK_BYTES,
+        data + ((size_t)blocks[TS_MINUTE] + blocks[TS_HOUR]) * TS_BLOCK_BYTES,
+    };
+    TsBlockHeader* const hdrs[TS_TIER_COUNT] = {
+        headers, headers + blocks[TS_MINUTE], headers + blocks[TS_MINUTE] + blocks[TS_HOUR],
+    };
+    tsStoreInit(&h->store, buffers, hdrs, blocks);
+    s_history[sid] = h;
+    return h;
+}
+
+static bool partitionRead(void* ctx, uint32_t offset, void* buf, size_t len)
+{
+    return esp_partition_read((const esp_partition_t*)ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool partitionWrite(void* ctx, uint32_t offset, const void* buf, size_t len)
+{
+    return esp_partition_write((const esp_partition_t*)ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool partitionErase(void* ctx, uint32_t offset)
+{
+    return esp_partition_erase_range((const esp_partition_t*)ctx, offset, FLASH_LOG_SECTOR_BYTES) == ESP_OK;
+}
+
+void historyBegin()
+{
+    if (!FLASH_LOG_ENABLED) return;
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FLASH_LOG_PARTITION);
+    if (!s_partition) {
+        Serial.printf("Flash-Log: Partition '%s' fehlt\n", FLASH_LOG_PARTITION);
+        return;
+    }
+    const FlashLogIo io = { (void*)s_partition, partitionRead, partitionWrite, partitionErase, s_partition->size };
+    const uint16_t sectors = flashLogSectorCount(io);
+    FlashLogSectorInfo* index = new (std::nothrow) FlashLogSectorInfo[sectors];
+    if (!index || !flashLogMount(&s_log, io, index, sectors)) {
+        Serial.println("Flash-Log: Einhaengen fehlgeschlagen");
+        delete[] index;
+        return;
+    }
+    s_logMounted = true;
+    Serial.printf("Flash-Log: Partition '%s' @0x%06lx, %lu KB, %u/%u Sektoren belegt, %u abgeschnitten\n",
+                  FLASH_LOG_PARTITION, (unsigned long)s_partition->address, (unsigned long)(s_partition->size / 1024),
+                  (unsigned)s_log.usedSectors, (unsigned)sectors, (unsigned)s_log.torn);
+
+    // Verlauf in Schreibreihenfolge wieder aufbauen (älteste zuerst)
+    const unsigned long t0 = millis();
+    FlashLogCursor c;
+    FlashLogRecord r;
+    uint32_t n = 0;
+    flashLogScan(&s_log, 0, &c);
+    while (flashLogNext(&c, &r)) {
+        if (r.kind != FLASH_LOG_DEPTH_MM) continue;
+        SensorHistory* h = historyGet(r.sid);
+        if (!h) continue;
+        tsStoreAdd(&h->store, r.tSec, r.value);
+        ++n;
+    }
+    s_restored = n > 0;
+    Serial.printf("Flash-Log: %lu Messwerte in %lu ms wiederhergestellt (%lu beschaedigt)\n",
+                  (unsigned long)n, millis() - t0, (unsigned long)c.invalid);
+}
+
+void historyLoop()
+{
+    if (!s_logMounted || !flashLogPending(&s_log)) {
+        s_lastFlushMs = millis();
+        return;
+    }
+    if (millis() - s_lastFlushMs >= FLASH_LOG_FLUSH_MS) historyFlush();
+}
+
+void historyFlush()
+{
+    s_lastFlushMs = millis();
+    if (s_logMounted && !flashLogFlush(&s_log)) Serial.println("Flash-Log: Schreibfehler");
+}
+
+const FlashLog* historyLog()
+{
+    return s_logMounted ? &s_log : nullptr;
+}
+
+uint32_t historyNowSec()
+{
+    const time_t now = time(nullptr);
+    if (now > HISTORY_EPOCH_MIN) return (uint32_t)now; // Uhrzeit per NTP gesetzt
+    return millis() / 1000UL;
+}
+
+bool historyAdd(uint8_t sid, uint32_t tSec, int32_t depthMm)
+{
+    const bool epoch = tSec > HISTORY_EPOCH_MIN;
+    if (!epoch && s_restored) return false; // bis NTP die Uhr stellt
+    SensorHistory* h = historyGet(sid);
+    if (!h) return false;
+    tsStoreAdd(&h->store, tSec, depthMm);
+    // Ins Flash nur mit echter Uhrzeit (Sekunden seit Start sind nach einem Neustart wertlos)
+    if (epoch && s_logMounted) {
+        const FlashLogRecord rec = { tSec, depthMm, sid, FLASH_LOG_DEPTH_MM, 0 };
+        if (!flashLogAppend(&s_log, rec)) Serial.println("Flash-Log: Schreibfehler");
+    }
+    return true;
+}
+
+const TsStore* historyFind(uint8_t sid)
+{
+    return s_history[sid] ? &s_history[sid]->store : nullptr;
+}
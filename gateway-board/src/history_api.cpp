@@ -0,0 +1,112 @@
+// Deutsche Dokumentation
+// HTTP-Export des Messwert-Verlaufs: Implementierung
+#include "history_api.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include "config.h"
+#include "history.h"
+#include "pipeline.h"
+#include "ts_downsample.h"
+#include "webui.h"
+
+// Stufe auch dann noch wählen, wenn sie bis zu so viele Punkte je Ausgabepunkt liefert
+static const uint32_t HISTORY_API_OVERSAMPLE = 8;
+// Platz für einen Punkt im Chunk (Zeitstempel und drei Werte, großzügig)
+static const size_t HISTORY_API_LINE_MAX = 64;
+static const char *const TIER_KEYS[TS_TIER_COUNT] = { "minute", "hour", "day" };
+
+// Blöcke, in denen die Lesezeiger stehen (erster Zeitpunkt), um ein Überschreiben durch
+// den Logik-Task zwischen zwei Chunks zu erkennen
+struct HistoryApiMark
+{
+  uint32_t cur, ahead;
+};
+
+static uint32_t blockFirst(const TsCursor &c)
+{
+  return c.blocksLeft ? c.s->headers[c.block].firstT : 0;
+}
+
+static HistoryApiMark markBlocks(const TsDownsampler &d)
+{
+  return { blockFirst(d.cur), blockFirst(d.ahead) };
+}
+
+static bool argU32(WebServer &web, const char *name, uint32_t *out)
+{
+  if (!web.hasArg(name)) return false;
+  *out = (uint32_t)strtoul(web.arg(name).c_str(), nullptr, 10);
+  return true;
+}
+
+void historyApiHandle(WebServer &web)
+{
+  uint32_t sid = 0;
+  if (!argU32(web, "sid", &sid) || sid > 255) { web.send(400, "text/plain", "sid fehlt"); return; }
+
+  uint32_t to = historyNowSec(), from = 0, points = HISTORY_API_DEFAULT_POINTS;
+  argU32(web, "to", &to);
+  if (!argU32(web, "from", &from)) from = to > 86400UL ? to - 86400UL : 0;
+  if (from > to) { web.send(400, "text/plain", "from > to"); return; }
+  argU32(web, "points", &points);
+  if (points < 3) points = 3;
+  if (points > HISTORY_API_MAX_POINTS) points = HISTORY_API_MAX_POINTS;
+
+  const String tierArg = web.arg("tier");
+  const bool csv = web.arg("format") == "csv";
+
+  // Der Logik-Task schreibt weiter in den Verlauf: gelesen wird unter der Sperre, gesendet
+  // ohne sie (je Chunk neu gesperrt, ein langsamer Client hält die Auswertung nicht auf).
+  // Der Bereich endet am jüngsten abgeschlossenen Punkt beim Start (später angehängte Punkte
+  // und das offene Intervall ändern die Punktzahl nicht mehr); überschreibt der Ring den
+  // gerade gelesenen Block, endet die Antwort vorzeitig ("truncated")
+  pipelineLock();
+  const TsStore *st = historyFind((uint8_t)sid);
+  if (!st) { pipelineUnlock(); web.send(404, "text/plain", "kein Verlauf fuer diesen Sensor"); return; }
+  TsTier tier = tsPickTier(st, from, to, points, HISTORY_API_OVERSAMPLE);
+  for (uint8_t i = 0; i < TS_TIER_COUNT; ++i)
+    if (tierArg == TIER_KEYS[i]) tier = (TsTier)i;
+  const TsSeries &series = st->tier[tier];
+  if (series.used && tsSeriesNewest(&series) < to) to = tsSeriesNewest(&series);
+  TsDownsampler d;
+  tsDownsampleBegin(&d, st, tier, from, to, points);
+  HistoryApiMark mark = markBlocks(d);
+  pipelineUnlock();
+
+  // Länge unbekannt: WebServer antwortet mit Transfer-Encoding: chunked
+  web.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  web.sendHeader("Cache-Control", "no-store");
+  web.send(200, csv ? "text/csv; charset=utf-8" : "application/json", "");
+
+  char chunk[WEBUI_CHUNK_BYTES];
+  WebWriter head(chunk, sizeof(chunk), &web);
+  if (csv)
+    head.printf("ts,cm,min_cm,max_cm\n");
+  else
+    head.printf("{\"sid\":%lu,\"tier\":\"%s\",\"resolution_s\":%lu,\"from\":%lu,\"to\":%lu,\"total\":%lu,\"points\":[",
+                (unsigned long)sid, TIER_KEYS[tier], (unsigned long)TS_TIER_SECONDS[tier],
+                (unsigned long)from, (unsigned long)to, (unsigned long)d.total);
+  head.flush();
+  TsPoint p;
+  bool first = true, more = true, truncated = false;
+  while (more)
+  {
+    // Ohne WebServer sendet der Writer nicht selbst: Chunk füllen, Sperre lösen, senden
+    WebWriter out(chunk, sizeof(chunk), nullptr);
+    pipelineLock();
+    const HistoryApiMark now = markBlocks(d);
+    truncated = now.cur != mark.cur || now.ahead != mark.ahead;
+    more = !truncated;
+    while (more && out.length() + HISTORY_API_LINE_MAX <= sizeof(chunk) && (more = tsDownsampleNext(&d, &p)))
+    {
+      out.printf(csv ? "%s%lu,%.1f,%.1f,%.1f\n" : "%s[%lu,%.1f,%.1f,%.1f]", csv || first ? "" : ",",
+                 (unsigned long)p.t, p.avg / 10.0f, p.min / 10.0f, p.max / 10.0f);
+      first = false;
+    }
+    mark = markBlocks(d);
+    pipelineUnlock();
+    if (out.length()) web.sendContent(chunk, out.length());
+  }
+  if (!csv) web.sendContent(truncated ? "],\"truncated\":true}" : "]}");
+  web.sendContent(""); // letztes (leeres) Chunk
+}
@@ -0,0 +1,123 @@
+// Deutsche Dokumentation
+// Interrupt-gesteuerter LoRa-Empfang: Implementierung
+//
+// Die DIO0-ISR (RxDone) greift nicht auf das Funkmodul zu: SPI-Transaktionen nehmen
+// auf dem ESP32 einen FreeRTOS-Mutex, Gleitkomma ist in einer ISR nicht erlaubt. Sie merkt
+// sich nur den Zeitstempel und weckt den Funk-Task. Dieser besitzt den SPI-Bus ohnehin,
+// liest in loraRxPoll() FIFO, RSSI und SNR in einen Ring-Slot und wertet ihn danach aus
+// (pipeline.h). Ein langsamer HTTP-Request verzögert damit weder Empfang noch Entschlüsselung.
+#include "lora_rx.h"
+#include <Arduino.h>
+#include <LoRa.h>
+#include "spsc_ring.h"
+
+static SpscRing<LoRaRxPacket, LORA_RX_RING_SLOTS> s_ring;
+static volatile uint32_t s_received = 0;
+static volatile uint32_t s_overruns = 0;
+static volatile uint32_t s_oversize = 0;
+static TaskHandle_t s_waiter = nullptr;
+
+// Von der ISR geschrieben (unter s_mux): Anzahl RxDone und Zeitpunkt des letzten
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_irqs = 0;
+static uint32_t s_irqMs = 0;
+static uint32_t s_irqUs = 0;
+static uint32_t s_handled = 0; // Funk-Task
+static int s_dio0 = -1;
+
+static void IRAM_ATTR onDio0()
+{
+    portENTER_CRITICAL_ISR(&s_mux);
+    s_irqMs = millis();
+    s_irqUs = micros();
+    ++s_irqs;
+    portEXIT_CRITICAL_ISR(&s_mux);
+    if (s_waiter) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s_waiter, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
+}
+
+void loraRxBegin(int dio0Pin)
+{
+    s_dio0 = dio0Pin;
+    pinMode(dio0Pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(dio0Pin), onDio0, RISING);
+    LoRa.receive(); // Dauerempfang, DIO0 = RxDone
+}
+
+void loraRxPoll()
+{
+    portENTER_CRITICAL(&s_mux);
+    const uint32_t irqs = s_irqs;
+    const uint32_t ms = s_irqMs;
+    const uint32_t us = s_irqUs;
+    portEXIT_CRITICAL(&s_mux);
+    if (irqs == s_handled) return;
+    // Im Modul liegt nur das letzte Paket; frühere sind schon überschrieben
+    if (irqs - s_handled > 1) s_overruns = s_overruns + (irqs - s_handled - 1);
+    s_handled = irqs;
+
+    // parsePacket() liest und löscht die IRQ-Flags (CRC-Fehler: 0) und verlässt den
+    // Dauerempfang; receive() nimmt ihn danach wieder auf
+    const int packetSize = LoRa.parsePacket();
+    LoRaRxPacket* slot = nullptr;
+    if (packetSize > (int)LORA_FRAME_MAX_LEN) s_oversize = s_oversize + 1;
+    else if (packetSize > 0 && !(slot = s_ring.claim())) s_overruns = s_overruns + 1;
+    if (slot) {
+        slot->ms = ms;
+        slot->us = us;
+        size_t n = 0;
+        while (n < (size_t)packetSize && LoRa.available()) slot->data[n++] = (uint8_t)LoRa.read();
+        slot->len = (uint8_t)n;
+        slot->rssi = (int16_t)LoRa.packetRssi();
+        slot->snr = LoRa.packetSnr();
+    }
+    LoRa.receive();
+    if (slot) {
+        s_ring.publish();
+        s_received = s_received + 1;
+    }
+}
+
+LoRaRxPacket* loraRxFront()
+{
+    return s_ring.front();
+}
+
+void loraRxPop()
+{
+    s_ring.pop();
+}
+
+void loraRxWait(uint32_t timeoutMs)
+{
+    s_waiter = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+}
+
+void loraRxSuspend()
+{
+    detachInterrupt(digitalPinToInterrupt(s_dio0));
+    LoRa.idle();
+}
+
+void loraRxResume()
+{
+    // Ein RxDone vor dem Senden ist mit idle() verfallen
+    portENTER_CRITICAL(&s_mux);
+    s_handled = s_irqs;
+    portEXIT_CRITICAL(&s_mux);
+    loraRxBegin(s_dio0);
+}
+
+LoRaRxStats loraRxStats()
+{
+    LoRaRxStats s;
+    s.received = s_received;
+    s.overruns = s_overruns;
+    s.oversize = s_oversize;
+    s.highWater = (uint32_t)s_ring.highWater();
+    return s;
+}
@@ -9,25 +9,48 @@
 #include <Adafruit_SSD1306.h>
 #include <ArduinoOTA.h>
 #include <WebServer.h>
-#include <memory>
+#include <atomic>
 #include <cstring>
-// Krypto-Helfer aus common
+#include <time.h>
+// Krypto-Helfer und Frame-Codec aus common
 #include "crypto.h"
+#include "lora_frame.h"
+#include "payload.h"
+#include "replay_guard.h"
+#include "sensor_sessions.h"
+#include "lora_rx.h"
+#include "downlink.h"
+#include "command_queue.h"
+#include "adr_manager.h"
+#include "alert_manager.h"
+#include "forecast_monitor.h"
+#include "sensor_registry.h"
+#include "duty_cycle.h"
+#include "lora_airtime.h"
+#include "history.h"
+#include "history_api.h"
+#include "webui.h"
+#include "pipeline.h"
+#include "pump_monitor.h"
+#include "sse.h"
 
 WiFiClient espClient;
 PubSubClient mqttClient(espClient);
+// Größte Nutzlast, die das Gateway baut (Pumpen-JSON mit PUMP_CYCLE_MAX_PUMPS Pumpen, ca.
+// 1,1 kB); der Client-Puffer fasst zusätzlich Kopf und Topic, sonst verwirft publish() still
+static const size_t MQTT_PAYLOAD_MAX = 1152;
+static const uint16_t MQTT_BUFFER_BYTES = MQTT_PAYLOAD_MAX + 128;
 WebServer web(80);
 
 static unsigned long g_lastWifiAttempt = 0;
 static unsigned long g_lastMqttAttempt = 0;
-static String g_lastValue = "-";
-static String g_lastStatus = "-";
 static bool g_otaInitialized = false;
+// Verbindungszustand aus dem Netz-Task für OLED/Logik (IP 0 = kein WLAN)
+static std::atomic<bool> g_netMqttUp{false};
+static std::atomic<uint32_t> g_netIp{0};
 
 static void publishDiscovery();
-static void processPayload(const String &payload);
-// Vorwärtsdeklaration, da in buildStatusPage() verwendet
-static String fmtAge(unsigned long sinceMs);
+static void publishAlarmStates();
 // Vorwärtsdeklaration für OLED-Hilfsfunktion
 static void oledPrint(const String &line1, const String &line2);
 static void initOta()
@@ -42,6 +65,9 @@ static void initOta()
 
   ArduinoOTA.onStart([]() {
     Serial.println("OTA Start");
+    pipelineLock();
+    historyFlush(); // gepufferte Messwerte vor dem Neustart sichern
+    pipelineUnlock();
   });
   ArduinoOTA.onEnd([]() {
     Serial.println("\nOTA Ende");
@@ -68,14 +94,9 @@ static const int SCREEN_WIDTH = 128;
 static const int SCREEN_HEIGHT = 64;
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST);
 
-// Anzeige-/Messwertverwaltung
-struct Measurement { String value; String status; unsigned long ts; };
-static const int MAX_MEAS = 4;
-static Measurement g_hist[MAX_MEAS];
-static int g_histCount = 0;
+// Anzeige: letzter Empfang über alle Sensoren (Werte je Sensor im Sensor-Register)
 static unsigned long g_lastLoRaMs = 0;
-static int g_lastRssi = 0;
-static float g_lastSnr = 0.0f; // TODO: optional veröffentlichen oder entfernen
+static uint8_t g_lastSid = 0;
 static bool g_oledOk = false;
 static bool g_oledEnabled = OLED_ENABLED; // zur Laufzeit schaltbar
 
@@ -86,65 +107,6 @@ static bool g_btnStable = true; // HIGH = nicht gedrückt
 static unsigned long g_btnLastChangeMs = 0;
 static unsigned long g_btnPressStartMs = 0;
 
-// Crypto/Packet Parameter
-static const size_t NONCE_LEN = 8;
-static const size_t MAC_LEN = 8; // HMAC-SHA256 gekürzt
-
-// Replay-Schutz: pro Sensor letzte 8 Nonces merken
-struct ReplayMem { uint8_t sensorId; uint64_t nonces[8]; uint8_t count; };
-static ReplayMem g_replay[4] = {0};
-
-static bool isAllowedSensor(uint8_t sid)
-{
-  for (size_t i = 0; i < ALLOWED_SENSOR_IDS_COUNT; ++i)
-    if (ALLOWED_SENSOR_IDS[i] == sid) return true;
-  return false;
-}
-
-static bool replaySeen(uint8_t sid, uint64_t nonce)
-{
-  for (ReplayMem &m : g_replay)
-  {
-    if (m.sensorId == sid)
-    {
-      for (uint8_t i = 0; i < m.count; ++i)
-        if (m.nonces[i] == nonce) return true;
-      return false;
-    }
-  }
-  return false;
-}
-
-static void rememberNonce(uint8_t sid, uint64_t nonce)
-{
-  for (ReplayMem &m : g_replay)
-  {
-    if (m.sensorId == sid || m.sensorId == 0)
-    {
-      if (m.sensorId == 0) { m.sensorId = sid; m.count = 0; }
-      if (m.count < 8) { m.nonces[m.count++] = nonce; }
-      else { for (int i = 7; i > 0; --i) m.nonces[i] = m.nonces[i-1]; m.nonces[0] = nonce; }
-      return;
-    }
-  }
-  // Fällt durch, wenn mehr als 4 Sensoren -> überschreiben Slot 0
-  g_replay[0].sensorId = sid; g_replay[0].nonces[0] = nonce; g_replay[0].count = 1;
-}
-
-// Gemeinsame Krypto-Helfer aus common (ersetzt lokale Implementierung)
-static inline bool hmac_trunc(const uint8_t *key, size_t keyLen,
-                              const uint8_t *msg, size_t msgLen,
-                              uint8_t *out, size_t outLen)
-{
-  return hmacSha256Trunc(key, keyLen, msg, msgLen, out, outLen);
-}
-
-static inline bool aes_ctr_crypt(const uint8_t *key, const uint8_t *nonce8,
-                                 uint8_t *data, size_t len)
-{
-  return aesCtrCrypt(key, nonce8, data, len);
-}
-
 static void setOledPower(bool on)
 {
   if (!g_oledOk) { g_oledEnabled = on; return; }
@@ -185,176 +147,494 @@ static void handleButton()
   }
 }
 
-static void sendLoRaCommand(uint8_t targetSid, const String &cmd)
-{
-  // Paketformat wie Sensor-Uplink: [sid(1)][nonce(8)][ciphertext][mac(8)]
-  const size_t NONCE = NONCE_LEN; const size_t MAC = MAC_LEN;
-  uint8_t nonce[NONCE];
-  for (size_t i = 0; i < NONCE; ++i) nonce[i] = (uint8_t)(esp_random() & 0xFF);
-  const size_t ptLen = cmd.length();
-  std::unique_ptr<uint8_t[]> buf(new uint8_t[1 + NONCE + ptLen + MAC]);
-  buf[0] = targetSid;
-  memcpy(buf.get() + 1, nonce, NONCE);
-  // copy plaintext then encrypt in place after header
-  std::unique_ptr<uint8_t[]> ct(new uint8_t[ptLen]);
-  memcpy(ct.get(), (const uint8_t*)cmd.c_str(), ptLen);
-  if (!aes_ctr_crypt(AES_KEY, nonce, ct.get(), ptLen)) return;
-  memcpy(buf.get() + 1 + NONCE, ct.get(), ptLen);
-  // MAC über (sid|nonce|ciphertext)
-  uint8_t mac[MAC];
-  if (!hmac_trunc(HMAC_KEY, sizeof(HMAC_KEY), buf.get(), 1 + NONCE + ptLen, mac, MAC)) return;
-  memcpy(buf.get() + 1 + NONCE + ptLen, mac, MAC);
-  // Senden
-  LoRa.beginPacket();
-  LoRa.write(buf.get(), 1 + NONCE + ptLen + MAC);
-  LoRa.endPacket();
-}
-
-static String htmlEscape(const String &s)
-{
-  String o; o.reserve(s.length()+8);
-  for (size_t i=0;i<s.length();++i){char c=s[i];
-    if(c=='&') o+="&amp;"; else if(c=='<') o+="&lt;"; else if(c=='>') o+="&gt;"; else o+=c;}
-  return o;
-}
-
-// OTA-AP Wunschzustand pro Sensor (unbestätigt)
-struct OtaState { uint8_t sid; int8_t desired; unsigned long ts; };
-static OtaState g_otaStates[4] = {{0, -1, 0},{0, -1, 0},{0, -1, 0},{0, -1, 0}};
-static void setOtaDesired(uint8_t sid, bool on)
-{
-  for (auto &x : g_otaStates) {
-    if (x.sid == sid || x.sid == 0) { if (x.sid == 0) x.sid = sid; x.desired = on?1:0; x.ts = millis(); return; }
-  }
-  g_otaStates[0] = {sid, (int8_t)(on?1:0), millis()};
-}
-static int8_t getOtaDesired(uint8_t sid)
-{
-  for (auto &x : g_otaStates) if (x.sid == sid) return x.desired;
-  return -1;
-}
-
-static String buildStatusPage()
-{
-  String ip = (WiFi.status() == WL_CONNECTED) ? WiFi.localIP().toString() : String("-");
-  String wifi = (WiFi.status() == WL_CONNECTED) ? String("verbunden") : String("--");
-  String mqtt = mqttClient.connected()? String("verbunden") : String("--");
-  String loraAge = g_lastLoRaMs ? fmtAge(millis()-g_lastLoRaMs) : String("--");
-
-  String html;
-  html += F("<!doctype html><html><head><meta charset='utf-8'><meta name='viewport' content='width=device-width,initial-scale=1'>");
-  html += F("<title>Drainage Gateway</title><style>");
-  html += F("body{font-family:system-ui,-apple-system,Segoe UI,Roboto,Ubuntu,sans-serif;margin:0;background:#f6f7fb;color:#222}");
-  html += F("header{display:flex;align-items:center;gap:12px;padding:12px 16px;background:#1f2937;color:#fff}");
-  html += F("main{padding:16px;display:grid;grid-template-columns:1fr;gap:16px;max-width:900px;margin:0 auto}");
-  html += F(".card{background:#fff;border:1px solid #e5e7eb;border-radius:10px;box-shadow:0 1px 2px rgba(0,0,0,.04)}");
-  html += F(".card h2{margin:0;padding:12px 16px;border-bottom:1px solid #eee;font-size:16px}");
-  html += F(".card .body{padding:12px 16px}");
-  html += F("table{border-collapse:collapse;width:100%} td,th{border:1px solid #e5e7eb;padding:8px;text-align:left}");
-  html += F(".row{display:flex;gap:16px;align-items:flex-start;flex-wrap:wrap}");
-  html += F(".muted{color:#6b7280;font-size:12px}");
-  html += F(".btn{display:inline-block;margin-right:8px;padding:8px 10px;border-radius:8px;border:1px solid #d1d5db;background:#f9fafb}");
-  html += F(".btn:hover{background:#f3f4f6}");
-  html += F(".badge{display:inline-block;padding:2px 8px;border-radius:999px;background:#eef2ff;color:#3730a3;border:1px solid #c7d2fe;font-size:12px}");
-  html += F("img.pump{width:120px;height:auto;border:1px solid #e5e7eb;border-radius:8px;background:#fff}");
-  html += F("</style></head><body>");
-  html += F("<header style='padding:12px 16px;background:#1f2937;color:#fff;margin-bottom:16px;'>");
-  html += F("<div style='font-size:18px;font-weight:600'>Drainage Gateway</div>");
-  html += F("<div class='muted'>LoRa · WLAN · MQTT</div>");
-  html += F("</header>");
-  html += F("<main>");
-  html += F("<section class='card'><h2>Status</h2><div class='body'>");
-  html += F("<div class='row'>");
-  html += F("<div style='flex:1;min-width:260px'><table>");
-  html += F("<tr><th>WLAN</th><td>"); html += htmlEscape(wifi); html += F("</td></tr>");
-  html += F("<tr><th>IP</th><td>"); html += htmlEscape(ip); html += F("</td></tr>");
-  html += F("<tr><th>MQTT</th><td>"); html += htmlEscape(mqtt); html += F("</td></tr>");
-  html += F("<tr><th>LoRa letzte RX</th><td>"); html += htmlEscape(loraAge); html += F("</td></tr>");
-  html += F("<tr><th>RSSI</th><td>"); html += String(g_lastRssi); html += F("</td></tr>");
-  // OTA-AP Status (gewünschter Zustand, unbestätigt)
-  int8_t ota = getOtaDesired(1);
-  html += F("<tr><th>Drainage WLAN-AP</th><td>");
-  if (ota < 0) html += F("<span class='badge'>unbekannt</span>");
-  else if (ota == 1) html += F("<span class='badge'>Eingeschaltet</span>");
-  else html += F("<span class='badge'>Ausgeschaltet</span>");
-  html += F("</td></tr>");
-  html += F("</table></div>");
-  html += F("</div></div></section>");
-
-  html += F("<section class='card'><h2>Letzte Messwerte</h2><div class='body'><table><tr><th>#</th><th>Wert (cm)</th><th>Alter</th></tr>");
-  for (int i=0;i<g_histCount;i++){
-    unsigned long a = millis()-g_hist[i].ts;
-    html += F("<tr><td>"); html += String(i+1);
-    html += F("</td><td>"); html += htmlEscape(g_hist[i].value);
-    html += F("</td><td>"); html += htmlEscape(fmtAge(a)); html += F("</td></tr>");
-  }
-  html += F("</table></div></section>");
-
-  html += F("<section class='card'><h2>Sensor OTA-AP steuern</h2><div class='body'>");
-  html += F("<form method='POST' action='/sensor/ota'>");
-  html += F("Sensor-ID: <input type='number' name='sid' min='1' max='255' value='1'>\n");
-  html += F("<button class='btn' name='enable' value='1' type='submit'>AP einschalten</button>\n");
-  html += F("<button class='btn' name='enable' value='0' type='submit'>AP ausschalten</button>\n");
-  html += F("</form>");
-  html += F("<div class='muted'>Hinweis: Status basiert auf dem zuletzt angeforderten Zustand (ohne Bestätigung).</div>");
-  html += F("</div></section>");
-
-  // Schwellwerte-Beschreibung
-  html += F("<section class='card'><h2>Wasserstand · Schwellwerte</h2><div class='body'>");
-  html += F("<p>Die wichtigsten Schwellenwerte für den Wasserstand im Drainageschacht:</p>");
-  html += F("<div style='margin: 16px 0;'><b>🟢 Normaler Bereich (bis 30 cm)</b><ul><li><b>Pumpe 1 \"Jung U5 KS\":</b> Hält den Wasserstand bei unter <b>19cm</b>.</li></ul></div>");
-  html += F("<div style='margin: 16px 0;'><b>🟡 Erhöter Bereich (bis 65 cm)</b><ul><li><b>Pumpe 2 \"Makita PF1110\":</b> Springt an bei <b>56 cm</b> pumt ab auf <b>37cm</b>.</li></ul></div>");
-  html += F("<div style='margin: 16px 0;'><b>🟠 Hoher Wasserstand (bis 80 cm)</b><ul><li><b>Drainage-Zulauf Bodenplatte:</b> Etwa auf Höhe <b>80-90cm</b>.</li></ul></div>");
-  html += F("<div style='margin: 16px 0;'><b>🔴 Kritischer Bereich (ab 180 cm)</b><ul><li><b>Drainage-Zulauf Kellerfenster:</b> Etwa auf Höhe <b>180-190cm</b>.</li><li><b>Wassereintritt:</b> Bei einem Wasserstand von <b>±230cm</b> kommt es zu einem sicheren Wassereintritt im Keller.</li></ul></div>");
-  html += F("</div></section>");
-
-  html += F("</main></body></html>");
-  return html;
-}
-
-static void handleRoot(){ String html = buildStatusPage(); web.send(200, "text/html; charset=utf-8", html); }
+// Duty-Cycle-Konto des Gateways (alle Downlinks, gleitende Stunde)
+static DutyCycle g_duty;
+
+static uint32_t downlinkToaUs(size_t frameLen)
+{
+  return loraTimeOnAirUs(loraModulationDefault(adrGatewaySf()), frameLen);
+}
+
+// Passt der längste Befehl noch ins Budget? Vor commandNextDownlink() prüfen, damit ein
+// zurückgestellter Befehl keinen Zustellversuch verbraucht.
+static bool downlinkAllowed()
+{
+  return dutyCycleRemainingUs(&g_duty, millis()) >=
+         downlinkToaUs(LORA_FRAME_OVERHEAD + DOWNLINK_HDR_LEN + DOWNLINK_MAX_ARGS);
+}
+
+// Altersangabe wie fmtAge(), ohne String
+static void printAge(WebWriter &out, unsigned long sinceMs)
+{
+  unsigned long s = sinceMs / 1000UL;
+  if (s < 60) { out.printf("%lus", s); return; }
+  unsigned long m = s / 60UL; s %= 60UL;
+  if (m < 60) { if (s) out.printf("%lum %lus", m, s); else out.printf("%lum", m); return; }
+  unsigned long h = m / 60UL; m %= 60UL;
+  if (m) out.printf("%luh %lum", h, m); else out.printf("%luh", h);
+}
+
+// Zeitspannen bis Monate (millis-Differenzen laufen nach ~49 Tagen über)
+static void printSpan(WebWriter &out, uint32_t sec)
+{
+  if (sec < 86400UL) { printAge(out, sec * 1000UL); return; }
+  uint32_t d = sec / 86400UL, h = (sec % 86400UL) / 3600UL;
+  if (h) out.printf("%lud %luh", (unsigned long)d, (unsigned long)h); else out.printf("%lud", (unsigned long)d);
+}
+
+// Klartext einer Alarmregel; kurz = für das OLED (21 Zeichen je Zeile)
+static void alarmLabel(uint8_t rule, char *buf, size_t len, bool brief)
+{
+  const AlertRule &r = alertManagerRules()[rule];
+  switch (r.kind)
+  {
+  case ALERT_LEVEL: snprintf(buf, len, brief ? "Pegel >=%gcm" : "Pegel ab %g cm", r.threshold / 10.0); break;
+  case ALERT_RISE: snprintf(buf, len, brief ? "Anstieg >=%gcm/h" : "Anstieg ab %g cm/h", r.threshold / 10.0); break;
+  default: snprintf(buf, len, brief ? "Sensor still" : "Sensor verstummt"); break;
+  }
+}
+
+// Zeit bis zu einer Höhe auf Minuten gerundet; kurz = für das OLED ("42m", "3h05")
+static void fmtEta(char *buf, size_t len, uint32_t sec, bool brief)
+{
+  const unsigned long m = (sec + 30UL) / 60UL;
+  if (m < 60) snprintf(buf, len, brief ? "%lum" : "%lu min", m);
+  else snprintf(buf, len, brief ? "%luh%02lu" : "%lu h %02lu min", m / 60UL, m % 60UL);
+}
+
+// Prognose für eine Höhe (Zelle wie der Live-Feed "forecast" sie setzt)
+static void printForecastEta(WebWriter &out, const ForecastEta &e)
+{
+  char eta[20], early[20], late[20];
+  if (e.status == FORECAST_REACHED) { out.print(F("<b>erreicht</b>")); return; }
+  if (e.status != FORECAST_ETA) { out.print(F("-")); return; }
+  fmtEta(eta, sizeof(eta), e.etaS, false);
+  fmtEta(early, sizeof(early), e.earlyS, false);
+  if (e.lateS == FORECAST_OPEN) snprintf(late, sizeof(late), "offen");
+  else fmtEta(late, sizeof(late), e.lateS, false);
+  out.printf("in %s <span class='muted'>(%s &ndash; %s)</span>", eta, early, late);
+}
+
+// OTA-AP Status: vom Sensor quittierter Zustand, dazu ein offener Befehl
+static void printOtaCell(WebWriter &out, uint8_t sid)
+{
+  OtaApStatus ota = commandOtaApStatus(sid);
+  if (ota.confirmed < 0) out.print(F("<span class='badge'>unbekannt</span>"));
+  else if (ota.confirmed == 1) out.print(F("<span class='badge'>Eingeschaltet</span>"));
+  else out.print(F("<span class='badge'>Ausgeschaltet</span>"));
+  if (ota.confirmed >= 0) { out.print(F(" <span class='muted'>bestätigt vor ")); printAge(out, millis() - ota.confirmedMs); out.print(F("</span>")); }
+  if (ota.pending >= 0)
+  {
+    out.print(F(" <span class='badge'>"));
+    out.print(ota.pending ? F("Einschalten") : F("Ausschalten"));
+    out.print(F(" ausstehend, Versuch ")); out.print((unsigned)ota.attempts); out.print(F("</span>"));
+  }
+  else if (ota.lastExpired) out.print(F(" <span class='badge'>letzter Befehl unbestätigt abgelaufen</span>"));
+  else if (ota.lastAckStatus == DL_ACK_REJECTED) out.print(F(" <span class='badge'>vom Sensor abgelehnt</span>"));
+}
+
+static void printSensorRow(WebWriter &out, uint8_t sid)
+{
+  const SensorRecord *r = sensorRegistryFind(sid);
+  const SensorSample *last = sensorRecordLatest(r);
+  // ids: Ziel der Live-Aktualisierung per /events (Skript in STATUS_PAGE)
+  out.print(F("<tr><td>")); out.print((unsigned)sid); out.printf("</td><td id='lvl-%u'>", (unsigned)sid);
+  if (last && last->ok) { out.print(last->depthMm / 10.0f, 1); out.print(F(" cm")); }
+  else out.print(F("-"));
+  if (r->trendValid)
+  {
+    // Tendenz aus dem Pegelfilter des Sensors (unter 0,5 cm/h gilt als gleichbleibend)
+    out.print(r->trendMmPerH >= 5 ? F(" &uarr; ") : (r->trendMmPerH <= -5 ? F(" &darr; ") : F(" &rarr; ")));
+    out.print(r->trendMmPerH / 10.0f, 1); out.print(F(" cm/h"));
+  }
+  out.print(F(" <span class='muted'>vor ")); printAge(out, millis() - r->lastRxMs); out.print(F("</span>"));
+  out.printf("</td><td><span class='badge' id='hl-%u'>", (unsigned)sid); out.print(sensorHealthName(sensorRegistryHealth(r, millis())));
+  out.print(F("</span> <span class='muted'>Seq ")); out.print((unsigned)r->seq);
+  out.print(F(", ")); out.print((unsigned long)r->lost); out.print(F(" verloren (")); out.print(sensorRecordLossPermille(r) / 10.0f, 1);
+  out.printf(" %%)</span></td><td><span id='rf-%u'>", (unsigned)sid); out.print((int)r->rssi); out.print(F(" dBm, SNR "));
+  out.print(r->snrX4 / 4.0f, 1); out.print(F(" dB</span>"));
+  // Linkqualität und ADR-Vorgaben
+  AdrStatus adr = adrStatus(sid);
+  if (adr.frames)
+  {
+    out.print(F("<br><span class='muted'>Reserve ")); out.print(adr.marginDb, 1);
+    out.print(F(" dB (SNR Mittel ")); out.print(adr.meanSnr, 1); out.print(F(" / max "));
+    out.print(adr.maxSnr, 1); out.print(F(", ")); out.print((unsigned)adr.frames); out.print(F(" Uplinks)</span>"));
+  }
+  out.printf("</td><td><span id='adr-%u'>", (unsigned)sid);
+  if (adr.known) { out.print(F("SF")); out.print((unsigned)adr.current.sf); out.print(F(", ")); out.print((int)adr.current.txPowerDbm); out.print(F(" dBm")); }
+  else out.print(F("-"));
+  out.print(F("</span>"));
+  if (adr.lastToaUs) { out.print(F(" <span class='muted'>")); out.print(adr.lastToaUs / 1000.0f, 1); out.print(F(" ms</span>")); }
+  if (r->airtimeMs || r->txDeferred)
+  {
+    out.print(F("<br><span class='muted'>Sendezeit ")); out.print(r->airtimeMs / 1000.0f, 1); out.print(F(" s/h"));
+    if (r->txDeferred) { out.print(F(", ")); out.print((unsigned)r->txDeferred); out.print(F(" verschoben")); }
+    out.print(F("</span>"));
+  }
+  if (adr.pending) out.print(F(" <span class='badge'>Anpassung läuft</span>"));
+  out.print(F("</td><td>"));
+  printOtaCell(out, sid);
+  out.print(F("</td></tr>"));
+}
+
+// Statusseite: fester Text im Flash, {{name}} wird von renderStatusField() gefüllt
+static const char STATUS_PAGE[] PROGMEM = R"HTML(<!doctype html><html><head><meta charset='utf-8'><meta name='viewport' content='width=device-width,initial-scale=1'>
+<title>Drainage Gateway</title><style>
+body{font-family:system-ui,-apple-system,Segoe UI,Roboto,Ubuntu,sans-serif;margin:0;background:#f6f7fb;color:#222}
+header{display:flex;align-items:center;gap:12px;padding:12px 16px;background:#1f2937;color:#fff}
+main{padding:16px;display:grid;grid-template-columns:1fr;gap:16px;max-width:900px;margin:0 auto}
+.card{background:#fff;border:1px solid #e5e7eb;border-radius:10px;box-shadow:0 1px 2px rgba(0,0,0,.04)}
+.card h2{margin:0;padding:12px 16px;border-bottom:1px solid #eee;font-size:16px}
+.card .body{padding:12px 16px}
+table{border-collapse:collapse;width:100%} td,th{border:1px solid #e5e7eb;padding:8px;text-align:left}
+.row{display:flex;gap:16px;align-items:flex-start;flex-wrap:wrap}
+.muted{color:#6b7280;font-size:12px}
+.btn{display:inline-block;margin-right:8px;padding:8px 10px;border-radius:8px;border:1px solid #d1d5db;background:#f9fafb}
+.btn:hover{background:#f3f4f6}
+.badge{display:inline-block;padding:2px 8px;border-radius:999px;background:#eef2ff;color:#3730a3;border:1px solid #c7d2fe;font-size:12px}
+img.pump{width:120px;height:auto;border:1px solid #e5e7eb;border-radius:8px;background:#fff}
+</style></head><body>
+<header style='padding:12px 16px;background:#1f2937;color:#fff;margin-bottom:16px;'>
+<div style='font-size:18px;font-weight:600'>Drainage Gateway</div>
+<div class='muted'>LoRa · WLAN · MQTT</div>
+</header>
+<main>
+<section class='card'><h2>Status</h2><div class='body'>
+<div class='row'>
+<div style='flex:1;min-width:260px'><table>{{status}}</table></div>
+</div></div></section>
+<section class='card'><h2>Sensoren</h2><div class='body'><table>
+<tr><th>ID</th><th>Wasserstand</th><th>Zustand</th><th>Link</th><th>Funk</th><th>Drainage WLAN-AP</th></tr>
+{{sensors}}</table></div></section>
+<section class='card'><h2>Alarme</h2><div class='body'><table>
+<tr><th>Sensor</th><th>Regel</th><th>Stufe</th><th>Zustand</th></tr>
+{{alarms}}</table>
+<div class='muted'>Geprüft mit jedem Messwert; Wechsel gehen sofort per MQTT (lora/drainage/alarm/&lt;id&gt;/&lt;regel&gt;), an offene Seiten und aufs OLED.</div></div></section>
+<section class='card'><h2>Hochwasser-Prognose</h2><div class='body'><table>
+<tr><th>Sensor</th><th>Höhe</th><th>Voraussichtlich (Band)</th></tr>
+{{forecast}}</table>
+<div class='muted'>Ausgleichsgerade über die letzten Messwerte; das Band gilt bei gleichbleibendem Anstieg. Wird der Regen stärker, kommt der Pegel früher.</div></div></section>
+<section class='card'><h2>Letzte Messwerte</h2><div class='body'><table><tr><th>Sensor</th><th>Wert (cm)</th><th>Alter</th></tr>
+{{latest}}</table></div></section>
+<section class='card'><h2>Verlauf (Stundenwerte)</h2><div class='body'><table>
+<tr><th>Sensor</th><th>Stunde</th><th>Mittel (cm)</th><th>Min (cm)</th><th>Max (cm)</th></tr>
+{{history}}</div></section>
+<section class='card'><h2>Pumpen</h2><div class='body'><table>
+<tr><th>Sensor</th><th>Pumpe</th><th>Ein / Aus (cm)</th><th>Zuletzt (cm)</th><th>Läufe</th><th>Zyklus</th><th>Laufzeit</th><th>Abpumpen</th><th>Zustand</th></tr>
+{{pumps}}</table>
+<div class='muted'>Aus dem Pegelverlauf erkannt (Mittel der letzten Zyklen). Läuft eine Pumpe länger oder senkt sie langsamer ab, lässt sie nach.</div></div></section>
+<section class='card'><h2>Sensor OTA-AP steuern</h2><div class='body'>
+<form method='POST' action='/sensor/ota'>
+Sensor-ID: <input type='number' name='sid' min='1' max='255' value='1'>
+<button class='btn' name='enable' value='1' type='submit'>AP einschalten</button>
+<button class='btn' name='enable' value='0' type='submit'>AP ausschalten</button>
+</form>
+<div class='muted'>Hinweis: Der Befehl wird beim nächsten Uplink des Sensors zugestellt und mit dem darauffolgenden bestätigt.</div>
+</div></section>
+<section class='card'><h2>Wasserstand · Schwellwerte</h2><div class='body'>
+<p>Die wichtigsten Schwellenwerte für den Wasserstand im Drainageschacht:</p>
+<div style='margin: 16px 0;'><b>🟢 Normaler Bereich (bis 30 cm)</b><ul><li><b>Pumpe 1 "Jung U5 KS":</b> Hält den Wasserstand bei unter <b>19cm</b>.</li></ul></div>
+<div style='margin: 16px 0;'><b>🟡 Erhöter Bereich (bis 65 cm)</b><ul><li><b>Pumpe 2 "Makita PF1110":</b> Springt an bei <b>56 cm</b> pumt ab auf <b>37cm</b>.</li></ul></div>
+<div style='margin: 16px 0;'><b>🟠 Hoher Wasserstand (bis 80 cm)</b><ul><li><b>Drainage-Zulauf Bodenplatte:</b> Etwa auf Höhe <b>80-90cm</b>.</li></ul></div>
+<div style='margin: 16px 0;'><b>🔴 Kritischer Bereich (ab 180 cm)</b><ul><li><b>Drainage-Zulauf Kellerfenster:</b> Etwa auf Höhe <b>180-190cm</b>.</li><li><b>Wassereintritt:</b> Bei einem Wasserstand von <b>±230cm</b> kommt es zu einem sicheren Wassereintritt im Keller.</li></ul></div>
+</div></section>
+</main><script>
+(function(){if(!window.EventSource)return;
+var es=new EventSource('/events');
+function set(id,h){var e=document.getElementById(id);if(e)e.innerHTML=h;return e}
+function f(v){return v.toFixed(1)}
+function on(n,fn){es.addEventListener(n,function(e){fn(JSON.parse(e.data))})}
+es.onopen=function(){set('live','verbunden')};
+es.onerror=function(){set('live','getrennt, neuer Versuch ...')};
+on('reading',function(d){
+if(!set('lvl-'+d.sid,(d.cm==null?'-':f(d.cm)+' cm')+(d.trend==null?'':(d.trend>=0.5?' &uarr; ':d.trend<=-0.5?' &darr; ':' &rarr; ')+f(d.trend)+' cm/h')+" <span class='muted'>gerade eben</span>")){location.reload();return}
+set('hl-'+d.sid,d.health);set('rf-'+d.sid,d.rssi+' dBm, SNR '+f(d.snr)+' dB');set('lastrx','gerade eben')});
+on('health',function(d){set('hl-'+d.sid,d.health)});
+on('link',function(d){set('adr-'+d.sid,'SF'+d.sf+', '+d.txp+' dBm')});
+on('alarm',function(d){set('alm-'+d.sid+'-'+d.idx,d.state=='ON'?'<b>AKTIV</b>':'-')});
+function eta(v){var m=Math.round(v);return m<60?m+' min':Math.floor(m/60)+' h '+('0'+m%60).slice(-2)+' min'}
+on('forecast',function(d){set('fcr-'+d.sid,d.valid?(d.rate_cm_h>=0?'+':'')+f(d.rate_cm_h)+' &plusmn; '+f(d.rate_se_cm_h)+' cm/h':'zu wenig Verlauf');
+d.levels.forEach(function(l,i){set('fc-'+d.sid+'-'+i,l.status=='reached'?'<b>erreicht</b>':l.status=='eta'?'in '+eta(l.eta_min)+" <span class='muted'>("+eta(l.early_min)+' &ndash; '+(l.late_min==null?'offen':eta(l.late_min))+')</span>':'-')})});
+on('pump',function(d){set('pmp-'+d.sid+'-'+d.pump,(d.failed?'<b>springt nicht an</b>':d.running?'läuft':'bereit')+(d.failures?" <span class='muted'>("+d.failures+"&times; nicht angesprungen)</span>":''))});
+})();
+</script></body></html>)HTML";
+
+enum StatusField : uint8_t { FIELD_STATUS, FIELD_SENSORS, FIELD_ALARMS, FIELD_FORECAST, FIELD_LATEST, FIELD_HISTORY, FIELD_PUMPS, FIELD_COUNT };
+static const char *const STATUS_FIELDS[FIELD_COUNT] = { "status", "sensors", "alarms", "forecast", "latest", "history", "pumps" };
+
+// Zustellung der Alarme (nur im Netz-Task geschrieben und gelesen)
+struct AlarmStats
+{
+  uint32_t sent;       // per MQTT veröffentlicht
+  uint32_t missed;     // MQTT nicht verbunden (Zustand folgt nach dem Verbindungsaufbau)
+  uint32_t lastUs;     // Erkennung -> MQTT veröffentlicht
+  uint32_t maxUs;
+  uint32_t rxMaxUs;    // Funkempfang (ISR) -> MQTT veröffentlicht
+};
+static AlarmStats g_alarmStats = {};
+
+static void printStatusTable(WebWriter &out)
+{
+  const bool wifiUp = WiFi.status() == WL_CONNECTED;
+  out.print(F("<tr><th>WLAN</th><td>")); out.print(wifiUp ? F("verbunden") : F("--")); out.print(F("</td></tr>"));
+  out.print(F("<tr><th>IP</th><td>")); out.printEscaped(wifiUp ? WiFi.localIP().toString().c_str() : "-"); out.print(F("</td></tr>"));
+  out.print(F("<tr><th>MQTT</th><td>")); out.print(mqttClient.connected() ? F("verbunden") : F("--")); out.print(F("</td></tr>"));
+  out.print(F("<tr><th>Live</th><td id='live'>--</td></tr>"));
+  out.print(F("<tr><th>LoRa letzte RX</th><td id='lastrx'>"));
+  if (g_lastLoRaMs) printAge(out, millis() - g_lastLoRaMs); else out.print(F("--"));
+  out.print(F("</td></tr>"));
+  out.print(F("<tr><th>Funk</th><td>SF")); out.print((unsigned)adrGatewaySf()); out.print(F("</td></tr>"));
+  out.print(F("<tr><th>Sendezeit (1 h)</th><td>")); out.print(dutyCycleUsedUs(&g_duty, millis()) / 1000000.0f, 2);
+  out.print(F(" s von ")); out.print(g_duty.budgetUs / 1000000.0f, 0); out.print(F(" s"));
+  if (g_duty.deferred) { out.print(F(" <span class='badge'>")); out.print((unsigned long)g_duty.deferred); out.print(F(" Downlinks zurückgestellt</span>")); }
+  out.print(F("</td></tr>"));
+  LoRaRxStats rx = loraRxStats();
+  out.print(F("<tr><th>LoRa RX</th><td>")); out.print((unsigned long)rx.received); out.print(F(" empfangen, "));
+  out.print((unsigned long)rx.overruns); out.print(F(" verloren (Ring voll), max. Füllung "));
+  out.print((unsigned long)rx.highWater); out.print(F("/")); out.print((unsigned)LORA_RX_RING_SLOTS); out.print(F("</td></tr>"));
+  // Tasks: Füllung der Ringe (jetzt/max./Plätze), Verluste, Stack-Reserve und Latenz ab ISR
+  PipelineStats ps = pipelineStats();
+  const PipelineQueueStats *queues[4] = { &ps.uplinks, &ps.radioJobs, &ps.events, &ps.alarms };
+  static const char *const QUEUE_NAMES[4] = { "Uplinks", "Funkaufträge", "Ereignisse", "Alarme" };
+  out.print(F("<tr><th>Tasks</th><td>"));
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    out.printf("%s %u/%u/%u", QUEUE_NAMES[i], (unsigned)queues[i]->depth, (unsigned)queues[i]->highWater, (unsigned)queues[i]->slots);
+    if (queues[i]->dropped) { out.print(F(" <b>")); out.print((unsigned long)queues[i]->dropped); out.print(F(" verworfen</b>")); }
+    out.print(F(", "));
+  }
+  out.printf("Stack frei Funk %lu / Logik %lu / Netz %lu B", (unsigned long)ps.stackFree[PIPELINE_RADIO],
+             (unsigned long)ps.stackFree[PIPELINE_LOGIC], (unsigned long)ps.stackFree[PIPELINE_NET]);
+  out.print(F("<br><span class='muted'>Latenz max. Entschlüsselung ")); out.print(ps.rxLatencyMaxUs / 1000.0f, 1);
+  out.print(F(" ms, Auswertung ")); out.print(ps.logicLatencyMaxUs / 1000.0f, 1);
+  out.printf(" ms; %lu Frames abgewiesen, %lu Downlinks zu spät</span></td></tr>", (unsigned long)ps.rejected, (unsigned long)ps.downlinksLate);
+  // Alarme: Latenz von der Erkennung (bzw. vom Funkempfang) bis MQTT
+  out.print(F("<tr><th>Alarme</th><td>")); out.print((unsigned long)g_alarmStats.sent); out.print(F(" gemeldet"));
+  if (g_alarmStats.missed) { out.print(F(", ")); out.print((unsigned long)g_alarmStats.missed); out.print(F(" ohne MQTT")); }
+  if (g_alarmStats.sent)
+  {
+    out.print(F("<br><span class='muted'>Erkennung bis MQTT zuletzt ")); out.print(g_alarmStats.lastUs / 1000.0f, 1);
+    out.print(F(" ms, max. ")); out.print(g_alarmStats.maxUs / 1000.0f, 1);
+    out.print(F(" ms; Empfang bis MQTT max. ")); out.print(g_alarmStats.rxMaxUs / 1000.0f, 1); out.print(F(" ms</span>"));
+  }
+  out.print(F("</td></tr>"));
+}
+
+// Alarmregeln je Sensor mit aktuellem Zustand (Zelle wie der Live-Feed "alarm" sie setzt)
+static void printAlarms(WebWriter &out)
+{
+  static const char *const SEVERITY_NAMES[3] = { "Info", "Warnung", "kritisch" };
+  const AlertRule *rules = alertManagerRules();
+  bool any = false;
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const AlertState *st = alertManagerFind((uint8_t)sid);
+    if (!st) continue;
+    for (uint8_t i = 0; i < alertManagerRuleCount(); ++i)
+    {
+      const AlertRule &r = rules[i];
+      char label[32];
+      alarmLabel(i, label, sizeof(label), false);
+      out.print(F("<tr><td>")); out.print(sid); out.print(F("</td><td>")); out.print(label);
+      if (r.kind == ALERT_LEVEL) out.printf(" <span class='muted'>(zurück unter %g cm, %u Werte)</span>", (r.threshold - r.hysteresis) / 10.0, (unsigned)(r.debounce ? r.debounce : 1));
+      else if (r.kind == ALERT_RISE) out.printf(" <span class='muted'>(zurück unter %g cm/h)</span>", (r.threshold - r.hysteresis) / 10.0);
+      out.print(F("</td><td>")); out.print(SEVERITY_NAMES[r.severity < 3 ? r.severity : 2]);
+      out.printf("</td><td id='alm-%u-%u'>", (unsigned)sid, (unsigned)i);
+      out.print(st->rule[i].active ? F("<b>AKTIV</b>") : F("-"));
+      out.print(F("</td></tr>"));
+      any = true;
+    }
+  }
+  if (!any) out.print(F("<tr><td colspan='4' class='muted'>noch kein Sensor empfangen</td></tr>"));
+}
+
+// Prognose je Sensor und Höhe, darunter der Anstieg der Ausgleichsgeraden
+static void printForecast(WebWriter &out)
+{
+  const ForecastConfig &cfg = forecastMonitorConfig();
+  bool any = false;
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const ForecastResult *fc = forecastMonitorFind((uint8_t)sid);
+    if (!fc) continue;
+    for (uint8_t l = 0; l < cfg.levelCount; ++l)
+    {
+      out.print(F("<tr><td>")); out.print(sid); out.print(F("</td><td>")); out.printEscaped(forecastMonitorName(l));
+      out.print(F(" (")); out.print(cfg.levelsMm[l] / 10.0f, 0); out.print(F(" cm)"));
+      out.printf("</td><td id='fc-%u-%u'>", (unsigned)sid, (unsigned)l); printForecastEta(out, fc->eta[l]);
+      out.print(F("</td></tr>"));
+    }
+    out.print(F("<tr><td>")); out.print(sid); out.printf("</td><td class='muted'>Anstieg</td><td id='fcr-%u'>", (unsigned)sid);
+    if (fc->valid) out.printf("%+.1f &plusmn; %.1f cm/h", fc->rateMmPerH / 10.0f, fc->rateSeMmPerH / 10.0f);
+    else out.print(F("zu wenig Verlauf"));
+    out.print(F("</td></tr>"));
+    any = true;
+  }
+  if (!any) out.print(F("<tr><td colspan='3' class='muted'>noch kein Sensor empfangen</td></tr>"));
+}
+
+static void printLatestRows(WebWriter &out)
+{
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const SensorRecord *r = sensorRegistryFind((uint8_t)sid);
+    for (uint8_t i = 0; i < r->histCount; ++i)
+    {
+      out.print(F("<tr><td>")); out.print(sid);
+      out.print(F("</td><td>")); if (r->hist[i].ok) out.print(r->hist[i].depthMm / 10.0f, 1); else out.print(F("Fehler"));
+      out.print(F("</td><td>")); printAge(out, millis() - r->hist[i].ms); out.print(F("</td></tr>"));
+    }
+  }
+}
+
+// Verlauf: Stundenwerte der letzten 12 h je Sensor (neueste zuerst) und Füllstand der Speicher
+static void printHistory(WebWriter &out)
+{
+  static const char *const TIER_NAMES[TS_TIER_COUNT] = { "Minuten", "Stunden", "Tage" };
+  const uint32_t nowSec = historyNowSec();
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const TsStore *st = historyFind((uint8_t)sid);
+    if (!st) continue;
+    TsPoint pts[12]; size_t n = 0; // 12 Stunden-Intervalle inkl. der laufenden Stunde
+    TsCursor c;
+    tsStoreScan(st, TS_HOUR, nowSec > 11UL * 3600UL ? nowSec - 11UL * 3600UL : 0, nowSec, &c);
+    while (n < 12 && tsCursorNext(&c, &pts[n])) ++n;
+    while (n-- > 0)
+    {
+      out.print(F("<tr><td>")); out.print(sid);
+      out.print(F("</td><td>")); printSpan(out, nowSec - pts[n].t);
+      out.print(F("</td><td>")); out.print(pts[n].avg / 10.0f, 1);
+      out.print(F("</td><td>")); out.print(pts[n].min / 10.0f, 1);
+      out.print(F("</td><td>")); out.print(pts[n].max / 10.0f, 1); out.print(F("</td></tr>"));
+    }
+  }
+  out.print(F("</table>"));
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const TsStore *st = historyFind((uint8_t)sid);
+    if (!st) continue;
+    out.print(F("<div class='muted'>Sensor ")); out.print(sid);
+    out.print(F(" (<a href='/api/history?sid=")); out.print(sid); out.print(F("&amp;format=csv'>CSV 24 h</a>):"));
+    for (uint8_t i = 0; i < TS_TIER_COUNT; ++i)
+    {
+      const TsSeries &ts = st->tier[i];
+      out.print(F(" ")); out.print(TIER_NAMES[i]); out.print(F(" ")); out.print((unsigned long)ts.points);
+      out.print(F(" Werte (")); out.print(tsSeriesBytesUsed(&ts) / 1024.0f, 1); out.print(F(" von "));
+      out.print(ts.blockCount * TS_BLOCK_BYTES / 1024.0f, 0); out.print(F(" KB"));
+      if (ts.used) { out.print(F(", seit ")); printSpan(out, nowSec - tsSeriesOldest(&ts)); }
+      out.print(i + 1 < TS_TIER_COUNT ? F(");") : F(")"));
+    }
+    out.print(F("</div>"));
+  }
+  if (const FlashLog *log = historyLog())
+  {
+    out.print(F("<div class='muted'>Flash-Log: ")); out.print((unsigned)log->usedSectors); out.print(F("/")); out.print((unsigned)log->sectors);
+    out.print(F(" Sektoren belegt, ")); out.print((unsigned)flashLogPending(log)); out.print(F(" Werte im Puffer"));
+    if (log->ioError) out.print(F(", <b>Schreibfehler</b>"));
+    out.print(F("</div>"));
+  }
+}
+
+// Zustand einer Pumpe (wie der Live-Feed "pump" ihn setzt)
+static void printPumpState(WebWriter &out, const PumpCycleState &st, uint8_t p)
+{
+  const PumpStats &ps = st.pump[p];
+  if (ps.failed) out.print(F("<b>springt nicht an</b>"));
+  else if (st.phase == PUMP_PHASE_DRAINING && st.drainPump == p) out.print(F("läuft"));
+  else out.print(F("bereit"));
+  if (ps.failures) out.printf(" <span class='muted'>(%u&times; nicht angesprungen)</span>", (unsigned)ps.failures);
+}
+
+// Pumpzyklen je Sensor: Soll-Schwellen aus config.h, gemessene Werte aus dem Pegelverlauf
+static void printPumps(WebWriter &out)
+{
+  const PumpCycleConfig &cfg = pumpMonitorConfig();
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const PumpCycleState *st = pumpMonitorFind((uint8_t)sid);
+    if (!st) continue;
+    for (uint8_t p = 0; p < cfg.pumpCount; ++p)
+    {
+      const PumpStats &ps = st->pump[p];
+      out.print(F("<tr><td>")); out.print(sid);
+      out.print(F("</td><td>")); out.printEscaped(pumpMonitorName(p));
+      out.print(F("</td><td>")); out.print(cfg.pumps[p].startMm / 10.0f, 1); out.print(F(" / ")); out.print(cfg.pumps[p].stopMm / 10.0f, 1);
+      out.print(F("</td><td>"));
+      if (ps.cycles) { out.print(ps.lastStartMm / 10.0f, 1); out.print(F(" / ")); out.print(ps.lastStopMm / 10.0f, 1); }
+      else out.print(F("-"));
+      out.print(F("</td><td>")); out.print((unsigned long)ps.cycles);
+      out.print(F("</td><td>")); if (ps.periodCount) printSpan(out, ps.periodS); else out.print(F("-"));
+      out.print(F("</td><td>")); if (ps.cycles) printSpan(out, ps.runS); else out.print(F("-"));
+      out.print(F("</td><td>"));
+      if (ps.cycles) { out.print(ps.drainMmPerH / 10.0f, 1); out.print(F(" cm/h")); } else out.print(F("-"));
+      out.printf("</td><td id='pmp-%u-%u'>", (unsigned)sid, (unsigned)p); printPumpState(out, *st, p);
+      out.print(F("</td></tr>"));
+    }
+    out.print(F("<tr><td>")); out.print(sid); out.print(F("</td><td colspan='8' class='muted'>"));
+    if (st->phase == PUMP_PHASE_DRAINING) { out.printEscaped(pumpMonitorName(st->drainPump)); out.print(F(" pumpt ab")); }
+    else out.print(F("Schacht füllt sich"));
+    if (st->fills)
+    {
+      out.print(F(", Zulauf ")); out.print(st->inflowMmPerH / 10.0f, 1);
+      out.print(F(" cm/h (zuletzt ")); out.print(st->lastInflowMmPerH / 10.0f, 1); out.print(F(" cm/h)"));
+    }
+    out.print(F("</td></tr>"));
+  }
+}
+
+static void renderStatusField(uint8_t field, WebWriter &out)
+{
+  switch (field)
+  {
+  case FIELD_STATUS: printStatusTable(out); break;
+  case FIELD_SENSORS:
+    // Eine Zeile je Sensor aus dem Register
+    if (!sensorRegistryCount()) out.print(F("<tr><td colspan='6' class='muted'>noch kein Sensor empfangen</td></tr>"));
+    for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+      printSensorRow(out, (uint8_t)sid);
+    break;
+  case FIELD_ALARMS: printAlarms(out); break;
+  case FIELD_FORECAST: printForecast(out); break;
+  case FIELD_LATEST: printLatestRows(out); break;
+  case FIELD_HISTORY: printHistory(out); break;
+  case FIELD_PUMPS: printPumps(out); break;
+  }
+}
+
+static const WebPage STATUS_WEB_PAGE = { STATUS_PAGE, STATUS_FIELDS, FIELD_COUNT, renderStatusField, pipelineLock, pipelineUnlock };
+
+static void handleRoot() { webuiServe(web, STATUS_WEB_PAGE); }
 static void handleSensorOta()
 {
   if (!web.hasArg("sid") || !web.hasArg("enable")) { web.send(400, "text/plain", "Bad Request"); return; }
   int sid = web.arg("sid").toInt();
   bool en = web.arg("enable")=="1";
-  String cmd = en ? String("CMD:OTA_AP_ON") : String("CMD:OTA_AP_OFF");
-  sendLoRaCommand((uint8_t)sid, cmd);
-  setOtaDesired((uint8_t)sid, en);
+  pipelineLock();
+  const bool queued = sid >= 1 && sid <= 255 && commandQueueOtaAp((uint8_t)sid, en);
+  if (queued) webuiTouch(); // ausstehender Befehl in der Sensortabelle
+  pipelineUnlock();
+  if (!queued) { web.send(409, "text/plain", "Sensor unbekannt oder Warteschlange voll"); return; }
   web.sendHeader("Location", "/"); web.send(303);
 }
 
-static bool processEncryptedPacketBytes(const uint8_t *buf, size_t len)
-{
-  if (len < 1 + NONCE_LEN + MAC_LEN) return false;
-  uint8_t sid = buf[0];
-  if (!isAllowedSensor(sid)) return false;
-  const uint8_t *nonce = buf + 1;
-  size_t ctLen = len - 1 - NONCE_LEN - MAC_LEN;
-  if (ctLen == 0) return false;
-  const uint8_t *ct = buf + 1 + NONCE_LEN;
-  const uint8_t *mac = buf + 1 + NONCE_LEN + ctLen;
-
-  // MAC prüfen über (sid | nonce | ciphertext)
-  uint8_t calc[MAC_LEN];
-  if (!hmac_trunc(HMAC_KEY, sizeof(HMAC_KEY), buf, 1 + NONCE_LEN + ctLen, calc, MAC_LEN)) return false;
-  if (memcmp(mac, calc, MAC_LEN) != 0) return false;
-
-  // Replay prüfen
-  uint64_t nonce64 = 0; memcpy(&nonce64, nonce, NONCE_LEN);
-  if (replaySeen(sid, nonce64)) return false;
-
-  // Entschlüsseln in-place
-  std::unique_ptr<uint8_t[]> pt(new uint8_t[ctLen+1]);
-  memcpy(pt.get(), ct, ctLen);
-  if (!aes_ctr_crypt(AES_KEY, nonce, pt.get(), ctLen)) return false;
-  pt[ctLen] = 0;
-
-  // Gültig -> merken und verarbeiten
-  rememberNonce(sid, nonce64);
-  String plain = String((const char*)pt.get());
-  processPayload(plain);
-  return true;
+// Offenen Befehl im Empfangsfenster des Sensors senden (nur solange es noch offen ist).
+// Über dem Duty-Cycle-Budget bleibt er für einen späteren Uplink in der Warteschlange.
+static void queueDownlink(const RadioUplink &up)
+{
+  if (millis() - up.ms >= DOWNLINK_TX_DEADLINE_MS || !commandQueued(up.sid)) return;
+  if (!downlinkAllowed())
+  {
+    ++g_duty.deferred;
+    Serial.println("Duty-Cycle: Downlink zurückgestellt");
+    return;
+  }
+  uint8_t cmd[DOWNLINK_HDR_LEN + DOWNLINK_MAX_ARGS];
+  size_t cmdLen = commandNextDownlink(up.sid, millis(), cmd, sizeof(cmd));
+  // Sendezeit schon hier buchen, der Funk-Task verschlüsselt und sendet nur noch
+  if (!cmdLen || !dutyCycleTryConsume(&g_duty, millis(), downlinkToaUs(LORA_FRAME_OVERHEAD + cmdLen))) return;
+  pipelineDownlink(up.sid, up.ms + DOWNLINK_TX_DEADLINE_MS, cmd, cmdLen);
 }
 
 static String fmtAge(unsigned long sinceMs)
@@ -367,14 +647,6 @@ static String fmtAge(unsigned long sinceMs)
   return String(h) + "h" + (m?String(" ")+String(m)+"m":"");
 }
 
-static void addMeasurement(const String &val, const String &stat)
-{
-  for (int i = (g_histCount < (MAX_MEAS-1) ? g_histCount : (MAX_MEAS-1)); i > 0; --i)
-    g_hist[i] = g_hist[i-1];
-  g_hist[0] = { val, stat, millis() };
-  if (g_histCount < MAX_MEAS) g_histCount++;
-}
-
 static void drawStatus()
 {
   if (!g_oledEnabled || !g_oledOk) return;
@@ -386,11 +658,12 @@ static void drawStatus()
   display.setCursor(0, 0);
   display.println("LoRa Drainage GW");
 
-  // Zeile 1: WLAN + IP
-  String ip = (WiFi.status() == WL_CONNECTED) ? WiFi.localIP().toString() : String("-");
+  // Zeile 1: WLAN + IP (Stand aus dem Netz-Task)
+  const uint32_t ipRaw = g_netIp;
+  String ip = ipRaw ? IPAddress(ipRaw).toString() : String("-");
   display.setCursor(0, 10);
   display.print("MQTT:");
-  display.print(mqttClient.connected()?"OK ":"-- ");
+  display.print(g_netMqttUp ? "OK " : "-- ");
   display.print(ip);
 
   // Zeile 2: LoRa letzte RX (direkt unter MQTT-Zeile)
@@ -401,25 +674,80 @@ static void drawStatus()
     display.print("LoRa:");
     display.print(fmtAge(age));
     display.print(" RSSI:");
-    display.println(g_lastRssi);
+    const SensorRecord *last = sensorRegistryFind(g_lastSid);
+    display.println(last ? (int)last->rssi : 0);
   }
   else
   {
     display.println("LoRa: --");
   }
 
-  // Zeilen 3-5: letzte Messwerte
+  // Höchster aktiver Alarm, nächste Höhe laut Prognose und ausgefallene Pumpe (je die erste
+  // gefundene) bleiben sichtbar
   int lineY = 30;
-  for (int i = 0; i < g_histCount && i < 3; ++i)
+  int lines = 0;
+  for (int sid = sensorRegistryNext(-1); sid >= 0 && !lines; sid = sensorRegistryNext(sid))
   {
-    unsigned long a = millis() - g_hist[i].ts;
+    const AlertState *st = alertManagerFind((uint8_t)sid);
+    const int rule = st ? alertHighestActive(alertManagerRules(), alertManagerRuleCount(), *st) : -1;
+    if (rule < 0) continue;
+    char label[24];
+    alarmLabel((uint8_t)rule, label, sizeof(label), true);
     display.setCursor(0, lineY);
-    display.print(i+1);
-    display.print(") ");
-    display.print(g_hist[i].value);
-    display.print("cm ");
-    display.println(fmtAge(a));
+    display.print(alertManagerRules()[rule].severity == ALERT_CRITICAL ? "!!S" : "!S");
+    display.print(sid); display.print(" "); display.println(label);
     lineY += 10;
+    lines = 1;
+  }
+  int before = lines;
+  for (int sid = sensorRegistryNext(-1); sid >= 0 && lines == before; sid = sensorRegistryNext(sid))
+  {
+    const ForecastResult *fc = forecastMonitorFind((uint8_t)sid);
+    for (uint8_t l = 0; fc && l < forecastMonitorConfig().levelCount && lines == before; ++l)
+    {
+      const ForecastEta &e = fc->eta[l];
+      if (e.status != FORECAST_ETA) continue;
+      char early[8], late[8];
+      fmtEta(early, sizeof(early), e.earlyS, true);
+      if (e.lateS == FORECAST_OPEN) snprintf(late, sizeof(late), "?");
+      else fmtEta(late, sizeof(late), e.lateS, true);
+      display.setCursor(0, lineY);
+      display.printf("S%d>%dcm %s-%s", sid, (int)(forecastMonitorConfig().levelsMm[l] / 10), early, late);
+      lineY += 10;
+      ++lines;
+    }
+  }
+  before = lines;
+  for (int sid = sensorRegistryNext(-1); sid >= 0 && lines == before; sid = sensorRegistryNext(sid))
+  {
+    const PumpCycleState *st = pumpMonitorFind((uint8_t)sid);
+    for (uint8_t p = 0; st && p < pumpMonitorConfig().pumpCount && lines == before; ++p)
+    {
+      if (!st->pump[p].failed) continue;
+      display.setCursor(0, lineY);
+      display.print("!S"); display.print(sid); display.print(" ");
+      display.print(pumpMonitorName(p)); display.println(" AUS");
+      lineY += 10;
+      ++lines;
+    }
+  }
+
+  // Zeilen 3-5: ein Sensor -> seine letzten Messwerte, mehrere -> aktueller Wert je Sensor
+  const bool single = sensorRegistryCount() == 1;
+  for (int sid = sensorRegistryNext(-1); sid >= 0 && lines < 3; sid = sensorRegistryNext(sid))
+  {
+    const SensorRecord *r = sensorRegistryFind((uint8_t)sid);
+    for (uint8_t i = 0; i < r->histCount && lines < 3; ++i, ++lines)
+    {
+      display.setCursor(0, lineY);
+      if (single) { display.print(i+1); display.print(") "); }
+      else { display.print("S"); display.print(sid); display.print(" "); }
+      if (r->hist[i].ok) { display.print(r->hist[i].depthMm / 10.0f, 1); display.print("cm "); }
+      else display.print("ERR ");
+      display.println(fmtAge(millis() - r->hist[i].ms));
+      lineY += 10;
+      if (!single) break;
+    }
   }
 
   display.display();
@@ -472,8 +800,8 @@ static void ensureMqtt()
   if (mqttClient.connect(clientId.c_str(), MQTT_USER, MQTT_PASS))
   {
     Serial.println("MQTT verbunden.");
-    publishDiscovery();
-    oledPrint("MQTT verbunden", String(MQTT_HOST));
+    publishDiscovery(); // OLED-Meldung kommt aus dem Logik-Task (g_netMqttUp)
+    publishAlarmStates();
   }
   else
   {
@@ -481,90 +809,642 @@ static void ensureMqtt()
   }
 }
 
-static void publishReadings()
+// Topic je Sensor: <Basis>/<sid>
+static String sensorTopic(const char *base, uint8_t sid)
+{
+  return String(base) + "/" + String(sid);
+}
+
+// publish() mit Meldung bei Fehler (Puffer zu klein, Verbindung abgerissen)
+static bool mqttPublish(const char *topic, const char *payload, bool retained)
+{
+  if (mqttClient.publish(topic, payload, retained)) return true;
+  Serial.printf("MQTT: %s nicht gesendet (%u Byte, rc=%d)\n", topic, (unsigned)strlen(payload), mqttClient.state());
+  return false;
+}
+
+// Veröffentlichen im Netz-Task: nur aus der Kopie im Ereignis, nie aus dem Logik-Zustand
+static void publishReadings(const NetEvent &ev)
 {
+  const SensorRecord *r = &ev.rec;
+  const uint8_t sid = ev.sid;
   if (!mqttClient.connected()) return;
-  if (g_lastValue.length())
+  const SensorSample *last = sensorRecordLatest(r);
+  String value = (last && last->ok) ? String(last->depthMm / 10.0f, 1) : String("");
+  String rssiStr = String((int)r->rssi);
+  if (value.length()) mqttPublish(sensorTopic(TOPIC_WATERLEVEL, sid).c_str(), value.c_str(), true);
+  // RSSI des letzten LoRa-Pakets zusätzlich veröffentlichen (retained)
+  mqttPublish(sensorTopic(TOPIC_RSSI, sid).c_str(), rssiStr.c_str(), true);
+  // Bisherige Topics ohne Sensor-ID für bestehende Auswertungen
+  if (LEGACY_TOPIC_SID && sid == LEGACY_TOPIC_SID)
   {
-    mqttClient.publish(TOPIC_WATERLEVEL, g_lastValue.c_str(), true);
+    if (value.length()) mqttPublish(TOPIC_WATERLEVEL, value.c_str(), true);
+    mqttPublish(TOPIC_RSSI, rssiStr.c_str(), true);
   }
-  // Status-Topic entfällt
-  // RSSI des letzten LoRa-Pakets zusätzlich veröffentlichen (retained)
-  if (g_lastLoRaMs)
+  // Zustand, Sequenz und Verluste als JSON
+  if (r->trendValid)
   {
-    String rssiStr = String(g_lastRssi);
-    mqttClient.publish(TOPIC_RSSI, rssiStr.c_str(), true);
+    String trend = String(r->trendMmPerH / 10.0f, 1);
+    mqttPublish(sensorTopic(TOPIC_TREND, sid).c_str(), trend.c_str(), true);
   }
+  char msg[320];
+  snprintf(msg, sizeof(msg), "{\"health\":\"%s\",\"seq\":%u,\"received\":%lu,\"lost\":%lu,\"loss_pct\":%.1f,\"restarts\":%u,\"snr\":%.1f,\"airtime_ms\":%u,\"tx_deferred\":%u,\"noise_mv\":%.1f,\"boot_to_tx_ms\":%u,\"level_filtered_cm\":%.1f,\"trend_cm_h\":%.1f}",
+           sensorHealthName(sensorRegistryHealth(r, millis())), (unsigned)r->seq,
+           (unsigned long)r->received, (unsigned long)r->lost, sensorRecordLossPermille(r) / 10.0f,
+           (unsigned)r->restarts, r->snrX4 / 4.0f, (unsigned)r->airtimeMs, (unsigned)r->txDeferred,
+           r->noiseMvX10 / 10.0f, (unsigned)r->bootToTxMs, r->filteredMm / 10.0f, r->trendMmPerH / 10.0f);
+  mqttPublish(sensorTopic(TOPIC_SENSOR_STATE, sid).c_str(), msg, true);
+}
+
+// Ältere Messwerte eines Batches einzeln mit Zeitstempel veröffentlichen (nicht retained)
+static void publishSample(uint8_t sid, int32_t depthMm, uint32_t ageSec)
+{
+  if (!mqttClient.connected()) return;
+  char msg[80];
+  time_t now = time(nullptr);
+  if (now > 1600000000) // Uhrzeit per NTP gesetzt
+    snprintf(msg, sizeof(msg), "{\"cm\":%.1f,\"age_s\":%lu,\"ts\":%lu}",
+             depthMm / 10.0f, (unsigned long)ageSec, (unsigned long)(now - ageSec));
+  else
+    snprintf(msg, sizeof(msg), "{\"cm\":%.1f,\"age_s\":%lu}", depthMm / 10.0f, (unsigned long)ageSec);
+  mqttPublish(sensorTopic(TOPIC_SAMPLES, sid).c_str(), msg, false);
+}
+
+// Sendezeit des Gateways in der letzten Stunde und Restbudget (retained)
+static void publishAirtime(const NetEvent &ev)
+{
+  if (!mqttClient.connected()) return;
+  char msg[96];
+  snprintf(msg, sizeof(msg), "{\"used_ms\":%lu,\"remaining_ms\":%lu,\"deferred\":%lu}",
+           (unsigned long)ev.usedMs, (unsigned long)ev.remainingMs, (unsigned long)ev.deferred);
+  mqttPublish(TOPIC_AIRTIME, msg, true);
 }
 
-static void processPayload(const String &payload)
+// Linkqualität je Sensor als JSON (retained): <Topic>/<sid>
+static void publishLink(const NetEvent &ev)
 {
-  Serial.print("LoRa empfangen: ");
-  Serial.println(payload);
+  if (!mqttClient.connected()) return;
+  const AdrStatus &adr = ev.adr;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "{\"rssi\":%d,\"snr\":%.1f,\"margin_db\":%.1f,\"sf\":%u,\"txp\":%d,\"toa_ms\":%.1f}",
+           (int)adr.meanRssi, adr.meanSnr, adr.marginDb, (unsigned)adr.current.sf,
+           (int)adr.current.txPowerDbm, adr.lastToaUs / 1000.0f);
+  mqttPublish(sensorTopic(TOPIC_LINK, ev.sid).c_str(), msg, true);
+}
 
-  // Erwartetes Format (alt): WATER_CM:<wert>;STATUS:<OK|ERR>;MID:<id>
-  // Neu: reine Zahl als Payload, z.B. "18.6"
-  String waterStr = "";
-  String statusStr = "";
+static void publishOtaState(const NetEvent &ev)
+{
+  if (!mqttClient.connected() || ev.otaConfirmed < 0) return;
+  mqttPublish(sensorTopic(TOPIC_OTA_AP, ev.sid).c_str(), ev.otaConfirmed ? "ON" : "OFF", true);
+}
 
-  String s = payload; s.trim();
-  int wIdx = s.indexOf("WATER_CM:");
-  if (wIdx >= 0)
+// Pumpzyklen je Sensor als JSON (retained): <Topic>/<sid>; Werte erst, wenn gemessen
+static void publishPumps(const NetEvent &ev)
+{
+  if (!mqttClient.connected()) return;
+  const PumpCycleState &st = ev.pumps;
+  const PumpCycleConfig &cfg = pumpMonitorConfig();
+  char msg[MQTT_PAYLOAD_MAX];
+  size_t n = snprintf(msg, sizeof(msg), "{\"event\":\"%s\",\"pump\":%u,\"phase\":\"%s\"",
+                      pumpEventName(ev.pumpEvent.kind), (unsigned)ev.pumpEvent.pump, pumpPhaseName(st.phase));
+  if (st.fills)
+    n += snprintf(msg + n, sizeof(msg) - n, ",\"inflow_cm_h\":%.1f,\"inflow_last_cm_h\":%.1f",
+                  st.inflowMmPerH / 10.0f, st.lastInflowMmPerH / 10.0f);
+  n += snprintf(msg + n, sizeof(msg) - n, ",\"pumps\":[");
+  for (uint8_t p = 0; p < cfg.pumpCount && n < sizeof(msg); ++p)
+  {
+    const PumpStats &ps = st.pump[p];
+    n += snprintf(msg + n, sizeof(msg) - n, "%s{\"name\":\"%s\",\"cycles\":%lu,\"failed\":%s,\"failures\":%u",
+                  p ? "," : "", pumpMonitorName(p), (unsigned long)ps.cycles, ps.failed ? "true" : "false", (unsigned)ps.failures);
+    if (n < sizeof(msg) && ps.periodCount)
+      n += snprintf(msg + n, sizeof(msg) - n, ",\"period_min\":%.1f,\"last_period_min\":%.1f", ps.periodS / 60.0f, ps.lastPeriodS / 60.0f);
+    if (n < sizeof(msg) && ps.cycles)
+      n += snprintf(msg + n, sizeof(msg) - n, ",\"run_s\":%lu,\"last_run_s\":%lu,\"drain_cm_h\":%.1f,\"start_cm\":%.1f,\"stop_cm\":%.1f",
+                    (unsigned long)ps.runS, (unsigned long)ps.lastRunS, ps.drainMmPerH / 10.0f, ps.lastStartMm / 10.0f, ps.lastStopMm / 10.0f);
+    if (n < sizeof(msg)) n += snprintf(msg + n, sizeof(msg) - n, "}");
+  }
+  if (n < sizeof(msg)) snprintf(msg + n, sizeof(msg) - n, "]}");
+  if (n + 2 >= sizeof(msg)) // abgeschnitten, kein gültiges JSON
   {
-    int wEnd = s.indexOf(';', wIdx);
-    if (wEnd < 0) wEnd = s.length();
-    waterStr = s.substring(wIdx + 9, wEnd);
-    waterStr.trim();
+    Serial.printf("MQTT: Pumpen-JSON S%u zu lang\n", (unsigned)ev.sid);
+    return;
+  }
+  mqttPublish(sensorTopic(TOPIC_PUMPS, ev.sid).c_str(), msg, true);
+}
 
-    int sIdx = s.indexOf("STATUS:");
-    if (sIdx >= 0)
+// Hochwasser-Prognose als JSON (MQTT und Live-Feed); Minuten, late_min null = nicht absehbar
+static bool forecastJson(const NetEvent &ev, char *msg, size_t len)
+{
+  const ForecastResult &fc = ev.forecast;
+  const ForecastConfig &cfg = forecastMonitorConfig();
+  size_t n = snprintf(msg, len, "{\"sid\":%u,\"valid\":%s,\"cm\":%.1f,\"samples\":%u,\"span_min\":%.1f",
+                      (unsigned)ev.sid, fc.valid ? "true" : "false", fc.levelMm / 10.0f, (unsigned)fc.samples, fc.spanS / 60.0f);
+  if (n < len && fc.valid)
+    n += snprintf(msg + n, len - n, ",\"rate_cm_h\":%.1f,\"rate_se_cm_h\":%.1f", fc.rateMmPerH / 10.0f, fc.rateSeMmPerH / 10.0f);
+  if (n < len) n += snprintf(msg + n, len - n, ",\"levels\":[");
+  for (uint8_t l = 0; l < cfg.levelCount && n < len; ++l)
+  {
+    const ForecastEta &e = fc.eta[l];
+    n += snprintf(msg + n, len - n, "%s{\"name\":\"%s\",\"cm\":%.1f,\"status\":\"%s\"", l ? "," : "",
+                  forecastMonitorName(l), cfg.levelsMm[l] / 10.0f, forecastStatusName(e.status));
+    if (n < len && e.status != FORECAST_NONE)
+      n += snprintf(msg + n, len - n, ",\"eta_min\":%.1f,\"early_min\":%.1f", e.etaS / 60.0f, e.earlyS / 60.0f);
+    if (n < len && e.status != FORECAST_NONE)
     {
-      int sEnd = s.indexOf(';', sIdx);
-      if (sEnd < 0) sEnd = s.length();
-      statusStr = s.substring(sIdx + 7, sEnd);
-      statusStr.trim();
+      if (e.lateS == FORECAST_OPEN) n += snprintf(msg + n, len - n, ",\"late_min\":null");
+      else n += snprintf(msg + n, len - n, ",\"late_min\":%.1f", e.lateS / 60.0f);
     }
+    if (n < len) n += snprintf(msg + n, len - n, "}");
+  }
+  if (n < len) n += snprintf(msg + n, len - n, "]}");
+  return n < len; // sonst abgeschnitten, kein gültiges JSON
+}
+
+// Ringe, Stack-Reserve und Latenzen der Tasks (retained)
+static void publishPipeline()
+{
+  if (!mqttClient.connected()) return;
+  const PipelineStats ps = pipelineStats();
+  const LoRaRxStats rx = loraRxStats();
+  char msg[640];
+  const int n = snprintf(msg, sizeof(msg), "{\"rx_hw\":%lu,\"rx_overruns\":%lu,\"uplink_hw\":%u,\"uplink_dropped\":%lu,\"job_hw\":%u,\"job_dropped\":%lu,\"event_hw\":%u,\"event_dropped\":%lu,\"alarm_hw\":%u,\"alarm_dropped\":%lu,\"stack_radio\":%lu,\"stack_logic\":%lu,\"stack_net\":%lu,\"rx_latency_max_us\":%lu,\"logic_latency_max_us\":%lu,\"rejected\":%lu,\"downlinks_late\":%lu,\"alarms_sent\":%lu,\"alarms_missed\":%lu,\"alarm_latency_last_us\":%lu,\"alarm_latency_max_us\":%lu,\"alarm_rx_latency_max_us\":%lu}",
+           (unsigned long)rx.highWater, (unsigned long)rx.overruns,
+           (unsigned)ps.uplinks.highWater, (unsigned long)ps.uplinks.dropped,
+           (unsigned)ps.radioJobs.highWater, (unsigned long)ps.radioJobs.dropped,
+           (unsigned)ps.events.highWater, (unsigned long)ps.events.dropped,
+           (unsigned)ps.alarms.highWater, (unsigned long)ps.alarms.dropped,
+           (unsigned long)ps.stackFree[PIPELINE_RADIO], (unsigned long)ps.stackFree[PIPELINE_LOGIC],
+           (unsigned long)ps.stackFree[PIPELINE_NET], (unsigned long)ps.rxLatencyMaxUs,
+           (unsigned long)ps.logicLatencyMaxUs, (unsigned long)ps.rejected, (unsigned long)ps.downlinksLate,
+           (unsigned long)g_alarmStats.sent, (unsigned long)g_alarmStats.missed, (unsigned long)g_alarmStats.lastUs,
+           (unsigned long)g_alarmStats.maxUs, (unsigned long)g_alarmStats.rxMaxUs);
+  if (n < 0 || (size_t)n >= sizeof(msg)) return; // abgeschnitten, kein gültiges JSON
+  mqttPublish(TOPIC_PIPELINE, msg, true);
+}
+
+// Alarmwechsel: Zustand retained auf <TOPIC_ALARM>/<sid>/<regel>, dazu das Ereignis als JSON
+// (auch an den Live-Feed). Gemessen wird bis nach dem Veröffentlichen.
+static void publishAlarm(const AlarmEvent &a)
+{
+  const AlertRule &rule = alertManagerRules()[a.rule];
+  const char *key = alertManagerKey(a.rule);
+  const bool stale = rule.kind == ALERT_STALE;
+  char msg[224];
+  int n = snprintf(msg, sizeof(msg), "{\"sid\":%u,\"idx\":%u,\"rule\":\"%s\",\"kind\":\"%s\",\"severity\":\"%s\",\"state\":\"%s\",\"value\":%.1f,\"unit\":\"%s\"",
+                   (unsigned)a.sid, (unsigned)a.rule, key, alertKindName(rule.kind), alertSeverityName(rule.severity),
+                   a.active ? "ON" : "OFF", stale ? (float)a.value : a.value / 10.0f,
+                   stale ? "s" : rule.kind == ALERT_RISE ? "cm/h" : "cm");
+  if (a.rxUs) n += snprintf(msg + n, sizeof(msg) - n, ",\"rx_to_detect_ms\":%.1f", (uint32_t)(a.detectUs - a.rxUs) / 1000.0f);
+  snprintf(msg + n, sizeof(msg) - n, "}");
+  if (mqttClient.connected())
+  {
+    mqttPublish((sensorTopic(TOPIC_ALARM, a.sid) + "/" + key).c_str(), a.active ? "ON" : "OFF", true);
+    mqttPublish(TOPIC_ALARM_EVENT, msg, false);
+    const uint32_t now = micros();
+    g_alarmStats.sent++;
+    g_alarmStats.lastUs = now - a.detectUs;
+    if (g_alarmStats.lastUs > g_alarmStats.maxUs) g_alarmStats.maxUs = g_alarmStats.lastUs;
+    if (a.rxUs && now - a.rxUs > g_alarmStats.rxMaxUs) g_alarmStats.rxMaxUs = now - a.rxUs;
   }
   else
+    g_alarmStats.missed++;
+  if (sseClientCount()) ssePublish("alarm", msg);
+  webuiTouch();
+}
+
+// Alarmzustand aller Sensoren erneut veröffentlichen (nach dem Verbindungsaufbau bzw. wenn
+// Alarme im Ring verworfen wurden); Zustand unter der Sperre kopieren, senden ohne
+static void publishAlarmStates()
+{
+  int sid = -1;
+  while (mqttClient.connected())
   {
-    // numeric-only Pfad: evtl. "cm" Suffix entfernen
-    if (s.endsWith("cm")) s = s.substring(0, s.length()-2);
-    s.trim();
-    // einfache Numerik-Validierung: optionales +/- am Anfang, Ziffern, ein '.' erlaubt
-    bool numeric = true; bool dotSeen = false; int start = 0;
-    if (s.length() == 0) numeric = false;
-    if (numeric && (s[0] == '+' || s[0] == '-')) start = 1;
-    for (int i = start; numeric && i < s.length(); ++i)
+    AlertState st;
+    pipelineLock();
+    sid = sensorRegistryNext(sid);
+    const AlertState *cur = sid >= 0 ? alertManagerFind((uint8_t)sid) : nullptr;
+    if (cur) st = *cur;
+    pipelineUnlock();
+    if (sid < 0) break;
+    if (!cur) continue;
+    for (uint8_t i = 0; i < alertManagerRuleCount(); ++i)
+      mqttPublish((sensorTopic(TOPIC_ALARM, (uint8_t)sid) + "/" + alertManagerKey(i)).c_str(),
+                         st.rule[i].active ? "ON" : "OFF", true);
+  }
+}
+
+static void drainAlarms()
+{
+  AlarmEvent *a;
+  while ((a = pipelineAlarmFront()) != nullptr)
+  {
+    publishAlarm(*a);
+    pipelineAlarmPop();
+  }
+}
+
+// Live-Feed (/events): ein Ereignis je Paket, Linkwechsel und Zustandswechsel
+static void sseReading(const NetEvent &ev)
+{
+  const SensorRecord *r = &ev.rec;
+  const SensorSample *last = sensorRecordLatest(r);
+  char json[256];
+  int n = snprintf(json, sizeof(json), "{\"sid\":%u,\"health\":\"%s\",\"rssi\":%d,\"snr\":%.1f,\"seq\":%u,\"lost\":%lu,\"latency_ms\":%lu",
+                   (unsigned)ev.sid, sensorHealthName(sensorRegistryHealth(r, millis())), (int)r->rssi, r->snrX4 / 4.0f,
+                   (unsigned)r->seq, (unsigned long)r->lost, (unsigned long)(millis() - ev.ms));
+  if (last && last->ok) n += snprintf(json + n, sizeof(json) - n, ",\"cm\":%.1f", last->depthMm / 10.0f);
+  if (r->trendValid) n += snprintf(json + n, sizeof(json) - n, ",\"trend\":%.1f", r->trendMmPerH / 10.0f);
+  snprintf(json + n, sizeof(json) - n, "}");
+  ssePublish("reading", json);
+}
+
+// Zuletzt gesendete Linkwerte je Sensor: "link" nur bei Änderung (Reserve auf 1 dB gerundet)
+struct SseLinkSent
+{
+  bool valid;
+  bool pending;
+  uint8_t sf;
+  int8_t txp;
+  int8_t marginDb;
+};
+static SseLinkSent g_sseLink[256];
+
+static void sseLink(const NetEvent &ev)
+{
+  const AdrStatus &adr = ev.adr;
+  if (!adr.known) return;
+  const SseLinkSent now = { true, adr.pending, adr.current.sf, adr.current.txPowerDbm,
+                            (int8_t)(adr.marginDb + (adr.marginDb < 0 ? -0.5f : 0.5f)) };
+  SseLinkSent &sent = g_sseLink[ev.sid];
+  if (sent.valid && sent.pending == now.pending && sent.sf == now.sf && sent.txp == now.txp && sent.marginDb == now.marginDb) return;
+  sent = now;
+  char json[160];
+  snprintf(json, sizeof(json), "{\"sid\":%u,\"sf\":%u,\"txp\":%d,\"margin_db\":%.1f,\"snr\":%.1f,\"rssi\":%d,\"pending\":%s}",
+           (unsigned)ev.sid, (unsigned)adr.current.sf, (int)adr.current.txPowerDbm, adr.marginDb, adr.meanSnr,
+           (int)adr.meanRssi, adr.pending ? "true" : "false");
+  ssePublish("link", json);
+}
+
+static void ssePump(const NetEvent &ev)
+{
+  const uint8_t p = ev.pumpEvent.pump;
+  const PumpStats &ps = ev.pumps.pump[p];
+  const bool running = ev.pumps.phase == PUMP_PHASE_DRAINING && ev.pumps.drainPump == p;
+  char json[128];
+  snprintf(json, sizeof(json), "{\"sid\":%u,\"pump\":%u,\"event\":\"%s\",\"running\":%s,\"failed\":%s,\"failures\":%u}",
+           (unsigned)ev.sid, (unsigned)p, pumpEventName(ev.pumpEvent.kind), running ? "true" : "false",
+           ps.failed ? "true" : "false", (unsigned)ps.failures);
+  ssePublish("pump", json);
+}
+
+static void sseHealth(const NetEvent &ev)
+{
+  char json[48];
+  snprintf(json, sizeof(json), "{\"sid\":%u,\"health\":\"%s\"}", (unsigned)ev.sid, sensorHealthName((SensorHealth)ev.health));
+  ssePublish("health", json);
+}
+
+static void publishEvent(const NetEvent &ev)
+{
+  switch (ev.kind)
+  {
+  case NET_UPLINK:
+  {
+    char forecast[768];
+    const bool hasForecast = ev.hasForecast && forecastJson(ev, forecast, sizeof(forecast));
+    if (ev.hasForecast && !hasForecast) Serial.printf("MQTT: Prognose-JSON S%u zu lang\n", (unsigned)ev.sid);
+    // Browser zuerst: ein langsamer MQTT-Broker verzögert den Live-Feed nicht
+    if (sseClientCount())
     {
-      char c = s[i];
-      if (c == '.') { if (dotSeen) numeric = false; else dotSeen = true; continue; }
-      if (c < '0' || c > '9') numeric = false;
+      sseReading(ev);
+      sseLink(ev);
+      if (ev.pumpEvent.kind != PUMP_EVENT_NONE) ssePump(ev);
+      if (hasForecast) ssePublish("forecast", forecast);
     }
-    if (numeric) waterStr = s;
+    if (ENCRYPTION_ENABLED) publishLink(ev);
+    publishOtaState(ev);
+    // Alter seit dem Empfang mitrechnen (Ereignis kann im Ring gewartet haben)
+    const uint32_t waitSec = (millis() - ev.ms) / 1000UL;
+    for (uint8_t i = 0; i < ev.sampleCount; ++i)
+      publishSample(ev.sid, ev.samples[i].depthMm, ev.samples[i].ageSec + waitSec);
+    publishReadings(ev);
+    if (ev.pumpEvent.kind != PUMP_EVENT_NONE) publishPumps(ev);
+    if (hasForecast && mqttClient.connected())
+      mqttPublish(sensorTopic(TOPIC_FORECAST, ev.sid).c_str(), forecast, true);
+    break;
+  }
+  case NET_AIRTIME: publishAirtime(ev); break;
+  case NET_HEALTH: sseHealth(ev); break;
   }
+}
 
-  if (waterStr.length() == 0)
+// Alarmregeln direkt im Paketpfad auswerten; Wechsel sofort in den Alarm-Ring (weckt den
+// Netz-Task), protokolliert wird erst danach
+static void raiseAlerts(uint8_t sid, const AlertInput &in, uint32_t rxUs)
+{
+  AlertTransition t[ALERT_MAX_RULES];
+  const size_t n = alertManagerEvaluate(sid, in, t, ALERT_MAX_RULES);
+  for (size_t i = 0; i < n; ++i)
   {
-    statusStr = "parse_error";
+    const AlarmEvent a = { sid, t[i].rule, t[i].active, t[i].value, rxUs, (uint32_t)micros() };
+    const bool queued = pipelineAlarm(a);
+    Serial.printf("  Sensor %u: Alarm %s %s%s\n", (unsigned)sid, alertManagerKey(t[i].rule),
+                  t[i].active ? "EIN" : "AUS", queued ? "" : " (Ring voll, verworfen)");
   }
+  if (n) webuiTouch();
+}
 
-  g_lastValue = waterStr.length() ? waterStr : "-";
-  g_lastStatus = statusStr.length() ? statusStr : "-";
-  g_lastLoRaMs = millis();
-  g_lastRssi = LoRa.packetRssi();
-  g_lastSnr = LoRa.packetSnr(); // TODO: optional veröffentlichen
-  addMeasurement(g_lastValue, g_lastStatus);
+// Messwert in die Pumpzyklen; ein Wechsel geht ins Ereignis (der letzte eines Uplinks zählt)
+static void trackPumps(uint8_t sid, uint32_t tSec, int32_t depthMm, NetEvent *ev)
+{
+  const PumpEvent pe = pumpMonitorAdd(sid, tSec, depthMm);
+  if (pe.kind == PUMP_EVENT_NONE) return;
+  Serial.printf("  Sensor %u: %s %s\n", (unsigned)sid, pumpMonitorName(pe.pump), pumpEventName(pe.kind));
+  if (ev) ev->pumpEvent = pe;
+}
 
-  publishReadings();
-  oledPrint(String("Wasser: ") + g_lastValue + " cm",
-            String("Status: ") + g_lastStatus);
+// Läuft im Logik-Task unter pipelineLock(). ev (nullptr = Netz-Ring voll) erhält die Kopie
+// fürs Veröffentlichen. false = Sensor nicht im Register, nichts ausgewertet.
+static bool processPayload(uint8_t sid, const uint8_t *data, size_t len, const RadioUplink &rx, NetEvent *ev)
+{
+  const unsigned long rxMs = rx.ms; // Empfangszeitpunkt aus der ISR, nicht Auswertezeitpunkt
+  SensorRecord *rec = sensorRegistryGet(sid);
+  if (!rec) return false;
+  if (ev) ev->otaConfirmed = -1;
+  // Ältere Messwerte aus dem BATCH-TLV (neueste zuerst)
+  BatchSample older[PAYLOAD_BATCH_MAX];
+  size_t olderCount = 0;
+  bool trend = false; // ohne TREND-TLV (Filter nicht eingeschwungen, älterer Sensor) kein Trend
+  // Auswertung (Binärformat v2 bzw. ASCII-Altformate) in common/payload
+  PayloadReading r;
+  parsePayload(data, len, &r);
+  if (r.version == PAYLOAD_VERSION_V2)
+  {
+    Serial.printf("LoRa empfangen: v2 seq=%u tiefe_mm=%ld flags=0x%02x\n",
+                  (unsigned)r.seq, (long)r.depthMm, (unsigned)r.flags);
+    size_t pos = 0; PayloadTlv tlv;
+    while (payloadNextTlv(r.ext, r.extLen, &pos, &tlv))
+    {
+      if (tlv.type == PAYLOAD_TLV_RAW_MV && tlv.len == 2)
+        Serial.printf("  mv_raw=%u\n", (unsigned)(tlv.value[0] | (tlv.value[1] << 8)));
+      else if (tlv.type == PAYLOAD_TLV_BATCH)
+      {
+        BatchCursor c;
+        payloadBatchBegin(&c, tlv, r.depthMm);
+        while (olderCount < PAYLOAD_BATCH_MAX && payloadBatchNext(&c, &older[olderCount])) ++olderCount;
+        Serial.printf("  batch=%u aeltere Werte\n", (unsigned)olderCount);
+      }
+      else if (tlv.type == PAYLOAD_TLV_ACK)
+      {
+        size_t apos = 0; DownlinkAck ack; DownlinkCommand done;
+        while (payloadNextAck(tlv, &apos, &ack))
+        {
+          if (!commandHandleAck(sid, ack, &done)) continue;
+          if (done.opcode == DL_OP_OTA_AP) { if (ev) ev->otaConfirmed = commandOtaApStatus(sid).confirmed; }
+          else adrOnAck(sid, done, ack.status);
+        }
+      }
+      else if (tlv.type == PAYLOAD_TLV_RADIO && tlv.len == 2)
+      {
+        RadioSettings radio = { tlv.value[0], (int8_t)tlv.value[1] };
+        adrOnRadioReport(sid, radio);
+      }
+      else if (tlv.type == PAYLOAD_TLV_AIRTIME && tlv.len == 4)
+      {
+        rec->airtimeMs = (uint16_t)(tlv.value[0] | (tlv.value[1] << 8));
+        rec->txDeferred = (uint16_t)(tlv.value[2] | (tlv.value[3] << 8));
+      }
+      else if (tlv.type == PAYLOAD_TLV_NOISE && tlv.len == 2)
+        rec->noiseMvX10 = (uint16_t)(tlv.value[0] | (tlv.value[1] << 8));
+      else if (tlv.type == PAYLOAD_TLV_WAKE && tlv.len == 2)
+        rec->bootToTxMs = (uint16_t)(tlv.value[0] | (tlv.value[1] << 8));
+      else if (tlv.type == PAYLOAD_TLV_TREND && tlv.len == 4)
+      {
+        trend = true;
+        rec->filteredMm = (int16_t)(tlv.value[0] | (tlv.value[1] << 8));
+        rec->trendMmPerH = (int16_t)(tlv.value[2] | (tlv.value[3] << 8));
+        Serial.printf("  gefiltert_mm=%d trend_mm_h=%d\n", (int)rec->filteredMm, (int)rec->trendMmPerH);
+      }
+    }
+  }
+  else
+  {
+    Serial.print("LoRa empfangen: ");
+    Serial.write(data, len);
+    Serial.println();
+  }
+  const bool ok = r.valid && strcmp(r.status, "ERR") != 0;
+  rec->trendValid = trend;
+  uint16_t lost = sensorRecordUplink(rec, rxMs, rx.rssi, rx.snr, r.version == PAYLOAD_VERSION_V2, r.seq);
+  if (lost) Serial.printf("  Sensor %u: %u Uplinks verloren\n", (unsigned)sid, (unsigned)lost);
+  g_lastLoRaMs = rxMs;
+  g_lastSid = sid;
+  webuiTouch();
+  // Batch rückdatiert eintragen: älteste zuerst, damit die Historie sortiert bleibt.
+  // Der BATCH-TLV enthält nur gültige Werte (der Sensor lässt ERR weg), das Fehler-Flag
+  // im Kopf gilt nur für den neuesten Wert
+  // Pumpzyklen mit denselben Zeitstempeln, Alarme mit jedem Messwert (ein Uplink beendet "still")
+  const uint32_t rxSec = historyNowSec() - (uint32_t)((millis() - rxMs) / 1000UL);
+  AlertInput alert = {};
+  alert.hasSilence = true;
+  alert.hasLevel = true;
+  for (size_t i = olderCount; i-- > 0;)
+  {
+    unsigned long ageMs = older[i].ageSec * 1000UL;
+    const uint32_t tSec = older[i].ageSec < rxSec ? rxSec - older[i].ageSec : 0;
+    sensorRecordSample(rec, older[i].depthMm, true, ageMs < rxMs ? rxMs - ageMs : 0);
+    historyAdd(sid, tSec, older[i].depthMm);
+    trackPumps(sid, tSec, older[i].depthMm, ev);
+    forecastMonitorAdd(sid, tSec, older[i].depthMm);
+    alert.levelMm = older[i].depthMm;
+    raiseAlerts(sid, alert, rx.us);
+    if (ev) ev->samples[ev->sampleCount++] = older[i];
+  }
+  sensorRecordSample(rec, r.depthMm, ok, rxMs);
+  if (ok)
+  {
+    historyAdd(sid, rxSec, r.depthMm);
+    trackPumps(sid, rxSec, r.depthMm, ev);
+    forecastMonitorAdd(sid, rxSec, r.depthMm);
+  }
+  const ForecastResult *fc = forecastMonitorUpdate(sid);
+  for (uint8_t l = 0; fc && l < forecastMonitorConfig().levelCount; ++l)
+  {
+    if (fc->eta[l].status != FORECAST_ETA) continue;
+    Serial.printf("  Prognose: %s in %lu min (fruehestens %lu min)\n", forecastMonitorName(l),
+                  (unsigned long)(fc->eta[l].etaS / 60UL), (unsigned long)(fc->eta[l].earlyS / 60UL));
+    break;
+  }
+  alert.hasLevel = ok;
+  alert.levelMm = r.depthMm;
+  alert.hasRate = trend;
+  alert.rateMmPerH = rec->trendMmPerH;
+  raiseAlerts(sid, alert, rx.us);
+
+  if (ev)
+  {
+    ev->kind = NET_UPLINK;
+    ev->sid = sid;
+    ev->ms = rxMs;
+    ev->rec = *rec;
+    ev->adr = adrStatus(sid);
+    if (ev->pumpEvent.kind != PUMP_EVENT_NONE) ev->pumps = *pumpMonitorFind(sid);
+    if (fc) { ev->hasForecast = true; ev->forecast = *fc; }
+  }
+  String value = ok ? String(r.depthMm / 10.0f, 1) + " cm" : String("-");
+  oledPrint(String("S") + String(sid) + " Wasser: " + value,
+            String("Status: ") + (r.valid ? String(r.status) : String("parse_error")));
   drawStatus();
+  return true;
+}
+
+// Ein Uplink aus dem Funk-Task: Linkstatistik vor den TLVs (Quittungen), dann Auswertung,
+// zuletzt ein offener Befehl für das Empfangsfenster
+static void processUplink(const RadioUplink &up)
+{
+  if (ENCRYPTION_ENABLED) adrOnUplink(up.sid, up.rssi, up.snr, up.frameLen);
+  NetEvent *ev = pipelineEventClaim();
+  if (processPayload(up.sid, up.data, up.len, up, ev) && ev) pipelineEventPublish();
+  if (ENCRYPTION_ENABLED) queueDownlink(up);
+}
+
+// Zustandswechsel je Sensor ans Netz melden, auch ohne Uplink (verstummt = "stale")
+static void publishHealthChanges()
+{
+  static uint8_t lastHealth[256] = {0}; // SENSOR_UNKNOWN
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    const SensorHealth h = sensorRegistryHealth(sensorRegistryFind((uint8_t)sid), millis());
+    if (h == lastHealth[sid]) continue;
+    NetEvent *ev = pipelineEventClaim();
+    if (!ev) return; // im nächsten Durchlauf erneut
+    lastHealth[sid] = h;
+    ev->kind = NET_HEALTH;
+    ev->sid = (uint8_t)sid;
+    ev->health = h;
+    pipelineEventPublish();
+  }
+}
+
+// Stille-Alarme: zyklisch, da ein verstummter Sensor kein Paket auslöst
+static void checkStaleAlerts()
+{
+  AlertInput in = {};
+  in.hasSilence = true;
+  for (int sid = sensorRegistryNext(-1); sid >= 0; sid = sensorRegistryNext(sid))
+  {
+    in.silentS = (millis() - sensorRegistryFind((uint8_t)sid)->lastRxMs) / 1000UL;
+    raiseAlerts((uint8_t)sid, in, 0);
+  }
+}
+
+// Logik-Task: Uplinks auswerten, dazu alles Zeitgesteuerte am Logik-Zustand
+static void logicLoop()
+{
+  pipelineWaitUplink(10); // geweckt vom Funk-Task, sonst alle 10 ms (Taster)
+  RadioUplink *up;
+  while ((up = pipelineUplinkFront()) != nullptr)
+  {
+    pipelineLock();
+    processUplink(*up);
+    pipelineUnlock();
+    pipelineUplinkPop();
+  }
+
+  pipelineLock();
+  // Button abfragen (kurzer Druck toggelt OLED)
+  handleButton();
+  // ADR: quittierte Wechsel nach dem Empfangsfenster umsetzen, verstummte Sensoren zurückholen
+  adrLoop();
+  historyLoop();
+
+  static uint32_t lastOverruns = 0;
+  LoRaRxStats rxStats = loraRxStats();
+  if (rxStats.overruns != lastOverruns)
+  {
+    Serial.printf("LoRa RX-Ring voll: %lu Pakete verworfen\n", (unsigned long)rxStats.overruns);
+    lastOverruns = rxStats.overruns;
+  }
+
+  static unsigned long lastAirtime = 0;
+  if (millis() - lastAirtime > 60000UL)
+  {
+    lastAirtime = millis();
+    if (NetEvent *ev = pipelineEventClaim())
+    {
+      const unsigned long now = millis();
+      ev->kind = NET_AIRTIME;
+      ev->usedMs = (uint32_t)(dutyCycleUsedUs(&g_duty, now) / 1000);
+      ev->remainingMs = (uint32_t)(dutyCycleRemainingUs(&g_duty, now) / 1000);
+      ev->deferred = g_duty.deferred;
+      pipelineEventPublish();
+    }
+  }
+
+  static bool mqttShown = false;
+  const bool mqttUp = g_netMqttUp;
+  if (mqttUp && !mqttShown) oledPrint("MQTT verbunden", String(MQTT_HOST));
+  mqttShown = mqttUp;
+
+  static unsigned long lastDraw = 0;
+  if (millis() - lastDraw > 1000)
+  {
+    lastDraw = millis();
+    checkStaleAlerts();
+    drawStatus();
+    publishHealthChanges();
+  }
+  pipelineUnlock();
+}
+
+// Netz-Task: WLAN, MQTT, OTA, Web-UI und die Ereignisse der Logik
+static void netLoop()
+{
+  // geweckt von der Logik (Ereignis, Alarm), sonst alle 10 ms; Alarme vor allem anderen
+  pipelineWaitEvent(10);
+  drainAlarms();
+  replayGuardPersist(); // vor ensureWifi(): ein Verbindungsversuch kann Sekunden blockieren
+  ensureWifi();
+  if (WiFi.status() == WL_CONNECTED)
+  {
+    ensureMqtt();
+    initOta();
+  }
+
+  if (mqttClient.connected()) { mqttClient.loop(); }
+  if (OTA_ENABLED && g_otaInitialized) { ArduinoOTA.handle(); }
+  web.handleClient();
+  sseLoop();
+
+  NetEvent *ev;
+  drainAlarms();
+  while ((ev = pipelineEventFront()) != nullptr)
+  {
+    publishEvent(*ev);
+    pipelineEventPop();
+    drainAlarms();
+  }
+  g_netMqttUp = mqttClient.connected();
+  g_netIp = WiFi.status() == WL_CONNECTED ? (uint32_t)WiFi.localIP() : 0;
+
+  static unsigned long lastStats = 0;
+  if (millis() - lastStats > 60000UL)
+  {
+    lastStats = millis();
+    publishPipeline();
+    // Im Ring verworfene Alarme: Zustand vollständig nachliefern
+    static uint32_t lastAlarmsDropped = 0;
+    const uint32_t alarmsDropped = pipelineStats().alarms.dropped;
+    if (alarmsDropped != lastAlarmsDropped) publishAlarmStates();
+    lastAlarmsDropped = alarmsDropped;
+  }
 }
 
 void setup()
 {
   Serial.begin(SERIAL_BAUD);
   delay(200);
+  cryptoBenchmark(); // nur mit -D CRYPTO_BENCH aktiv
 
   // OLED initialisieren (Heltec: Reset über GPIO16 notwendig), immer initialisieren
   Wire.begin(OLED_SDA, OLED_SCL);
@@ -611,95 +1491,157 @@ void setup()
     while (true) { delay(1000); }
   }
 
-  // Kein Interrupt-Callback verwenden; stattdessen Polling im loop()
+  dutyCycleInit(&g_duty, DUTY_CYCLE_PERMILLE, 3600UL * 1000UL);
+
+  // Replay-Schutz: gesicherte Frame-Zähler aus NVS laden
+  replayGuardInit();
+
+  // Empfangs-SF (ADR) aus NVS, vor dem Start des Empfangs
+  adrInit();
+
+  // Messwert-Verlauf aus dem Flash-Log wiederherstellen
+  historyBegin();
+
+  // Empfang per DIO0-Interrupt in den Ringpuffer, Auswertung im Funk-Task
+  loraRxBegin(LORA_DIO0);
 
   // WLAN/MQTT init
   WiFi.mode(WIFI_STA);
   ensureWifi();
+  // SNTP läuft im Hintergrund und stellt die Uhr, sobald das WLAN verbunden ist
+  if (NTP_SERVER[0]) configTime(0, 0, NTP_SERVER);
   mqttClient.setKeepAlive(30);
-  mqttClient.setBufferSize(256);
+  mqttClient.setBufferSize(MQTT_BUFFER_BYTES);
   ensureMqtt();
 
   // Webserver Routen registrieren und starten
+  webuiBegin(web);
   web.on("/", handleRoot);
   web.on("/sensor/ota", HTTP_POST, handleSensorOta);
+  web.on("/api/history", HTTP_GET, []() { historyApiHandle(web); });
+  web.on("/events", HTTP_GET, []() { sseHandle(web); });
   web.begin();
   Serial.println("Webserver gestartet auf Port 80");
 
   oledPrint("Init...", "WLAN/MQTT verbinden");
+
+  // Funk-, Logik- und Netz-Task starten (Kerne und Prioritäten aus config.h)
+  pipelineBegin(logicLoop, netLoop);
 }
 
 void loop()
 {
-  ensureWifi();
-  if (WiFi.status() == WL_CONNECTED)
-  {
-    ensureMqtt();
-    initOta();
-  }
+  // Alles läuft in den Tasks aus pipelineBegin(), der Arduino-loop-Task wird nicht gebraucht
+  vTaskDelete(nullptr);
+}
 
-  if (mqttClient.connected()) { mqttClient.loop(); }
-  if (OTA_ENABLED && g_otaInitialized) { ArduinoOTA.handle(); }
-  web.handleClient();
+// Eine Discovery-Config (Home Assistant) für einen Sensorwert eines Schachts
+static void publishDiscoveryEntity(uint8_t sid, const char *key, const char *name, const String &stateTopic,
+                                   const char *unit, const char *deviceClass, const char *valueTemplate)
+{
+  // Topic: <prefix>/sensor/<node_id>_s<sid>/<key>/config
+  String node = String(HA_NODE_ID) + "_s" + String(sid);
+  String topic = String(HA_DISCOVERY_PREFIX) + "/sensor/" + node + "/" + key + "/config";
 
-  // Button abfragen (kurzer Druck toggelt OLED)
-  handleButton();
+  // JSON manuell erstellen (klein halten, ohne ArduinoJson)
+  String payload = "{";
+  payload += "\"name\":\"" + String(name) + "\",";
+  payload += "\"state_topic\":\"" + stateTopic + "\",";
+  if (unit) payload += "\"unit_of_measurement\":\"" + String(unit) + "\",";
+  if (deviceClass) payload += "\"device_class\":\"" + String(deviceClass) + "\",\"state_class\":\"measurement\",";
+  if (valueTemplate) payload += "\"value_template\":\"" + String(valueTemplate) + "\",";
+  payload += "\"unique_id\":\"" + node + "_" + key + "\",";
+  // Ein Gerät je Sensor, angebunden über das Gateway
+  payload += "\"device\":{\"name\":\"" + String(HA_DEVICE_NAME) + " Sensor " + String(sid) + "\",";
+  payload += "\"identifiers\":[\"" + node + "\"],\"via_device\":\"" + String(HA_NODE_ID) + "\"}";
+  payload += "}";
+
+  mqttPublish(topic.c_str(), payload.c_str(), true);
+}
 
-  // LoRa-Pakete im Polling-Modus verarbeiten
-  int packetSize = LoRa.parsePacket();
-  if (packetSize)
+// Je Alarmregel ein binary_sensor (ON/OFF) am Gerät des Sensors
+static void publishAlarmDiscovery(uint8_t sid)
+{
+  const AlertRule *rules = alertManagerRules();
+  String node = String(HA_NODE_ID) + "_s" + String(sid);
+  for (uint8_t i = 0; i < alertManagerRuleCount(); ++i)
   {
-    if (ENCRYPTION_ENABLED)
-    {
-      // Binärpaket lesen
-      std::unique_ptr<uint8_t[]> buf(new uint8_t[packetSize]);
-      size_t read = LoRa.readBytes(buf.get(), packetSize);
-      if (read == (size_t)packetSize)
-      {
-        if (!processEncryptedPacketBytes(buf.get(), read))
-        {
-          Serial.println("Verschl. Paket ungültig/verworfen");
-        }
-      }
-    }
-    else
-    {
-      String payload;
-      while (LoRa.available()) payload += (char)LoRa.read();
-      if (payload.length()) processPayload(payload);
-    }
+    const String key = String("alarm_") + alertManagerKey(i);
+    char label[32];
+    alarmLabel(i, label, sizeof(label), false);
+    String topic = String(HA_DISCOVERY_PREFIX) + "/binary_sensor/" + node + "/" + key + "/config";
+    String payload = "{";
+    payload += "\"name\":\"Alarm " + String(label) + "\",";
+    payload += "\"state_topic\":\"" + sensorTopic(TOPIC_ALARM, sid) + "/" + alertManagerKey(i) + "\",";
+    payload += "\"device_class\":\"" + String(rules[i].kind == ALERT_LEVEL ? "moisture" : "problem") + "\",";
+    payload += "\"unique_id\":\"" + node + "_" + key + "\",";
+    payload += "\"device\":{\"identifiers\":[\"" + node + "\"]}";
+    payload += "}";
+    mqttPublish(topic.c_str(), payload.c_str(), true);
   }
+}
 
-  static unsigned long lastDraw = 0;
-  if (millis() - lastDraw > 1000)
+static void publishSensorDiscovery(uint8_t sid)
+{
+  publishDiscoveryEntity(sid, "waterlevel", "Wasserstand", sensorTopic(TOPIC_WATERLEVEL, sid), "cm", "distance", nullptr);
+  publishDiscoveryEntity(sid, "trend", "Trend", sensorTopic(TOPIC_TREND, sid), "cm/h", nullptr, nullptr);
+  publishDiscoveryEntity(sid, "rssi", "RSSI", sensorTopic(TOPIC_RSSI, sid), "dBm", "signal_strength", nullptr);
+  publishDiscoveryEntity(sid, "health", "Zustand", sensorTopic(TOPIC_SENSOR_STATE, sid), nullptr, nullptr, "{{ value_json.health }}");
+  publishDiscoveryEntity(sid, "loss", "Paketverlust", sensorTopic(TOPIC_SENSOR_STATE, sid), "%", nullptr, "{{ value_json.loss_pct }}");
+  publishDiscoveryEntity(sid, "inflow", "Zulauf", sensorTopic(TOPIC_PUMPS, sid), "cm/h", nullptr, "{{ value_json.inflow_cm_h }}");
+  publishDiscoveryEntity(sid, "pump_faults", "Pumpen ausgefallen", sensorTopic(TOPIC_PUMPS, sid), nullptr, nullptr,
+                         "{{ value_json.pumps | selectattr('failed') | list | count }}");
+  // Zeit bis zu jeder Höhe der Prognose (ohne Anstieg: unbekannt)
+  const ForecastConfig &fcfg = forecastMonitorConfig();
+  for (uint8_t l = 0; l < fcfg.levelCount; ++l)
   {
-    lastDraw = millis();
-    drawStatus();
+    const String key = String("eta_") + String((int)(fcfg.levelsMm[l] / 10));
+    const String tpl = String("{{ value_json.levels[") + String(l) + "].eta_min | default(None) }}";
+    publishDiscoveryEntity(sid, key.c_str(), (String("Bis ") + forecastMonitorName(l)).c_str(), sensorTopic(TOPIC_FORECAST, sid),
+                           "min", "duration", tpl.c_str());
   }
+  publishAlarmDiscovery(sid);
+}
 
-  delay(10);
+// Gerät des Gateways (via_device der Sensor-Geräte)
+static String gatewayDevice()
+{
+  return "\"device\":{\"name\":\"" + String(HA_DEVICE_NAME) + "\",\"identifiers\":[\"" + String(HA_NODE_ID) + "\"]}";
 }
 
 static void publishDiscovery()
 {
   if (!ENABLE_HA_DISCOVERY || !mqttClient.connected()) return;
 
-  // Home Assistant Discovery für den Wasserstand-Sensor
-  // Topic: <prefix>/sensor/<node_id>/waterlevel/config
-  String topic = String(HA_DISCOVERY_PREFIX) + "/sensor/" + HA_NODE_ID + "/waterlevel/config";
-
-  // JSON manuell erstellen (klein halten, ohne ArduinoJson)
-  // Enthält Verfügbarkeit, Gerätedaten und Zustandsthema
+  // Gateway immer anmelden (eigene Sendezeit), sonst verweist via_device der Sensoren ins Leere
+  String topic = String(HA_DISCOVERY_PREFIX) + "/sensor/" + HA_NODE_ID + "/airtime/config";
   String payload = "{";
+  payload += "\"name\":\"Sendezeit\",";
+  payload += "\"state_topic\":\"" + String(TOPIC_AIRTIME) + "\",";
+  payload += "\"unit_of_measurement\":\"ms\",";
+  payload += "\"value_template\":\"{{ value_json.used_ms }}\",";
+  payload += "\"unique_id\":\"" + String(HA_NODE_ID) + "_airtime\",";
+  payload += gatewayDevice();
+  payload += "}";
+  mqttPublish(topic.c_str(), payload.c_str(), true);
+
+  // Alle freigegebenen Sensoren sofort anmelden, nicht erst beim ersten Uplink
+  if (ENCRYPTION_ENABLED)
+    for (size_t i = 0; i < ALLOWED_SENSOR_IDS_COUNT; ++i) publishSensorDiscovery(ALLOWED_SENSOR_IDS[i]);
+  else
+    publishSensorDiscovery(0);
+
+  if (!LEGACY_TOPIC_SID) return;
+  // Bisherige Entität auf dem Topic ohne Sensor-ID (unveränderte unique_id)
+  topic = String(HA_DISCOVERY_PREFIX) + "/sensor/" + HA_NODE_ID + "/waterlevel/config";
+  payload = "{";
   payload += "\"name\":\"Drainage Wasserstand\",";
   payload += "\"state_topic\":\"" + String(TOPIC_WATERLEVEL) + "\",";
   payload += "\"unit_of_measurement\":\"cm\",";
   payload += "\"device_class\":\"distance\",";
   payload += "\"state_class\":\"measurement\",";
-  // Availability entfällt (kein Status-Topic mehr)
   payload += "\"unique_id\":\"" + String(HA_NODE_ID) + "_waterlevel\",";
-  payload += "\"device\":{\"name\":\"" + String(HA_DEVICE_NAME) + "\",\"identifiers\":[\"" + String(HA_NODE_ID) + "\"]}";
+  payload += gatewayDevice();
   payload += "}";
-
-  mqttClient.publish(topic.c_str(), payload.c_str(), true);
+  mqttPublish(topic.c_str(), payload.c_str(), true);
 }
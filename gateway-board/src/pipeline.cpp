@@ -0,0 +1,307 @@
+// Deutsche Dokumentation
+// Aufteilung auf FreeRTOS-Tasks: Implementierung
+//
+// Der Funk-Task steht vollständig hier, Logik- und Netz-Task rufen die Schleifen aus
+// main.cpp auf. Jeder Zähler wird nur von einem Task geschrieben.
+#include "pipeline.h"
+#include <Arduino.h>
+#include <LoRa.h>
+#include <cstring>
+#include "config.h"
+#include "frame_counter.h"
+#include "lora_rx.h"
+#include "replay_guard.h"
+#include "sensor_sessions.h"
+#include "spsc_ring.h"
+
+// Ohne Paket oder Auftrag schläft der Funk-Task höchstens so lange (geweckt wird per
+// Benachrichtigung aus der ISR bzw. von der Logik, das ist nur ein Sicherheitsnetz)
+static const uint32_t RADIO_IDLE_WAIT_MS = 100;
+
+static SpscRing<RadioUplink, PIPELINE_UPLINK_SLOTS> s_uplinks;  // Funk -> Logik
+static SpscRing<RadioJob, PIPELINE_RADIO_JOB_SLOTS> s_jobs;     // Logik -> Funk
+static SpscRing<NetEvent, PIPELINE_EVENT_SLOTS> s_events;       // Logik -> Netz
+static SpscRing<AlarmEvent, PIPELINE_ALARM_SLOTS> s_alarms;     // Logik -> Netz, Vorrang
+
+static TaskHandle_t s_tasks[PIPELINE_TASK_COUNT] = {nullptr};
+static SemaphoreHandle_t s_lock = nullptr;
+static PipelineLoopFn s_logic = nullptr;
+static PipelineLoopFn s_net = nullptr;
+
+// Funk-Task
+static volatile uint32_t s_uplinksDropped = 0;
+static volatile uint32_t s_rejected = 0;
+static volatile uint32_t s_late = 0;
+static volatile uint32_t s_rxLatencyMaxUs = 0;
+// Logik-Task
+static volatile uint32_t s_jobsDropped = 0;
+static volatile uint32_t s_eventsDropped = 0;
+static volatile uint32_t s_alarmsDropped = 0;
+static volatile uint32_t s_logicLatencyMaxUs = 0;
+
+// Frame prüfen und in-place entschlüsseln, Klartext in den Uplink-Slot
+static bool openFrame(LoRaRxPacket& pkt, RadioUplink* out)
+{
+    uint8_t sid;
+    if (!loraFrameSensorId(pkt.data, pkt.len, &sid)) return false;
+    CryptoSession* session = sensorSession(sid); // nullptr = nicht freigegeben
+    if (!session) return false;
+
+    // Replay prüfen (Frame-Zähler liegt unverschlüsselt im Header), O(1)
+    const uint64_t counter = frameCounterFromNonce(loraFrameNonce(pkt.data));
+    if (!replayCheck(sid, counter)) return false;
+
+    // MAC prüfen über (sid | nonce | ciphertext) und in-place entschlüsseln
+    const uint8_t* pt; size_t ptLen;
+    if (!loraFrameOpen(*session, pkt.data, pkt.len, &pt, &ptLen)) return false;
+    replayCommit(sid, counter);
+    out->sid = sid;
+    out->len = (uint8_t)ptLen;
+    memcpy(out->data, pt, ptLen);
+    return true;
+}
+
+static void handleRx(LoRaRxPacket& pkt)
+{
+    RadioUplink* up = s_uplinks.claim();
+    if (!up) { s_uplinksDropped = s_uplinksDropped + 1; return; } // Logik kommt nicht nach
+    if (ENCRYPTION_ENABLED) {
+        if (!openFrame(pkt, up)) {
+            s_rejected = s_rejected + 1;
+            Serial.println("Verschl. Paket ungültig/verworfen");
+            return;
+        }
+    } else {
+        if (!pkt.len) return;
+        up->sid = 0; // ohne Frame keine Sensor-ID
+        up->len = pkt.len;
+        memcpy(up->data, pkt.data, pkt.len);
+    }
+    up->ms = pkt.ms;
+    up->us = pkt.us;
+    up->rssi = pkt.rssi;
+    up->snr = pkt.snr;
+    up->frameLen = pkt.len;
+    s_uplinks.publish();
+    const uint32_t latency = micros() - pkt.us;
+    if (latency > s_rxLatencyMaxUs) s_rxLatencyMaxUs = latency;
+    if (s_tasks[PIPELINE_LOGIC]) xTaskNotifyGive(s_tasks[PIPELINE_LOGIC]);
+}
+
+static void sendDownlink(const RadioJob& job)
+{
+    if ((int32_t)(millis() - job.deadlineMs) >= 0) { s_late = s_late + 1; return; }
+    // Paketformat wie Sensor-Uplink: [sid(1)][nonce(8)][ciphertext][mac(8)]
+    // Schlüssel des Ziel-Sensors (vorbereitete Session aus dem Cache)
+    CryptoSession* session = sensorSession(job.sid);
+    if (!session) return;
+    // Zähler-Reservierung noch nicht gesichert: wie einen verspäteten Downlink verwerfen
+    uint64_t counter;
+    if (!nextDownlinkCounter(&counter)) { s_late = s_late + 1; return; }
+    uint8_t nonce[LORA_FRAME_NONCE_LEN];
+    frameCounterToNonce(counter, nonce);
+    // Frame direkt im Stack-Puffer aufbauen und in-place versiegeln
+    uint8_t frame[LORA_FRAME_MAX_LEN];
+    const size_t len = loraFrameEncode(*session, job.sid, nonce, job.data, job.len, frame, sizeof(frame));
+    if (!len) return;
+    // Empfang während des Sendens anhalten (DIO0-Interrupt ab), danach weiter empfangen
+    loraRxSuspend();
+    LoRa.beginPacket();
+    LoRa.write(frame, len);
+    LoRa.endPacket();
+    loraRxResume();
+}
+
+static void runJob(const RadioJob& job)
+{
+    switch (job.kind) {
+    case RADIO_JOB_DOWNLINK: sendDownlink(job); break;
+    case RADIO_JOB_SET_SF:
+        loraRxSuspend();
+        LoRa.setSpreadingFactor(job.data[0]);
+        loraRxResume();
+        break;
+    }
+}
+
+static void radioTask(void*)
+{
+    for (;;) {
+        // Aufträge zuerst: ein Downlink muss ins Empfangsfenster des Sensors
+        RadioJob* job;
+        while ((job = s_jobs.front()) != nullptr) {
+            runJob(*job);
+            s_jobs.pop();
+        }
+        // Paket nach einem RxDone aus dem Modul lesen, dann direkt im Ring-Slot prüfen
+        // und entschlüsseln
+        loraRxPoll();
+        LoRaRxPacket* pkt;
+        while ((pkt = loraRxFront()) != nullptr) {
+            handleRx(*pkt);
+            loraRxPop();
+        }
+        loraRxWait(RADIO_IDLE_WAIT_MS);
+    }
+}
+
+static void logicTask(void*)
+{
+    for (;;) s_logic();
+}
+
+static void netTask(void*)
+{
+    for (;;) s_net();
+}
+
+static void startTask(TaskFunction_t fn, const char* name, uint32_t stack, uint8_t prio, uint8_t core, PipelineTask t)
+{
+    if (xTaskCreatePinnedToCore(fn, name, stack, nullptr, prio, &s_tasks[t], core) != pdPASS)
+        Serial.printf("Task %s konnte nicht gestartet werden\n", name);
+}
+
+void pipelineBegin(PipelineLoopFn logic, PipelineLoopFn net)
+{
+    s_lock = xSemaphoreCreateMutex();
+    s_logic = logic;
+    s_net = net;
+    startTask(radioTask, "radio", RADIO_TASK_STACK, RADIO_TASK_PRIORITY, RADIO_TASK_CORE, PIPELINE_RADIO);
+    startTask(logicTask, "logic", LOGIC_TASK_STACK, LOGIC_TASK_PRIORITY, LOGIC_TASK_CORE, PIPELINE_LOGIC);
+    startTask(netTask, "net", NET_TASK_STACK, NET_TASK_PRIORITY, NET_TASK_CORE, PIPELINE_NET);
+}
+
+void pipelineWaitUplink(uint32_t timeoutMs)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+}
+
+RadioUplink* pipelineUplinkFront()
+{
+    return s_uplinks.front();
+}
+
+void pipelineUplinkPop()
+{
+    const RadioUplink* up = s_uplinks.front();
+    if (!up) return;
+    const uint32_t latency = micros() - up->us;
+    if (latency > s_logicLatencyMaxUs) s_logicLatencyMaxUs = latency;
+    s_uplinks.pop();
+}
+
+static bool pushJob(const RadioJob& job)
+{
+    if (!s_jobs.push(job)) { s_jobsDropped = s_jobsDropped + 1; return false; }
+    if (s_tasks[PIPELINE_RADIO]) xTaskNotifyGive(s_tasks[PIPELINE_RADIO]);
+    return true;
+}
+
+bool pipelineDownlink(uint8_t sid, uint32_t deadlineMs, const uint8_t* cmd, size_t len)
+{
+    RadioJob job;
+    if (len > sizeof(job.data)) return false;
+    job.kind = RADIO_JOB_DOWNLINK;
+    job.sid = sid;
+    job.len = (uint8_t)len;
+    job.deadlineMs = deadlineMs;
+    memcpy(job.data, cmd, len);
+    return pushJob(job);
+}
+
+bool pipelineSetSpreadingFactor(uint8_t sf)
+{
+    RadioJob job = {};
+    job.kind = RADIO_JOB_SET_SF;
+    job.len = 1;
+    job.data[0] = sf;
+    return pushJob(job);
+}
+
+NetEvent* pipelineEventClaim()
+{
+    NetEvent* ev = s_events.claim();
+    if (!ev) { s_eventsDropped = s_eventsDropped + 1; return nullptr; }
+    memset(ev, 0, sizeof(*ev));
+    return ev;
+}
+
+static void wakeNet()
+{
+    if (s_tasks[PIPELINE_NET]) xTaskNotifyGive(s_tasks[PIPELINE_NET]);
+}
+
+void pipelineEventPublish()
+{
+    s_events.publish();
+    wakeNet();
+}
+
+bool pipelineAlarm(const AlarmEvent& alarm)
+{
+    if (!s_alarms.push(alarm)) { s_alarmsDropped = s_alarmsDropped + 1; return false; }
+    wakeNet();
+    return true;
+}
+
+void pipelineWaitEvent(uint32_t timeoutMs)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+}
+
+NetEvent* pipelineEventFront()
+{
+    return s_events.front();
+}
+
+void pipelineEventPop()
+{
+    s_events.pop();
+}
+
+AlarmEvent* pipelineAlarmFront()
+{
+    return s_alarms.front();
+}
+
+void pipelineAlarmPop()
+{
+    s_alarms.pop();
+}
+
+void pipelineLock()
+{
+    if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY);
+}
+
+void pipelineUnlock()
+{
+    if (s_lock) xSemaphoreGive(s_lock);
+}
+
+template <typename Ring>
+static PipelineQueueStats queueStats(const Ring& r, uint32_t dropped)
+{
+    PipelineQueueStats q;
+    q.depth = (uint16_t)r.size();
+    q.highWater = (uint16_t)r.highWater();
+    q.slots = (uint16_t)r.capacity();
+    q.dropped = dropped;
+    return q;
+}
+
+PipelineStats pipelineStats()
+{
+    PipelineStats s;
+    s.uplinks = queueStats(s_uplinks, s_uplinksDropped);
+    s.radioJobs = queueStats(s_jobs, s_jobsDropped);
+    s.events = queueStats(s_events, s_eventsDropped);
+    s.alarms = queueStats(s_alarms, s_alarmsDropped);
+    for (uint8_t t = 0; t < PIPELINE_TASK_COUNT; ++t)
+        s.stackFree[t] = s_tasks[t] ? (uint32_t)uxTaskGetStackHighWaterMark(s_tasks[t]) : 0;
+    s.rxLatencyMaxUs = s_rxLatencyMaxUs;
+    s.logicLatencyMaxUs = s_logicLatencyMaxUs;
+    s.rejected = s_rejected;
+    s.downlinksLate = s_late;
+    return s;
+}
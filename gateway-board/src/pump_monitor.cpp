@@ -0,0 +1,67 @@
+// Deutsche Dokumentation
+// Pumpzyklen je Sensor (Gateway): Implementierung
+#include "pump_monitor.h"
+#include <Arduino.h>
+#include <new>
+#include "config.h"
+
+static const size_t PUMP_CONFIG_COUNT = sizeof(PUMP_LEVELS_CM) / sizeof(PUMP_LEVELS_CM[0]);
+static_assert(PUMP_CONFIG_COUNT <= PUMP_CYCLE_MAX_PUMPS, "PUMP_LEVELS_CM: hoechstens 4 Pumpen");
+static_assert(sizeof(PUMP_NAMES) / sizeof(PUMP_NAMES[0]) == PUMP_CONFIG_COUNT, "PUMP_NAMES passt nicht zu PUMP_LEVELS_CM");
+
+static int32_t cmToMm(float cm)
+{
+    return (int32_t)lroundf(cm * 10.0f);
+}
+
+static PumpCycleConfig makeConfig()
+{
+    PumpCycleConfig c = {};
+    for (size_t i = 0; i < PUMP_CONFIG_COUNT; ++i) {
+        c.pumps[i].startMm = cmToMm(PUMP_LEVELS_CM[i][0]);
+        c.pumps[i].stopMm = cmToMm(PUMP_LEVELS_CM[i][1]);
+    }
+    c.pumpCount = (uint8_t)PUMP_CONFIG_COUNT;
+    c.swingMm = cmToMm(PUMP_SWING_CM);
+    c.failMarginMm = cmToMm(PUMP_FAIL_MARGIN_CM);
+    // Ohne Uplink über die Stale-Grenze hinaus passen Füllphase und Zyklusdauer nicht mehr
+    c.maxGapS = SENSOR_STALE_MS / 1000UL;
+    return c;
+}
+
+static const PumpCycleConfig s_config = makeConfig();
+
+// Wie das Sensor-Register: nur Zeiger, Speicher erst beim ersten Messwert
+static PumpCycleState* s_state[256] = {nullptr};
+static bool s_allocFailed = false;
+
+PumpEvent pumpMonitorAdd(uint8_t sid, uint32_t tSec, int32_t depthMm)
+{
+    PumpCycleState* s = s_state[sid];
+    if (!s) {
+        s = new (std::nothrow) PumpCycleState();
+        if (!s) {
+            if (!s_allocFailed) Serial.printf("Pumpen: kein Speicher fuer Sensor %u\n", (unsigned)sid);
+            s_allocFailed = true;
+            return { PUMP_EVENT_NONE, 0 };
+        }
+        pumpCycleReset(s);
+        s_state[sid] = s;
+    }
+    return pumpCycleUpdate(s_config, s, tSec, depthMm);
+}
+
+const PumpCycleState* pumpMonitorFind(uint8_t sid)
+{
+    return s_state[sid];
+}
+
+const PumpCycleConfig& pumpMonitorConfig()
+{
+    return s_config;
+}
+
+const char* pumpMonitorName(uint8_t pump)
+{
+    return pump < PUMP_CONFIG_COUNT ? PUMP_NAMES[pump] : "?";
+}
@@ -0,0 +1,122 @@
+// Deutsche Dokumentation
+// Replay-Schutz (Gateway): Implementierung
+//
+// Persistenz: Pro Sensor wird der höchste Zähler höchstens alle
+// REPLAY_PERSIST_EVERY Frames gesichert (Flash-Schonung). Der Funk-Task schreibt
+// nicht selbst in NVS (Millisekunden, gelegentlich Löschen einer Seite), er reicht
+// den Stand über einen Ring an den Netz-Task weiter (replayGuardPersist()).
+// Bis dieser schreibt, können weitere Frames des Sensors eintreffen; nach einem
+// Neustart gilt daher alles bis (gesichert + 2 * REPLAY_PERSIST_EVERY) als gesehen.
+// Eine Replay-Lücke entsteht erst, wenn der Netz-Task REPLAY_PERSIST_EVERY Frames
+// eines Sensors lang nicht dazu kommt; im ungünstigsten Fall werden direkt nach
+// dem Neustart bis zu 2 * REPLAY_PERSIST_EVERY - 1 echte Frames verworfen.
+//
+// Der Downlink-Zähler wird blockweise in NVS reserviert. Sind weniger als die
+// Hälfte eines Blocks übrig, fordert der Funk-Task über denselben Ring den
+// nächsten an; vergeben wird nur, was bereits gesichert ist.
+#include "replay_guard.h"
+#include <Arduino.h>
+#include <atomic>
+#include <Preferences.h>
+#include "config.h"
+#include "frame_counter.h"
+#include "spsc_ring.h"
+
+static const char* NVS_NAMESPACE = "replay";
+static const char* NVS_KEY_DOWNLINK = "down";
+// Downlink-Zähler wird blockweise reserviert (nach Neustart geht es am Blockende weiter)
+static const uint64_t DOWNLINK_LEASE = 64;
+// Zu sichernde Stände (Funk -> Netz); voll: beim nächsten Frame des Sensors erneut
+static const size_t PERSIST_SLOTS = 16;
+// Sensor-IDs beginnen bei 1, 0 im Ring steht für die Downlink-Reservierung
+static const uint8_t PERSIST_DOWNLINK = 0;
+
+struct ReplayPersist
+{
+    uint8_t sid;
+    uint64_t top;
+};
+
+static ReplayWindow s_windows[256];
+static uint64_t s_persisted[256]; // zuletzt zum Sichern weitergereichter Stand je Sensor (Funk-Task)
+static SpscRing<ReplayPersist, PERSIST_SLOTS> s_persist;
+// Downlink-Zähler (Funk-Task): zuletzt vergeben, gesichert reserviert bis, angefordert (0: nichts offen)
+static uint64_t s_downlinkCounter = 0;
+static uint64_t s_downlinkReserved = 0;
+static uint64_t s_downlinkRenewal = 0;
+static uint32_t s_leasesRequested = 0;
+static std::atomic<uint32_t> s_leasesWritten{0}; // vom Netz-Task gesicherte Reservierungen
+static Preferences s_prefs;
+static bool s_prefsOk = false;
+
+static void sensorKey(uint8_t sid, char out[8])
+{
+    snprintf(out, 8, "s%u", (unsigned)sid);
+}
+
+void replayGuardInit()
+{
+    for (ReplayWindow& w : s_windows) replayWindowReset(w);
+    s_prefsOk = s_prefs.begin(NVS_NAMESPACE, false);
+    if (!s_prefsOk) {
+        Serial.println("Replay-Schutz: NVS nicht verfügbar, Zähler nur im RAM");
+        s_downlinkReserved = FRAME_COUNTER_MAX;
+        return;
+    }
+    for (size_t i = 0; i < ALLOWED_SENSOR_IDS_COUNT; ++i) {
+        uint8_t sid = ALLOWED_SENSOR_IDS[i];
+        char key[8]; sensorKey(sid, key);
+        uint64_t saved = s_prefs.getULong64(key, 0);
+        s_persisted[sid] = saved;
+        if (saved) replayWindowRestore(s_windows[sid], saved + 2 * REPLAY_PERSIST_EVERY);
+    }
+    // Nach dem Neustart am Blockende weiter; der erste Block wird hier (setup()) gesichert
+    s_downlinkCounter = s_prefs.getULong64(NVS_KEY_DOWNLINK, 0);
+    s_downlinkReserved = s_downlinkCounter + DOWNLINK_LEASE;
+    s_prefs.putULong64(NVS_KEY_DOWNLINK, s_downlinkReserved);
+}
+
+bool replayCheck(uint8_t sid, uint64_t counter)
+{
+    return replayWindowCheck(s_windows[sid], counter);
+}
+
+void replayCommit(uint8_t sid, uint64_t counter)
+{
+    ReplayWindow& w = s_windows[sid];
+    replayWindowUpdate(w, counter);
+    if (s_prefsOk && w.top >= s_persisted[sid] + REPLAY_PERSIST_EVERY && s_persist.push({ sid, w.top }))
+        s_persisted[sid] = w.top;
+}
+
+void replayGuardPersist()
+{
+    ReplayPersist p;
+    while (s_persist.pop(&p)) {
+        if (p.sid == PERSIST_DOWNLINK) {
+            s_prefs.putULong64(NVS_KEY_DOWNLINK, p.top);
+            s_leasesWritten.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+        char key[8]; sensorKey(p.sid, key);
+        s_prefs.putULong64(key, p.top);
+    }
+}
+
+bool nextDownlinkCounter(uint64_t* counter)
+{
+    if (s_downlinkRenewal && s_leasesWritten.load(std::memory_order_acquire) == s_leasesRequested) {
+        s_downlinkReserved = s_downlinkRenewal;
+        s_downlinkRenewal = 0;
+    }
+    if (s_downlinkCounter >= s_downlinkReserved) return false;
+    *counter = FRAME_COUNTER_DOWNLINK | ++s_downlinkCounter;
+    if (s_prefsOk && !s_downlinkRenewal && s_downlinkReserved - s_downlinkCounter < DOWNLINK_LEASE / 2) {
+        const uint64_t renewal = s_downlinkReserved + DOWNLINK_LEASE;
+        if (s_persist.push({ PERSIST_DOWNLINK, renewal })) {
+            s_downlinkRenewal = renewal;
+            ++s_leasesRequested;
+        }
+    }
+    return true;
+}
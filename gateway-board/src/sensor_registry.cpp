@@ -0,0 +1,46 @@
+// Deutsche Dokumentation
+// Sensor-Register (Gateway): Implementierung
+#include "sensor_registry.h"
+#include <Arduino.h>
+#include <new>
+#include "config.h"
+#include "sensor_sessions.h"
+
+// Wie die Session-Tabelle: nur Zeiger, Einträge (~90 Byte) erst beim ersten Uplink
+static SensorRecord* s_records[256] = {nullptr};
+static uint8_t s_count = 0;
+
+SensorRecord* sensorRegistryGet(uint8_t sid)
+{
+    if (s_records[sid]) return s_records[sid];
+    if (ENCRYPTION_ENABLED ? !isAllowedSensor(sid) : sid != 0) return nullptr;
+
+    SensorRecord* r = new (std::nothrow) SensorRecord();
+    if (!r) return nullptr;
+    sensorRecordReset(r);
+    s_records[sid] = r;
+    ++s_count;
+    return r;
+}
+
+const SensorRecord* sensorRegistryFind(uint8_t sid)
+{
+    return s_records[sid];
+}
+
+int sensorRegistryNext(int afterSid)
+{
+    for (int sid = afterSid + 1; sid < 256; ++sid)
+        if (s_records[sid]) return sid;
+    return -1;
+}
+
+uint8_t sensorRegistryCount()
+{
+    return s_count;
+}
+
+SensorHealth sensorRegistryHealth(const SensorRecord* r, uint32_t nowMs)
+{
+    return sensorRecordHealth(r, nowMs, SENSOR_STALE_MS, SENSOR_LOSS_WARN_PERMILLE);
+}
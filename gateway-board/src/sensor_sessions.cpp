@@ -0,0 +1,77 @@
+// Deutsche Dokumentation
+// Krypto-Sessions pro Sensor (Gateway): Implementierung
+#include "sensor_sessions.h"
+#include <Arduino.h>
+#include <new>
+#include <cstring>
+#include "config.h"
+
+// Session-Tabelle, indiziert über die Sensor-ID (nur Zeiger, Sessions werden
+// erst beim ersten Paket eines freigegebenen Sensors angelegt)
+static CryptoSession* s_sessions[256] = {nullptr};
+
+bool isAllowedSensor(uint8_t sid)
+{
+    for (size_t i = 0; i < ALLOWED_SENSOR_IDS_COUNT; ++i)
+        if (ALLOWED_SENSOR_IDS[i] == sid) return true;
+    return false;
+}
+
+static bool beginSession(CryptoSession& s, uint8_t sid)
+{
+    if (!PER_SENSOR_KEYS) return s.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY));
+
+    uint8_t aesKey[CRYPTO_AES_KEY_LEN];
+    uint8_t hmacKey[CRYPTO_HMAC_KEY_LEN];
+    bool ok = deriveSensorKeys(MASTER_KEY, sizeof(MASTER_KEY), sid, aesKey, hmacKey) &&
+              s.begin(aesKey, hmacKey, sizeof(hmacKey));
+    memset(aesKey, 0, sizeof(aesKey));
+    memset(hmacKey, 0, sizeof(hmacKey));
+    return ok;
+}
+
+CryptoSession* sensorSession(uint8_t sid)
+{
+    if (s_sessions[sid]) return s_sessions[sid];
+    if (!isAllowedSensor(sid)) return nullptr;
+
+    CryptoSession* s = new (std::nothrow) CryptoSession();
+    if (!s) return nullptr;
+    if (!beginSession(*s, sid)) { delete s; return nullptr; }
+    s_sessions[sid] = s;
+    return s;
+}
+
+void cryptoBenchmark()
+{
+#ifdef CRYPTO_BENCH
+    // Typischer Uplink: [sid][nonce8]["123.4"][mac8]
+    static const int ROUNDS = 200;
+    static const size_t PT_LEN = 5;
+    uint8_t frame[1 + 8 + PT_LEN + 8] = {0x01};
+    uint8_t* nonce = frame + 1;
+    uint8_t* pt = frame + 9;
+    memcpy(pt, "123.4", PT_LEN);
+
+    uint32_t t0 = ESP.getCycleCount();
+    for (int i = 0; i < ROUNDS; ++i) {
+        nonce[0] = (uint8_t)i;
+        aesCtrCrypt(AES_KEY, nonce, frame[0], pt, PT_LEN);
+        hmacSha256Trunc(HMAC_KEY, sizeof(HMAC_KEY), frame, 9 + PT_LEN, frame + 9 + PT_LEN, 8);
+    }
+    uint32_t legacy = (ESP.getCycleCount() - t0) / ROUNDS;
+
+    CryptoSession s;
+    s.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY));
+    t0 = ESP.getCycleCount();
+    for (int i = 0; i < ROUNDS; ++i) {
+        nonce[0] = (uint8_t)i;
+        s.ctrCrypt(nonce, frame[0], pt, PT_LEN);
+        s.mac(frame, 9 + PT_LEN, frame + 9 + PT_LEN, 8);
+    }
+    uint32_t session = (ESP.getCycleCount() - t0) / ROUNDS;
+
+    Serial.printf("Krypto-Benchmark (%u B Payload): alt %lu Zyklen/Frame, Session %lu Zyklen/Frame\n",
+                  (unsigned)PT_LEN, (unsigned long)legacy, (unsigned long)session);
+#endif
+}
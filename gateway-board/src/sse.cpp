@@ -0,0 +1,68 @@
+// Deutsche Dokumentation
+// Server-Sent Events (Gateway): Implementierung
+#include "sse.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include "config.h"
+
+static WiFiClient s_clients[SSE_MAX_CLIENTS];
+static bool s_used[SSE_MAX_CLIENTS] = {false};
+static unsigned long s_lastWriteMs = 0;
+
+static void dropClient(uint8_t i)
+{
+  s_clients[i].stop();
+  s_clients[i] = WiFiClient();
+  s_used[i] = false;
+}
+
+static bool writeAll(uint8_t i, const char *s, size_t n)
+{
+  if (s_clients[i].write((const uint8_t *)s, n) == n) return true;
+  dropClient(i);
+  return false;
+}
+
+void sseHandle(WebServer &web)
+{
+  sseLoop(); // getrennte Plätze zuerst freigeben
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; ++i)
+  {
+    if (s_used[i]) continue;
+    s_clients[i] = web.client(); // hält den Socket über das Ende der Anfrage hinaus
+    s_used[i] = true;
+    static const char HEAD[] = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+                               "Connection: keep-alive\r\n\r\nretry: 3000\n\n";
+    writeAll(i, HEAD, sizeof(HEAD) - 1);
+    return;
+  }
+  web.send(503, "text/plain", "zu viele Live-Verbindungen");
+}
+
+void ssePublish(const char *event, const char *json)
+{
+  char msg[SSE_EVENT_BYTES];
+  const int n = snprintf(msg, sizeof(msg), "event: %s\ndata: %s\n\n", event, json);
+  if (n <= 0 || (size_t)n >= sizeof(msg)) return; // abgeschnitten wäre kein gültiges JSON
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; ++i)
+    if (s_used[i]) writeAll(i, msg, (size_t)n);
+  s_lastWriteMs = millis();
+}
+
+void sseLoop()
+{
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; ++i)
+    if (s_used[i] && !s_clients[i].connected()) dropClient(i);
+  // Kommentarzeile hält Proxys und NAT offen und deckt tote Verbindungen auf
+  if (millis() - s_lastWriteMs < SSE_KEEPALIVE_MS) return;
+  s_lastWriteMs = millis();
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; ++i)
+    if (s_used[i]) writeAll(i, ":\n\n", 3);
+}
+
+uint8_t sseClientCount()
+{
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; ++i) n += s_used[i];
+  return n;
+}
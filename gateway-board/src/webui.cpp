@@ -1,117 +1,197 @@
 // Deutsche Dokumentation
-// Mini Web-GUI (Gateway): Implementierung
+// Web-UI (Gateway): Implementierung
 #include "webui.h"
-#include <WiFi.h>
-#include <WebServer.h>
-#include <LoRa.h>
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 #include "config.h"
 
-// Vorwärtsdeklarationen lokaler Helfer
-static String htmlEscape(const String &s);
-static String fmtAge(unsigned long sinceMs);
+static const uint8_t WEBUI_MAX_FIELDS = 16;
 
-// Zustandswerte (werden extern gesetzt/abgerufen – hier nur als Platzhalter deklariert)
-extern String g_lastValue;     // letzter Wasserstand
-extern unsigned long g_lastLoRaMs; // Zeitstempel letzte LoRa RX
-extern int g_lastRssi;         // RSSI letzter RX
+static std::atomic<uint32_t> s_version{1}; // webuiTouch() aus Logik- und Netz-Task
+// Zwischenspeicher der formatierten Felder (statisch, kein Heap)
+static char s_cache[WEBUI_CACHE_BYTES];
+static uint16_t s_fieldEnd[WEBUI_MAX_FIELDS];
+static const WebPage *s_cachedPage = nullptr;
+static uint32_t s_cachedVersion = 0;
+static uint32_t s_cachedEpoch = 0;
+static bool s_cacheValid = false;
+// Feldinhalt der zuletzt gestreamten Seite; passt er nicht in s_cache, direkt streamen
+static size_t s_streamBytes = 0;
 
-// OTA-AP Wunschzustand pro Sensor (unbestätigt)
-struct OtaState { uint8_t sid; int8_t desired; unsigned long ts; };
-static OtaState g_otaStates[4] = {{0,-1,0},{0,-1,0},{0,-1,0},{0,-1,0}};
+void WebWriter::write(const char *s, size_t n)
+{
+  while (n)
+  {
+    size_t room = cap_ - len_;
+    if (!room)
+    {
+      if (!web_) { overflow_ = true; return; }
+      flush();
+      room = cap_;
+    }
+    const size_t k = n < room ? n : room;
+    memcpy(buf_ + len_, s, k);
+    len_ += k; total_ += k; s += k; n -= k;
+  }
+}
+
+void WebWriter::print(const char *s)
+{
+  write(s, strlen(s));
+}
+
+void WebWriter::print(long v)
+{
+  char tmp[12];
+  const int n = snprintf(tmp, sizeof(tmp), "%ld", v);
+  write(tmp, (size_t)n);
+}
+
+void WebWriter::print(unsigned long v)
+{
+  char tmp[12];
+  const int n = snprintf(tmp, sizeof(tmp), "%lu", v);
+  write(tmp, (size_t)n);
+}
 
-static void setOtaDesired(uint8_t sid, bool on)
+void WebWriter::print(float v, uint8_t digits)
 {
-    for (auto &x : g_otaStates) {
-        if (x.sid == sid || x.sid == 0) {
-            if (x.sid == 0) x.sid = sid;
-            x.desired = on?1:0; x.ts = millis();
-            return;
-        }
+  char tmp[24];
+  const int n = snprintf(tmp, sizeof(tmp), "%.*f", (int)digits, (double)v);
+  if (n > 0) write(tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+void WebWriter::printf(const char *fmt, ...)
+{
+  char tmp[128];
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+  va_end(ap);
+  if (n > 0) write(tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+void WebWriter::printEscaped(const char *s)
+{
+  for (; *s; ++s)
+  {
+    switch (*s)
+    {
+    case '&': print("&amp;"); break;
+    case '<': print("&lt;"); break;
+    case '>': print("&gt;"); break;
+    case '\'': print("&#39;"); break;
+    default: write(s, 1);
     }
-    g_otaStates[0] = {sid, (int8_t)(on?1:0), millis()};
+  }
 }
 
-static int8_t getOtaDesired(uint8_t sid)
+void WebWriter::flush()
 {
-    for (auto &x : g_otaStates) if (x.sid == sid) return x.desired;
-    return -1;
+  if (web_ && len_)
+  {
+    // Nicht unter der Sperre senden: ein langsamer Browser hielte sonst den Logik-Task auf
+    if (unlock_) unlock_();
+    web_->sendContent(buf_, len_);
+    if (lock_) lock_();
+  }
+  len_ = 0;
 }
 
-String buildStatusPageHtml()
+void webuiBegin(WebServer &web)
 {
-    String ip = (WiFi.status() == WL_CONNECTED) ? WiFi.localIP().toString() : String("-");
-    String wifi = (WiFi.status() == WL_CONNECTED) ? String("verbunden") : String("--");
-    String mqtt = String("siehe OLED/Log"); // Vereinfachte Darstellung – Details im Log
-    String loraAge = g_lastLoRaMs ? fmtAge(millis()-g_lastLoRaMs) : String("--");
-
-    String html;
-    html.reserve(4000);
-    html += F("<!doctype html><html><head><meta charset='utf-8'><meta name='viewport' content='width=device-width,initial-scale=1'>");
-    html += F("<title>Drainage Gateway</title><style>");
-    html += F("bodyfont-family:system-ui,-apple-system,Segoe UI,Roboto,Ubuntu,sans-serif;margin:0;background:#f6f7fb;color:#222}");
-    html += F("headerdisplay:flex;align-items:center;gap:12px;padding:12px 16px;background:#1f2937;color:#fff}");
-    html += F("mainpadding:16px;display:grid;grid-template-columns:1fr;gap:16px;max-width:900px;margin:0 auto}");
-    html += F(".cardbackground:#fff;border:1px solid #e5e7eb;border-radius:10px;box-shadow:0 1px 2px rgba(0,0,0,.04)}");
-    html += F(".card h2margin:0;padding:12px 16px;border-bottom:1px solid #eee;font-size:16px}");
-    html += F(".card .bodypadding:12px 16px}");
-    html += F("tableborder-collapse:collapse;width:100%} td,thborder:1px solid #e5e7eb;padding:8px;text-align:left}");
-    html += F(".rowdisplay:flex;gap:16px;align-items:flex-start;flex-wrap:wrap}");
-    html += F(".mutedcolor:#6b7280;font-size:12px}");
-    html += F(".btndisplay:inline-block;margin-right:8px;padding:8px 10px;border-radius:8px;border:1px solid #d1d5db;background:#f9fafb}");
-    html += F(".btn:hoverbackground:#f3f4f6}");
-    html += F(".badgedisplay:inline-block;padding:2px 8px;border-radius:999px;background:#eef2ff;color:#3730a3;border:1px solid #c7d2fe;font-size:12px}");
-    html += F("</style></head><body>");
-    html += F("<header><div style='font-size:18px;font-weight:600'>Drainage Gateway</div><div class='muted'>LoRa · WLAN · MQTT</div></header>");
-    html += F("<main>");
-
-    html += F("<section class='card'><h2>Status</h2><div class='body'><div class='row'><div style='flex:1;min-width:260px'><table>");
-    html += F("<tr><th>WLAN</th><td>"); html += htmlEscape(wifi); html += F("</td></tr>");
-    html += F("<tr><th>IP</th><td>"); html += htmlEscape(ip); html += F("</td></tr>");
-    html += F("<tr><th>MQTT</th><td>"); html += htmlEscape(mqtt); html += F("</td></tr>");
-    html += F("<tr><th>LoRa letzte RX</th><td>"); html += htmlEscape(loraAge); html += F("</td></tr>");
-    html += F("<tr><th>RSSI</th><td>"); html += String(g_lastRssi); html += F("</td></tr>");
-    int8_t ota = getOtaDesired(1);
-    html += F("<tr><th>Drainage WLAN-AP</th><td>");
-    if (ota < 0) html += F("<span class='badge'>unbekannt</span>");
-    else if (ota == 1) html += F("<span class='badge'>Eingeschaltet</span>");
-    else html += F("<span class='badge'>Ausgeschaltet</span>");
-    html += F("</td></tr>");
-    html += F("</table></div></div></div></section>");
-
-    html += F("<section class='card'><h2>Sensor OTA-AP steuern</h2><div class='body'>");
-    html += F("<form method='POST' action='/sensor/ota'>");
-    html += F("Sensor-ID: <input type='number' name='sid' min='1' max='255' value='1'>\n");
-    html += F("<button class='btn' name='enable' value='1' type='submit'>AP einschalten</button>\n");
-    html += F("<button class='btn' name='enable' value='0' type='submit'>AP ausschalten</button>\n");
-    html += F("</form>");
-    html += F("<div class='muted'>Hinweis: Status basiert auf dem zuletzt angeforderten Zustand (ohne Bestätigung).</div>");
-    html += F("</div></section>");
-
-    html += F("</main></body></html>");
-    return html;
+  static const char *headers[] = { "If-None-Match" };
+  web.collectHeaders(headers, 1);
 }
 
-bool handleSensorOtaPost(int sid, bool enable)
+void webuiTouch()
 {
-    if (sid < 1 || sid > 255) return false;
-    setOtaDesired((uint8_t)sid, enable);
-    return true;
+  ++s_version;
 }
 
-static String htmlEscape(const String &s)
+// Vorlage abarbeiten: fester Text bis zum nächsten {{name}}, dann field(Index)
+template <typename Field>
+static void walkTemplate(const WebPage &page, WebWriter &out, Field field)
 {
-    String o; o.reserve(s.length()+8);
-    for (size_t i=0;i<s.length();++i){char c=s[i];
-        if(c=='&') o+="&amp;"; else if(c=='<') o+="&lt;"; else if(c=='>') o+="&gt;"; else o+=c;}
-    return o;
+  const char *p = page.tmpl;
+  for (;;)
+  {
+    const char *open = strstr(p, "{{");
+    if (!open) { out.print(p); return; }
+    out.write(p, (size_t)(open - p));
+    const char *name = open + 2;
+    const char *close = strstr(name, "}}");
+    if (!close) { out.print(open); return; }
+    const size_t len = (size_t)(close - name);
+    for (uint8_t i = 0; i < page.fieldCount && i < WEBUI_MAX_FIELDS; ++i)
+      if (strlen(page.fields[i]) == len && !strncmp(page.fields[i], name, len)) { field(i); break; }
+    p = close + 2;
+  }
 }
 
-static String fmtAge(unsigned long sinceMs)
+static bool fillCache(const WebPage &page)
 {
-    unsigned long s = sinceMs / 1000UL;
-    if (s < 60) return String(s) + "s";
-    unsigned long m = s / 60UL; s %= 60UL;
-    if (m < 60) return String(m) + "m" + (s?String(" ")+String(s)+"s":"");
-    unsigned long h = m / 60UL; m %= 60UL;
-    return String(h) + "h" + (m?String(" ")+String(m)+"m":"");
+  WebWriter cache(s_cache, sizeof(s_cache), nullptr);
+  for (uint8_t i = 0; i < page.fieldCount && i < WEBUI_MAX_FIELDS; ++i)
+  {
+    page.render(i, cache);
+    s_fieldEnd[i] = (uint16_t)cache.length();
+  }
+  return !cache.overflow();
+}
+
+void webuiServe(WebServer &web, const WebPage &page)
+{
+  // Inhalt gilt bis zur nächsten Datenänderung, höchstens WEBUI_CACHE_MS (Altersangaben)
+  const uint32_t epoch = millis() / WEBUI_CACHE_MS;
+  char etag[24];
+  const uint32_t version = s_version.load();
+  snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)version, (unsigned long)epoch);
+  web.sendHeader("ETag", etag);
+  web.sendHeader("Cache-Control", "no-cache");
+  if (web.header("If-None-Match") == etag) { web.send(304); return; }
+
+  const bool hit = s_cacheValid && s_cachedPage == &page && s_cachedVersion == version && s_cachedEpoch == epoch;
+  const bool tooBig = s_cachedPage == &page && s_streamBytes > sizeof(s_cache);
+  if (!hit && !tooBig)
+  {
+    if (page.lock) page.lock();
+    s_cacheValid = fillCache(page);
+    if (page.unlock) page.unlock();
+  }
+  else if (!hit)
+    s_cacheValid = false;
+  s_cachedPage = &page;
+  s_cachedVersion = version;
+  s_cachedEpoch = epoch;
+
+  web.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  web.send(200, "text/html; charset=utf-8", "");
+  char chunk[WEBUI_CHUNK_BYTES];
+  WebWriter out(chunk, sizeof(chunk), &web);
+  if (s_cacheValid)
+    walkTemplate(page, out, [&](uint8_t i) {
+      const uint16_t start = i ? s_fieldEnd[i - 1] : 0;
+      out.write(s_cache + start, s_fieldEnd[i] - start);
+    });
+  else
+  {
+    // Zu groß: je Feld unter der Sperre in den Chunk formatieren, gesendet wird ohne sie
+    size_t fieldBytes = 0;
+    walkTemplate(page, out, [&](uint8_t i) {
+      const size_t before = out.total();
+      if (page.lock) page.lock();
+      out.holdLock(page.lock, page.unlock);
+      page.render(i, out);
+      out.holdLock(nullptr, nullptr);
+      if (page.unlock) page.unlock();
+      fieldBytes += out.total() - before;
+    });
+    s_streamBytes = fieldBytes;
+  }
+  out.flush();
+  web.sendContent("");
 }
@@ -0,0 +1,12 @@
+#pragma once
+// Deutsche Dokumentation
+// Minimaler Host-Ersatz für Arduino.h: nur Zeit- und Zufallsfunktionen,
+// die von hardwareunabhängigem Code genutzt werden. Kein String, kein Serial.
+#include <cstddef>
+#include <cstdint>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+uint32_t esp_random();
@@ -0,0 +1,28 @@
+// Deutsche Dokumentation
+// Host-Ersatz für Arduino-Zeitfunktionen (Basis: std::chrono, Start = Programmstart)
+#include "Arduino.h"
+#include <chrono>
+#include <random>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+static const Clock::time_point s_start = Clock::now();
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - s_start).count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - s_start).count();
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+uint32_t esp_random()
+{
+    static std::mt19937 rng(std::random_device{}());
+    return (uint32_t)rng();
+}
@@ -0,0 +1,277 @@
+// Deutsche Dokumentation
+// Host-Ersatz für die genutzten mbedTLS-Funktionen (AES, SHA-256, HMAC).
+// Kompakte Referenzimplementierung ohne Tabellenoptimierung: funktional
+// korrekt (FIPS-197 / FIPS-180-4 / RFC 2104), aber nicht auf Tempo getrimmt.
+// Benchmark-Zahlen vom Host eignen sich daher nur für relative Vergleiche.
+#include "mbedtls/aes.h"
+#include "mbedtls/md.h"
+#include <cstring>
+
+// ---------------- AES ----------------
+
+static const uint8_t SBOX[256] = {
+    0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+    0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+    0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+    0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+    0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+    0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+    0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+    0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+    0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+    0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+    0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+    0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+    0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+    0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+    0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+    0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16
+};
+
+static inline uint8_t xtime(uint8_t x) { return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00)); }
+
+static inline uint32_t subWord(uint32_t w)
+{
+    return ((uint32_t)SBOX[(w >> 24) & 0xFF] << 24) | ((uint32_t)SBOX[(w >> 16) & 0xFF] << 16) |
+           ((uint32_t)SBOX[(w >> 8) & 0xFF] << 8) | (uint32_t)SBOX[w & 0xFF];
+}
+
+void mbedtls_aes_init(mbedtls_aes_context *ctx) { memset(ctx, 0, sizeof(*ctx)); }
+void mbedtls_aes_free(mbedtls_aes_context *ctx) { if (ctx) memset(ctx, 0, sizeof(*ctx)); }
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+    int nk;
+    switch (keybits) {
+        case 128: nk = 4; ctx->nr = 10; break;
+        case 256: nk = 8; ctx->nr = 14; break;
+        default: return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    }
+    const int total = 4 * (ctx->nr + 1);
+    for (int i = 0; i < nk; ++i)
+        ctx->rk[i] = ((uint32_t)key[4*i] << 24) | ((uint32_t)key[4*i+1] << 16) |
+                     ((uint32_t)key[4*i+2] << 8) | (uint32_t)key[4*i+3];
+    uint8_t rcon = 0x01;
+    for (int i = nk; i < total; ++i) {
+        uint32_t t = ctx->rk[i-1];
+        if (i % nk == 0) {
+            t = subWord((t << 8) | (t >> 24)) ^ ((uint32_t)rcon << 24);
+            rcon = xtime(rcon);
+        } else if (nk > 6 && i % nk == 4) {
+            t = subWord(t);
+        }
+        ctx->rk[i] = ctx->rk[i-nk] ^ t;
+    }
+    return 0;
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode,
+                          const unsigned char input[16], unsigned char output[16])
+{
+    if (mode != MBEDTLS_AES_ENCRYPT) return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH; // nur Verschlüsselung nötig (CTR)
+    uint8_t s[16];
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            s[4*c+r] = input[4*c+r] ^ (uint8_t)(ctx->rk[c] >> (24 - 8*r));
+    for (int round = 1; round <= ctx->nr; ++round) {
+        uint8_t t[16];
+        // SubBytes + ShiftRows
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                t[4*c+r] = SBOX[s[4*((c + r) & 3) + r]];
+        // MixColumns (nicht in der letzten Runde)
+        if (round != ctx->nr) {
+            for (int c = 0; c < 4; ++c) {
+                uint8_t *col = t + 4*c;
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+                col[0] ^= all ^ xtime(a0 ^ a1);
+                col[1] ^= all ^ xtime(a1 ^ a2);
+                col[2] ^= all ^ xtime(a2 ^ a3);
+                col[3] ^= all ^ xtime(a3 ^ a0);
+            }
+        }
+        // AddRoundKey
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                s[4*c+r] = t[4*c+r] ^ (uint8_t)(ctx->rk[4*round + c] >> (24 - 8*r));
+    }
+    memcpy(output, s, 16);
+    return 0;
+}
+
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length, size_t *nc_off,
+                          unsigned char nonce_counter[16], unsigned char stream_block[16],
+                          const unsigned char *input, unsigned char *output)
+{
+    size_t n = *nc_off;
+    if (n > 15) return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    for (size_t i = 0; i < length; ++i) {
+        if (n == 0) {
+            mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block);
+            for (int j = 15; j >= 0; --j)
+                if (++nonce_counter[j] != 0) break;
+        }
+        output[i] = input[i] ^ stream_block[n];
+        n = (n + 1) & 0x0F;
+    }
+    *nc_off = n;
+    return 0;
+}
+
+// ---------------- SHA-256 ----------------
+
+static const uint32_t K256[64] = {
+    0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+    0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+    0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+    0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+    0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+    0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+    0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+    0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+
+static inline uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static void shaBlock(mbedtls_sha256_state *st, const uint8_t *p)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i)
+        w[i] = ((uint32_t)p[4*i] << 24) | ((uint32_t)p[4*i+1] << 16) | ((uint32_t)p[4*i+2] << 8) | p[4*i+3];
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = ror(w[i-15], 7) ^ ror(w[i-15], 18) ^ (w[i-15] >> 3);
+        uint32_t s1 = ror(w[i-2], 17) ^ ror(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    uint32_t a = st->h[0], b = st->h[1], c = st->h[2], d = st->h[3];
+    uint32_t e = st->h[4], f = st->h[5], g = st->h[6], h = st->h[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+        uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+    }
+    st->h[0] += a; st->h[1] += b; st->h[2] += c; st->h[3] += d;
+    st->h[4] += e; st->h[5] += f; st->h[6] += g; st->h[7] += h;
+}
+
+static void shaStart(mbedtls_sha256_state *st)
+{
+    static const uint32_t IV[8] = { 0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,
+                                    0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19 };
+    memcpy(st->h, IV, sizeof(IV));
+    st->total = 0; st->bufLen = 0;
+}
+
+static void shaUpdate(mbedtls_sha256_state *st, const uint8_t *in, size_t len)
+{
+    st->total += len;
+    if (st->bufLen) {
+        size_t take = 64 - st->bufLen; if (take > len) take = len;
+        memcpy(st->buf + st->bufLen, in, take);
+        st->bufLen += take; in += take; len -= take;
+        if (st->bufLen < 64) return;
+        shaBlock(st, st->buf); st->bufLen = 0;
+    }
+    while (len >= 64) { shaBlock(st, in); in += 64; len -= 64; }
+    if (len) { memcpy(st->buf, in, len); st->bufLen = len; }
+}
+
+static void shaFinish(mbedtls_sha256_state *st, uint8_t out[32])
+{
+    const uint64_t bits = st->total * 8;
+    static const uint8_t PAD[64] = { 0x80 };
+    size_t padLen = (st->bufLen < 56) ? (56 - st->bufLen) : (120 - st->bufLen);
+    shaUpdate(st, PAD, padLen);
+    uint8_t lenBe[8];
+    for (int i = 0; i < 8; ++i) lenBe[i] = (uint8_t)(bits >> (56 - 8*i));
+    shaUpdate(st, lenBe, 8);
+    for (int i = 0; i < 8; ++i) {
+        out[4*i] = (uint8_t)(st->h[i] >> 24); out[4*i+1] = (uint8_t)(st->h[i] >> 16);
+        out[4*i+2] = (uint8_t)(st->h[i] >> 8); out[4*i+3] = (uint8_t)st->h[i];
+    }
+}
+
+// ---------------- md / HMAC ----------------
+
+static const mbedtls_md_info_t SHA256_INFO = { MBEDTLS_MD_SHA256, 32 };
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t md_type)
+{
+    return md_type == MBEDTLS_MD_SHA256 ? &SHA256_INFO : nullptr;
+}
+
+unsigned char mbedtls_md_get_size(const mbedtls_md_info_t *md_info) { return md_info ? md_info->size : 0; }
+
+void mbedtls_md_init(mbedtls_md_context_t *ctx) { memset(ctx, 0, sizeof(*ctx)); }
+void mbedtls_md_free(mbedtls_md_context_t *ctx) { if (ctx) memset(ctx, 0, sizeof(*ctx)); }
+
+int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *md_info, int hmac)
+{
+    if (!ctx || !md_info) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    ctx->md_info = md_info; ctx->hmac = hmac;
+    return 0;
+}
+
+int mbedtls_md_clone(mbedtls_md_context_t *dst, const mbedtls_md_context_t *src)
+{
+    if (!dst || !src || !dst->md_info || dst->md_info != src->md_info) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    dst->sha = src->sha; // wie mbedTLS: nur der Hash-Zustand, nicht ipad/opad
+    return 0;
+}
+
+int mbedtls_md_starts(mbedtls_md_context_t *ctx)
+{
+    if (!ctx || !ctx->md_info) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    shaStart(&ctx->sha); return 0;
+}
+
+int mbedtls_md_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t ilen)
+{
+    if (!ctx || !ctx->md_info) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    shaUpdate(&ctx->sha, input, ilen); return 0;
+}
+
+int mbedtls_md_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    if (!ctx || !ctx->md_info) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    shaFinish(&ctx->sha, output); return 0;
+}
+
+int mbedtls_md_hmac_starts(mbedtls_md_context_t *ctx, const unsigned char *key, size_t keylen)
+{
+    if (!ctx || !ctx->md_info || !ctx->hmac) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    uint8_t k[64] = {0};
+    if (keylen > 64) {
+        mbedtls_sha256_state t; shaStart(&t); shaUpdate(&t, key, keylen); shaFinish(&t, k);
+    } else if (keylen) {
+        memcpy(k, key, keylen);
+    }
+    for (int i = 0; i < 64; ++i) { ctx->ipad[i] = k[i] ^ 0x36; ctx->opad[i] = k[i] ^ 0x5c; }
+    return mbedtls_md_hmac_reset(ctx);
+}
+
+int mbedtls_md_hmac_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t ilen)
+{
+    return mbedtls_md_update(ctx, input, ilen);
+}
+
+int mbedtls_md_hmac_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    if (!ctx || !ctx->md_info || !ctx->hmac) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    uint8_t inner[32];
+    shaFinish(&ctx->sha, inner);
+    shaStart(&ctx->sha);
+    shaUpdate(&ctx->sha, ctx->opad, 64);
+    shaUpdate(&ctx->sha, inner, 32);
+    shaFinish(&ctx->sha, output);
+    return 0;
+}
+
+int mbedtls_md_hmac_reset(mbedtls_md_context_t *ctx)
+{
+    if (!ctx || !ctx->md_info || !ctx->hmac) return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    shaStart(&ctx->sha);
+    shaUpdate(&ctx->sha, ctx->ipad, 64);
+    return 0;
+}
@@ -0,0 +1,221 @@
+// Deutsche Dokumentation
+// Micro-Benchmark-Runner (Host): misst ns/op der hardwareunabhängigen Pfade.
+// Aufruf: pio run -e native -t exec
+// Ausgabe: eine Zeile je Benchmark (Name, Iterationen, ns/op), geeignet zum
+// Vergleichen zweier Stände (Regressionen), nicht als ESP32-Absolutwert.
+
+#include <Arduino.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "crypto.h"
+#include "lora_frame.h"
+#include "payload.h"
+#include "conversion.h"
+#include "adc_filter.h"
+#include "timeseries.h"
+#include "ts_downsample.h"
+
+// Verhindert, dass der Optimierer Ergebnisse wegwirft
+static volatile uint32_t g_sink = 0;
+
+// Führt fn so oft aus, bis mindestens minMs vergangen sind, und gibt ns/op aus
+template <typename Fn>
+static void bench(const char* name, Fn fn, unsigned minMs = 200)
+{
+    using Clock = std::chrono::steady_clock;
+    for (int i = 0; i < 100; ++i) fn(); // Aufwärmen
+    uint64_t iters = 0;
+    const auto t0 = Clock::now();
+    auto t1 = t0;
+    do {
+        for (int i = 0; i < 256; ++i) fn();
+        iters += 256;
+        t1 = Clock::now();
+    } while (t1 - t0 < std::chrono::milliseconds(minMs));
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    printf("%-34s %12llu %12.1f ns/op\n", name, (unsigned long long)iters, ns / (double)iters);
+}
+
+static const uint8_t AES_KEY[16]  = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+static const uint8_t HMAC_KEY[16] = { 16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1 };
+
+static void benchCrypto()
+{
+    uint8_t frame[LORA_FRAME_MAX_LEN] = {0x01};
+    uint8_t* nonce = frame + 1;
+    uint8_t* pt = loraFramePayload(frame);
+    memcpy(pt, "123.4", 5);
+
+    bench("crypto/legacy_frame_5B", [&]() {
+        nonce[0]++;
+        aesCtrCrypt(AES_KEY, nonce, frame[0], pt, 5);
+        hmacSha256Trunc(HMAC_KEY, sizeof(HMAC_KEY), frame, LORA_FRAME_HDR_LEN + 5, pt + 5, 8);
+        g_sink += pt[5];
+    });
+
+    static CryptoSession s;
+    s.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY));
+    bench("crypto/session_frame_5B", [&]() {
+        nonce[0]++;
+        s.ctrCrypt(nonce, frame[0], pt, 5);
+        s.mac(frame, LORA_FRAME_HDR_LEN + 5, pt + 5, 8);
+        g_sink += pt[5];
+    });
+
+    uint8_t master[32] = {0};
+    bench("crypto/derive_sensor_keys", [&]() {
+        uint8_t a[CRYPTO_AES_KEY_LEN], h[CRYPTO_HMAC_KEY_LEN];
+        deriveSensorKeys(master, sizeof(master), (uint8_t)g_sink, a, h);
+        g_sink += a[0];
+    });
+}
+
+static void benchFrame()
+{
+    static CryptoSession s;
+    s.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY));
+    uint8_t nonce[LORA_FRAME_NONCE_LEN] = {0};
+    uint8_t pt[64];
+    for (size_t i = 0; i < sizeof(pt); ++i) pt[i] = (uint8_t)i;
+    uint8_t frame[LORA_FRAME_MAX_LEN];
+
+    bench("frame/encode_8B", [&]() {
+        nonce[0]++;
+        g_sink += (uint32_t)loraFrameEncode(s, 1, nonce, pt, 8, frame, sizeof(frame));
+    });
+    bench("frame/encode_64B", [&]() {
+        nonce[0]++;
+        g_sink += (uint32_t)loraFrameEncode(s, 1, nonce, pt, 64, frame, sizeof(frame));
+    });
+
+    uint8_t sealed[LORA_FRAME_MAX_LEN];
+    const size_t len = loraFrameEncode(s, 1, nonce, pt, 8, sealed, sizeof(sealed));
+    bench("frame/open_8B", [&]() {
+        memcpy(frame, sealed, len);
+        const uint8_t* out; size_t outLen;
+        g_sink += loraFrameOpen(s, frame, len, &out, &outLen) ? (uint32_t)outLen : 0;
+    });
+}
+
+static void benchParse()
+{
+    static const uint8_t NUMERIC[] = { '1','2','3','.','4' };
+    bench("payload/parse_numeric", []() {
+        PayloadReading r;
+        parsePayload(NUMERIC, sizeof(NUMERIC), &r);
+        g_sink += (uint32_t)r.depthMm;
+    });
+    static const char LEGACY[] = "WATER_CM:123.4;STATUS:OK;MID:42";
+    bench("payload/parse_legacy", []() {
+        PayloadReading r;
+        parsePayload((const uint8_t*)LEGACY, sizeof(LEGACY) - 1, &r);
+        g_sink += (uint32_t)r.depthMm;
+    });
+    static uint8_t v2[PAYLOAD_V2_HDR_LEN];
+    payloadEncodeV2(v2, sizeof(v2), 0, 42, 1234);
+    bench("payload/parse_v2", []() {
+        PayloadReading r;
+        parsePayload(v2, sizeof(v2), &r);
+        g_sink += (uint32_t)r.depthMm;
+    });
+    bench("payload/encode_v2", []() {
+        uint8_t buf[PAYLOAD_V2_HDR_LEN];
+        g_sink += (uint32_t)payloadEncodeV2(buf, sizeof(buf), 0, (uint16_t)g_sink, 1234);
+    });
+    // Batch mit 6 Messwerten im 10-s-Raster (Kopf + 5 ältere)
+    static const BatchSample older[] = { {1233, 10}, {1231, 20}, {1230, 30}, {1228, 40}, {1227, 50} };
+    bench("payload/encode_batch6", []() {
+        uint8_t buf[32];
+        size_t len = payloadEncodeV2(buf, sizeof(buf), 0, (uint16_t)g_sink, 1234);
+        g_sink += (uint32_t)payloadAppendBatch(buf, sizeof(buf), len, 1234, older, 5);
+    });
+    static uint8_t batch[32];
+    static size_t batchLen = payloadAppendBatch(batch, sizeof(batch),
+        payloadEncodeV2(batch, sizeof(batch), 0, 42, 1234), 1234, older, 5);
+    bench("payload/parse_batch6", []() {
+        PayloadReading r;
+        parsePayload(batch, batchLen, &r);
+        size_t pos = 0; PayloadTlv tlv;
+        while (payloadNextTlv(r.ext, r.extLen, &pos, &tlv)) {
+            BatchCursor c; BatchSample s;
+            payloadBatchBegin(&c, tlv, r.depthMm);
+            while (payloadBatchNext(&c, &s)) g_sink += (uint32_t)s.depthMm;
+        }
+    });
+}
+
+static void benchConversion()
+{
+    uint32_t mv = 0;
+    static constexpr float points[][2] = { { 0.0f, 0.0f }, { 1000.0f, 130.0f }, { 3300.0f, 436.0f } };
+    static constexpr CalibrationLut lut = calibrationLutBuild(points);
+    bench("conversion/calibration_lut", [&]() {
+        mv = (mv + 17) & 0x0FFF;
+        g_sink += (uint32_t)calibrationDepthMmX10(lut, mv);
+    });
+}
+
+static void benchAdc()
+{
+    // 256 Rohwerte wie ein ADC-Burst (Rauschen ±8 LSB, eine Störspitze)
+    static uint16_t burst[256], work[256];
+    for (size_t i = 0; i < 256; ++i) burst[i] = (uint16_t)(1200 + (int)((i * 37) % 17) - 8);
+    for (size_t i = 100; i < 112; ++i) burst[i] = 4095;
+    AdcReduceResult r;
+    bench("adc/mean_256", [&]() {
+        memcpy(work, burst, sizeof(work));
+        adcReduce(work, 256, ADC_REDUCE_MEAN, 0, &r);
+        g_sink += (uint32_t)r.value;
+    });
+    bench("adc/trimmed_mean_256", [&]() {
+        memcpy(work, burst, sizeof(work));
+        adcReduce(work, 256, ADC_REDUCE_TRIMMED_MEAN, 20, &r);
+        g_sink += (uint32_t)r.value;
+    });
+    bench("adc/median_of_means_256", [&]() {
+        memcpy(work, burst, sizeof(work));
+        adcReduce(work, 256, ADC_REDUCE_MEDIAN_OF_MEANS, 8, &r);
+        g_sink += (uint32_t)r.value;
+    });
+}
+
+static void benchTimeseries()
+{
+    static uint8_t data[TS_TIER_COUNT][32 * TS_BLOCK_BYTES];
+    static TsBlockHeader headers[TS_TIER_COUNT][32];
+    uint8_t* const buffers[TS_TIER_COUNT] = { data[0], data[1], data[2] };
+    TsBlockHeader* const hdrs[TS_TIER_COUNT] = { headers[0], headers[1], headers[2] };
+    const uint16_t blocks[TS_TIER_COUNT] = { 32, 32, 32 };
+    static TsStore st;
+    tsStoreInit(&st, buffers, hdrs, blocks);
+    uint32_t t = 0;
+    bench("timeseries/add_10s", [&]() {
+        t += 10;
+        tsStoreAdd(&st, t, 1000 + (int32_t)((t * 37) % 7));
+    });
+    TsCursor c;
+    TsPoint p;
+    bench("timeseries/scan_minute_1h", [&]() {
+        tsStoreScan(&st, TS_MINUTE, t - 3600, t, &c);
+        while (tsCursorNext(&c, &p)) g_sink += (uint32_t)p.avg;
+    });
+    TsDownsampler d;
+    bench("timeseries/lttb_1d_to_200", [&]() {
+        tsDownsampleBegin(&d, &st, TS_MINUTE, t - 86400, t, 200);
+        while (tsDownsampleNext(&d, &p)) g_sink += (uint32_t)p.avg;
+    });
+}
+
+int main()
+{
+    printf("%-34s %12s %12s\n", "benchmark", "iterations", "time");
+    benchCrypto();
+    benchFrame();
+    benchParse();
+    benchConversion();
+    benchAdc();
+    benchTimeseries();
+    printf("(sink %lu, Laufzeit %lu ms)\n", (unsigned long)g_sink, millis());
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Deutsche Dokumentation
+// Unit-Tests: Auswertung von ADC-Bursts (Host). Die Puffer bilden aufgezeichnete
+// Bursts nach: Grundrauschen um einen festen Wert plus Störspitzen der Pumpenmotoren.
+#include <unity.h>
+#include <cstring>
+#include "adc_filter.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const size_t BURST = 256;
+
+// Reproduzierbares Rauschen (LCG), Dreiecksverteilung ±amp
+static uint32_t s_lcg = 12345;
+static int noise(int amp)
+{
+    s_lcg = s_lcg * 1103515245u + 12345u;
+    int a = (int)((s_lcg >> 16) % (amp + 1));
+    s_lcg = s_lcg * 1103515245u + 12345u;
+    int b = (int)((s_lcg >> 16) % (amp + 1));
+    return a - b;
+}
+
+static void fillBurst(uint16_t* buf, uint16_t level, int amp)
+{
+    s_lcg = 12345;
+    for (size_t i = 0; i < BURST; ++i) buf[i] = (uint16_t)(level + noise(amp));
+}
+
+// Anlaufspitze: ein Block von 12 Werten bei Vollausschlag (4095)
+static void addSpike(uint16_t* buf, size_t at)
+{
+    for (size_t i = at; i < at + 12 && i < BURST; ++i) buf[i] = 4095;
+}
+
+static void test_spike_skews_mean_but_not_robust_kernels()
+{
+    uint16_t buf[BURST], work[BURST];
+    fillBurst(buf, 1200, 6);
+    addSpike(buf, 100);
+    AdcReduceResult r;
+
+    memcpy(work, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(adcReduce(work, BURST, ADC_REDUCE_MEAN, 0, &r));
+    TEST_ASSERT_GREATER_THAN(1300, (int)r.value); // ~+135 LSB durch eine Spitze
+
+    memcpy(work, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(adcReduce(work, BURST, ADC_REDUCE_TRIMMED_MEAN, 10, &r));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 1200.0f, r.value);
+    TEST_ASSERT_EQUAL(4095, r.max);
+
+    memcpy(work, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(adcReduce(work, BURST, ADC_REDUCE_MEDIAN_OF_MEANS, 8, &r));
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 1200.0f, r.value);
+}
+
+static void test_clean_burst_all_modes_agree()
+{
+    uint16_t buf[BURST], work[BURST];
+    fillBurst(buf, 2000, 10);
+    AdcReduceResult mean, trim, mom;
+    memcpy(work, buf, sizeof(buf)); adcReduce(work, BURST, ADC_REDUCE_MEAN, 0, &mean);
+    memcpy(work, buf, sizeof(buf)); adcReduce(work, BURST, ADC_REDUCE_TRIMMED_MEAN, 25, &trim);
+    memcpy(work, buf, sizeof(buf)); adcReduce(work, BURST, ADC_REDUCE_MEDIAN_OF_MEANS, 8, &mom);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, mean.value, trim.value);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, mean.value, mom.value);
+    TEST_ASSERT_EQUAL(BURST, mean.count);
+}
+
+static void test_spread_tracks_noise_and_ignores_spikes()
+{
+    uint16_t buf[BURST];
+    AdcReduceResult quiet, noisy;
+    fillBurst(buf, 1500, 2);
+    adcReduce(buf, BURST, ADC_REDUCE_TRIMMED_MEAN, 10, &quiet);
+    fillBurst(buf, 1500, 20);
+    addSpike(buf, 0);
+    adcReduce(buf, BURST, ADC_REDUCE_TRIMMED_MEAN, 10, &noisy);
+    // Dreiecksverteilung ±a: Standardabweichung a/sqrt(6)
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 0.8f, quiet.spread);
+    TEST_ASSERT_FLOAT_WITHIN(2.5f, 8.2f, noisy.spread);
+}
+
+static void test_invalid_parameters()
+{
+    uint16_t buf[4] = {1, 2, 3, 4};
+    AdcReduceResult r;
+    TEST_ASSERT_FALSE(adcReduce(buf, 0, ADC_REDUCE_MEAN, 0, &r));
+    TEST_ASSERT_FALSE(adcReduce(buf, 4, ADC_REDUCE_TRIMMED_MEAN, 50, &r));
+    TEST_ASSERT_FALSE(adcReduce(buf, 4, ADC_REDUCE_MEDIAN_OF_MEANS, 5, &r));
+    TEST_ASSERT_TRUE(adcReduce(buf, 1, ADC_REDUCE_MEDIAN_OF_MEANS, 1, &r));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, r.value);
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spike_skews_mean_but_not_robust_kernels);
+    RUN_TEST(test_clean_burst_all_modes_agree);
+    RUN_TEST(test_spread_tracks_noise_and_ignores_spikes);
+    RUN_TEST(test_invalid_parameters);
+    return UNITY_END();
+}
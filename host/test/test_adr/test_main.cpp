@@ -0,0 +1,80 @@
+// Deutsche Dokumentation
+// Unit-Tests: Sendedauer und adaptive Datenrate (Host)
+#include <unity.h>
+#include "lora_airtime.h"
+#include "adr.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_time_on_air_matches_semtech_calculator()
+{
+    // Referenzwerte aus dem Semtech LoRa Calculator (125 kHz, CR 4/5, 8 Präambel, expl. Header)
+    LoRaModulation withCrc = loraModulationDefault(7);
+    withCrc.crc = true;
+    TEST_ASSERT_UINT32_WITHIN(50, 61696, loraTimeOnAirUs(withCrc, 23));
+    TEST_ASSERT_UINT32_WITHIN(50, 56576, loraTimeOnAirUs(loraModulationDefault(7), 23));
+    TEST_ASSERT_UINT32_WITHIN(50, 991232, loraTimeOnAirUs(loraModulationDefault(12), 10));
+    // SF12 mit Low-Data-Rate-Optimierung
+    TEST_ASSERT_UINT32_WITHIN(50, 1810432, loraTimeOnAirUs(loraModulationDefault(12), 35));
+    // SF7 gegen SF12 bei gleichem Frame: etwa Faktor 20-30
+    uint32_t t7 = loraTimeOnAirUs(loraModulationDefault(7), 35);
+    uint32_t t12 = loraTimeOnAirUs(loraModulationDefault(12), 35);
+    TEST_ASSERT_TRUE(t12 / t7 >= 20 && t12 / t7 <= 30);
+}
+
+static const AdrPolicy POLICY = { 10.0f, 7, 12, 2, 14, 8 };
+
+static LinkStats statsWith(float snr, int n)
+{
+    LinkStats s; linkStatsReset(&s);
+    for (int i = 0; i < n; ++i) linkStatsAdd(&s, -100, snr - (i % 3));
+    return s;
+}
+
+static void test_strong_link_lowers_sf_then_power()
+{
+    // SF12, bestes SNR +5 dB: Reserve 5 + 20 - 10 = 15 dB -> 5 Stufen
+    LinkStats s = statsWith(5.0f, 10);
+    RadioSettings out;
+    TEST_ASSERT_TRUE(adrRecommend(POLICY, s, { 12, 14 }, &out));
+    TEST_ASSERT_EQUAL_UINT8(7, out.sf);
+    TEST_ASSERT_EQUAL_INT8(14, out.txPowerDbm);
+    // schon SF7: Reserve 5 + 7,5 - 10 = 2,5 dB -> keine volle Stufe
+    TEST_ASSERT_FALSE(adrRecommend(POLICY, s, { 7, 14 }, &out));
+    // sehr starkes Signal: 10 + 7,5 - 10 = 7,5 dB -> Leistung zwei Stufen herunter
+    LinkStats strong = statsWith(10.0f, 10);
+    TEST_ASSERT_TRUE(adrRecommend(POLICY, strong, { 7, 14 }, &out));
+    TEST_ASSERT_EQUAL_UINT8(7, out.sf);
+    TEST_ASSERT_EQUAL_INT8(8, out.txPowerDbm);
+}
+
+static void test_weak_link_raises_power_then_sf()
+{
+    // SF7, bestes SNR -8 dB: Reserve -8 + 7,5 - 10 = -10,5 dB -> -4 Stufen
+    LinkStats s = statsWith(-8.0f, 10);
+    RadioSettings out;
+    TEST_ASSERT_TRUE(adrRecommend(POLICY, s, { 7, 8 }, &out));
+    TEST_ASSERT_EQUAL_INT8(14, out.txPowerDbm);
+    TEST_ASSERT_EQUAL_UINT8(9, out.sf);
+}
+
+static void test_needs_enough_frames_and_respects_fixed_sf()
+{
+    RadioSettings out;
+    TEST_ASSERT_FALSE(adrRecommend(POLICY, statsWith(5.0f, 5), { 12, 14 }, &out));
+    const AdrPolicy fixedSf = { 10.0f, 9, 9, 2, 14, 8 };
+    TEST_ASSERT_TRUE(adrRecommend(fixedSf, statsWith(5.0f, 10), { 9, 14 }, &out));
+    TEST_ASSERT_EQUAL_UINT8(9, out.sf);
+    TEST_ASSERT_EQUAL_INT8(8, out.txPowerDbm); // 5 + 12,5 - 10 = 7,5 dB -> 2 Stufen Leistung
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_time_on_air_matches_semtech_calculator);
+    RUN_TEST(test_strong_link_lowers_sf_then_power);
+    RUN_TEST(test_weak_link_raises_power_then_sf);
+    RUN_TEST(test_needs_enough_frames_and_respects_fixed_sf);
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// Deutsche Dokumentation
+// Unit-Tests: Alarmregeln mit Hysterese, Entprellung, Anstiegsrate und Stille (Host)
+#include <unity.h>
+#include "alert.h"
+
+void setUp() {}
+void tearDown() {}
+
+// 30 cm (2 Werte, 2 cm Hysterese), 180 cm sofort, Anstieg ab 30 cm/h, still ab 35 min
+static const AlertRule RULES[] = {
+    { ALERT_LEVEL, ALERT_INFO, 2, 300, 20 },
+    { ALERT_LEVEL, ALERT_CRITICAL, 1, 1800, 30 },
+    { ALERT_RISE, ALERT_WARNING, 2, 300, 100 },
+    { ALERT_STALE, ALERT_WARNING, 3, 35 * 60, 0 },
+};
+static const size_t RULE_COUNT = sizeof(RULES) / sizeof(RULES[0]);
+
+static size_t level(AlertState* s, int32_t mm, AlertTransition* out)
+{
+    AlertInput in = {};
+    in.hasLevel = true;
+    in.levelMm = mm;
+    return alertEvaluate(RULES, RULE_COUNT, s, in, out, 4);
+}
+
+static void test_level_needs_debounce_and_clears_below_hysteresis()
+{
+    AlertState s; alertReset(&s);
+    AlertTransition t[4];
+    TEST_ASSERT_EQUAL_UINT32(0, level(&s, 310, t));   // erster Wert über 30 cm: noch entprellt
+    TEST_ASSERT_EQUAL_UINT32(0, level(&s, 295, t));   // Welle: Zähler zurück
+    TEST_ASSERT_EQUAL_UINT32(0, level(&s, 305, t));
+    TEST_ASSERT_EQUAL_UINT32(1, level(&s, 302, t));
+    TEST_ASSERT_EQUAL_UINT8(0, t[0].rule);
+    TEST_ASSERT_TRUE(t[0].active);
+    TEST_ASSERT_EQUAL_INT32(302, t[0].value);
+
+    // Unter der Schwelle, aber innerhalb der Hysterese: bleibt aktiv
+    for (int i = 0; i < 5; ++i) TEST_ASSERT_EQUAL_UINT32(0, level(&s, 285, t));
+    TEST_ASSERT_TRUE(s.rule[0].active);
+    TEST_ASSERT_EQUAL_UINT32(0, level(&s, 275, t));
+    TEST_ASSERT_EQUAL_UINT32(1, level(&s, 270, t));
+    TEST_ASSERT_FALSE(t[0].active);
+    TEST_ASSERT_EQUAL(-1, alertHighestActive(RULES, RULE_COUNT, s));
+}
+
+static void test_critical_level_fires_on_first_sample_and_wins()
+{
+    AlertState s; alertReset(&s);
+    AlertTransition t[4];
+    level(&s, 400, t);
+    TEST_ASSERT_EQUAL_UINT32(1, level(&s, 400, t));
+    TEST_ASSERT_EQUAL(0, alertHighestActive(RULES, RULE_COUNT, s));
+    // Sprung über 180 cm: kritisch ohne Entprellung
+    TEST_ASSERT_EQUAL_UINT32(1, level(&s, 1805, t));
+    TEST_ASSERT_EQUAL_UINT8(1, t[0].rule);
+    TEST_ASSERT_EQUAL(1, alertHighestActive(RULES, RULE_COUNT, s));
+    TEST_ASSERT_EQUAL_STRING("critical", alertSeverityName(RULES[1].severity));
+    // Pegelmessung berührt Anstiegs- und Stille-Regel nicht
+    TEST_ASSERT_FALSE(s.rule[2].active);
+    TEST_ASSERT_FALSE(s.rule[3].active);
+}
+
+static void test_rate_of_rise_with_hysteresis()
+{
+    AlertState s; alertReset(&s);
+    AlertTransition t[4];
+    AlertInput in = {};
+    in.hasRate = true;
+    in.rateMmPerH = 350;
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_EQUAL_UINT8(2, t[0].rule);
+    TEST_ASSERT_EQUAL_STRING("rise", alertKindName(RULES[t[0].rule].kind));
+    in.rateMmPerH = 250; // innerhalb der 10 cm/h Hysterese
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    in.rateMmPerH = -50;
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_FALSE(t[0].active);
+}
+
+static void test_stale_fires_once_and_clears_on_next_uplink()
+{
+    AlertState s; alertReset(&s);
+    AlertTransition t[4];
+    AlertInput in = {};
+    in.hasSilence = true;
+    in.silentS = 34 * 60;
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    in.silentS = 35 * 60; // Stille ohne Entprellung (zyklisch geprüft)
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_EQUAL_UINT8(3, t[0].rule);
+    TEST_ASSERT_EQUAL_INT32(35 * 60, t[0].value);
+    in.silentS = 50 * 60;
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    // Uplink: zurück ohne Hysterese, zusammen mit einem Pegelwert
+    in.silentS = 0;
+    in.hasLevel = true;
+    in.levelMm = 100;
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 4));
+    TEST_ASSERT_FALSE(t[0].active);
+}
+
+static void test_output_limit_defers_remaining_transitions()
+{
+    AlertState s; alertReset(&s);
+    AlertTransition t[4];
+    AlertInput in = {};
+    in.hasLevel = true;
+    in.levelMm = 2000;
+    // 30 cm braucht zwei Werte, 180 cm schlägt sofort an; nur ein Platz frei
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 1));
+    TEST_ASSERT_EQUAL_UINT8(1, t[0].rule);
+    TEST_ASSERT_EQUAL_UINT32(1, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, t[0].rule);
+    TEST_ASSERT_EQUAL_UINT32(0, alertEvaluate(RULES, RULE_COUNT, &s, in, t, 1));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_level_needs_debounce_and_clears_below_hysteresis);
+    RUN_TEST(test_critical_level_fires_on_first_sample_and_wins);
+    RUN_TEST(test_rate_of_rise_with_hysteresis);
+    RUN_TEST(test_stale_fires_once_and_clears_on_next_uplink);
+    RUN_TEST(test_output_limit_defers_remaining_transitions);
+    return UNITY_END();
+}
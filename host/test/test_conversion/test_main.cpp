@@ -0,0 +1,64 @@
+// Deutsche Dokumentation
+// Unit-Tests: Umrechnung mV -> cm (Host)
+#include <unity.h>
+#include "conversion.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Kalibrierpunkte wie im Schacht aufgenommen: Offset, gekrümmte Kennlinie oben
+static constexpr float POINTS[][2] = {
+    {  120.0f,   0.0f },
+    {  400.0f,  40.0f },
+    { 1000.0f, 130.0f },
+    { 2600.0f, 380.0f },
+    { 3100.0f, 450.0f },
+};
+static_assert(calibrationPointsValid(POINTS), "Testpunkte ungültig");
+static constexpr CalibrationLut LUT = calibrationLutBuild(POINTS);
+static constexpr float UNSORTED[][2] = { { 0.0f, 0.0f }, { 500.0f, 10.0f }, { 500.0f, 20.0f } };
+static_assert(!calibrationPointsValid(UNSORTED), "gleiche mV müssen abgelehnt werden");
+
+static void test_calibration_hits_reference_points()
+{
+    // an den Kalibrierpunkten selbst (Knick in der Tabellenzelle) höchstens 1 mm daneben
+    for (const auto& p : POINTS) {
+        const int32_t expected = (int32_t)(p[1] * 100.0f + 0.5f);
+        TEST_ASSERT_INT32_WITHIN(10, expected, calibrationDepthMmX10(LUT, (uint32_t)p[0]));
+    }
+    // zwischen den Punkten linear: 1800 mV liegt mitten im Segment 1000..2600
+    TEST_ASSERT_INT32_WITHIN(1, 25500, calibrationDepthMmX10(LUT, 1800));
+    TEST_ASSERT_INT32_WITHIN(1, 8500, calibrationDepthMmX10(LUT, 700));
+}
+
+static void test_calibration_matches_exact_curve()
+{
+    // gesamter ADC-Bereich gegen die exakte Stückweise-Lineare (Float-Referenz)
+    int32_t worst = 0;
+    for (uint32_t mv = 0; mv <= CAL_LUT_MAX_MV; ++mv) {
+        const int32_t exact = (int32_t)(calibrationCm(POINTS, (float)mv) * 100.0f + 0.5f);
+        int32_t err = calibrationDepthMmX10(LUT, mv) - exact;
+        if (err < 0) err = -err;
+        if (err > worst) worst = err;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(10, worst);
+}
+
+static void test_calibration_outside_points()
+{
+    // unter dem ersten Punkt: negativ -> 0; über dem letzten: letztes Segment verlängert
+    TEST_ASSERT_EQUAL_INT32(0, calibrationDepthMmX10(LUT, 0));
+    TEST_ASSERT_EQUAL_INT32(0, calibrationDepthMmX10(LUT, 100));
+    TEST_ASSERT_INT32_WITHIN(1, 45000 + 2800, calibrationDepthMmX10(LUT, 3300));
+    // über dem Tabellenende begrenzt, kein Zugriff außerhalb
+    TEST_ASSERT_EQUAL_INT32(calibrationDepthMmX10(LUT, CAL_LUT_MAX_MV), calibrationDepthMmX10(LUT, 60000));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_calibration_hits_reference_points);
+    RUN_TEST(test_calibration_matches_exact_curve);
+    RUN_TEST(test_calibration_outside_points);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+// Deutsche Dokumentation
+// Unit-Tests: Krypto-Helfer und CryptoSession (Host)
+#include <unity.h>
+#include <cstring>
+#include "crypto.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void fill(uint8_t* p, size_t n, uint8_t seed)
+{
+    for (size_t i = 0; i < n; ++i) p[i] = (uint8_t)(seed + i * 7);
+}
+
+// RFC 4231, Testfall 2 (HMAC-SHA256)
+static void test_hmac_rfc4231()
+{
+    static const uint8_t expect[32] = {
+        0x5b,0xdc,0xc1,0x46,0xbf,0x60,0x75,0x4e,0x6a,0x04,0x24,0x26,0x08,0x95,0x75,0xc7,
+        0x5a,0x00,0x3f,0x08,0x9d,0x27,0x39,0x83,0x9d,0xec,0x58,0xb9,0x64,0xec,0x38,0x43 };
+    const char* msg = "what do ya want for nothing?";
+    uint8_t out[32];
+    TEST_ASSERT_TRUE(hmacSha256Trunc((const uint8_t*)"Jefe", 4, (const uint8_t*)msg, strlen(msg), out, 32));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, out, 32);
+
+    CryptoSession s;
+    uint8_t aes[16] = {0};
+    TEST_ASSERT_TRUE(s.begin(aes, (const uint8_t*)"Jefe", 4));
+    memset(out, 0, sizeof(out));
+    TEST_ASSERT_TRUE(s.mac((const uint8_t*)msg, strlen(msg), out, 32));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, out, 32);
+}
+
+// RFC 5869, Testfall 1 (HKDF-SHA256)
+static void test_hkdf_rfc5869()
+{
+    static const uint8_t expect[42] = {
+        0x3c,0xb2,0x5f,0x25,0xfa,0xac,0xd5,0x7a,0x90,0x43,0x4f,0x64,0xd0,0x36,0x2f,0x2a,
+        0x2d,0x2d,0x0a,0x90,0xcf,0x1a,0x5a,0x4c,0x5d,0xb0,0x2d,0x56,0xec,0xc4,0xc5,0xbf,
+        0x34,0x00,0x72,0x08,0xd5,0xb8,0x87,0x18,0x58,0x65 };
+    uint8_t ikm[22], salt[13], info[10], okm[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+    for (int i = 0; i < 13; ++i) salt[i] = (uint8_t)i;
+    for (int i = 0; i < 10; ++i) info[i] = (uint8_t)(0xf0 + i);
+    TEST_ASSERT_TRUE(hkdfSha256(salt, sizeof(salt), ikm, sizeof(ikm), info, sizeof(info), okm, sizeof(okm)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, okm, sizeof(okm));
+}
+
+static void test_session_matches_legacy()
+{
+    uint8_t aesKey[16], hmacKey[32];
+    fill(aesKey, sizeof(aesKey), 1);
+    fill(hmacKey, sizeof(hmacKey), 2);
+    CryptoSession s;
+    TEST_ASSERT_TRUE(s.begin(aesKey, hmacKey, sizeof(hmacKey)));
+
+    for (size_t n = 0; n < 100; n += 9) {
+        uint8_t a[100], b[100], nonce[8], macA[8], macB[8];
+        fill(a, n, (uint8_t)n); memcpy(b, a, n);
+        fill(nonce, sizeof(nonce), (uint8_t)(n + 3));
+        TEST_ASSERT_TRUE(aesCtrCrypt(aesKey, nonce, (uint8_t)n, a, n));
+        TEST_ASSERT_TRUE(s.ctrCrypt(nonce, (uint8_t)n, b, n));
+        TEST_ASSERT_EQUAL_MEMORY(a, b, n);
+        TEST_ASSERT_TRUE(hmacSha256Trunc(hmacKey, sizeof(hmacKey), a, n, macA, 8));
+        TEST_ASSERT_TRUE(s.mac(b, n, macB, 8));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(macA, macB, 8);
+    }
+}
+
+static void test_sensor_keys_differ_per_id()
+{
+    uint8_t master[32];
+    fill(master, sizeof(master), 9);
+    uint8_t aes1[16], hmac1[32], aes2[16], hmac2[32], aes1b[16], hmac1b[32];
+    TEST_ASSERT_TRUE(deriveSensorKeys(master, sizeof(master), 1, aes1, hmac1));
+    TEST_ASSERT_TRUE(deriveSensorKeys(master, sizeof(master), 2, aes2, hmac2));
+    TEST_ASSERT_TRUE(deriveSensorKeys(master, sizeof(master), 1, aes1b, hmac1b));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(aes1, aes1b, 16);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(hmac1, hmac1b, 32);
+    TEST_ASSERT_FALSE(memcmp(aes1, aes2, 16) == 0);
+    TEST_ASSERT_FALSE(memcmp(hmac1, hmac2, 32) == 0);
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hmac_rfc4231);
+    RUN_TEST(test_hkdf_rfc5869);
+    RUN_TEST(test_session_matches_legacy);
+    RUN_TEST(test_sensor_keys_differ_per_id);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// Deutsche Dokumentation
+// Unit-Tests: Downlink-Befehle, Quittungen und Warteschlange (Host)
+#include <unity.h>
+#include "downlink.h"
+#include "downlink_queue.h"
+
+void setUp() {}
+void tearDown() {}
+
+static DownlinkCommand otaCmd(uint16_t id, bool on)
+{
+    DownlinkCommand c = {};
+    c.id = id; c.opcode = DL_OP_OTA_AP; c.argLen = 1; c.args[0] = on ? 1 : 0;
+    return c;
+}
+
+static void test_command_roundtrip()
+{
+    uint8_t buf[16];
+    DownlinkCommand in = otaCmd(0xBEEF, true), out;
+    size_t len = downlinkEncode(in, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT(DOWNLINK_HDR_LEN + 1, len);
+    TEST_ASSERT_TRUE(downlinkDecode(buf, len, &out));
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, out.id);
+    TEST_ASSERT_EQUAL_UINT8(DL_OP_OTA_AP, out.opcode);
+    TEST_ASSERT_EQUAL_UINT8(1, out.argLen);
+    TEST_ASSERT_EQUAL_UINT8(1, out.args[0]);
+    // alter ASCII-Befehl wird nicht als Downlink v1 erkannt
+    TEST_ASSERT_FALSE(downlinkDecode((const uint8_t*)"CMD:OTA_AP_ON", 13, &out));
+    TEST_ASSERT_FALSE(downlinkDecode(buf, 3, &out));
+}
+
+static void test_acks_piggyback_on_uplink()
+{
+    uint8_t buf[32];
+    size_t len = payloadEncodeV2(buf, sizeof(buf), 0, 1, 100);
+    const DownlinkAck acks[] = { {7, DL_ACK_OK}, {8, DL_ACK_REJECTED} };
+    len = payloadAppendAcks(buf, sizeof(buf), len, acks, 2);
+    TEST_ASSERT_EQUAL_UINT(PAYLOAD_V2_HDR_LEN + 2 + 6, len);
+
+    PayloadReading r;
+    TEST_ASSERT_TRUE(parsePayload(buf, len, &r));
+    size_t pos = 0; PayloadTlv tlv;
+    TEST_ASSERT_TRUE(payloadNextTlv(r.ext, r.extLen, &pos, &tlv));
+    TEST_ASSERT_EQUAL_UINT8(PAYLOAD_TLV_ACK, tlv.type);
+    size_t apos = 0; DownlinkAck a;
+    TEST_ASSERT_TRUE(payloadNextAck(tlv, &apos, &a));
+    TEST_ASSERT_EQUAL_UINT16(7, a.id);
+    TEST_ASSERT_TRUE(payloadNextAck(tlv, &apos, &a));
+    TEST_ASSERT_EQUAL_UINT16(8, a.id);
+    TEST_ASSERT_EQUAL_UINT8(DL_ACK_REJECTED, a.status);
+    TEST_ASSERT_FALSE(payloadNextAck(tlv, &apos, &a));
+}
+
+static const DownlinkPolicy POLICY = { 3, 600000 };
+
+static void test_queue_retries_until_ack()
+{
+    DownlinkQueue q; downlinkQueueReset(&q);
+    TEST_ASSERT_TRUE(downlinkQueuePush(&q, otaCmd(1, true), 0));
+    DownlinkCommand exp[2], done;
+    // zwei Uplinks ohne Quittung -> zwei Versuche
+    for (int i = 1; i <= 2; ++i) {
+        TEST_ASSERT_EQUAL_UINT(0, downlinkQueueExpire(&q, POLICY, i * 1000, exp, 2));
+        const DownlinkEntry* e = downlinkQueueTake(&q, i * 1000);
+        TEST_ASSERT_NOT_NULL(e);
+        TEST_ASSERT_EQUAL_UINT8(i, e->attempts);
+    }
+    TEST_ASSERT_TRUE(downlinkQueueAck(&q, 1, &done));
+    TEST_ASSERT_EQUAL_UINT8(1, done.args[0]);
+    TEST_ASSERT_FALSE(downlinkQueueAck(&q, 1, &done)); // doppelte Quittung
+    TEST_ASSERT_NULL(downlinkQueueTake(&q, 3000));
+}
+
+static void test_queue_expiry_and_replace()
+{
+    DownlinkQueue q; downlinkQueueReset(&q);
+    downlinkQueuePush(&q, otaCmd(1, true), 0);
+    downlinkQueuePush(&q, otaCmd(2, false), 10); // ersetzt Befehl 1
+    TEST_ASSERT_EQUAL_UINT8(1, q.count);
+    TEST_ASSERT_EQUAL_UINT16(2, downlinkQueueFind(&q, DL_OP_OTA_AP)->cmd.id);
+
+    DownlinkCommand exp[2];
+    for (int i = 0; i < POLICY.maxAttempts; ++i) downlinkQueueTake(&q, 100 + i);
+    TEST_ASSERT_EQUAL_UINT(1, downlinkQueueExpire(&q, POLICY, 200, exp, 2));
+    TEST_ASSERT_EQUAL_UINT16(2, exp[0].id);
+    TEST_ASSERT_EQUAL_UINT8(0, q.count);
+
+    // Ablauf über das Alter
+    downlinkQueuePush(&q, otaCmd(3, true), 1000);
+    TEST_ASSERT_EQUAL_UINT(0, downlinkQueueExpire(&q, POLICY, 1000 + POLICY.expiryMs - 1, exp, 2));
+    TEST_ASSERT_EQUAL_UINT(1, downlinkQueueExpire(&q, POLICY, 1000 + POLICY.expiryMs, exp, 2));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_command_roundtrip);
+    RUN_TEST(test_acks_piggyback_on_uplink);
+    RUN_TEST(test_queue_retries_until_ack);
+    RUN_TEST(test_queue_expiry_and_replace);
+    return UNITY_END();
+}
@@ -0,0 +1,93 @@
+// Deutsche Dokumentation
+// Unit-Tests: Bereichsabfrage mit LTTB-Ausdünnung auf dem Zeitreihen-Speicher (Host)
+#include <unity.h>
+#include "ts_downsample.h"
+
+void setUp() {}
+void tearDown() {}
+
+static uint8_t s_data[3][64 * TS_BLOCK_BYTES];
+static TsBlockHeader s_headers[3][64];
+
+static void initStore(TsStore* st, uint16_t minuteBlocks)
+{
+    uint8_t* const buffers[TS_TIER_COUNT] = { s_data[0], s_data[1], s_data[2] };
+    TsBlockHeader* const headers[TS_TIER_COUNT] = { s_headers[0], s_headers[1], s_headers[2] };
+    const uint16_t blocks[TS_TIER_COUNT] = { minuteBlocks, 8, 4 };
+    tsStoreInit(st, buffers, headers, blocks);
+}
+
+static const uint32_t T0 = 1700000000u - 1700000000u % 86400;
+
+static void test_short_range_passes_through()
+{
+    TsStore st; initStore(&st, 16);
+    for (uint32_t i = 0; i < 50; ++i) tsStoreAdd(&st, T0 + i * 60, (int32_t)i * 3);
+    TsDownsampler d; TsPoint p;
+    tsDownsampleBegin(&d, &st, TS_MINUTE, T0, T0 + 3600, 100);
+    TEST_ASSERT_EQUAL_UINT32(50, d.total);
+    uint32_t n = 0;
+    while (tsDownsampleNext(&d, &p)) {
+        TEST_ASSERT_EQUAL_UINT32(T0 + n * 60, p.t);
+        TEST_ASSERT_EQUAL_INT32((int32_t)n * 3, p.avg);
+        ++n;
+    }
+    TEST_ASSERT_EQUAL_UINT32(50, n);
+}
+
+static void test_lttb_keeps_endpoints_and_peaks()
+{
+    TsStore st; initStore(&st, 64);
+    // 3 Tage Minutenwerte: ruhiger Pegel mit zwei kurzen Pumpen-Spitzen
+    const uint32_t minutes = 3 * 1440;
+    for (uint32_t i = 0; i < minutes; ++i) {
+        int32_t v = 300 + (int32_t)(i % 7);
+        if (i == 1000) v = 900;
+        if (i == 3000) v = 20;
+        tsStoreAdd(&st, T0 + i * 60, v);
+    }
+    TsDownsampler d; TsPoint p;
+    tsDownsampleBegin(&d, &st, TS_MINUTE, 0, UINT32_MAX, 200);
+    TEST_ASSERT_EQUAL_UINT32(minutes, d.total);
+    uint32_t n = 0, lastT = 0;
+    bool high = false, low = false;
+    while (tsDownsampleNext(&d, &p)) {
+        if (n == 0) TEST_ASSERT_EQUAL_UINT32(T0, p.t);
+        else TEST_ASSERT_TRUE(p.t > lastT);
+        lastT = p.t;
+        high |= p.avg == 900;
+        low |= p.avg == 20;
+        ++n;
+    }
+    TEST_ASSERT_EQUAL_UINT32(200, n);
+    TEST_ASSERT_EQUAL_UINT32(T0 + (minutes - 1) * 60, lastT);
+    TEST_ASSERT_TRUE(high);
+    TEST_ASSERT_TRUE(low);
+}
+
+static void test_tier_follows_range_and_coverage()
+{
+    TsStore st; initStore(&st, 4);
+    // 20 Tage Minutenwerte: der Minuten-Ring (4 Blöcke) hält nur die letzten Tage
+    const uint32_t end = T0 + 20 * 86400;
+    for (uint32_t t = T0; t < end; t += 60) tsStoreAdd(&st, t, 500 + (int32_t)((t / 60) % 11));
+    const uint32_t minuteOldest = tsSeriesOldest(&st.tier[TS_MINUTE]);
+    TEST_ASSERT_TRUE(minuteOldest > T0);
+
+    // letzte Stunde: Minuten; letzte 30 Tage: Minuten fehlen am Anfang, 480 h passen
+    TEST_ASSERT_EQUAL(TS_MINUTE, tsPickTier(&st, end - 3600, end, 100, 4));
+    TEST_ASSERT_EQUAL(TS_HOUR, tsPickTier(&st, end - 20 * 86400, end, 500, 4));
+    // zu viele Stundenwerte für 10 Punkte: Tage
+    TEST_ASSERT_EQUAL(TS_DAY, tsPickTier(&st, end - 20 * 86400, end, 10, 4));
+    // noch kürzer, als die Minuten reichen, aber zu viele Minutenwerte: Stunden
+    TEST_ASSERT_EQUAL(TS_HOUR, tsPickTier(&st, minuteOldest, end, 50, 4));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_short_range_passes_through);
+    RUN_TEST(test_lttb_keeps_endpoints_and_peaks);
+    RUN_TEST(test_tier_follows_range_and_coverage);
+    return UNITY_END();
+}
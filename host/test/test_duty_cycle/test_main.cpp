@@ -0,0 +1,68 @@
+// Deutsche Dokumentation
+// Unit-Tests: Sendezeit-Konto für den Duty-Cycle (Host)
+#include <unity.h>
+#include "duty_cycle.h"
+#include "lora_airtime.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const uint32_t HOUR_MS = 3600UL * 1000UL;
+
+static void test_budget_is_one_percent_of_an_hour()
+{
+    DutyCycle d; dutyCycleInit(&d, 10, HOUR_MS);
+    TEST_ASSERT_EQUAL_UINT32(36000000UL, d.budgetUs);
+    TEST_ASSERT_EQUAL_UINT32(36000000UL, dutyCycleRemainingUs(&d, 0));
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, 0, 61696));
+    TEST_ASSERT_EQUAL_UINT32(61696, dutyCycleUsedUs(&d, 1000));
+}
+
+static void test_flood_rate_at_sf12_hits_the_limit()
+{
+    // Batch-Frame (35 Byte) bei SF12 alle 10 s: 1,8 s je Frame -> nach 19 Frames ist die Stunde voll
+    DutyCycle d; dutyCycleInit(&d, 10, HOUR_MS);
+    const uint32_t toa = loraTimeOnAirUs(loraModulationDefault(12), 35);
+    int sent = 0;
+    uint32_t t = 0;
+    for (; t < HOUR_MS; t += 10000)
+        if (dutyCycleTryConsume(&d, t, toa)) ++sent;
+    TEST_ASSERT_EQUAL(36000000UL / toa, (uint32_t)sent);
+    TEST_ASSERT_EQUAL_UINT32(360 - sent, d.deferred);
+    TEST_ASSERT_LESS_OR_EQUAL(36000000UL, dutyCycleUsedUs(&d, t));
+}
+
+static void test_budget_frees_after_window()
+{
+    DutyCycle d; dutyCycleInit(&d, 10, HOUR_MS);
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, 0, 20000000UL));
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, 30UL * 60000UL, 16000000UL));
+    TEST_ASSERT_FALSE(dutyCycleTryConsume(&d, 30UL * 60000UL + 5000, 100000));
+    // die erste Buchung fällt nach einer Stunde (plus Rest der Scheibe) heraus
+    TEST_ASSERT_EQUAL_UINT32(HOUR_MS - 30UL * 60000UL - 5000, dutyCycleWaitMs(&d, 30UL * 60000UL + 5000, 100000));
+    TEST_ASSERT_FALSE(dutyCycleTryConsume(&d, HOUR_MS - 1, 100000));
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, HOUR_MS, 100000));
+    TEST_ASSERT_EQUAL_UINT32(16100000UL, dutyCycleUsedUs(&d, HOUR_MS));
+    // lange Pause: alles frei
+    TEST_ASSERT_EQUAL_UINT32(0, dutyCycleUsedUs(&d, 3 * HOUR_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, dutyCycleWaitMs(&d, 3 * HOUR_MS, 100000));
+}
+
+static void test_millis_overflow()
+{
+    DutyCycle d; dutyCycleInit(&d, 10, HOUR_MS);
+    const uint32_t start = UINT32_MAX - 30000;
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, start, 30000000UL));
+    TEST_ASSERT_FALSE(dutyCycleTryConsume(&d, start + 120000, 10000000UL)); // über den Überlauf hinweg
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&d, start + HOUR_MS, 10000000UL));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_budget_is_one_percent_of_an_hour);
+    RUN_TEST(test_flood_rate_at_sf12_hits_the_limit);
+    RUN_TEST(test_budget_frees_after_window);
+    RUN_TEST(test_millis_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,205 @@
+// Deutsche Dokumentation
+// Unit-Tests: absturzsicheres Messwert-Log im Flash (Host, NOR-Flash im RAM nachgebildet)
+#include <unity.h>
+#include <cstring>
+#include "flash_log.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const uint16_t SECTORS = 4;
+static const uint16_t RECORDS_PER_SECTOR = FLASH_LOG_SLOTS - 1;
+
+// NOR-Flash: Schreiben kann Bits nur löschen (1 -> 0), Löschen setzt einen Sektor auf 0xFF.
+// writeBudget begrenzt die noch geschriebenen Bytes (Stromausfall mitten im Schreiben).
+struct NorFlash
+{
+    uint8_t mem[SECTORS * FLASH_LOG_SECTOR_BYTES];
+    long writeBudget;
+    uint32_t erases[SECTORS];
+};
+
+static NorFlash s_flash;
+
+static bool norRead(void* ctx, uint32_t offset, void* buf, size_t len)
+{
+    NorFlash* f = (NorFlash*)ctx;
+    if (offset + len > sizeof(f->mem)) return false;
+    memcpy(buf, f->mem + offset, len);
+    return true;
+}
+
+static bool norWrite(void* ctx, uint32_t offset, const void* buf, size_t len)
+{
+    NorFlash* f = (NorFlash*)ctx;
+    if (offset + len > sizeof(f->mem)) return false;
+    for (size_t i = 0; i < len; ++i) {
+        if (f->writeBudget == 0) return false;
+        if (f->writeBudget > 0) --f->writeBudget;
+        f->mem[offset + i] &= ((const uint8_t*)buf)[i];
+    }
+    return true;
+}
+
+static bool norErase(void* ctx, uint32_t offset)
+{
+    NorFlash* f = (NorFlash*)ctx;
+    if (offset % FLASH_LOG_SECTOR_BYTES || offset >= sizeof(f->mem)) return false;
+    memset(f->mem + offset, 0xFF, FLASH_LOG_SECTOR_BYTES);
+    ++f->erases[offset / FLASH_LOG_SECTOR_BYTES];
+    return true;
+}
+
+static FlashLogIo freshFlash()
+{
+    memset(&s_flash, 0xFF, sizeof(s_flash.mem));
+    memset(s_flash.erases, 0, sizeof(s_flash.erases));
+    s_flash.writeBudget = -1;
+    return { &s_flash, norRead, norWrite, norErase, sizeof(s_flash.mem) };
+}
+
+static FlashLogRecord sample(uint32_t i)
+{
+    return { 1700000000u + i * 10, (int32_t)(1000 + i % 97) - 50, (uint8_t)(1 + i % 3), FLASH_LOG_DEPTH_MM, 0 };
+}
+
+// Alle Sätze ab fromTSec lesen; prüft lückenlose Folge first, first+1, ...
+static uint32_t readBack(const FlashLog* log, uint32_t fromTSec, uint32_t first)
+{
+    FlashLogCursor c; FlashLogRecord r;
+    uint32_t n = 0;
+    flashLogScan(log, fromTSec, &c);
+    while (flashLogNext(&c, &r)) {
+        const FlashLogRecord e = sample(first + n);
+        TEST_ASSERT_EQUAL_UINT32(e.tSec, r.tSec);
+        TEST_ASSERT_EQUAL_INT32(e.value, r.value);
+        TEST_ASSERT_EQUAL_UINT8(e.sid, r.sid);
+        TEST_ASSERT_EQUAL_UINT8(FLASH_LOG_DEPTH_MM, r.kind);
+        ++n;
+    }
+    return n;
+}
+
+static void test_records_survive_remount()
+{
+    const FlashLogIo io = freshFlash();
+    FlashLogSectorInfo index[SECTORS];
+    FlashLog log;
+    TEST_ASSERT_TRUE(flashLogMount(&log, io, index, SECTORS));
+    TEST_ASSERT_EQUAL_UINT16(0, log.usedSectors);
+
+    for (uint32_t i = 0; i < 300; ++i) TEST_ASSERT_TRUE(flashLogAppend(&log, sample(i)));
+    // 300 Sätze: ein voller Sektor, im zweiten Kopf + 45 Sätze, davon 2 ganze Seiten geschrieben
+    TEST_ASSERT_EQUAL_UINT16(14, flashLogPending(&log));
+    TEST_ASSERT_TRUE(flashLogFlush(&log));
+    TEST_ASSERT_EQUAL_UINT16(0, flashLogPending(&log));
+    TEST_ASSERT_EQUAL_UINT32(300, readBack(&log, 0, 0));
+
+    // Neustart: Index und Schreibposition aus dem Flash, weiter mitten in der Seite
+    FlashLog again;
+    TEST_ASSERT_TRUE(flashLogMount(&again, io, index, SECTORS));
+    TEST_ASSERT_EQUAL_UINT16(2, again.usedSectors);
+    TEST_ASSERT_EQUAL_UINT16(0, again.torn);
+    TEST_ASSERT_EQUAL_UINT32(sample(0).tSec, index[0].firstTSec);
+    TEST_ASSERT_EQUAL_UINT32(sample(RECORDS_PER_SECTOR).tSec, index[1].firstTSec);
+    for (uint32_t i = 300; i < 320; ++i) TEST_ASSERT_TRUE(flashLogAppend(&again, sample(i)));
+    TEST_ASSERT_TRUE(flashLogFlush(&again));
+    TEST_ASSERT_EQUAL_UINT32(320, readBack(&again, 0, 0));
+}
+
+static void test_torn_tail_is_truncated_after_power_loss()
+{
+    const FlashLogIo io = freshFlash();
+    FlashLogSectorInfo index[SECTORS];
+    FlashLog log;
+    flashLogMount(&log, io, index, SECTORS);
+    for (uint32_t i = 0; i < 40; ++i) flashLogAppend(&log, sample(i));
+    TEST_ASSERT_TRUE(flashLogFlush(&log));
+    // Strom fällt beim nächsten Schreiben (dritte Seite) nach 5,5 Sätzen aus
+    s_flash.writeBudget = 5 * FLASH_LOG_ENTRY_BYTES + 8;
+    for (uint32_t i = 40; i < 46; ++i) flashLogAppend(&log, sample(i));
+    TEST_ASSERT_FALSE(flashLogFlush(&log));
+    s_flash.writeBudget = -1;
+
+    FlashLog again;
+    TEST_ASSERT_TRUE(flashLogMount(&again, io, index, SECTORS));
+    TEST_ASSERT_EQUAL_UINT16(1, again.torn);
+    // vollständige Sätze bleiben lesbar, der halbe nicht
+    FlashLogCursor c; FlashLogRecord r;
+    uint32_t n = 0;
+    flashLogScan(&again, 0, &c);
+    while (flashLogNext(&c, &r)) TEST_ASSERT_EQUAL_UINT32(sample(n++).tSec, r.tSec);
+    TEST_ASSERT_EQUAL_UINT32(45, n);
+    TEST_ASSERT_EQUAL_UINT32(1, c.invalid);
+
+    // Weiter an der nächsten Seitengrenze, nichts wird überschrieben
+    TEST_ASSERT_EQUAL_UINT16(3 * FLASH_LOG_PAGE_SLOTS, again.fill);
+    for (uint32_t i = 45; i < 60; ++i) flashLogAppend(&again, sample(i));
+    flashLogFlush(&again);
+    TEST_ASSERT_EQUAL_UINT32(60, readBack(&again, 0, 0));
+}
+
+static void test_ring_wraps_evenly_and_index_skips_old_sectors()
+{
+    const FlashLogIo io = freshFlash();
+    FlashLogSectorInfo index[SECTORS];
+    FlashLog log;
+    flashLogMount(&log, io, index, SECTORS);
+    // 10 Sektoren voll: der Ring läuft mehrfach um, es bleiben die letzten 3 vollen + der aktuelle
+    const uint32_t total = 10 * RECORDS_PER_SECTOR + 7;
+    for (uint32_t i = 0; i < total; ++i) TEST_ASSERT_TRUE(flashLogAppend(&log, sample(i)));
+    flashLogFlush(&log);
+    for (uint16_t s = 0; s < SECTORS; ++s) TEST_ASSERT_UINT32_WITHIN(1, 11 / SECTORS, s_flash.erases[s]);
+
+    const uint32_t oldest = total - 7 - 3 * RECORDS_PER_SECTOR;
+    FlashLog again;
+    TEST_ASSERT_TRUE(flashLogMount(&again, io, index, SECTORS));
+    TEST_ASSERT_EQUAL_UINT32(total - oldest, readBack(&again, 0, oldest));
+
+    // Ab einem Zeitpunkt im jüngsten vollen Sektor: ältere Sektoren gar nicht erst lesen
+    const uint32_t from = total - 7 - 100;
+    FlashLogCursor c; FlashLogRecord r;
+    flashLogScan(&again, sample(from).tSec, &c);
+    TEST_ASSERT_EQUAL_UINT16(2, c.sectorsLeft);
+    TEST_ASSERT_TRUE(flashLogNext(&c, &r));
+    TEST_ASSERT_EQUAL_UINT32(sample(from).tSec, r.tSec);
+}
+
+static void test_erased_sector_without_header_and_buffer_loss()
+{
+    const FlashLogIo io = freshFlash();
+    FlashLogSectorInfo index[SECTORS];
+    FlashLog log;
+    flashLogMount(&log, io, index, SECTORS);
+    for (uint32_t i = 0; i < RECORDS_PER_SECTOR + 3; ++i) flashLogAppend(&log, sample(i));
+    // Stromausfall: Sektor 1 ist gelöscht, sein Kopf und die 3 Sätze stehen nur im Puffer
+    FlashLog again;
+    TEST_ASSERT_TRUE(flashLogMount(&again, io, index, SECTORS));
+    TEST_ASSERT_EQUAL_UINT16(1, again.usedSectors);
+    TEST_ASSERT_EQUAL_UINT16(0, again.head);
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, readBack(&again, 0, 0));
+    // nächster Satz beginnt wieder Sektor 1
+    TEST_ASSERT_TRUE(flashLogAppend(&again, sample(RECORDS_PER_SECTOR)));
+    TEST_ASSERT_TRUE(flashLogFlush(&again));
+    TEST_ASSERT_EQUAL_UINT16(1, again.head);
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR + 1, readBack(&again, 0, 0));
+
+    // beschädigter Eintrag mitten im Log wird übersprungen, der Rest bleibt lesbar
+    s_flash.mem[5 * FLASH_LOG_ENTRY_BYTES + 6] ^= 0x10;
+    FlashLogCursor c; FlashLogRecord r;
+    uint32_t n = 0;
+    flashLogScan(&again, 0, &c);
+    while (flashLogNext(&c, &r)) ++n;
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, n);
+    TEST_ASSERT_EQUAL_UINT32(1, c.invalid);
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_records_survive_remount);
+    RUN_TEST(test_torn_tail_is_truncated_after_power_loss);
+    RUN_TEST(test_ring_wraps_evenly_and_index_skips_old_sectors);
+    RUN_TEST(test_erased_sector_without_header_and_buffer_loss);
+    return UNITY_END();
+}
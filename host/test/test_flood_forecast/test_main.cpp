@@ -0,0 +1,210 @@
+// Deutsche Dokumentation
+// Unit-Tests: Hochwasser-Prognose (gleitende Regression, ETA mit Band) an Pegelverläufen (Host)
+#include <unity.h>
+#include "flood_forecast.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Wie im Gateway: 180/230 cm, 30 min Fenster mit 30 Stützstellen, ab 4 Werten über 10 min,
+// ab 1 cm/h, Pumpensprung 3 cm, Pause 35 min, Horizont 24 h, Band +/- 2 Standardfehler
+static const ForecastConfig CONFIG = { { 1800, 2300 }, 2, 1800, 30, 4, 600, 10, 30, 35 * 60, 24 * 3600, 2.0f };
+
+// Pegelverläufe im Format des Flash-Log-Exports (mm, 2-Minuten-Raster), nachgestellt:
+// gleichmäßiger Anstieg ~45 cm/h, zunehmender Zulauf (20 -> 80 cm/h) und ein Hochwasser,
+// das bei ~150 cm seinen Scheitel erreicht; Messrauschen ~6 mm.
+static const uint32_t TRACE_STEP_S = 120;
+static const int16_t TRACE_STEADY[] = {
+    793, 817, 836, 842, 852, 875, 893, 912, 913, 927, 954, 968,
+    989, 1001, 1009, 1023, 1055, 1053, 1065, 1078, 1101, 1116, 1128, 1145,
+    1162, 1179, 1197, 1206, 1209, 1239, 1241, 1264, 1271, 1295, 1305, 1326,
+    1360, 1355, 1375, 1377, 1398, 1419, 1429, 1447, 1461, 1469, 1493, 1500,
+    1531, 1532, 1554, 1565, 1586, 1591, 1616, 1624, 1648, 1659, 1671, 1680,
+    1705, 1718, 1740, 1743, 1763, 1778, 1792, 1806, 1821, 1831, 1844, 1863,
+    1884, 1904, 1916, 1931, 1945, 1959, 1971, 1990, 2011, 2013, 2026, 2057,
+    2061, 2081, 2095, 2098, 2135, 2146, 2151, 2170, 2181, 2190, 2209, 2227,
+    2247, 2259, 2270, 2293, 2295, 2320, 2337, 2343, 2349, 2370,
+};
+static const int16_t TRACE_RISING_INFLOW[] = {
+    598, 610, 612, 619, 623, 635, 651, 655, 667, 670, 680, 688,
+    686, 711, 718, 728, 725, 735, 751, 764, 780, 789, 804, 808,
+    826, 838, 844, 871, 877, 894, 896, 909, 925, 940, 959, 971,
+    981, 993, 1011, 1036, 1040, 1062, 1079, 1083, 1109, 1133, 1130, 1157,
+    1175, 1189, 1214, 1229, 1238, 1270, 1288, 1308, 1330, 1343, 1361, 1372,
+    1404, 1416, 1438, 1453, 1476, 1500, 1532, 1533, 1558, 1590, 1620, 1637,
+    1645, 1664, 1704, 1721, 1742, 1778, 1803, 1821, 1846, 1872, 1903, 1922,
+    1947, 1973, 1986, 2029, 2053, 2077, 2088, 2123, 2158, 2169, 2206, 2239,
+    2252, 2296, 2317, 2339,
+};
+static const int16_t TRACE_CREST[] = {
+    602, 630, 652, 683, 696, 721, 752, 768, 784, 816, 839, 847,
+    861, 887, 905, 922, 949, 951, 981, 982, 1000, 1024, 1041, 1054,
+    1064, 1076, 1090, 1105, 1112, 1127, 1141, 1148, 1164, 1174, 1193, 1193,
+    1198, 1208, 1219, 1234, 1235, 1248, 1265, 1247, 1263, 1279, 1288, 1294,
+    1297, 1310, 1315, 1316, 1340, 1334, 1335, 1343, 1348, 1355, 1344, 1363,
+    1377, 1368, 1380, 1391, 1395, 1403, 1388, 1400, 1404, 1414, 1421, 1402,
+    1428, 1416, 1432, 1423, 1436, 1445, 1440, 1445, 1452, 1451, 1452, 1464,
+    1464, 1459, 1479, 1458, 1473, 1468, 1473, 1478, 1478, 1482, 1471, 1473,
+    1488, 1480, 1481, 1480, 1498, 1496, 1502, 1488, 1494, 1487, 1498, 1502,
+    1487, 1500, 1495, 1486, 1473, 1491, 1479, 1473, 1476, 1472, 1475, 1456,
+};
+
+#define TRACE_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+// Zeitpunkt (ab Beginn), an dem der Verlauf die Höhe erstmals erreicht; -1 = nie
+static int32_t crossing(const int16_t* trace, size_t n, int32_t levelMm)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (trace[i] >= levelMm) return (int32_t)(i * TRACE_STEP_S);
+    return -1;
+}
+
+static void replayStep(ForecastState* s, ForecastResult* r, const int16_t* trace, size_t i)
+{
+    forecastAdd(CONFIG, s, 5000 + (uint32_t)(i * TRACE_STEP_S), trace[i]);
+    forecastCompute(CONFIG, *s, r);
+}
+
+static void test_linear_rise_is_exact_across_rebase()
+{
+    // 3,6 cm/h ohne Rauschen, 100 s Abstand, über die Neubezugsgrenze der Summen (~12 Tage)
+    ForecastConfig c = CONFIG;
+    ForecastState s; forecastReset(&s);
+    ForecastResult r;
+    const uint32_t t0 = 1700000000UL;
+    uint32_t i = 0;
+    for (; i * 100 < (1UL << 20) + 7200; ++i) forecastAdd(c, &s, t0 + i * 100, 1000 + (int32_t)i);
+    const int32_t last = 1000 + (int32_t)i - 1;
+    c.levelsMm[0] = last + 36;   // in einer Stunde
+    c.levelsMm[1] = last;        // schon erreicht
+    forecastCompute(c, s, &r);
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_EQUAL_UINT8(19, r.samples); // 30 min mit 100 s Abstand
+    TEST_ASSERT_EQUAL_INT32(last, r.levelMm);
+    TEST_ASSERT_EQUAL_INT32(36, r.rateMmPerH);
+    TEST_ASSERT_EQUAL_INT32(0, r.rateSeMmPerH);
+    TEST_ASSERT_EQUAL_UINT8(FORECAST_ETA, r.eta[0].status);
+    TEST_ASSERT_EQUAL_UINT32(3600, r.eta[0].etaS);
+    TEST_ASSERT_EQUAL_UINT32(3600, r.eta[0].earlyS);
+    TEST_ASSERT_EQUAL_UINT32(3600, r.eta[0].lateS);
+    TEST_ASSERT_EQUAL_UINT8(FORECAST_REACHED, r.eta[1].status);
+    TEST_ASSERT_EQUAL_UINT8(FORECAST_NONE, r.eta[2].status);
+}
+
+static void test_steady_flood_band_covers_actual_crossing()
+{
+    ForecastState s; forecastReset(&s);
+    ForecastResult r;
+    const size_t n = TRACE_LEN(TRACE_STEADY);
+    uint32_t forecasts = 0, covered = 0;
+    for (size_t i = 0; i < n; ++i) {
+        replayStep(&s, &r, TRACE_STEADY, i);
+        if (i * TRACE_STEP_S < CONFIG.minSpanS) TEST_ASSERT_FALSE(r.valid);
+        for (uint8_t l = 0; l < 2; ++l) {
+            const ForecastEta& e = r.eta[l];
+            const int32_t actual = crossing(TRACE_STEADY, n, CONFIG.levelsMm[l]) - (int32_t)(i * TRACE_STEP_S);
+            if (actual <= 0) { TEST_ASSERT_EQUAL_UINT8(FORECAST_REACHED, e.status); continue; }
+            if (e.status != FORECAST_ETA) continue;
+            TEST_ASSERT_TRUE(e.earlyS <= e.etaS && e.etaS <= e.lateS);
+            // Übergang liegt irgendwo im Messabstand vor dem ersten Wert darüber
+            ++forecasts;
+            if (actual + (int32_t)TRACE_STEP_S >= (int32_t)e.earlyS && actual - (int32_t)TRACE_STEP_S <= (int32_t)e.lateS) ++covered;
+            // Schon nach den ersten 10 min auf 15 % genau
+            TEST_ASSERT_INT32_WITHIN(actual * 15 / 100 + (int32_t)TRACE_STEP_S, actual, (int32_t)e.etaS);
+        }
+    }
+    TEST_ASSERT_TRUE(forecasts > 150);
+    TEST_ASSERT_TRUE(covered * 10 >= forecasts * 9);
+    TEST_ASSERT_INT32_WITHIN(50, 450, r.rateMmPerH);
+}
+
+static void test_rising_inflow_forecast_lags_but_converges()
+{
+    // Zulauf nimmt zu: die Gerade unterschätzt den künftigen Anstieg, die ETA kommt zu spät,
+    // holt aber mit jedem Wert auf
+    ForecastState s; forecastReset(&s);
+    ForecastResult r;
+    const size_t n = TRACE_LEN(TRACE_RISING_INFLOW);
+    const int32_t cross = crossing(TRACE_RISING_INFLOW, n, 1800);
+    TEST_ASSERT_TRUE(cross > 0);
+    int32_t errHourBefore = -1, errLast = -1;
+    for (size_t i = 0; i < n; ++i) {
+        replayStep(&s, &r, TRACE_RISING_INFLOW, i);
+        const int32_t actual = cross - (int32_t)(i * TRACE_STEP_S);
+        if (actual <= 0 || r.eta[0].status != FORECAST_ETA) continue;
+        const int32_t err = (int32_t)r.eta[0].etaS - actual;
+        TEST_ASSERT_TRUE(err >= -(int32_t)TRACE_STEP_S);
+        if (actual <= 3600 && errHourBefore < 0) errHourBefore = err;
+        if (actual <= 20 * 60) TEST_ASSERT_INT32_WITHIN(actual / 4 + (int32_t)TRACE_STEP_S, actual, (int32_t)r.eta[0].etaS);
+        errLast = err;
+    }
+    TEST_ASSERT_TRUE(errHourBefore > 0);
+    TEST_ASSERT_TRUE(errLast < errHourBefore / 4);
+    TEST_ASSERT_EQUAL_UINT8(FORECAST_REACHED, r.eta[0].status);
+}
+
+static void test_crest_pushes_eta_out_and_clears()
+{
+    ForecastState s; forecastReset(&s);
+    ForecastResult r;
+    const size_t n = TRACE_LEN(TRACE_CREST);
+    uint32_t etaEarly = 0, etaLate = 0;
+    for (size_t i = 0; i < n; ++i) {
+        replayStep(&s, &r, TRACE_CREST, i);
+        TEST_ASSERT_NOT_EQUAL(FORECAST_REACHED, r.eta[0].status);
+        TEST_ASSERT_NOT_EQUAL(FORECAST_REACHED, r.eta[1].status);
+        if (i * TRACE_STEP_S == 30 * 60) etaEarly = r.eta[0].etaS;
+        if (i * TRACE_STEP_S == 150 * 60) etaLate = r.eta[0].etaS;
+        // Nach dem Scheitel: keine Prognose mehr
+        if (i + 5 >= n) {
+            TEST_ASSERT_EQUAL_UINT8(FORECAST_NONE, r.eta[0].status);
+            TEST_ASSERT_EQUAL_UINT8(FORECAST_NONE, r.eta[1].status);
+        }
+    }
+    TEST_ASSERT_TRUE(etaEarly > 0 && etaEarly != FORECAST_OPEN);
+    TEST_ASSERT_TRUE(etaLate > 2 * etaEarly);
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_TRUE(r.rateMmPerH < 0);
+}
+
+static void test_pump_drop_gap_and_dense_samples()
+{
+    ForecastState s; forecastReset(&s);
+    ForecastResult r;
+    uint32_t t = 100;
+    // Hochwasser-Schnellpfad: alle 10 s, Stützstellen bleiben >= 60 s auseinander
+    for (int i = 0; i < 400; ++i, t += 10) forecastAdd(CONFIG, &s, t, 500 + i / 6);
+    forecastCompute(CONFIG, s, &r);
+    TEST_ASSERT_EQUAL_UINT8(30, r.samples);
+    TEST_ASSERT_EQUAL_UINT32(t - 10, r.t);
+    TEST_ASSERT_TRUE(r.spanS <= CONFIG.windowS);
+    TEST_ASSERT_INT32_WITHIN(5, 60, r.rateMmPerH);
+    // Älterer Zeitstempel wird ignoriert
+    forecastAdd(CONFIG, &s, t - 500, 2000);
+    forecastCompute(CONFIG, s, &r);
+    TEST_ASSERT_EQUAL_UINT32(t - 10, r.t);
+    TEST_ASSERT_INT32_WITHIN(5, 60, r.rateMmPerH);
+    // Pumpe springt an: Pegel fällt um mehr als 3 cm, Fenster beginnt neu
+    forecastAdd(CONFIG, &s, t, 500);
+    forecastCompute(CONFIG, s, &r);
+    TEST_ASSERT_EQUAL_UINT8(1, r.samples);
+    TEST_ASSERT_FALSE(r.valid);
+    TEST_ASSERT_EQUAL_UINT8(FORECAST_NONE, r.eta[0].status);
+    // Messpause über maxGapS: ebenfalls neu
+    forecastAdd(CONFIG, &s, t + 60, 505);
+    forecastAdd(CONFIG, &s, t + 60 + CONFIG.maxGapS + 1, 510);
+    forecastCompute(CONFIG, s, &r);
+    TEST_ASSERT_EQUAL_UINT8(1, r.samples);
+    TEST_ASSERT_EQUAL_STRING("none", forecastStatusName(r.eta[0].status));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_rise_is_exact_across_rebase);
+    RUN_TEST(test_steady_flood_band_covers_actual_crossing);
+    RUN_TEST(test_rising_inflow_forecast_lags_but_converges);
+    RUN_TEST(test_crest_pushes_eta_out_and_clears);
+    RUN_TEST(test_pump_drop_gap_and_dense_samples);
+    return UNITY_END();
+}
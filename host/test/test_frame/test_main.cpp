@@ -0,0 +1,109 @@
+// Deutsche Dokumentation
+// Unit-Tests: gemeinsamer LoRa-Frame-Codec (Host)
+#include <unity.h>
+#include <cstring>
+#include "lora_frame.h"
+
+static const uint8_t AES_KEY[16]  = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+static const uint8_t HMAC_KEY[16] = { 16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1 };
+static const uint8_t NONCE[8]     = { 0xa0,0xa1,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7 };
+static CryptoSession s_session;
+
+void setUp() { s_session.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY)); }
+void tearDown() {}
+
+// Frame muss bytegleich zum bisherigen Aufbau (aesCtrCrypt + hmacSha256Trunc) sein
+static void test_encode_matches_legacy_layout()
+{
+    const char* pt = "18.6";
+    const size_t n = strlen(pt);
+    uint8_t frame[LORA_FRAME_MAX_LEN];
+    size_t len = loraFrameEncode(s_session, 0x01, NONCE, (const uint8_t*)pt, n, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_UINT(n + LORA_FRAME_OVERHEAD, len);
+
+    uint8_t ref[LORA_FRAME_MAX_LEN];
+    ref[0] = 0x01;
+    memcpy(ref + 1, NONCE, 8);
+    memcpy(ref + 9, pt, n);
+    TEST_ASSERT_TRUE(aesCtrCrypt(AES_KEY, NONCE, 0x01, ref + 9, n));
+    TEST_ASSERT_TRUE(hmacSha256Trunc(HMAC_KEY, sizeof(HMAC_KEY), ref, 9 + n, ref + 9 + n, 8));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, frame, len);
+}
+
+static void test_roundtrip_all_sizes()
+{
+    for (size_t n = 1; n <= LORA_FRAME_MAX_PAYLOAD; ++n) {
+        uint8_t pt[LORA_FRAME_MAX_PAYLOAD], frame[LORA_FRAME_MAX_LEN];
+        for (size_t i = 0; i < n; ++i) pt[i] = (uint8_t)(i * 13 + n);
+        size_t len = loraFrameEncode(s_session, 7, NONCE, pt, n, frame, sizeof(frame));
+        TEST_ASSERT_EQUAL_UINT(n + LORA_FRAME_OVERHEAD, len);
+        uint8_t sid = 0;
+        TEST_ASSERT_TRUE(loraFrameSensorId(frame, len, &sid));
+        TEST_ASSERT_EQUAL_UINT8(7, sid);
+        const uint8_t* out; size_t outLen;
+        TEST_ASSERT_TRUE(loraFrameOpen(s_session, frame, len, &out, &outLen));
+        TEST_ASSERT_EQUAL_UINT(n, outLen);
+        TEST_ASSERT_EQUAL_MEMORY(pt, out, n);
+    }
+}
+
+// Gemeinsamer Schlüssel, gleicher Zähler: Sensor-ID und Richtung müssen den Schlüsselstrom trennen
+static void test_keystream_bound_to_sensor_and_direction()
+{
+    uint8_t zero[LORA_FRAME_MAX_PAYLOAD] = {0};
+    uint8_t a[LORA_FRAME_MAX_LEN], b[LORA_FRAME_MAX_LEN], c[LORA_FRAME_MAX_LEN];
+    uint8_t down[8];
+    memcpy(down, NONCE, 8);
+    down[7] ^= 0x80;
+    loraFrameEncode(s_session, 1, NONCE, zero, sizeof(zero), a, sizeof(a));
+    loraFrameEncode(s_session, 2, NONCE, zero, sizeof(zero), b, sizeof(b));
+    TEST_ASSERT_TRUE(memcmp(a + 9, b + 9, sizeof(zero)) != 0);
+
+    uint8_t ksUp[sizeof(zero)] = {0}, ksDown[sizeof(zero)] = {0};
+    TEST_ASSERT_TRUE(aesCtrCrypt(AES_KEY, NONCE, 1, ksUp, sizeof(ksUp)));
+    TEST_ASSERT_TRUE(aesCtrCrypt(AES_KEY, down, 1, ksDown, sizeof(ksDown)));
+    TEST_ASSERT_TRUE(memcmp(ksUp, ksDown, sizeof(ksUp)) != 0);
+    loraFrameEncode(s_session, 1, down, zero, sizeof(zero), c, sizeof(c));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ksDown, c + 9, sizeof(zero));
+}
+
+static void test_tampered_frame_rejected_and_wiped()
+{
+    const uint8_t pt[6] = { 'C','M','D',':','O','K' };
+    uint8_t frame[LORA_FRAME_MAX_LEN];
+    size_t len = loraFrameEncode(s_session, 1, NONCE, pt, sizeof(pt), frame, sizeof(frame));
+    for (size_t pos = 0; pos < len; ++pos) {
+        uint8_t copy[LORA_FRAME_MAX_LEN];
+        memcpy(copy, frame, len);
+        copy[pos] ^= 0x01;
+        const uint8_t* out; size_t outLen;
+        TEST_ASSERT_FALSE(loraFrameOpen(s_session, copy, len, &out, &outLen));
+        if (pos < LORA_FRAME_HDR_LEN || pos >= LORA_FRAME_HDR_LEN + sizeof(pt)) {
+            uint8_t zero[sizeof(pt)] = {0};
+            TEST_ASSERT_EQUAL_MEMORY(zero, copy + LORA_FRAME_HDR_LEN, sizeof(pt));
+        }
+    }
+}
+
+static void test_bounds()
+{
+    uint8_t pt[LORA_FRAME_MAX_PAYLOAD + 1] = {0};
+    uint8_t frame[LORA_FRAME_MAX_LEN];
+    TEST_ASSERT_EQUAL_UINT(0, loraFrameEncode(s_session, 1, NONCE, pt, 0, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT(0, loraFrameEncode(s_session, 1, NONCE, pt, sizeof(pt), frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT(0, loraFrameEncode(s_session, 1, NONCE, pt, 4, frame, 4 + LORA_FRAME_OVERHEAD - 1));
+    const uint8_t* out; size_t outLen; uint8_t sid;
+    TEST_ASSERT_FALSE(loraFrameSensorId(frame, LORA_FRAME_OVERHEAD, &sid));
+    TEST_ASSERT_FALSE(loraFrameOpen(s_session, frame, LORA_FRAME_OVERHEAD, &out, &outLen));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_matches_legacy_layout);
+    RUN_TEST(test_roundtrip_all_sizes);
+    RUN_TEST(test_keystream_bound_to_sensor_and_direction);
+    RUN_TEST(test_tampered_frame_rejected_and_wiped);
+    RUN_TEST(test_bounds);
+    return UNITY_END();
+}
@@ -0,0 +1,91 @@
+// Deutsche Dokumentation
+// Unit-Tests: Pegelfilter mit Anstiegsrate und Ausreißererkennung (Host)
+#include <unity.h>
+#include "level_filter.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const uint32_t STEP_MS = 10000;
+// 3 mm Messrauschen, Rate darf sich um ~1 m/h je Stunde ändern; Ausreißer ab 4 Sigma bzw. 2 cm
+static const LevelFilterConfig CONFIG = { 3.0f, 10000.0f, STEP_MS, 4, 20, 3, 5UL * 60UL * 1000UL };
+
+// Reproduzierbares Rauschen ±n mm
+static int32_t noise(uint32_t i, int32_t n)
+{
+    return (int32_t)((i * 2654435761u) >> 16) % (2 * n + 1) - n;
+}
+
+static void test_gains_are_plausible()
+{
+    const LevelFilterParams p = levelFilterParams(CONFIG);
+    TEST_ASSERT_TRUE(p.alphaQ16 > 65536 / 20 && p.alphaQ16 < 65536 / 2);
+    TEST_ASSERT_TRUE(p.betaQ16 > 0 && p.betaQ16 < p.alphaQ16);
+    TEST_ASSERT_TRUE(p.minVarQ4 >= 9 * 16);
+}
+
+static void test_steady_level_is_smoothed_without_trend()
+{
+    const LevelFilterParams p = levelFilterParams(CONFIG);
+    LevelFilter f; levelFilterReset(&f);
+    TEST_ASSERT_FALSE(levelFilterSettled(f));
+    int32_t worst = 0;
+    for (uint32_t i = 0; i < 360; ++i) {
+        TEST_ASSERT_NOT_EQUAL(LEVEL_REJECTED, levelFilterUpdate(p, &f, 1800 + noise(i, 4), i * STEP_MS));
+        if (i > 30) {
+            const int32_t d = levelFilterLevelMm(f) - 1800;
+            if ((d < 0 ? -d : d) > worst) worst = d < 0 ? -d : d;
+        }
+    }
+    TEST_ASSERT_TRUE(levelFilterSettled(f));
+    TEST_ASSERT_LESS_OR_EQUAL(3, worst);
+    // ±4 mm Rauschen je 10 s wäre differenziert ±2,9 m/h; gefiltert nahe 0
+    TEST_ASSERT_INT32_WITHIN(60, 0, levelFilterRateMmPerH(f));
+}
+
+static void test_rising_level_reports_rate_in_cm_per_hour()
+{
+    const LevelFilterParams p = levelFilterParams(CONFIG);
+    LevelFilter f; levelFilterReset(&f);
+    // 3 cm/min = 1800 mm/h, 5 mm je Messung, mit Rauschen
+    for (uint32_t i = 0; i < 90; ++i)
+        levelFilterUpdate(p, &f, 500 + (int32_t)i * 5 + noise(i, 3), i * STEP_MS);
+    TEST_ASSERT_INT32_WITHIN(150, 1800, levelFilterRateMmPerH(f));
+    // kein Nachlauf des Pegels bei konstanter Anstiegsrate
+    TEST_ASSERT_INT32_WITHIN(4, 500 + 89 * 5, levelFilterLevelMm(f));
+}
+
+static void test_spike_is_rejected_and_real_step_relocks()
+{
+    const LevelFilterParams p = levelFilterParams(CONFIG);
+    LevelFilter f; levelFilterReset(&f);
+    uint32_t i = 0;
+    for (; i < 30; ++i) levelFilterUpdate(p, &f, 600 + noise(i, 2), i * STEP_MS);
+    // einzelne Störspitze (+25 cm) verändert weder Pegel noch Rate
+    TEST_ASSERT_EQUAL(LEVEL_REJECTED, levelFilterUpdate(p, &f, 850, i++ * STEP_MS));
+    TEST_ASSERT_INT32_WITHIN(3, 600, levelFilterLevelMm(f));
+    TEST_ASSERT_EQUAL(LEVEL_ACCEPTED, levelFilterUpdate(p, &f, 601, i++ * STEP_MS));
+    TEST_ASSERT_INT32_WITHIN(60, 0, levelFilterRateMmPerH(f));
+    TEST_ASSERT_EQUAL_UINT16(1, f.rejectedTotal);
+
+    // Pumpe leert den Schacht: nach maxRejects Ausreißern rastet der Filter neu ein
+    TEST_ASSERT_EQUAL(LEVEL_REJECTED, levelFilterUpdate(p, &f, 300, i++ * STEP_MS));
+    TEST_ASSERT_EQUAL(LEVEL_REJECTED, levelFilterUpdate(p, &f, 300, i++ * STEP_MS));
+    TEST_ASSERT_EQUAL(LEVEL_RESTARTED, levelFilterUpdate(p, &f, 300, i++ * STEP_MS));
+    TEST_ASSERT_EQUAL_INT32(300, levelFilterLevelMm(f));
+    TEST_ASSERT_EQUAL_INT32(0, levelFilterRateMmPerH(f));
+    TEST_ASSERT_FALSE(levelFilterSettled(f));
+
+    // nach langer Pause (Sensor ohne Strom) ebenfalls Neustart
+    TEST_ASSERT_EQUAL(LEVEL_RESTARTED, levelFilterUpdate(p, &f, 310, i * STEP_MS + 10UL * 60UL * 1000UL));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_gains_are_plausible);
+    RUN_TEST(test_steady_level_is_smoothed_without_trend);
+    RUN_TEST(test_rising_level_reports_rate_in_cm_per_hour);
+    RUN_TEST(test_spike_is_rejected_and_real_step_relocks);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+// Deutsche Dokumentation
+// Unit-Tests: Payload-Auswertung des Gateways (Host)
+#include <unity.h>
+#include <cstring>
+#include "payload.h"
+
+void setUp() {}
+void tearDown() {}
+
+static PayloadReading parse(const char* s)
+{
+    PayloadReading r;
+    parsePayload((const uint8_t*)s, strlen(s), &r);
+    return r;
+}
+
+static void test_numeric()
+{
+    PayloadReading r = parse("18.6");
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_EQUAL_INT32(186, r.depthMm);
+    TEST_ASSERT_EQUAL_STRING("", r.status);
+
+    TEST_ASSERT_EQUAL_INT32(1234, parse(" 123.4cm ").depthMm);
+    TEST_ASSERT_EQUAL_INT32(-25, parse("-2.5").depthMm);
+    TEST_ASSERT_EQUAL_INT32(10, parse("+1").depthMm);
+    TEST_ASSERT_EQUAL_INT32(187, parse("18.66").depthMm); // auf mm gerundet
+}
+
+static void test_legacy_format()
+{
+    PayloadReading r = parse("WATER_CM:42.0;STATUS:OK;MID:7");
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_EQUAL_INT32(420, r.depthMm);
+    TEST_ASSERT_EQUAL_STRING("OK", r.status);
+
+    r = parse("WATER_CM: 5 ;STATUS: ERR");
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_EQUAL_INT32(50, r.depthMm);
+    TEST_ASSERT_EQUAL_STRING("ERR", r.status);
+}
+
+static void test_invalid()
+{
+    TEST_ASSERT_FALSE(parse("").valid);
+    TEST_ASSERT_FALSE(parse("cm").valid);
+    TEST_ASSERT_FALSE(parse("1.2.3").valid);
+    TEST_ASSERT_FALSE(parse("12a").valid);
+    TEST_ASSERT_FALSE(parse("-").valid);
+    TEST_ASSERT_FALSE(parse("WATER_CM:;STATUS:OK").valid);
+}
+
+static void test_not_nul_terminated()
+{
+    const uint8_t buf[] = { '1', '2', '.', '5', 'X' };
+    PayloadReading r;
+    TEST_ASSERT_TRUE(parsePayload(buf, 4, &r));
+    TEST_ASSERT_EQUAL_INT32(125, r.depthMm);
+}
+
+static void test_v2_roundtrip_with_tlv()
+{
+    uint8_t buf[32];
+    size_t len = payloadEncodeV2(buf, sizeof(buf), PAYLOAD_FLAG_ERR, 0xBEEF, -1234);
+    TEST_ASSERT_EQUAL_UINT(PAYLOAD_V2_HDR_LEN, len);
+    const uint8_t mv[2] = { 0x34, 0x12 };
+    len = payloadAppendTlv(buf, sizeof(buf), len, PAYLOAD_TLV_RAW_MV, mv, sizeof(mv));
+    len = payloadAppendTlv(buf, sizeof(buf), len, 0x7F, nullptr, 0); // unbekannt, leer
+    TEST_ASSERT_EQUAL_UINT(PAYLOAD_V2_HDR_LEN + 4 + 2, len);
+
+    PayloadReading r;
+    TEST_ASSERT_TRUE(parsePayload(buf, len, &r));
+    TEST_ASSERT_EQUAL_UINT8(PAYLOAD_VERSION_V2, r.version);
+    TEST_ASSERT_EQUAL_INT32(-1234, r.depthMm);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, r.seq);
+    TEST_ASSERT_EQUAL_STRING("ERR", r.status);
+    TEST_ASSERT_TRUE(r.ext == buf + PAYLOAD_V2_HDR_LEN); // keine Kopie
+
+    size_t pos = 0; PayloadTlv tlv;
+    TEST_ASSERT_TRUE(payloadNextTlv(r.ext, r.extLen, &pos, &tlv));
+    TEST_ASSERT_EQUAL_UINT8(PAYLOAD_TLV_RAW_MV, tlv.type);
+    TEST_ASSERT_EQUAL_UINT8(2, tlv.len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mv, tlv.value, 2);
+    TEST_ASSERT_TRUE(payloadNextTlv(r.ext, r.extLen, &pos, &tlv));
+    TEST_ASSERT_EQUAL_UINT8(0x7F, tlv.type);
+    TEST_ASSERT_FALSE(payloadNextTlv(r.ext, r.extLen, &pos, &tlv));
+}
+
+static void test_v2_truncated_rejected()
+{
+    uint8_t buf[16];
+    size_t len = payloadEncodeV2(buf, sizeof(buf), 0, 1, 500);
+    len = payloadAppendTlv(buf, sizeof(buf), len, PAYLOAD_TLV_RAW_MV, buf, 4);
+    PayloadReading r;
+    for (size_t n = 1; n < len; ++n) {
+        if (n == PAYLOAD_V2_HDR_LEN) continue; // Kopf ohne TLV ist gültig
+        TEST_ASSERT_FALSE(parsePayload(buf, n, &r));
+    }
+    TEST_ASSERT_TRUE(parsePayload(buf, len, &r));
+    TEST_ASSERT_EQUAL_UINT(0, payloadEncodeV2(buf, PAYLOAD_V2_HDR_LEN - 1, 0, 0, 0));
+    const uint8_t unknownVersion[] = { 0x03, 0, 0, 0, 0, 0 };
+    TEST_ASSERT_FALSE(parsePayload(unknownVersion, sizeof(unknownVersion), &r));
+}
+
+static void test_batch_roundtrip()
+{
+    const BatchSample older[] = { {1200, 10}, {1195, 20}, {-300, 30}, {32000, 95}, {32000, 4000} };
+    const size_t n = sizeof(older) / sizeof(older[0]);
+    uint8_t buf[64];
+    size_t len = payloadEncodeV2(buf, sizeof(buf), 0, 7, 1201);
+    len = payloadAppendBatch(buf, sizeof(buf), len, 1201, older, n);
+    TEST_ASSERT_GREATER_THAN(PAYLOAD_V2_HDR_LEN, len);
+
+    PayloadReading r;
+    TEST_ASSERT_TRUE(parsePayload(buf, len, &r));
+    size_t pos = 0; PayloadTlv tlv;
+    TEST_ASSERT_TRUE(payloadNextTlv(r.ext, r.extLen, &pos, &tlv));
+    TEST_ASSERT_EQUAL_UINT8(PAYLOAD_TLV_BATCH, tlv.type);
+
+    BatchCursor c; BatchSample s;
+    payloadBatchBegin(&c, tlv, r.depthMm);
+    for (size_t i = 0; i < n; ++i) {
+        TEST_ASSERT_TRUE(payloadBatchNext(&c, &s));
+        TEST_ASSERT_EQUAL_INT32(older[i].depthMm, s.depthMm);
+        TEST_ASSERT_EQUAL_UINT32(older[i].ageSec, s.ageSec);
+    }
+    TEST_ASSERT_FALSE(payloadBatchNext(&c, &s));
+}
+
+static void test_batch_small_deltas_are_compact()
+{
+    // 5 ältere Werte im 10-s-Raster mit kleinen Änderungen: 2 Byte je Wert
+    BatchSample older[5];
+    for (int i = 0; i < 5; ++i) older[i] = { 500 - i, (uint32_t)(10 * (i + 1)) };
+    uint8_t buf[64];
+    size_t len = payloadEncodeV2(buf, sizeof(buf), 0, 1, 500);
+    len = payloadAppendBatch(buf, sizeof(buf), len, 500, older, 5);
+    TEST_ASSERT_EQUAL_UINT(PAYLOAD_V2_HDR_LEN + 2 + 5 * 2, len);
+}
+
+static void test_batch_rejects_bad_input()
+{
+    uint8_t buf[16];
+    const BatchSample unsorted[] = { {0, 20}, {0, 10} };
+    TEST_ASSERT_EQUAL_UINT(0, payloadAppendBatch(buf, sizeof(buf), 6, 0, unsorted, 2));
+    const BatchSample one[] = { {0, 10} };
+    TEST_ASSERT_EQUAL_UINT(0, payloadAppendBatch(buf, 7, 6, 0, one, 1)); // kein Platz
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_numeric);
+    RUN_TEST(test_legacy_format);
+    RUN_TEST(test_invalid);
+    RUN_TEST(test_not_nul_terminated);
+    RUN_TEST(test_v2_roundtrip_with_tlv);
+    RUN_TEST(test_v2_truncated_rejected);
+    RUN_TEST(test_batch_roundtrip);
+    RUN_TEST(test_batch_small_deltas_are_compact);
+    RUN_TEST(test_batch_rejects_bad_input);
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+// Deutsche Dokumentation
+// Unit-Tests: Pumpzyklen aus dem Pegelverlauf (Host)
+#include <unity.h>
+#include "pump_cycle.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const uint32_t STEP_S = 10;
+// Pumpe 1 hält unter 19 cm, Pumpe 2 springt bei 56 cm an und pumpt ab auf 37 cm
+static const PumpCycleConfig CONFIG = { { { 190, 120 }, { 560, 370 } }, 2, 30, 50, 2UL * 3600UL };
+
+// Reproduzierbares Rauschen ±n mm
+static int32_t noise(uint32_t i, int32_t n)
+{
+    return (int32_t)((i * 2654435761u) >> 16) % (2 * n + 1) - n;
+}
+
+// Schacht mit Zulauf und zwei Schwimmerschaltern (ein am Einschalt-, aus am Ausschaltpegel)
+struct Shaft
+{
+    double levelMm;
+    double inflowMmPerH;
+    double capacityMmPerH[2];
+    bool broken[2];
+    bool on[2];
+    uint32_t t;
+    uint32_t i;
+    uint32_t events[5]; // je PumpEventKind
+};
+
+static Shaft shaft(double levelMm, double inflowMmPerH)
+{
+    Shaft s = {};
+    s.levelMm = levelMm;
+    s.inflowMmPerH = inflowMmPerH;
+    s.capacityMmPerH[0] = 3000;
+    s.capacityMmPerH[1] = 6000;
+    s.t = 1000;
+    return s;
+}
+
+static void run(Shaft* s, PumpCycleState* st, uint32_t seconds)
+{
+    for (uint32_t end = s->t + seconds; s->t < end; s->t += STEP_S) {
+        double rate = s->inflowMmPerH;
+        for (uint8_t p = 0; p < 2; ++p) {
+            if (s->broken[p]) s->on[p] = false;
+            else if (s->levelMm >= CONFIG.pumps[p].startMm) s->on[p] = true;
+            else if (s->levelMm <= CONFIG.pumps[p].stopMm) s->on[p] = false;
+            if (s->on[p]) rate -= s->capacityMmPerH[p];
+        }
+        s->levelMm += rate * STEP_S / 3600.0;
+        if (s->levelMm < 0) s->levelMm = 0;
+        const PumpEvent ev = pumpCycleUpdate(CONFIG, st, s->t, (int32_t)s->levelMm + noise(s->i++, 3));
+        s->events[ev.kind]++;
+    }
+}
+
+static void test_regular_cycles_give_inflow_period_and_run_time()
+{
+    PumpCycleState st; pumpCycleReset(&st);
+    TEST_ASSERT_EQUAL_STRING("unknown", pumpPhaseName(st.phase));
+    // 6 cm/h Zulauf: 7 cm füllen dauert 420 s, abpumpen (30 - 6 cm/h netto) 105 s
+    Shaft s = shaft(130, 600);
+    run(&s, &st, 3UL * 3600UL);
+    const PumpStats& p1 = st.pump[0];
+    TEST_ASSERT_TRUE(p1.cycles >= 18);
+    TEST_ASSERT_EQUAL_UINT32(0, st.pump[1].cycles);
+    TEST_ASSERT_EQUAL_UINT32(p1.cycles, s.events[PUMP_EVENT_STOPPED]);
+    TEST_ASSERT_INT32_WITHIN(120, 600, st.inflowMmPerH);
+    TEST_ASSERT_UINT32_WITHIN(30, 525, p1.periodS);
+    TEST_ASSERT_UINT32_WITHIN(20, 105, p1.runS);
+    TEST_ASSERT_INT32_WITHIN(500, 2400, p1.drainMmPerH);
+    TEST_ASSERT_INT32_WITHIN(15, 190, p1.lastStartMm);
+    TEST_ASSERT_INT32_WITHIN(15, 120, p1.lastStopMm);
+    TEST_ASSERT_FALSE(p1.failed);
+    TEST_ASSERT_EQUAL_UINT32(0, s.events[PUMP_EVENT_FAILED]);
+}
+
+static void test_weaker_pump_runs_longer()
+{
+    PumpCycleState st; pumpCycleReset(&st);
+    Shaft s = shaft(130, 600);
+    run(&s, &st, 3600);
+    const uint32_t runBefore = st.pump[0].runS;
+    const int32_t drainBefore = st.pump[0].drainMmPerH;
+    s.capacityMmPerH[0] = 1500; // verstopftes Laufrad
+    run(&s, &st, 3UL * 3600UL);
+    TEST_ASSERT_TRUE(st.pump[0].runS > runBefore * 2);
+    TEST_ASSERT_TRUE(st.pump[0].drainMmPerH < drainBefore / 2);
+    TEST_ASSERT_FALSE(st.pump[0].failed);
+}
+
+static void test_pump_that_does_not_start_is_flagged_until_it_runs_again()
+{
+    PumpCycleState st; pumpCycleReset(&st);
+    Shaft s = shaft(130, 1500);
+    run(&s, &st, 1800);
+    TEST_ASSERT_TRUE(st.pump[0].cycles > 0);
+
+    // Pumpe 1 fällt aus: Pegel steigt über 19 + 5 cm, Pumpe 2 übernimmt bei 56 cm
+    s.broken[0] = true;
+    run(&s, &st, 3UL * 3600UL);
+    TEST_ASSERT_TRUE(st.pump[0].failed);
+    TEST_ASSERT_EQUAL_UINT16(1, st.pump[0].failures);
+    TEST_ASSERT_EQUAL_UINT32(1, s.events[PUMP_EVENT_FAILED]);
+    TEST_ASSERT_EQUAL_STRING("failed", pumpEventName(PUMP_EVENT_FAILED));
+    TEST_ASSERT_TRUE(st.pump[1].cycles >= 3);
+    TEST_ASSERT_INT32_WITHIN(25, 560, st.pump[1].lastStartMm);
+    TEST_ASSERT_INT32_WITHIN(25, 370, st.pump[1].lastStopMm);
+    TEST_ASSERT_FALSE(st.pump[1].failed);
+
+    // Wieder in Ordnung: sie läuft ab dem nächsten Wiederanstieg mit und senkt unter 37 cm
+    s.broken[0] = false;
+    run(&s, &st, 3600);
+    TEST_ASSERT_FALSE(st.pump[0].failed);
+    TEST_ASSERT_EQUAL_UINT16(1, st.pump[0].failures);
+}
+
+static void test_overwhelmed_pump_is_not_flagged()
+{
+    PumpCycleState st; pumpCycleReset(&st);
+    Shaft s = shaft(130, 1500);
+    run(&s, &st, 1800);
+
+    // Starkregen über der Leistung von Pumpe 1: sie läuft, der Pegel steigt nur langsamer
+    // bis 56 cm, dann hält Pumpe 2 ihn zwischen 37 und 56 cm
+    s.inflowMmPerH = 4500;
+    run(&s, &st, 2UL * 3600UL);
+    TEST_ASSERT_TRUE(st.pump[1].cycles >= 3);
+    TEST_ASSERT_FALSE(st.pump[0].failed);
+    TEST_ASSERT_FALSE(st.pump[1].failed);
+    TEST_ASSERT_EQUAL_UINT32(0, s.events[PUMP_EVENT_FAILED]);
+}
+
+static void test_gap_and_out_of_order_samples()
+{
+    PumpCycleState st; pumpCycleReset(&st);
+    TEST_ASSERT_EQUAL(PUMP_EVENT_NONE, pumpCycleUpdate(CONFIG, &st, 100, 150).kind);
+    TEST_ASSERT_EQUAL_STRING("filling", pumpPhaseName(st.phase));
+    TEST_ASSERT_EQUAL(PUMP_EVENT_NONE, pumpCycleUpdate(CONFIG, &st, 400, 185).kind);
+    TEST_ASSERT_EQUAL(PUMP_EVENT_STARTED, pumpCycleUpdate(CONFIG, &st, 410, 150).kind);
+    TEST_ASSERT_EQUAL_STRING("draining", pumpPhaseName(st.phase));
+    // ohne Tiefpunkt am Anfang kein Zulauf, ohne vorherigen Start keine Zyklusdauer
+    TEST_ASSERT_EQUAL_UINT16(0, st.fills);
+    TEST_ASSERT_EQUAL_UINT16(0, st.pump[0].periodCount);
+    // älterer Zeitpunkt (Batch eines anderen Uplinks) wird ignoriert
+    TEST_ASSERT_EQUAL(PUMP_EVENT_NONE, pumpCycleUpdate(CONFIG, &st, 300, 500).kind);
+    TEST_ASSERT_EQUAL(PUMP_EVENT_NONE, pumpCycleUpdate(CONFIG, &st, 440, 120).kind);
+    TEST_ASSERT_EQUAL(PUMP_EVENT_STOPPED, pumpCycleUpdate(CONFIG, &st, 450, 160).kind);
+    TEST_ASSERT_EQUAL_UINT32(40, st.pump[0].lastRunS);
+    TEST_ASSERT_EQUAL_INT32(120, st.pump[0].lastStopMm);
+
+    // Messpause über maxGapS: Füllphase und Zyklusdauer neu ansetzen
+    TEST_ASSERT_EQUAL(PUMP_EVENT_NONE, pumpCycleUpdate(CONFIG, &st, 450 + 3UL * 3600UL, 180).kind);
+    TEST_ASSERT_FALSE(st.fillValid);
+    TEST_ASSERT_FALSE(st.pump[0].startValid);
+    TEST_ASSERT_EQUAL(PUMP_EVENT_STARTED, pumpCycleUpdate(CONFIG, &st, 460 + 3UL * 3600UL, 140).kind);
+    TEST_ASSERT_EQUAL_UINT16(0, st.fills);
+    TEST_ASSERT_EQUAL_UINT16(0, st.pump[0].periodCount);
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_regular_cycles_give_inflow_period_and_run_time);
+    RUN_TEST(test_weaker_pump_runs_longer);
+    RUN_TEST(test_pump_that_does_not_start_is_flagged_until_it_runs_again);
+    RUN_TEST(test_overwhelmed_pump_is_not_flagged);
+    RUN_TEST(test_gap_and_out_of_order_samples);
+    return UNITY_END();
+}
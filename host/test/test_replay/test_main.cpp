@@ -0,0 +1,76 @@
+// Deutsche Dokumentation
+// Unit-Tests: Frame-Zähler-Nonce und Replay-Fenster (Host)
+#include <unity.h>
+#include "frame_counter.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_nonce_roundtrip()
+{
+    const uint64_t values[] = { 1, 0x1234, 0x0102030405060708ULL, FRAME_COUNTER_DOWNLINK | 42 };
+    for (uint64_t v : values) {
+        uint8_t n[8];
+        frameCounterToNonce(v, n);
+        TEST_ASSERT_EQUAL_UINT64(v, frameCounterFromNonce(n));
+    }
+    uint8_t n[8];
+    frameCounterToNonce(0x0102, n);
+    TEST_ASSERT_EQUAL_HEX8(0x02, n[0]); // Little Endian
+    TEST_ASSERT_EQUAL_HEX8(0x01, n[1]);
+}
+
+static void test_in_order_and_duplicates()
+{
+    ReplayWindow w; replayWindowReset(w);
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 0));
+    for (uint64_t c = 1; c <= 200; ++c) {
+        TEST_ASSERT_TRUE(replayWindowCheck(w, c));
+        replayWindowUpdate(w, c);
+        TEST_ASSERT_FALSE(replayWindowCheck(w, c));
+    }
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 150));
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 1)); // außerhalb des Fensters
+}
+
+static void test_out_of_order_within_window()
+{
+    ReplayWindow w; replayWindowReset(w);
+    replayWindowUpdate(w, 100);
+    TEST_ASSERT_TRUE(replayWindowCheck(w, 99));
+    TEST_ASSERT_TRUE(replayWindowCheck(w, 100 - REPLAY_WINDOW_BITS + 1));
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 100 - REPLAY_WINDOW_BITS));
+    replayWindowUpdate(w, 98);
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 98));
+    TEST_ASSERT_TRUE(replayWindowCheck(w, 99));
+    // großer Sprung verschiebt das Fenster vollständig
+    replayWindowUpdate(w, 1000);
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 99));
+    TEST_ASSERT_TRUE(replayWindowCheck(w, 999));
+}
+
+static void test_restore_blocks_everything_up_to_top()
+{
+    ReplayWindow w;
+    replayWindowRestore(w, 500);
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 500));
+    TEST_ASSERT_FALSE(replayWindowCheck(w, 480));
+    TEST_ASSERT_TRUE(replayWindowCheck(w, 501));
+}
+
+static void test_downlink_bit_rejected_as_counter()
+{
+    ReplayWindow w; replayWindowReset(w);
+    TEST_ASSERT_FALSE(replayWindowCheck(w, FRAME_COUNTER_DOWNLINK | 1));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_nonce_roundtrip);
+    RUN_TEST(test_in_order_and_duplicates);
+    RUN_TEST(test_out_of_order_within_window);
+    RUN_TEST(test_restore_blocks_everything_up_to_top);
+    RUN_TEST(test_downlink_bit_rejected_as_counter);
+    return UNITY_END();
+}
@@ -0,0 +1,106 @@
+// Deutsche Dokumentation
+// Unit-Tests: adaptiver Sende-Zeitplan (Host)
+#include <unity.h>
+#include "report_policy.h"
+
+void setUp() {}
+void tearDown() {}
+
+// 1 cm Totband, 15 min Heartbeat, 10 s im Hochwasser-Modus, ab 60 cm oder 1,5 cm/min
+static const ReportPolicy POLICY = { 10, 15UL * 60UL * 1000UL, 10000, 600, 15 };
+static const uint32_t STEP_MS = 10000; // Messintervall
+
+// Speist einen Messwert ein und bestätigt den Versand wie der Sensor
+static ReportReason feed(ReportState* st, int32_t mm, uint32_t t)
+{
+    ReportReason r = reportDecide(POLICY, st, mm, t);
+    if (r != REPORT_NONE) reportSent(st, mm, t);
+    return r;
+}
+
+static void test_quiet_level_sends_only_heartbeats()
+{
+    ReportState st; reportStateReset(&st);
+    TEST_ASSERT_EQUAL(REPORT_FIRST, feed(&st, 180, 0));
+    int sent = 0;
+    // eine Stunde mit ±2 mm Rauschen
+    for (uint32_t t = STEP_MS; t <= 3600000UL; t += STEP_MS) {
+        int32_t mm = 180 + (int32_t)((t / STEP_MS) % 3) * 2 - 2;
+        ReportReason r = feed(&st, mm, t);
+        if (r != REPORT_NONE) { TEST_ASSERT_EQUAL(REPORT_HEARTBEAT, r); ++sent; }
+    }
+    TEST_ASSERT_EQUAL(4, sent); // statt 60 Frames bei festem 60-s-Takt
+}
+
+static void test_change_beyond_deadband_is_sent_next_sample()
+{
+    ReportState st; reportStateReset(&st);
+    uint32_t t = 0;
+    for (int i = 0; i < REPORT_RATE_SAMPLES; ++i, t += STEP_MS) feed(&st, 180, t);
+    TEST_ASSERT_EQUAL(REPORT_NONE, feed(&st, 188, t));
+    t += STEP_MS;
+    // Sprung über das Totband, aber langsamer als die Hochwasser-Rate
+    TEST_ASSERT_EQUAL(REPORT_DELTA, feed(&st, 192, t));
+    TEST_ASSERT_FALSE(st.fast);
+    t += STEP_MS;
+    TEST_ASSERT_EQUAL(REPORT_NONE, feed(&st, 192, t));
+}
+
+static void test_fast_rise_enters_flood_mode_within_seconds()
+{
+    ReportState st; reportStateReset(&st);
+    uint32_t t = 0;
+    feed(&st, 200, t);
+    // Anstieg 3 cm/min = 5 mm pro Messung
+    int32_t mm = 200;
+    int floodAt = -1;
+    for (int i = 1; i <= 10; ++i) {
+        t += STEP_MS; mm += 5;
+        ReportReason r = feed(&st, mm, t);
+        if (r == REPORT_FLOOD && floodAt < 0) floodAt = i;
+    }
+    TEST_ASSERT_TRUE(floodAt > 0 && floodAt <= 2); // spätestens nach 20 s
+    TEST_ASSERT_TRUE(st.fast);
+}
+
+static void test_high_level_reports_every_fast_interval_and_exits_with_hysteresis()
+{
+    ReportState st; reportStateReset(&st);
+    feed(&st, 610, 0);
+    TEST_ASSERT_TRUE(st.fast);
+    TEST_ASSERT_EQUAL(REPORT_FLOOD, feed(&st, 610, STEP_MS));
+    TEST_ASSERT_EQUAL(REPORT_FLOOD, feed(&st, 610, 2 * STEP_MS));
+    // knapp unter der Schwelle bleibt der Modus aktiv
+    feed(&st, 595, 3 * STEP_MS);
+    feed(&st, 595, 4 * STEP_MS);
+    TEST_ASSERT_TRUE(st.fast);
+    // deutlich darunter und ruhig: zurück in den Normalbetrieb
+    uint32_t t = 5 * STEP_MS;
+    for (int i = 0; i < 6; ++i, t += STEP_MS) feed(&st, 580, t);
+    TEST_ASSERT_FALSE(st.fast);
+    TEST_ASSERT_EQUAL(REPORT_NONE, feed(&st, 580, t));
+}
+
+static void test_external_rate_drives_flood_mode()
+{
+    // Anstiegsrate vom Pegelfilter: kein eigener Verlauf nötig, Pegel unter der Schwelle
+    ReportState st; reportStateReset(&st);
+    TEST_ASSERT_EQUAL(REPORT_FIRST, reportDecideWithRate(POLICY, &st, 200, 0, 0));
+    reportSent(&st, 200, 0);
+    TEST_ASSERT_EQUAL(REPORT_NONE, reportDecideWithRate(POLICY, &st, 203, 10, STEP_MS));
+    TEST_ASSERT_FALSE(st.fast);
+    TEST_ASSERT_EQUAL(REPORT_FLOOD, reportDecideWithRate(POLICY, &st, 205, 20, 2 * STEP_MS));
+    TEST_ASSERT_EQUAL_INT32(20, st.rateMmPerMin);
+    TEST_ASSERT_EQUAL(0, st.histCount);
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_quiet_level_sends_only_heartbeats);
+    RUN_TEST(test_change_beyond_deadband_is_sent_next_sample);
+    RUN_TEST(test_fast_rise_enters_flood_mode_within_seconds);
+    RUN_TEST(test_high_level_reports_every_fast_interval_and_exits_with_hysteresis);
+    RUN_TEST(test_external_rate_drives_flood_mode);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+// Deutsche Dokumentation
+// Unit-Tests: RTC-Zustand des Sensors über den Deep-Sleep (Host)
+#include <unity.h>
+#include <cstring>
+#include "rtc_state.h"
+#include "crc32.h"
+
+void setUp() {}
+void tearDown() {}
+
+static SensorRtcState sampleState()
+{
+    SensorRtcState st;
+    memset(&st, 0, sizeof(st));
+    st.bootCount = 4242;
+    st.lastMeasureMs = 0xFFFFF000u;
+    st.seq = 65535;
+    st.bootToTxMs = 187;
+    st.frameCounter = 0x0000123456789ABCull;
+    st.counterReserved = st.frameCounter + 64;
+    st.downWindow.top = 77;
+    st.downWindow.bitmap = 0x8000000000000005ull;
+    st.sampleCount = 3;
+    st.samples[0] = { 1234, true, 1000 };
+    st.samples[1] = { -5, false, 61000 };
+    st.samples[2] = { INT16_MAX, true, 121000 };
+    reportStateReset(&st.report);
+    st.report.sent = true;
+    st.report.lastSentMm = -120;
+    st.report.lastSentMs = 99;
+    st.report.histCount = 2;
+    st.report.histHead = 2;
+    st.report.histMm[0] = 500; st.report.histMs[0] = 10;
+    st.report.histMm[1] = 510; st.report.histMs[1] = 20;
+    st.report.rateMmPerMin = 60;
+    levelFilterReset(&st.filter);
+    st.filter.valid = true;
+    st.filter.samples = 12;
+    st.filter.rejectedTotal = 2;
+    st.filter.levelQ8 = 1805 * 256 + 17;
+    st.filter.rateQ8 = -450 * 256;
+    st.filter.varQ4 = 300;
+    st.filter.lastMs = 0xFFFFF000u;
+    dutyCycleInit(&st.duty, 10, 3600UL * 1000UL);
+    TEST_ASSERT_TRUE(dutyCycleTryConsume(&st.duty, 5000, 61696));
+    st.duty.deferred = 3;
+    st.radioCurrent = { 9, 11 };
+    st.radioPrevious = { 7, 14 };
+    st.radioStaged = { 10, 2 };
+    st.radioProbation = true;
+    st.radioReportDue = true;
+    st.radioProbationUplinks = 2;
+    st.ackCount = 2;
+    st.acks[0] = { 17, DL_ACK_OK };
+    st.acks[1] = { 18, DL_ACK_REJECTED };
+    st.haveLastCommand = true;
+    st.lastCommandId = 18;
+    st.lastCommandStatus = DL_ACK_REJECTED;
+    return st;
+}
+
+static void test_crc32_reference_value()
+{
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32(check, sizeof(check)));
+    // fortgesetzt über zwei Teile
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32Update(crc32(check, 4), check + 4, 5));
+}
+
+static void test_roundtrip_keeps_every_field()
+{
+    SensorRtcState st = sampleState();
+    uint8_t buf[RTC_STATE_MAX_LEN];
+    const size_t len = rtcStateSerialize(st, buf, sizeof(buf));
+    TEST_ASSERT_GREATER_THAN(0, len);
+
+    SensorRtcState back;
+    TEST_ASSERT_TRUE(rtcStateDeserialize(buf, len, &back));
+    TEST_ASSERT_EQUAL_UINT32(st.bootCount, back.bootCount);
+    TEST_ASSERT_EQUAL_UINT32(st.lastMeasureMs, back.lastMeasureMs);
+    TEST_ASSERT_EQUAL_UINT16(st.seq, back.seq);
+    TEST_ASSERT_EQUAL_UINT16(st.bootToTxMs, back.bootToTxMs);
+    TEST_ASSERT_TRUE(st.frameCounter == back.frameCounter);
+    TEST_ASSERT_TRUE(st.counterReserved == back.counterReserved);
+    TEST_ASSERT_TRUE(st.downWindow.top == back.downWindow.top);
+    TEST_ASSERT_TRUE(st.downWindow.bitmap == back.downWindow.bitmap);
+    TEST_ASSERT_EQUAL_UINT8(3, back.sampleCount);
+    TEST_ASSERT_EQUAL_INT16(-5, back.samples[1].depthMm);
+    TEST_ASSERT_FALSE(back.samples[1].ok);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, back.samples[2].depthMm);
+    TEST_ASSERT_EQUAL_UINT32(121000, back.samples[2].ms);
+    TEST_ASSERT_TRUE(back.report.sent);
+    TEST_ASSERT_FALSE(back.report.fast);
+    TEST_ASSERT_EQUAL_INT32(-120, back.report.lastSentMm);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(st.report.histMm, back.report.histMm, REPORT_RATE_SAMPLES);
+    TEST_ASSERT_EQUAL_UINT8(2, back.report.histHead);
+    TEST_ASSERT_EQUAL_INT32(60, back.report.rateMmPerMin);
+    // Pegelfilter rechnet nach dem Aufwachen mit Pegel und Rate weiter
+    TEST_ASSERT_TRUE(back.filter.valid);
+    TEST_ASSERT_EQUAL_INT32(st.filter.levelQ8, back.filter.levelQ8);
+    TEST_ASSERT_EQUAL_INT32(-450, levelFilterRateMmPerH(back.filter));
+    TEST_ASSERT_EQUAL_UINT32(300, back.filter.varQ4);
+    TEST_ASSERT_EQUAL_UINT16(2, back.filter.rejectedTotal);
+    // Duty-Cycle-Konto rechnet nach dem Aufwachen weiter
+    TEST_ASSERT_EQUAL_UINT32(dutyCycleUsedUs(&st.duty, 6000), dutyCycleUsedUs(&back.duty, 6000));
+    TEST_ASSERT_EQUAL_UINT32(3, back.duty.deferred);
+    TEST_ASSERT_EQUAL_UINT8(9, back.radioCurrent.sf);
+    TEST_ASSERT_EQUAL_INT8(11, back.radioCurrent.txPowerDbm);
+    TEST_ASSERT_EQUAL_INT8(2, back.radioStaged.txPowerDbm);
+    TEST_ASSERT_FALSE(back.radioHaveStaged);
+    TEST_ASSERT_TRUE(back.radioProbation);
+    TEST_ASSERT_TRUE(back.radioReportDue);
+    TEST_ASSERT_EQUAL_UINT8(2, back.radioProbationUplinks);
+    TEST_ASSERT_EQUAL_UINT8(2, back.ackCount);
+    TEST_ASSERT_EQUAL_UINT16(18, back.acks[1].id);
+    TEST_ASSERT_EQUAL_UINT8(DL_ACK_REJECTED, back.acks[1].status);
+    TEST_ASSERT_TRUE(back.haveLastCommand);
+    TEST_ASSERT_EQUAL_UINT16(18, back.lastCommandId);
+}
+
+static void test_corruption_is_rejected()
+{
+    const SensorRtcState st = sampleState();
+    uint8_t buf[RTC_STATE_MAX_LEN];
+    const size_t len = rtcStateSerialize(st, buf, sizeof(buf));
+    SensorRtcState back;
+    // jedes einzelne gekippte Bit (Brownout, undefinierter RTC-Speicher) fällt auf
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] ^= 0x10;
+        TEST_ASSERT_FALSE(rtcStateDeserialize(buf, len, &back));
+        buf[i] ^= 0x10;
+    }
+    TEST_ASSERT_TRUE(rtcStateDeserialize(buf, len, &back));
+    // gelöschter Speicher
+    memset(buf, 0, sizeof(buf));
+    TEST_ASSERT_FALSE(rtcStateDeserialize(buf, sizeof(buf), &back));
+}
+
+static void test_length_and_version_checks()
+{
+    SensorRtcState st = sampleState();
+    uint8_t buf[RTC_STATE_MAX_LEN];
+    const size_t len = rtcStateSerialize(st, buf, sizeof(buf));
+    SensorRtcState back;
+    TEST_ASSERT_FALSE(rtcStateDeserialize(buf, len - 1, &back));   // abgeschnitten
+    TEST_ASSERT_TRUE(rtcStateDeserialize(buf, len + 16, &back));   // Rest des RTC-Puffers egal
+    TEST_ASSERT_EQUAL(0, rtcStateSerialize(st, buf, len - 1));     // Puffer zu klein
+
+    // anderes Layout (z. B. nach OTA-Update): Version passt nicht, auch mit gültiger CRC
+    buf[4] = RTC_STATE_VERSION + 1;
+    const uint32_t crc = crc32(buf, len - 4);
+    buf[len - 4] = (uint8_t)crc; buf[len - 3] = (uint8_t)(crc >> 8);
+    buf[len - 2] = (uint8_t)(crc >> 16); buf[len - 1] = (uint8_t)(crc >> 24);
+    TEST_ASSERT_FALSE(rtcStateDeserialize(buf, len, &back));
+
+    st.sampleCount = RTC_STATE_MAX_SAMPLES + 1;
+    TEST_ASSERT_EQUAL(0, rtcStateSerialize(st, buf, sizeof(buf)));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_reference_value);
+    RUN_TEST(test_roundtrip_keeps_every_field);
+    RUN_TEST(test_corruption_is_rejected);
+    RUN_TEST(test_length_and_version_checks);
+    return UNITY_END();
+}
@@ -0,0 +1,76 @@
+// Deutsche Dokumentation
+// Unit-Tests: Sensorzustand im Gateway-Register (Host)
+#include <unity.h>
+#include "sensor_record.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const uint32_t STALE_MS = 35UL * 60UL * 1000UL;
+
+static void test_sequence_gaps_count_as_lost()
+{
+    SensorRecord r; sensorRecordReset(&r);
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 1000, -90, 7.25f, true, 10));
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 2000, -91, 7.0f, true, 11));
+    TEST_ASSERT_EQUAL(2, sensorRecordUplink(&r, 3000, -92, -3.5f, true, 14));
+    TEST_ASSERT_EQUAL_UINT32(3, r.received);
+    TEST_ASSERT_EQUAL_UINT32(2, r.lost);
+    TEST_ASSERT_EQUAL(400, sensorRecordLossPermille(&r)); // 2 von 5
+    TEST_ASSERT_EQUAL(-14, r.snrX4);
+    TEST_ASSERT_EQUAL(-92, r.rssi);
+    // Überlauf der 16-Bit-Sequenz ist keine Lücke
+    sensorRecordUplink(&r, 4000, -90, 7.0f, true, 65535);
+    TEST_ASSERT_EQUAL_UINT16(1, r.restarts);
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 5000, -90, 7.0f, true, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, r.lost);
+}
+
+static void test_restart_is_not_counted_as_loss()
+{
+    SensorRecord r; sensorRecordReset(&r);
+    sensorRecordUplink(&r, 0, -80, 9.0f, true, 500);
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 1000, -80, 9.0f, true, 0)); // Neustart: Sequenz ab 0
+    TEST_ASSERT_EQUAL_UINT16(1, r.restarts);
+    TEST_ASSERT_EQUAL_UINT32(0, r.lost);
+    // ASCII-Altformat ohne Sequenz verändert die Zählung nicht
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 2000, -80, 9.0f, false, 0));
+    TEST_ASSERT_EQUAL(0, sensorRecordUplink(&r, 3000, -80, 9.0f, true, 1));
+}
+
+static void test_history_keeps_newest_first()
+{
+    SensorRecord r; sensorRecordReset(&r);
+    TEST_ASSERT_NULL(sensorRecordLatest(&r));
+    for (int32_t i = 1; i <= 6; ++i) sensorRecordSample(&r, i * 100, true, (uint32_t)i * 1000);
+    TEST_ASSERT_EQUAL(SENSOR_HISTORY_LEN, r.histCount);
+    TEST_ASSERT_EQUAL_INT32(600, sensorRecordLatest(&r)->depthMm);
+    TEST_ASSERT_EQUAL_INT32(300, r.hist[SENSOR_HISTORY_LEN - 1].depthMm);
+    TEST_ASSERT_EQUAL_UINT32(5000, r.hist[1].ms);
+}
+
+static void test_health()
+{
+    SensorRecord r; sensorRecordReset(&r);
+    TEST_ASSERT_EQUAL(SENSOR_UNKNOWN, sensorRecordHealth(&r, 0, STALE_MS, 100));
+    sensorRecordUplink(&r, 1000, -90, 5.0f, true, 1);
+    sensorRecordSample(&r, 180, true, 1000);
+    TEST_ASSERT_EQUAL(SENSOR_OK, sensorRecordHealth(&r, 2000, STALE_MS, 100));
+    TEST_ASSERT_EQUAL(SENSOR_STALE, sensorRecordHealth(&r, 1000 + STALE_MS, STALE_MS, 100));
+    sensorRecordUplink(&r, 3000, -90, 5.0f, true, 3); // 1 von 3 verloren
+    TEST_ASSERT_EQUAL(SENSOR_LOSSY, sensorRecordHealth(&r, 3000, STALE_MS, 100));
+    TEST_ASSERT_EQUAL(SENSOR_OK, sensorRecordHealth(&r, 3000, STALE_MS, 0));
+    sensorRecordSample(&r, 0, false, 3000);
+    TEST_ASSERT_EQUAL(SENSOR_ERROR, sensorRecordHealth(&r, 3000, STALE_MS, 100));
+    TEST_ASSERT_EQUAL_STRING("error", sensorHealthName(SENSOR_ERROR));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sequence_gaps_count_as_lost);
+    RUN_TEST(test_restart_is_not_counted_as_loss);
+    RUN_TEST(test_history_keeps_newest_first);
+    RUN_TEST(test_health);
+    return UNITY_END();
+}
@@ -0,0 +1,49 @@
+// Deutsche Dokumentation
+// Unit-Tests: SPSC-Ringpuffer (Host)
+#include <unity.h>
+#include "spsc_ring.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_fifo_order_and_full()
+{
+    SpscRing<int, 4> ring;
+    TEST_ASSERT_NULL(ring.front());
+    for (int i = 0; i < 4; ++i) TEST_ASSERT_TRUE(ring.push(i));
+    TEST_ASSERT_FALSE(ring.push(99)); // voll: neuer Eintrag wird abgewiesen
+    TEST_ASSERT_NULL(ring.claim());
+    TEST_ASSERT_EQUAL_UINT(4, ring.size());
+    int v;
+    for (int i = 0; i < 4; ++i) { TEST_ASSERT_TRUE(ring.pop(&v)); TEST_ASSERT_EQUAL_INT(i, v); }
+    TEST_ASSERT_FALSE(ring.pop(&v));
+    TEST_ASSERT_EQUAL_UINT(4, ring.highWater());
+}
+
+static void test_claim_publish_in_place_with_wraparound()
+{
+    struct Slot { uint8_t len; uint8_t data[8]; };
+    SpscRing<Slot, 2> ring;
+    for (uint8_t round = 0; round < 10; ++round) {
+        Slot* s = ring.claim();
+        TEST_ASSERT_NOT_NULL(s);
+        s->len = round;
+        s->data[0] = (uint8_t)(round * 3);
+        ring.publish();
+        Slot* f = ring.front();
+        TEST_ASSERT_NOT_NULL(f);
+        TEST_ASSERT_EQUAL_UINT8(round, f->len);
+        TEST_ASSERT_EQUAL_UINT8(round * 3, f->data[0]);
+        ring.pop();
+        TEST_ASSERT_EQUAL_UINT(0, ring.size());
+    }
+    TEST_ASSERT_EQUAL_UINT(1, ring.highWater());
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_order_and_full);
+    RUN_TEST(test_claim_publish_in_place_with_wraparound);
+    return UNITY_END();
+}
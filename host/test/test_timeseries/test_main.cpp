@@ -0,0 +1,174 @@
+// Deutsche Dokumentation
+// Unit-Tests: komprimierter Zeitreihen-Speicher mit Minute/Stunde/Tag-Stufen (Host)
+#include <unity.h>
+#include "timeseries.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Reproduzierbares Rauschen ±n
+static int32_t noise(uint32_t i, int32_t n)
+{
+    return (int32_t)((i * 2654435761u) >> 16) % (2 * n + 1) - n;
+}
+
+static uint8_t s_data[3][64 * TS_BLOCK_BYTES];
+static TsBlockHeader s_headers[3][64];
+
+static void initStore(TsStore* st, uint16_t minuteBlocks, uint16_t hourBlocks, uint16_t dayBlocks)
+{
+    uint8_t* const buffers[TS_TIER_COUNT] = { s_data[0], s_data[1], s_data[2] };
+    TsBlockHeader* const headers[TS_TIER_COUNT] = { s_headers[0], s_headers[1], s_headers[2] };
+    const uint16_t blocks[TS_TIER_COUNT] = { minuteBlocks, hourBlocks, dayBlocks };
+    tsStoreInit(st, buffers, headers, blocks);
+}
+
+static void test_points_roundtrip_exactly()
+{
+    TsSeries s;
+    tsSeriesInit(&s, s_data[0], s_headers[0], 8, 60);
+    // unregelmäßige Abstände, große Sprünge, negative Werte
+    static const TsPoint in[] = {
+        { 600, 1800, 1795, 1804 }, { 660, 1800, 1800, 1800 }, { 720, 1803, 1790, 1810 },
+        { 1200, -50, -70, 0 }, { 1260, 30000, -30000, 32767 }, { 86400 * 20, 5, 5, 5 },
+        { 86400 * 20 + 60, INT32_MIN + 1, INT32_MIN + 1, INT32_MAX }, { 86400 * 20 + 120, 7, 7, 7 },
+    };
+    for (const TsPoint& p : in) tsSeriesAppend(&s, p);
+    TEST_ASSERT_EQUAL_UINT32(8, s.points);
+
+    TsCursor c; TsPoint p;
+    tsSeriesScan(&s, 0, UINT32_MAX, &c);
+    for (const TsPoint& e : in) {
+        TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+        TEST_ASSERT_EQUAL_UINT32(e.t, p.t);
+        TEST_ASSERT_EQUAL_INT32(e.avg, p.avg);
+        TEST_ASSERT_EQUAL_INT32(e.min, p.min);
+        TEST_ASSERT_EQUAL_INT32(e.max, p.max);
+    }
+    TEST_ASSERT_FALSE(tsCursorNext(&c, &p));
+}
+
+static void test_samples_roll_up_into_minute_hour_day()
+{
+    TsStore st; initStore(&st, 16, 4, 2);
+    // alle 10 s ein Wert über zwei Tage: 0..59 je Minute wiederholt, Tag 2 um 1000 höher
+    for (uint32_t t = 0; t < 2 * 86400; t += 10) {
+        const int32_t v = (int32_t)((t / 10) % 6) * 10 + (t >= 86400 ? 1000 : 0);
+        tsStoreAdd(&st, t, v);
+    }
+    // Minute: 6 Werte 1000..1050, Mittel 1025
+    const uint32_t minute = 2 * 86400 - 3600;
+    TsCursor c; TsPoint p;
+    tsStoreScan(&st, TS_MINUTE, minute, minute + 59, &c);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(minute, p.t);
+    TEST_ASSERT_EQUAL_INT32(1025, p.avg);
+    TEST_ASSERT_EQUAL_INT32(1000, p.min);
+    TEST_ASSERT_EQUAL_INT32(1050, p.max);
+    TEST_ASSERT_FALSE(tsCursorNext(&c, &p));
+
+    // Tag 1 abgeschlossen, Tag 2 noch offen (kommt als letzter Punkt)
+    tsStoreScan(&st, TS_DAY, 0, UINT32_MAX, &c);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(0, p.t);
+    TEST_ASSERT_EQUAL_INT32(25, p.avg);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(86400, p.t);
+    TEST_ASSERT_EQUAL_INT32(1025, p.avg);
+    TEST_ASSERT_EQUAL_INT32(1000, p.min);
+    TEST_ASSERT_EQUAL_INT32(1050, p.max);
+    TEST_ASSERT_FALSE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(1, st.tier[TS_DAY].points);
+
+    // Stunden: 47 abgeschlossene + die offene
+    uint32_t n = 0;
+    tsStoreScan(&st, TS_HOUR, 0, UINT32_MAX, &c);
+    while (tsCursorNext(&c, &p)) {
+        TEST_ASSERT_EQUAL_UINT32(n * 3600, p.t);
+        ++n;
+    }
+    TEST_ASSERT_EQUAL_UINT32(48, n);
+}
+
+static void test_ring_drops_oldest_blocks_and_scans_ranges()
+{
+    TsStore st; initStore(&st, 4, 2, 2);
+    // 10 Tage Minutenwerte mit Rauschen passen nicht in 4 Blöcke
+    const uint32_t end = 10 * 86400;
+    for (uint32_t t = 0; t < end; t += 60) tsStoreAdd(&st, t, 1000 + noise(t, 5));
+    const TsSeries& s = st.tier[TS_MINUTE];
+    TEST_ASSERT_EQUAL_UINT16(4, s.used);
+    const uint32_t oldest = tsSeriesOldest(&s);
+    TEST_ASSERT_TRUE(oldest > 0 && oldest < end);
+    // letzte Minute ist noch offen
+    TEST_ASSERT_EQUAL_UINT32(end - 120, tsSeriesNewest(&s));
+
+    // Bereich mitten im Bestand: genau die Minuten darin, aufsteigend, Werte stimmen
+    const uint32_t from = end - 3600, to = end - 1800 - 1;
+    TsCursor c; TsPoint p;
+    uint32_t n = 0;
+    tsStoreScan(&st, TS_MINUTE, from, to, &c);
+    while (tsCursorNext(&c, &p)) {
+        TEST_ASSERT_EQUAL_UINT32(from + n * 60, p.t);
+        TEST_ASSERT_EQUAL_INT32(1000 + noise(p.t, 5), p.avg);
+        ++n;
+    }
+    TEST_ASSERT_EQUAL_UINT32(30, n);
+
+    // vor dem ältesten Punkt liegt nichts mehr
+    tsStoreScan(&st, TS_MINUTE, 0, oldest - 1, &c);
+    TEST_ASSERT_FALSE(tsCursorNext(&c, &p));
+    tsStoreScan(&st, TS_MINUTE, 0, UINT32_MAX, &c);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(oldest, p.t);
+}
+
+static void test_minute_series_is_compact()
+{
+    TsStore st; initStore(&st, 64, 4, 2);
+    // Pegel wie im Schacht: langsames Auf und Ab, Messung alle 10 s mit ±3 mm Rauschen
+    for (uint32_t t = 0; t < 7 * 86400; t += 10) {
+        const int32_t trend = (int32_t)((t / 60) % 720);
+        const int32_t level = 800 + (trend < 360 ? trend : 720 - trend);
+        tsStoreAdd(&st, t, level + noise(t / 10, 3));
+    }
+    const TsSeries& s = st.tier[TS_MINUTE];
+    // ein Punkt (Mittel, Min, Max) kostet im Mittel weniger als 3 Byte statt 16
+    TEST_ASSERT_LESS_THAN(3 * s.points, tsSeriesBytesUsed(&s));
+    // 64 Blöcke (16 KB) halten mehr als 4 Tage Minutenwerte
+    TEST_ASSERT_GREATER_THAN(4 * 1440, s.points);
+}
+
+static void test_late_samples_are_folded_into_open_interval()
+{
+    TsStore st; initStore(&st, 4, 2, 2);
+    tsStoreAdd(&st, 120, 10);
+    tsStoreAdd(&st, 190, 20);
+    // verspätet (Batch mit falscher Uhr): zählt zur offenen Minute 180
+    tsStoreAdd(&st, 100, 60);
+    tsStoreAdd(&st, 250, 0);
+    TsCursor c; TsPoint p;
+    tsStoreScan(&st, TS_MINUTE, 0, UINT32_MAX, &c);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(120, p.t);
+    TEST_ASSERT_EQUAL_INT32(10, p.avg);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(180, p.t);
+    TEST_ASSERT_EQUAL_INT32(40, p.avg);
+    TEST_ASSERT_EQUAL_INT32(20, p.min);
+    TEST_ASSERT_EQUAL_INT32(60, p.max);
+    TEST_ASSERT_TRUE(tsCursorNext(&c, &p));
+    TEST_ASSERT_EQUAL_UINT32(240, p.t);
+    TEST_ASSERT_FALSE(tsCursorNext(&c, &p));
+}
+
+int main(int, char**)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_points_roundtrip_exactly);
+    RUN_TEST(test_samples_roll_up_into_minute_hour_day);
+    RUN_TEST(test_ring_drops_oldest_blocks_and_scans_ranges);
+    RUN_TEST(test_minute_series_is_compact);
+    RUN_TEST(test_late_samples_are_folded_into_open_interval);
+    return UNITY_END();
+}
@@ -0,0 +1,61 @@
+// Deutsche Dokumentation
+// Host-Werkzeug: Messwert-Log aus einem Flash-Abbild des Gateways lesen (common/include/flash_log.h).
+// Abbild der Partition holen (Offset/Größe meldet das Gateway beim Start im seriellen Log):
+//   esptool.py read_flash <offset> <größe> histlog.bin
+// Aufruf:  pio run -e flashlog && .pio/build/flashlog/program histlog.bin [ab_unixzeit]
+// Ausgabe: CSV (unixzeit, iso_zeit, sensor, art, wert) auf stdout, Übersicht auf stderr.
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include "flash_log.h"
+
+static bool fileRead(void* ctx, uint32_t offset, void* buf, size_t len)
+{
+    FILE* f = (FILE*)ctx;
+    return fseek(f, (long)offset, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Aufruf: %s <abbild.bin> [ab_unixzeit]\n", argv[0]);
+        return 2;
+    }
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    const FlashLogIo io = { f, fileRead, nullptr, nullptr, (uint32_t)ftell(f) };
+    std::vector<FlashLogSectorInfo> index(flashLogSectorCount(io));
+    FlashLog log;
+    if (!flashLogMount(&log, io, index.data(), (uint16_t)index.size())) {
+        fprintf(stderr, "kein Log lesbar (%u Sektoren)\n", (unsigned)index.size());
+        fclose(f);
+        return 1;
+    }
+
+    FlashLogCursor c;
+    FlashLogRecord r;
+    uint32_t n = 0, first = 0, last = 0;
+    flashLogScan(&log, argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 0, &c);
+    printf("unixzeit,iso_zeit,sensor,art,wert\n");
+    while (flashLogNext(&c, &r)) {
+        char iso[32];
+        const time_t t = (time_t)r.tSec;
+        strftime(iso, sizeof(iso), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+        printf("%lu,%s,%u,%s,%ld\n", (unsigned long)r.tSec, iso, (unsigned)r.sid,
+               r.kind == FLASH_LOG_DEPTH_MM ? "depth_mm" : "?", (long)r.value);
+        if (!n++) first = r.tSec;
+        last = r.tSec;
+    }
+    fprintf(stderr, "%u Sektoren, %u belegt, aktueller Sektor %u (Nr. %lu), %lu Saetze %lu..%lu, "
+            "%lu beschaedigt, %u abgeschnitten\n",
+            (unsigned)log.sectors, (unsigned)log.usedSectors, (unsigned)log.head, (unsigned long)log.headSeq,
+            (unsigned long)n, (unsigned long)first, (unsigned long)last, (unsigned long)c.invalid, (unsigned)log.torn);
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+// Deutsche Dokumentation
+// Downlink-Befehle (Sensor-Board): Ausführung und Quittungen für den nächsten Uplink
+#include <stddef.h>
+#include <stdint.h>
+#include "downlink.h"
+#include "rtc_state.h"
+
+// Führt einen Befehl aus und merkt die Quittung vor. Eine Wiederholung (gleiche ID,
+// weil die Quittung verloren ging) wird nicht erneut ausgeführt, nur erneut quittiert.
+void commandExecute(const DownlinkCommand& cmd);
+
+// true = Quittungen warten auf den nächsten Uplink
+bool commandAcksPending();
+
+// Hängt die vorgemerkten Quittungen als ACK-TLV an.
+// Rückgabe: neue Länge (unverändert, wenn nichts ansteht oder kein Platz ist).
+size_t commandAppendAcks(uint8_t* buf, size_t cap, size_t len);
+// Nach dem tatsächlichen Versand: angehängte Quittungen verwerfen
+void commandAcksSent();
+
+// Deep-Sleep: offene Quittungen und zuletzt ausgeführten Befehl sichern bzw. übernehmen
+void commandSaveState(SensorRtcState* st);
+void commandRestoreState(const SensorRtcState& st);
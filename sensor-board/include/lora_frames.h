@@ -2,7 +2,33 @@
 // Deutsche Dokumentation
 // LoRa-Frame-Build für Sensor-Uplink (verschlüsselt/optional unverschlüsselt)
 #include <Arduino.h>
+#include "downlink.h"
+#include "rtc_state.h"
 
-// Sendet einen Messwert-Payload (ASCII) als verschlüsseltes Paket.
-// Nutzt AES_KEY/HMAC_KEY aus config.h und LORA_FREQUENCY_HZ (bereits initialisiert in setup).
-bool loraSendEncrypted(uint8_t sensorId, const String& payload);
+enum LoRaSendResult : uint8_t
+{
+    LORA_SEND_OK = 0,
+    LORA_SEND_DEFERRED,     // Duty-Cycle-Budget der letzten Stunde erschöpft
+    LORA_SEND_FAILED,       // Session oder Frame-Aufbau fehlgeschlagen (kein Budget verbraucht)
+};
+
+// Sendet einen Messwert-Payload (beliebige Bytes) als verschlüsseltes Paket.
+// Nutzt AES_KEY/HMAC_KEY bzw. MASTER_KEY aus config.h und LORA_FREQUENCY_HZ (bereits initialisiert in setup).
+// Der Frame entsteht in einem festen Puffer über den gemeinsamen Codec (kein Heap, kein String).
+// Erst der fertige Frame wird im Duty-Cycle-Konto gebucht, direkt vor dem Senden; passt er
+// nicht mehr ins Budget der letzten Stunde, wird nicht gesendet.
+LoRaSendResult loraSendEncrypted(uint8_t sensorId, const uint8_t* payload, size_t len);
+
+// Sendezeit der letzten Stunde (ms) und seit dem Start verschobene Uplinks
+uint32_t loraAirtimeUsedMs();
+uint32_t loraAirtimeDeferred();
+
+// Empfangsfenster direkt nach einem Uplink: wartet höchstens windowMs auf einen
+// Downlink-Befehl des Gateways an sensorId. Geprüft werden Sensor-ID, Richtungsbit,
+// Replay-Fenster (Stand in NVS) und MAC. true = gültiger Befehl in *out.
+bool loraReceiveCommand(uint8_t sensorId, uint32_t windowMs, DownlinkCommand* out);
+
+// Deep-Sleep: Frame-Zähler samt reserviertem Block, Replay-Fenster und Duty-Cycle-Konto
+// sichern bzw. nach dem Aufwachen übernehmen (spart das Lesen/Reservieren in NVS je Start)
+void loraFramesSaveState(SensorRtcState* st);
+void loraFramesRestoreState(const SensorRtcState& st);
@@ -1,10 +1,22 @@
 #pragma once
 // Deutsche Dokumentation
-// Sensor-Messmodul: Mittelung in mV und Umrechnung mV -> cm
+// Sensor-Messmodul: ADC-Burst in mV (robust ausgewertet) und Umrechnung mV -> cm
 #include <stdint.h>
 
-// Liest gemittelte Millivolt vom angegebenen ADC-Pin (ESP32 ADC1 bevorzugt)
-uint32_t readMilliVoltsAveraged(int pin, int samples = 32);
+struct MvReading
+{
+    uint32_t mv;        // ausgewerteter Wert in mV
+    float noiseMv;      // Streuung im Burst (robuste Standardabweichung) in mV
+    uint16_t samples;   // Anzahl Rohwerte
+    uint32_t burstUs;   // Dauer der Erfassung
+    bool ok;            // false = ADC lieferte keine Werte
+};
 
-// Rechnet mV in Zentimeter Wassertiefe um (Parameter aus config.h)
-float mvToDepthCm(uint32_t mv);
+// ADC vorbereiten (Auflösung, Dämpfung, Kalibrierung, ggf. DMA über I2S0)
+void measurementBegin(int pin);
+
+// Erfasst ADC_BURST_SAMPLES Rohwerte am Pin und wertet sie nach ADC_REDUCE_MODE aus
+MvReading readMilliVoltsBurst(int pin);
+
+// Rechnet mV in Wassertiefe (mm) um: Tabelle aus SENSOR_CALIBRATION (config.h)
+int32_t mvToDepthMm(uint32_t mv);
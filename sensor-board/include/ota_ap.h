@@ -5,8 +5,12 @@
 // Startet den SoftAP + ArduinoOTA Service (gemäß config.h)
 void otaApInit();
 
-// Muss regelmäßig im loop() aufgerufen werden, um OTA zu bedienen
+// Muss regelmäßig im loop() aufgerufen werden, um OTA zu bedienen.
+// Mit DEEP_SLEEP_ENABLED wird der AP nach OTA_AP_TIMEOUT_MS ohne laufendes Update gestoppt.
 void otaApLoop();
 
 // Stoppt den SoftAP und den OTA-Service
 void otaApStop();
+
+// true = Access-Point läuft (im Deep-Sleep-Betrieb bleibt der Sensor dann wach)
+bool otaApActive();
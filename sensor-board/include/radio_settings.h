@@ -0,0 +1,34 @@
+#pragma once
+// Deutsche Dokumentation
+// Funkparameter des Sensors (SF, Sendeleistung) mit ADR-Vorgaben vom Gateway.
+//
+// Wechsel in zwei Schritten, damit Sensor und Gateway sich nicht verlieren:
+// 1. DL_OP_RADIO kommt im Empfangsfenster an und wird vorgemerkt; die Quittung geht
+//    mit dem nächsten Uplink noch mit den alten Parametern raus (Gateway stellt um).
+// 2. Erst danach schaltet der Sensor um. Kommt in den folgenden ADR_PROBATION_UPLINKS
+//    Uplinks kein Downlink (DL_OP_LINK_CHECK) an, kehrt er zu den alten Werten zurück.
+// Bestätigte Werte werden in NVS gesichert.
+#include <stdint.h>
+#include "adr.h"
+#include "rtc_state.h"
+
+// Gesicherte oder konfigurierte Werte laden und setzen (nach LoRa.begin())
+void radioInit();
+
+// Deep-Sleep: Zustand samt laufendem Wechsel sichern bzw. statt radioInit() übernehmen und setzen
+void radioSaveState(SensorRtcState* st);
+void radioRestoreState(const SensorRtcState& st);
+
+RadioSettings radioCurrent();
+
+// Vorgabe aus DL_OP_RADIO prüfen und vormerken. Rückgabe: DL_ACK_*.
+uint8_t radioStage(const uint8_t* args, uint8_t argLen);
+// true = der Sensor sendet schon mit diesen DL_OP_RADIO-Werten oder hat sie vorgemerkt
+bool radioTargets(const uint8_t* args, uint8_t argLen);
+
+// Nach jedem Uplink samt Empfangsfenster aufrufen (gotDownlink = gültiger Befehl empfangen)
+void radioAfterUplink(bool gotDownlink);
+
+// true = aktuelle Parameter sollen im nächsten Uplink gemeldet werden (PAYLOAD_TLV_RADIO)
+bool radioReportDue();
+void radioReported();
@@ -0,0 +1,24 @@
+#pragma once
+// Deutsche Dokumentation
+// Deep-Sleep-Zyklus des Sensor-Boards: Zustand im RTC-Speicher sichern, schlafen,
+// nach dem Timer-Wecker wiederherstellen (siehe common/include/rtc_state.h).
+//
+// Zeitstempel (Messung, Sende-Zeitplan, Duty-Cycle) laufen über clockMs(): millis()
+// beginnt nach jedem Aufwachen bei 0, die Systemzeit des ESP32 läuft über den RTC-Timer
+// im Deep-Sleep weiter (ab Kaltstart, ohne NTP).
+#include <stdint.h>
+#include "rtc_state.h"
+
+// Millisekunden seit dem Kaltstart, auch über den Deep-Sleep hinweg (Überlauf wie millis())
+uint32_t clockMs();
+
+// Ganz am Anfang von setup() aufrufen. true = vom Timer geweckt und gültiger Zustand in *out
+// (schneller Pfad), false = Kaltstart, Reset oder ungültiger RTC-Speicher.
+bool sleepRestore(SensorRtcState* out);
+
+// Aufwachvorgänge seit dem Kaltstart
+uint32_t sleepBootCount();
+
+// Sichert st im RTC-Speicher, legt das LoRa-Modul schlafen und geht für sleepMs in den
+// Deep-Sleep. Kehrt nicht zurück; der nächste Start beginnt in setup().
+void sleepEnter(SensorRtcState* st, uint32_t sleepMs);
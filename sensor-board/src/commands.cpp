@@ -0,0 +1,108 @@
+// Deutsche Dokumentation
+// Downlink-Befehle (Sensor-Board): Implementierung
+#include "commands.h"
+#include <Arduino.h>
+#include "config.h"
+#include "ota_ap.h"
+#include "radio_settings.h"
+
+static const size_t MAX_PENDING_ACKS = 4;
+static_assert(MAX_PENDING_ACKS <= RTC_STATE_MAX_ACKS, "Quittungen müssen in den RTC-Zustand passen");
+static DownlinkAck s_acks[MAX_PENDING_ACKS];
+static size_t s_ackCount = 0;
+
+// Zuletzt ausgeführter Befehl (Erkennung von Wiederholungen)
+static bool s_haveLast = false;
+static uint16_t s_lastId = 0;
+static uint8_t s_lastStatus = DL_ACK_OK;
+
+static void queueAck(uint16_t id, uint8_t status)
+{
+    for (size_t i = 0; i < s_ackCount; ++i) {
+        if (s_acks[i].id == id) { s_acks[i].status = status; return; }
+    }
+    if (s_ackCount == MAX_PENDING_ACKS) {
+        memmove(&s_acks[0], &s_acks[1], (MAX_PENDING_ACKS - 1) * sizeof(DownlinkAck));
+        --s_ackCount;
+    }
+    s_acks[s_ackCount++] = { id, status };
+}
+
+static uint8_t execute(const DownlinkCommand& cmd)
+{
+    switch (cmd.opcode) {
+    case DL_OP_OTA_AP:
+        if (cmd.argLen < 1) return DL_ACK_REJECTED;
+        if (cmd.args[0]) {
+            if (!OTA_AP_ENABLED) return DL_ACK_REJECTED;
+            otaApInit();
+        } else {
+            otaApStop();
+        }
+        return DL_ACK_OK;
+    case DL_OP_RADIO:
+        return radioStage(cmd.args, cmd.argLen);
+    case DL_OP_LINK_CHECK:
+        return DL_ACK_OK; // Empfang allein ist die Bestätigung (siehe radioAfterUplink)
+    default:
+        return DL_ACK_UNKNOWN;
+    }
+}
+
+void commandExecute(const DownlinkCommand& cmd)
+{
+    if (s_haveLast && cmd.id == s_lastId) {
+        // Ging die Quittung verloren, ist der Sensor nach der Probezeit evtl. schon zu den
+        // alten Funkwerten zurückgekehrt; das Gateway stellt nach dieser Quittung um, also
+        // die Vorgabe erneut vormerken
+        if (cmd.opcode == DL_OP_RADIO && s_lastStatus == DL_ACK_OK && !radioTargets(cmd.args, cmd.argLen)) {
+            Serial.printf("Befehl id=%u wiederholt, Funkwerte erneut vorgemerkt\n", (unsigned)cmd.id);
+            s_lastStatus = radioStage(cmd.args, cmd.argLen);
+        } else {
+            Serial.printf("Befehl id=%u wiederholt, nur Quittung\n", (unsigned)cmd.id);
+        }
+        queueAck(cmd.id, s_lastStatus);
+        return;
+    }
+    uint8_t status = execute(cmd);
+    Serial.printf("Befehl id=%u op=0x%02x status=%u\n", (unsigned)cmd.id, (unsigned)cmd.opcode, (unsigned)status);
+    s_haveLast = true;
+    s_lastId = cmd.id;
+    s_lastStatus = status;
+    queueAck(cmd.id, status);
+}
+
+bool commandAcksPending()
+{
+    return s_ackCount > 0;
+}
+
+size_t commandAppendAcks(uint8_t* buf, size_t cap, size_t len)
+{
+    if (!s_ackCount) return len;
+    size_t n = payloadAppendAcks(buf, cap, len, s_acks, s_ackCount);
+    return n ? n : len;
+}
+
+void commandAcksSent()
+{
+    s_ackCount = 0; // geht der Uplink verloren, wiederholt das Gateway den Befehl
+}
+
+void commandSaveState(SensorRtcState* st)
+{
+    memcpy(st->acks, s_acks, s_ackCount * sizeof(DownlinkAck));
+    st->ackCount = (uint8_t)s_ackCount;
+    st->haveLastCommand = s_haveLast;
+    st->lastCommandId = s_lastId;
+    st->lastCommandStatus = s_lastStatus;
+}
+
+void commandRestoreState(const SensorRtcState& st)
+{
+    s_ackCount = st.ackCount < MAX_PENDING_ACKS ? st.ackCount : MAX_PENDING_ACKS;
+    memcpy(s_acks, st.acks, s_ackCount * sizeof(DownlinkAck));
+    s_haveLast = st.haveLastCommand;
+    s_lastId = st.lastCommandId;
+    s_lastStatus = st.lastCommandStatus;
+}
@@ -2,47 +2,180 @@
 // LoRa-Frames (Sensor): Aufbau und Versand
 #include "lora_frames.h"
 #include <LoRa.h>
-#include <memory>
 #include <cstring>
 #include "config.h"
-// Gemeinsame Krypto-Funktionen
+// Gemeinsame Krypto-Funktionen und Frame-Codec
 #include "crypto.h"
+#include "lora_frame.h"
+#include "frame_counter.h"
+#include <Preferences.h>
+#include "duty_cycle.h"
+#include "lora_airtime.h"
+#include "radio_settings.h"
+#include "sleep_cycle.h"
 
-static const size_t NONCE_LEN = 8;
-static const size_t MAC_LEN   = 8; // Hinweis: Für mehr Sicherheit ggf. 16 nutzen
+// Vorbereitete Krypto-Session (Key-Schedule/HMAC-Zustand einmalig beim ersten Senden)
+static CryptoSession s_session;
 
-bool loraSendEncrypted(uint8_t sensorId, const String& payload)
+// Monotoner Frame-Zähler als Nonce; in NVS wird nur das Ende des
+// reservierten Blocks gesichert (ein Schreibvorgang je FRAME_COUNTER_LEASE Frames)
+static uint64_t s_counter = 0;
+static uint64_t s_counterReserved = 0;
+static bool s_counterLoaded = false;
+
+static uint64_t nextFrameCounter()
+{
+    Preferences prefs;
+    if (!s_counterLoaded) {
+        if (prefs.begin("lwlm", true)) { s_counterReserved = prefs.getULong64("ctr", 0); prefs.end(); }
+        s_counter = s_counterReserved;
+        s_counterLoaded = true;
+    }
+    ++s_counter;
+    if (s_counter > s_counterReserved) {
+        s_counterReserved = s_counter + FRAME_COUNTER_LEASE;
+        if (prefs.begin("lwlm", false)) { prefs.putULong64("ctr", s_counterReserved); prefs.end(); }
+    }
+    return s_counter;
+}
+
+// Replay-Fenster für Downlinks (Zähler ohne Richtungsbit). Der höchste akzeptierte
+// Zähler wird bei jedem Befehl gesichert; Befehle sind selten.
+static ReplayWindow s_downWindow;
+static bool s_downWindowLoaded = false;
+
+static void loadDownlinkWindow()
+{
+    if (s_downWindowLoaded) return;
+    Preferences prefs;
+    uint64_t top = 0;
+    if (prefs.begin("lwlm", true)) { top = prefs.getULong64("dl", 0); prefs.end(); }
+    if (top) replayWindowRestore(s_downWindow, top);
+    else replayWindowReset(s_downWindow);
+    s_downWindowLoaded = true;
+}
+
+static bool ensureSession(uint8_t sensorId)
+{
+    if (s_session.ready()) return true;
+    if (!PER_SENSOR_KEYS) return s_session.begin(AES_KEY, HMAC_KEY, sizeof(HMAC_KEY));
+
+    uint8_t aesKey[CRYPTO_AES_KEY_LEN];
+    uint8_t hmacKey[CRYPTO_HMAC_KEY_LEN];
+    bool ok = deriveSensorKeys(MASTER_KEY, sizeof(MASTER_KEY), sensorId, aesKey, hmacKey) &&
+              s_session.begin(aesKey, hmacKey, sizeof(hmacKey));
+    memset(aesKey, 0, sizeof(aesKey));
+    memset(hmacKey, 0, sizeof(hmacKey));
+    return ok;
+}
+
+// Duty-Cycle-Konto über alle Uplinks (gleitende Stunde)
+static DutyCycle s_duty;
+static bool s_dutyReady = false;
+
+static DutyCycle& duty()
+{
+    if (!s_dutyReady) { dutyCycleInit(&s_duty, DUTY_CYCLE_PERMILLE, 3600UL * 1000UL); s_dutyReady = true; }
+    return s_duty;
+}
+
+static uint32_t uplinkToaUs(size_t payloadLen)
+{
+    const size_t frameLen = ENCRYPTION_ENABLED ? payloadLen + LORA_FRAME_OVERHEAD : payloadLen;
+    return loraTimeOnAirUs(loraModulationDefault(radioCurrent().sf), frameLen);
+}
+
+uint32_t loraAirtimeUsedMs()
+{
+    return dutyCycleUsedUs(&duty(), clockMs()) / 1000;
+}
+
+uint32_t loraAirtimeDeferred()
+{
+    return duty().deferred;
+}
+
+LoRaSendResult loraSendEncrypted(uint8_t sensorId, const uint8_t* payload, size_t len)
 {
     if (!ENCRYPTION_ENABLED)
     {
+        if (!dutyCycleTryConsume(&duty(), clockMs(), uplinkToaUs(len))) return LORA_SEND_DEFERRED;
         LoRa.beginPacket();
-        LoRa.print(payload);
+        LoRa.write(payload, len);
         LoRa.endPacket();
-        return true;
+        return LORA_SEND_OK;
     }
+    if (!ensureSession(sensorId)) return LORA_SEND_FAILED;
 
-    const size_t ptLen = payload.length();
-    std::unique_ptr<uint8_t[]> ct(new uint8_t[ptLen]);
-    memcpy(ct.get(), (const uint8_t*)payload.c_str(), ptLen);
+    uint8_t nonce[LORA_FRAME_NONCE_LEN];
+    frameCounterToNonce(nextFrameCounter(), nonce);
 
-    uint8_t nonce[NONCE_LEN];
-    for (size_t i = 0; i < NONCE_LEN; ++i) nonce[i] = (uint8_t)(esp_random() & 0xFF);
+    // Frame im festen Puffer aufbauen, Verschlüsselung und MAC in-place
+    static uint8_t frame[LORA_FRAME_MAX_LEN];
+    size_t frameLen = loraFrameEncode(s_session, sensorId, nonce, payload, len, frame, sizeof(frame));
+    if (!frameLen) return LORA_SEND_FAILED;
 
-    if (!aesCtrCrypt(AES_KEY, nonce, ct.get(), ptLen)) return false;
+    // Nur ein tatsächlich gesendeter Frame verbraucht Budget (ein verworfener Zähler ist nur eine Lücke)
+    if (!dutyCycleTryConsume(&duty(), clockMs(), uplinkToaUs(len))) return LORA_SEND_DEFERRED;
+    LoRa.beginPacket();
+    LoRa.write(frame, frameLen);
+    LoRa.endPacket();
+    return LORA_SEND_OK;
+}
 
-    const size_t hdrLen = 1 + NONCE_LEN;
-    const size_t frameLen = hdrLen + ptLen + MAC_LEN;
-    std::unique_ptr<uint8_t[]> frame(new uint8_t[frameLen]);
-    frame[0] = sensorId;
-    memcpy(frame.get()+1, nonce, NONCE_LEN);
-    memcpy(frame.get()+hdrLen, ct.get(), ptLen);
+bool loraReceiveCommand(uint8_t sensorId, uint32_t windowMs, DownlinkCommand* out)
+{
+    if (!ENCRYPTION_ENABLED || !ensureSession(sensorId)) return false;
+    loadDownlinkWindow();
 
-    uint8_t mac[MAC_LEN];
-    if (!hmacSha256Trunc(HMAC_KEY, sizeof(HMAC_KEY), frame.get(), hdrLen + ptLen, mac, MAC_LEN)) return false;
-    memcpy(frame.get()+hdrLen+ptLen, mac, MAC_LEN);
+    static uint8_t frame[LORA_FRAME_MAX_LEN];
+    const unsigned long start = millis();
+    bool ok = false;
+    while (!ok && millis() - start < windowMs)
+    {
+        int packetSize = LoRa.parsePacket();
+        if (!packetSize) { delay(1); continue; }
+        size_t len = (packetSize <= (int)sizeof(frame)) ? LoRa.readBytes(frame, packetSize) : 0;
+        if (len != (size_t)packetSize) continue;
 
-    LoRa.beginPacket();
-    LoRa.write(frame.get(), frameLen);
-    LoRa.endPacket();
-    return true;
+        uint8_t sid;
+        if (!loraFrameSensorId(frame, len, &sid) || sid != sensorId) continue;
+        const uint64_t counter = frameCounterFromNonce(loraFrameNonce(frame));
+        if (!(counter & FRAME_COUNTER_DOWNLINK)) continue; // Uplink eines anderen Sensors mit gleicher ID
+        const uint64_t ctr = counter & FRAME_COUNTER_MAX;
+        if (!replayWindowCheck(s_downWindow, ctr)) continue;
+        const uint8_t* pt; size_t ptLen;
+        if (!loraFrameOpen(s_session, frame, len, &pt, &ptLen)) continue;
+        replayWindowUpdate(s_downWindow, ctr);
+        Preferences prefs;
+        if (prefs.begin("lwlm", false)) { prefs.putULong64("dl", s_downWindow.top); prefs.end(); }
+        ok = downlinkDecode(pt, ptLen, out);
+    }
+    LoRa.idle();
+    return ok;
+}
+
+void loraFramesSaveState(SensorRtcState* st)
+{
+    st->frameCounter = s_counterLoaded ? s_counter : 0;
+    st->counterReserved = s_counterLoaded ? s_counterReserved : 0;
+    if (s_downWindowLoaded) st->downWindow = s_downWindow;
+    else replayWindowReset(st->downWindow);
+    st->duty = duty();
+}
+
+void loraFramesRestoreState(const SensorRtcState& st)
+{
+    // noch nie gesendet: Zähler beim ersten Frame wie gewohnt aus NVS
+    if (st.counterReserved) {
+        s_counter = st.frameCounter;
+        s_counterReserved = st.counterReserved;
+        s_counterLoaded = true;
+    }
+    if (st.downWindow.top) {
+        s_downWindow = st.downWindow;
+        s_downWindowLoaded = true;
+    }
+    s_duty = st.duty;
+    s_dutyReady = true;
 }
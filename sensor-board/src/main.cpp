@@ -6,21 +6,230 @@
 #include "lora_frames.h"
 #include "oled.h"
 #include "ota_ap.h"
+#include "payload.h"
+#include "lora_frame.h"
+#include "report_policy.h"
+#include "commands.h"
+#include "radio_settings.h"
+#include "lora_airtime.h"
+#include "sleep_cycle.h"
+#include "level_filter.h"
 
-// Zeitsteuerung Messung
-static unsigned long g_lastMeasureMs = 0;
+static_assert(BATCH_SIZE >= 1 && BATCH_SIZE <= PAYLOAD_BATCH_MAX + 1, "BATCH_SIZE muss 1..PAYLOAD_BATCH_MAX+1 sein");
+
+// Zeitsteuerung Messung (clockMs, läuft über den Deep-Sleep weiter)
+static uint32_t g_lastMeasureMs = 0;
+// Sequenznummer der Messwert-Payload (v2)
+static uint16_t g_seq = 0;
+
+// Gepufferte Messwerte bis zum nächsten Uplink (älteste zuerst). Ist der Puffer voll,
+// ohne dass gesendet wurde, fällt der älteste Wert heraus (lag im Totband).
+static RtcSample g_samples[BATCH_SIZE];
+static size_t g_sampleCount = 0;
+
+// Deep-Sleep: vom Timer geweckt (schneller Pfad), Dauer Aufwachen -> Uplink gesendet
+static bool g_wokeFromSleep = false;
+static bool g_sentThisBoot = false;
+static uint16_t g_bootToTxMs = 0;
+
+// Adaptiver Sende-Zeitplan (Totband, Heartbeat, Hochwasser-Schnellpfad)
+static const ReportPolicy REPORT_POLICY = {
+  (int32_t)lroundf(REPORT_DEADBAND_CM * 10.0f),
+  REPORT_HEARTBEAT_MS,
+  REPORT_FAST_INTERVAL_MS,
+  (int32_t)lroundf(REPORT_FLOOD_LEVEL_CM * 10.0f),
+  (int32_t)lroundf(REPORT_FLOOD_RATE_CM_PER_MIN * 10.0f),
+};
+static ReportState g_report;
+
+// Pegelfilter: geglätteter Pegel und Anstiegsrate für Uplink und Sende-Zeitplan
+static const LevelFilterConfig LEVEL_FILTER_CONFIG = {
+  LEVEL_FILTER_NOISE_MM,
+  LEVEL_FILTER_ACCEL_MM_PER_H2,
+  MEASURE_INTERVAL_MS,
+  LEVEL_FILTER_GATE_SIGMA,
+  LEVEL_FILTER_GATE_MIN_MM,
+  LEVEL_FILTER_MAX_REJECTS,
+  6 * MEASURE_INTERVAL_MS,  // längere Lücke (Sensor aus): neu starten
+};
+static LevelFilterParams g_filterParams;
+static LevelFilter g_filter;
+
+static int16_t clampI16(int32_t v)
+{
+  return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+static void pushSample(const RtcSample& s)
+{
+  if (g_sampleCount == BATCH_SIZE)
+  {
+    memmove(&g_samples[0], &g_samples[1], (BATCH_SIZE - 1) * sizeof(RtcSample));
+    --g_sampleCount;
+  }
+  g_samples[g_sampleCount++] = s;
+}
+
+// Sendet alle gepufferten Messwerte in einem Frame: der neueste im v2-Kopf,
+// die älteren als Delta-kodierter BATCH-TLV mit ihrem Alter in Sekunden.
+// false = wegen Duty-Cycle verschoben, die Messwerte bleiben gepuffert.
+static bool sendBatch(const MvReading& lastMv, bool reportRadio)
+{
+  const RtcSample& head = g_samples[g_sampleCount - 1];
+  uint8_t payload[LORA_FRAME_MAX_PAYLOAD];
+  size_t payloadLen = payloadEncodeV2(payload, sizeof(payload), head.ok ? 0 : PAYLOAD_FLAG_ERR, g_seq, head.depthMm);
+  if (PAYLOAD_INCLUDE_RAW_MV)
+  {
+    const uint8_t rawMv[2] = { (uint8_t)lastMv.mv, (uint8_t)(lastMv.mv >> 8) };
+    payloadLen = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_RAW_MV, rawMv, sizeof(rawMv));
+  }
+  // Quittungen für Downlink-Befehle vor dem Batch, damit sie nie verdrängt werden
+  payloadLen = commandAppendAcks(payload, sizeof(payload), payloadLen);
+  // Aktuelle Funkparameter für die ADR des Gateways (nach Start, Wechsel und als Heartbeat),
+  // dazu die Sendezeit der letzten Stunde für das Duty-Cycle-Monitoring
+  bool radioIncluded = false;
+  if (reportRadio || radioReportDue())
+  {
+    const RadioSettings r = radioCurrent();
+    const uint8_t radio[2] = { r.sf, (uint8_t)r.txPowerDbm };
+    size_t n = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_RADIO, radio, sizeof(radio));
+    if (n) { payloadLen = n; radioIncluded = true; }
+    const uint32_t usedMs = loraAirtimeUsedMs();
+    const uint32_t deferred = loraAirtimeDeferred();
+    const uint8_t airtime[4] = { (uint8_t)usedMs, (uint8_t)(usedMs >> 8), (uint8_t)deferred, (uint8_t)(deferred >> 8) };
+    n = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_AIRTIME, airtime, sizeof(airtime));
+    if (n) payloadLen = n;
+    // Messrauschen (Zustand des Drucksensors/der Verkabelung)
+    const long noise = lroundf(lastMv.noiseMv * 10.0f);
+    const uint16_t noiseX10 = noise > 0xFFFF ? 0xFFFF : (uint16_t)noise;
+    const uint8_t noiseTlv[2] = { (uint8_t)noiseX10, (uint8_t)(noiseX10 >> 8) };
+    n = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_NOISE, noiseTlv, sizeof(noiseTlv));
+    if (n) payloadLen = n;
+    // Dauer des schnellen Pfads (zuletzt gemessen, also aus einem früheren Aufwachen)
+    if (g_bootToTxMs)
+    {
+      const uint8_t wake[2] = { (uint8_t)g_bootToTxMs, (uint8_t)(g_bootToTxMs >> 8) };
+      n = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_WAKE, wake, sizeof(wake));
+      if (n) payloadLen = n;
+    }
+  }
+  // Geglätteter Pegel und Anstiegsrate, sobald der Filter eingeschwungen ist
+  if (levelFilterSettled(g_filter))
+  {
+    const int16_t level = clampI16(levelFilterLevelMm(g_filter));
+    const int16_t rate = clampI16(levelFilterRateMmPerH(g_filter));
+    const uint8_t trend[4] = { (uint8_t)level, (uint8_t)(level >> 8), (uint8_t)rate, (uint8_t)(rate >> 8) };
+    size_t n = payloadAppendTlv(payload, sizeof(payload), payloadLen, PAYLOAD_TLV_TREND, trend, sizeof(trend));
+    if (n) payloadLen = n;
+  }
+  if (g_sampleCount > 1)
+  {
+    // Der BATCH-TLV kennt kein Fehler-Flag: ungültige Messwerte (ERR) bleiben draußen
+    BatchSample older[PAYLOAD_BATCH_MAX];
+    size_t n = 0;
+    for (size_t i = g_sampleCount - 1; i-- > 0;)
+    {
+      if (!g_samples[i].ok) continue;
+      older[n].depthMm = g_samples[i].depthMm;
+      older[n].ageSec = (head.ms - g_samples[i].ms + 500UL) / 1000UL;
+      ++n;
+    }
+    size_t withBatch = n ? payloadAppendBatch(payload, sizeof(payload), payloadLen, head.depthMm, older, n) : 0;
+    if (withBatch) payloadLen = withBatch;
+    else if (n) Serial.println("Batch passt nicht in den Frame, sende nur den neuesten Wert");
+  }
+
+  // Senden (verschlüsselt, wenn aktiviert); über dem Duty-Cycle-Budget bzw. nach einem Fehler
+  // beim nächsten Messwert erneut
+  const LoRaSendResult sent = loraSendEncrypted(SENSOR_ID, payload, payloadLen);
+  if (sent == LORA_SEND_DEFERRED)
+  {
+    Serial.print("Duty-Cycle: Uplink verschoben, Sendezeit letzte Stunde ms="); Serial.println(loraAirtimeUsedMs());
+    return false;
+  }
+  if (sent != LORA_SEND_OK)
+  {
+    Serial.println("Uplink fehlgeschlagen (Session/Frame)");
+    return false;
+  }
+  if (g_wokeFromSleep && !g_sentThisBoot)
+  {
+    // micros() zählt ab dem Start der Anwendung (ohne ROM-Bootloader)
+    const uint32_t ms = micros() / 1000UL;
+    g_bootToTxMs = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+    Serial.print("aufwachen_bis_tx_ms="); Serial.println(g_bootToTxMs);
+  }
+  g_sentThisBoot = true;
+  ++g_seq;
+  commandAcksSent();
+  if (radioIncluded) radioReported();
+  Serial.print("uplink samples="); Serial.print((unsigned)g_sampleCount);
+  Serial.print(" payload_bytes="); Serial.println((unsigned)payloadLen);
+  g_sampleCount = 0;
+
+  // Kurzes Empfangsfenster: das Gateway schickt offene Befehle direkt nach dem Uplink.
+  // Verlängert um die Sendedauer eines Befehls beim aktuellen SF (SF12: über eine Sekunde).
+  const uint32_t windowMs = RX_WINDOW_MS +
+      loraTimeOnAirUs(loraModulationDefault(radioCurrent().sf),
+                      LORA_FRAME_OVERHEAD + DOWNLINK_HDR_LEN + DOWNLINK_MAX_ARGS) / 1000;
+  DownlinkCommand cmd;
+  const bool gotDownlink = loraReceiveCommand(SENSOR_ID, windowMs, &cmd);
+  if (gotDownlink) commandExecute(cmd);
+  radioAfterUplink(gotDownlink);
+  return true;
+}
+
+// Zustand aus dem RTC-Speicher übernehmen (schneller Pfad nach dem Timer-Wecker)
+static void restoreState(const SensorRtcState& st)
+{
+  g_lastMeasureMs = st.lastMeasureMs;
+  g_seq = st.seq;
+  g_bootToTxMs = st.bootToTxMs;
+  g_sampleCount = st.sampleCount < BATCH_SIZE ? st.sampleCount : BATCH_SIZE;
+  memcpy(g_samples, &st.samples[st.sampleCount - g_sampleCount], g_sampleCount * sizeof(RtcSample));
+  g_report = st.report;
+  g_filter = st.filter;
+  loraFramesRestoreState(st);
+  radioRestoreState(st);
+  commandRestoreState(st);
+}
+
+// Zustand sichern und bis zur nächsten Messung schlafen (kehrt nicht zurück)
+static void sleepUntilNextMeasurement(uint32_t sleepMs)
+{
+  static SensorRtcState st;
+  memset(&st, 0, sizeof(st));
+  st.lastMeasureMs = g_lastMeasureMs;
+  st.seq = g_seq;
+  st.bootToTxMs = g_bootToTxMs;
+  st.sampleCount = (uint8_t)g_sampleCount;
+  memcpy(st.samples, g_samples, g_sampleCount * sizeof(RtcSample));
+  st.report = g_report;
+  st.filter = g_filter;
+  loraFramesSaveState(&st);
+  radioSaveState(&st);
+  commandSaveState(&st);
+  sleepEnter(&st, sleepMs);
+}
 
 void setup()
 {
+  static SensorRtcState rtc;
+  g_wokeFromSleep = DEEP_SLEEP_ENABLED && sleepRestore(&rtc);
+
   Serial.begin(SERIAL_BAUD);
-  delay(200);
+  if (g_wokeFromSleep) {
+    Serial.print("Aufgewacht #"); Serial.println(sleepBootCount());
+  } else {
+    delay(200);
 
-  // OLED initialisieren (wenn aktiviert)
-  oledInitSensor();
+    // OLED initialisieren (wenn aktiviert)
+    oledInitSensor();
 
-  // OTA-AP initialisieren (optional)
-  if (OTA_AP_ENABLED) {
-    otaApInit();
+    // OTA-AP initialisieren (optional); nach dem Aufwachen nur per Downlink-Befehl
+    if (OTA_AP_ENABLED) {
+      otaApInit();
+    }
   }
 
   // LoRa Pins für Heltec WiFi LoRa 32 (V2)
@@ -38,10 +247,18 @@ void setup()
     while (true) { delay(1000); }
   }
 
-  // ADC vorbereiten
-  analogReadResolution(12);
-  analogSetPinAttenuation(SENSOR_ADC_PIN, ADC_11db); // bis ~3.3V messbar
-  oledPrint2Sensor("Init...", "LoRa 868 MHz");
+  if (g_wokeFromSleep) {
+    restoreState(rtc);
+  } else {
+    reportStateReset(&g_report);
+    levelFilterReset(&g_filter);
+    radioInit();
+  }
+  g_filterParams = levelFilterParams(LEVEL_FILTER_CONFIG);
+
+  // ADC vorbereiten (Kalibrierung, Burst-Erfassung)
+  measurementBegin(SENSOR_ADC_PIN);
+  if (!g_wokeFromSleep) oledPrint2Sensor("Init...", "LoRa 868 MHz");
 }
 
 void loop()
@@ -49,34 +266,71 @@ void loop()
   // OTA-AP bedienen (falls aktiv)
   otaApLoop();
 
-  // Downlink-Befehle könnten hier optional verarbeitet werden (separates Modul empfohlen)
-  // ...
-
-  const unsigned long now = millis();
-  if (now - g_lastMeasureMs < MEASURE_INTERVAL_MS) {
+  const uint32_t now = clockMs();
+  const uint32_t elapsed = now - g_lastMeasureMs;
+  if (elapsed < MEASURE_INTERVAL_MS) {
+    // Bis zur nächsten Messung schlafen; solange der OTA-AP offen ist, wach bleiben
+    const uint32_t remaining = MEASURE_INTERVAL_MS - elapsed;
+    if (DEEP_SLEEP_ENABLED && !otaApActive() && remaining >= DEEP_SLEEP_MIN_MS) {
+      sleepUntilNextMeasurement(remaining);
+    }
     delay(50);
     return;
   }
   g_lastMeasureMs = now;
 
   // Messung durchführen
-  uint32_t mv = readMilliVoltsAveraged(SENSOR_ADC_PIN, 32);
-  float depthCm = mvToDepthCm(mv);
+  MvReading mv = readMilliVoltsBurst(SENSOR_ADC_PIN);
+  int32_t depthMm = mvToDepthMm(mv.mv);
+  const float depthCm = depthMm / 10.0f;
 
   // Plausibilität (lokal)
-  bool ok = (depthCm >= DEPTH_MIN_CM) && (depthCm <= DEPTH_MAX_CM);
-  String status = ok ? "OK" : "ERR";
+  bool ok = mv.ok && (depthCm >= DEPTH_MIN_CM) && (depthCm <= DEPTH_MAX_CM);
+  depthMm = clampI16(depthMm);
 
-  // Payload nur als Zahl mit einer Nachkommastelle
-  String payload = String(depthCm, 1);
+  // Pegelfilter: Ausreißer verwerfen, danach entscheiden geglätteter Pegel und Anstiegsrate
+  // über den Versand (Störspitzen lösen keinen Uplink aus). Ein verworfener Wert geht als ERR
+  // raus: das Gateway veröffentlicht ihn nicht und löst keinen Pegel-Alarm damit aus.
+  if (ok && levelFilterUpdate(g_filterParams, &g_filter, depthMm, now) == LEVEL_REJECTED)
+  {
+    Serial.print("Ausreißer verworfen, tiefe_mm="); Serial.print(depthMm);
+    Serial.print(" erwartet_mm="); Serial.println(levelFilterLevelMm(g_filter));
+    ok = false;
+  }
+  String status = ok ? "OK" : "ERR";
 
-  // Senden (verschlüsselt, wenn aktiviert)
-  loraSendEncrypted(SENSOR_ID, payload);
+  // Messwert puffern (Tiefe in mm als int16); ob gesendet wird, entscheidet der Zeitplan
+  pushSample({ (int16_t)depthMm, ok, now });
+  int32_t decideMm = depthMm;
+  ReportReason reason;
+  if (levelFilterSettled(g_filter))
+  {
+    decideMm = levelFilterLevelMm(g_filter);
+    const int32_t rateMmPerH = levelFilterRateMmPerH(g_filter);
+    const int32_t rateMmPerMin = (rateMmPerH + (rateMmPerH >= 0 ? 30 : -30)) / 60; // gerundet
+    reason = reportDecideWithRate(REPORT_POLICY, &g_report, decideMm, rateMmPerMin, now);
+  }
+  else reason = reportDecide(REPORT_POLICY, &g_report, depthMm, now);
+  // Quittung eines Befehls nicht bis zum nächsten Heartbeat zurückhalten
+  if (reason == REPORT_NONE && commandAcksPending()) reason = REPORT_ACK;
+  if (reason != REPORT_NONE)
+  {
+    Serial.print("sende grund="); Serial.print(reportReasonName(reason));
+    Serial.print(" rate_mm_min="); Serial.println(g_report.rateMmPerMin);
+    if (sendBatch(mv, reason == REPORT_FIRST || reason == REPORT_HEARTBEAT))
+      reportSent(&g_report, decideMm, now);
+  }
 
   // Debug & Anzeige
-  Serial.print("mv_raw="); Serial.print(mv);
-  Serial.print(" mv_scaled="); Serial.print((float)mv * SENSOR_MV_SCALE, 1);
+  Serial.print("mv_raw="); Serial.print(mv.mv);
+  Serial.print(" rauschen_mv="); Serial.print(mv.noiseMv, 1);
+  Serial.print(" burst="); Serial.print((unsigned)mv.samples); Serial.print("/"); Serial.print(mv.burstUs); Serial.print("us");
   Serial.print("  tiefe_cm="); Serial.print(depthCm, 1);
+  if (levelFilterSettled(g_filter))
+  {
+    Serial.print(" gefiltert_cm="); Serial.print(levelFilterLevelMm(g_filter) / 10.0f, 1);
+    Serial.print(" trend_cm_h="); Serial.print(levelFilterRateMmPerH(g_filter) / 10.0f, 1);
+  }
   Serial.print("  status="); Serial.println(status);
   oledPrint2Sensor(String("Tiefe: ") + String(depthCm, 1) + " cm", String("Status: ") + status);
 }
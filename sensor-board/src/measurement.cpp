@@ -1,23 +1,107 @@
 // Deutsche Dokumentation
 // Implementierung der Mess- und Umrechnungsfunktionen
+//
+// Statt einzelner analogReadMilliVolts()-Aufrufe mit Wartezeit (32 x ~200 µs, CPU wartet aktiv)
+// werden die Rohwerte als Burst gelesen: mit ADC_BURST_DMA über den I2S0-DMA-Pfad des ESP32
+// (ADC1, feste Abtastrate, CPU blockiert nur in i2s_read), sonst in einer engen Schleife
+// ohne Pause. Kalibriert (eFuse-Kennlinie) wird nur das Ergebnis, nicht jeder Rohwert.
 #include "measurement.h"
 #include <Arduino.h>
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#include <esp_adc_cal.h>
 #include "config.h"
+#include "conversion.h"
+#include "adc_filter.h"
 
-uint32_t readMilliVoltsAveraged(int pin, int samples)
+static_assert(calibrationPointsValid(SENSOR_CALIBRATION), "SENSOR_CALIBRATION: mindestens zwei Punkte, mV streng steigend");
+// Kalibriertabelle, vollständig zur Übersetzungszeit berechnet (liegt im Flash)
+static constexpr CalibrationLut CAL_LUT = calibrationLutBuild(SENSOR_CALIBRATION);
+
+static_assert(ADC_BURST_SAMPLES >= 8 && ADC_BURST_SAMPLES <= 1024, "ADC_BURST_SAMPLES muss 8..1024 sein");
+
+static const uint32_t ADC_RAW_MAX = 4095;
+static const uint32_t ADC_SLOPE_SPAN = 32;
+
+static esp_adc_cal_characteristics_t s_adcChars;
+static bool s_dma = false;
+static uint16_t s_burst[ADC_BURST_SAMPLES];
+
+void measurementBegin(int pin)
 {
-    uint64_t acc = 0;
-    for (int i = 0; i < samples; ++i) {
-        acc += analogReadMilliVolts(pin);
-        delayMicroseconds(200);
+    analogReadResolution(12);
+    analogSetPinAttenuation(pin, ADC_11db); // bis ~3.3V messbar
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &s_adcChars);
+
+    const int8_t channel = digitalPinToAnalogChannel(pin);
+    if (!ADC_BURST_DMA || channel < 0 || channel > 7) return; // I2S-DMA nur mit ADC1 (GPIO32..39)
+
+    i2s_config_t cfg = {};
+    cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    cfg.sample_rate = ADC_BURST_RATE_HZ;
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    cfg.dma_buf_count = 4;
+    cfg.dma_buf_len = 256;
+    if (i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr) != ESP_OK) return;
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11);
+    if (i2s_set_adc_mode(ADC_UNIT_1, (adc1_channel_t)channel) != ESP_OK) {
+        i2s_driver_uninstall(I2S_NUM_0);
+        return;
     }
-    return (uint32_t)(acc / samples);
+    s_dma = true;
+}
+
+// Burst über I2S0-DMA; die ersten Werte nach dem Einschalten sind unbrauchbar und werden verworfen
+static size_t readBurstDma()
+{
+    i2s_adc_enable(I2S_NUM_0);
+    size_t got = 0;
+    uint16_t discard[32];
+    i2s_read(I2S_NUM_0, discard, sizeof(discard), &got, pdMS_TO_TICKS(20));
+    got = 0;
+    i2s_read(I2S_NUM_0, s_burst, sizeof(s_burst), &got, pdMS_TO_TICKS(100));
+    i2s_adc_disable(I2S_NUM_0);
+    const size_t n = got / sizeof(s_burst[0]);
+    for (size_t i = 0; i < n; ++i) s_burst[i] &= 0x0FFF; // obere Bits: Kanalnummer
+    return n;
+}
+
+static size_t readBurstLoop(int pin)
+{
+    for (size_t i = 0; i < ADC_BURST_SAMPLES; ++i) s_burst[i] = (uint16_t)analogRead(pin);
+    return ADC_BURST_SAMPLES;
+}
+
+MvReading readMilliVoltsBurst(int pin)
+{
+    MvReading m = {};
+    const uint32_t t0 = micros();
+    const size_t n = s_dma ? readBurstDma() : readBurstLoop(pin);
+    m.burstUs = micros() - t0;
+
+    AdcReduceResult r;
+    if (!adcReduce(s_burst, n, (AdcReduceMode)ADC_REDUCE_MODE, ADC_REDUCE_PARAM, &r)) return m;
+    // Kennlinie ist stückweise linear: Ergebnis (mit Nachkommaanteil aus der Mittelung)
+    // und Streuung über die lokale Steigung umrechnen
+    // Steigung über +/- ADC_SLOPE_SPAN LSB: benachbarte Rohwerte liegen nur ~0,8 mV
+    // auseinander, ganzzahlig wäre die Differenz 0 oder 1 mV
+    const uint32_t raw = (uint32_t)r.value;
+    const uint32_t mv = esp_adc_cal_raw_to_voltage(raw, &s_adcChars);
+    const uint32_t lo = raw > ADC_SLOPE_SPAN ? raw - ADC_SLOPE_SPAN : 0;
+    const uint32_t hi = raw + ADC_SLOPE_SPAN < ADC_RAW_MAX ? raw + ADC_SLOPE_SPAN : ADC_RAW_MAX;
+    const float slope = (float)(esp_adc_cal_raw_to_voltage(hi, &s_adcChars) - esp_adc_cal_raw_to_voltage(lo, &s_adcChars)) /
+                        (float)(hi - lo);
+    m.mv = (uint32_t)lroundf((float)mv + (r.value - (float)raw) * slope);
+    m.noiseMv = r.spread * slope;
+    m.samples = r.count;
+    m.ok = true;
+    return m;
 }
 
-float mvToDepthCm(uint32_t mv)
+int32_t mvToDepthMm(uint32_t mv)
 {
-    float mvCal = (float)mv * SENSOR_MV_SCALE;
-    int32_t mvAdj = (int32_t)mvCal - (int32_t)SENSOR_OFFSET_MV;
-    if (mvAdj < 0) mvAdj = 0;
-    return ((float)mvAdj / (float)SENSOR_VREF_MV) * SENSOR_MAX_CM;
+    return (calibrationDepthMmX10(CAL_LUT, mv) + 5) / 10;
 }
@@ -7,6 +7,8 @@
 #include "oled.h"
 
 static bool s_active = false;
+static bool s_updating = false;
+static unsigned long s_startMs = 0;
 
 static String macSuffix()
 {
@@ -28,6 +30,7 @@ void otaApInit()
     ArduinoOTA.setPassword(OTA_AP_PASSWORD);
 
     ArduinoOTA.onStart([](){
+        s_updating = true;
         Serial.println("OTA Start (Sensor AP)");
     });
     ArduinoOTA.onEnd([](){
@@ -37,11 +40,13 @@ void otaApInit()
         Serial.printf("OTA Fortschritt: %u%%\r", (progress * 100) / total);
     });
     ArduinoOTA.onError([](ota_error_t error){
+        s_updating = false;
         Serial.printf("\nOTA Fehler[%u]\n", error);
     });
 
     ArduinoOTA.begin();
     s_active = true;
+    s_startMs = millis();
 
     Serial.printf("AP SSID: %s\n", ssid.c_str());
     Serial.printf("AP IP: %s\n", WiFi.softAPIP().toString().c_str());
@@ -51,13 +56,24 @@ void otaApInit()
 
 void otaApLoop()
 {
-    if (s_active) ArduinoOTA.handle();
+    if (!s_active) return;
+    ArduinoOTA.handle();
+    if (DEEP_SLEEP_ENABLED && OTA_AP_TIMEOUT_MS && !s_updating && millis() - s_startMs >= OTA_AP_TIMEOUT_MS) {
+        Serial.println("OTA AP: Zeit abgelaufen");
+        otaApStop();
+    }
 }
 
 void otaApStop()
 {
     if (!s_active) return;
     WiFi.softAPdisconnect(true);
+    WiFi.mode(WIFI_OFF);
     s_active = false;
     Serial.println("OTA AP gestoppt");
 }
+
+bool otaApActive()
+{
+    return s_active;
+}
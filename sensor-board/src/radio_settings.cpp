@@ -0,0 +1,144 @@
+// Deutsche Dokumentation
+// Funkparameter des Sensors: Implementierung
+#include "radio_settings.h"
+#include <Arduino.h>
+#include <LoRa.h>
+#include <Preferences.h>
+#include "config.h"
+#include "downlink.h"
+
+static RadioSettings s_current = { LORA_SF, LORA_TX_POWER_DBM };
+static RadioSettings s_previous = s_current; // Rückfall während der Probezeit
+static RadioSettings s_staged = s_current;
+static bool s_haveStaged = false;
+static bool s_stagedArmed = false;    // Quittung läuft mit dem nächsten Uplink
+static bool s_probation = false;
+static uint8_t s_probationUplinks = 0;
+static bool s_reportDue = true;       // erster Uplink nach dem Start meldet die Werte
+
+static void apply(const RadioSettings& r)
+{
+    LoRa.setSpreadingFactor(r.sf);
+    LoRa.setTxPower(r.txPowerDbm);
+    Serial.printf("Funk: SF%u, %d dBm\n", (unsigned)r.sf, (int)r.txPowerDbm);
+}
+
+static void persist(const RadioSettings& r)
+{
+    Preferences prefs;
+    if (!prefs.begin("lwlm", false)) return;
+    prefs.putUChar("sf", r.sf);
+    prefs.putChar("txp", r.txPowerDbm);
+    prefs.end();
+}
+
+static bool valid(const RadioSettings& r)
+{
+    return r.sf >= 7 && r.sf <= 12 && r.txPowerDbm >= 2 && r.txPowerDbm <= LORA_TX_POWER_MAX_DBM;
+}
+
+void radioInit()
+{
+    Preferences prefs;
+    if (ADR_ENABLED && prefs.begin("lwlm", true)) {
+        RadioSettings saved = { prefs.getUChar("sf", LORA_SF), prefs.getChar("txp", LORA_TX_POWER_DBM) };
+        prefs.end();
+        if (valid(saved)) s_current = saved;
+    }
+    s_previous = s_current;
+    apply(s_current);
+}
+
+void radioSaveState(SensorRtcState* st)
+{
+    st->radioCurrent = s_current;
+    st->radioPrevious = s_previous;
+    st->radioStaged = s_staged;
+    st->radioHaveStaged = s_haveStaged;
+    st->radioStagedArmed = s_stagedArmed;
+    st->radioProbation = s_probation;
+    st->radioReportDue = s_reportDue;
+    st->radioProbationUplinks = s_probationUplinks;
+}
+
+void radioRestoreState(const SensorRtcState& st)
+{
+    if (!valid(st.radioCurrent)) { radioInit(); return; }
+    s_current = st.radioCurrent;
+    s_previous = st.radioPrevious;
+    s_staged = st.radioStaged;
+    s_haveStaged = st.radioHaveStaged;
+    s_stagedArmed = st.radioStagedArmed;
+    s_probation = st.radioProbation;
+    s_reportDue = st.radioReportDue;
+    s_probationUplinks = st.radioProbationUplinks;
+    apply(s_current);
+}
+
+RadioSettings radioCurrent()
+{
+    return s_current;
+}
+
+uint8_t radioStage(const uint8_t* args, uint8_t argLen)
+{
+    if (!ADR_ENABLED || argLen < 2) return DL_ACK_REJECTED;
+    RadioSettings r = { args[0], (int8_t)args[1] };
+    if (!valid(r)) return DL_ACK_REJECTED;
+    s_staged = r;
+    s_haveStaged = true;
+    s_stagedArmed = false;
+    return DL_ACK_OK;
+}
+
+static bool sameSettings(const RadioSettings& a, const RadioSettings& b)
+{
+    return a.sf == b.sf && a.txPowerDbm == b.txPowerDbm;
+}
+
+bool radioTargets(const uint8_t* args, uint8_t argLen)
+{
+    if (argLen < 2) return false;
+    const RadioSettings r = { args[0], (int8_t)args[1] };
+    return sameSettings(s_current, r) || (s_haveStaged && sameSettings(s_staged, r));
+}
+
+void radioAfterUplink(bool gotDownlink)
+{
+    if (s_probation) {
+        if (gotDownlink) {
+            // Gateway hört uns mit den neuen Werten
+            s_probation = false;
+            persist(s_current);
+        } else if (++s_probationUplinks >= ADR_PROBATION_UPLINKS) {
+            Serial.println("Funk: keine Bestätigung, zurück zu den alten Werten");
+            s_probation = false;
+            s_current = s_previous;
+            apply(s_current);
+            s_reportDue = true;
+        }
+    }
+    if (!s_haveStaged) return;
+    if (!s_stagedArmed) {
+        // in diesem Fenster erhalten: Quittung geht mit dem nächsten Uplink raus
+        s_stagedArmed = true;
+        return;
+    }
+    s_haveStaged = false;
+    s_previous = s_current;
+    s_current = s_staged;
+    apply(s_current);
+    s_probation = true;
+    s_probationUplinks = 0;
+    s_reportDue = true;
+}
+
+bool radioReportDue()
+{
+    return s_reportDue;
+}
+
+void radioReported()
+{
+    s_reportDue = false;
+}
@@ -0,0 +1,43 @@
+// Deutsche Dokumentation
+// Deep-Sleep-Zyklus des Sensor-Boards: Implementierung
+#include "sleep_cycle.h"
+#include <Arduino.h>
+#include <LoRa.h>
+#include <esp_sleep.h>
+#include <sys/time.h>
+
+// Serialisierter Zustand; RTC_DATA_ATTR ist nach dem Kaltstart mit 0 belegt (Magic fehlt)
+RTC_DATA_ATTR static uint8_t s_rtcBlob[RTC_STATE_MAX_LEN];
+static uint32_t s_bootCount = 0;
+
+uint32_t clockMs()
+{
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint32_t)((uint64_t)tv.tv_sec * 1000ULL + (uint64_t)tv.tv_usec / 1000ULL);
+}
+
+bool sleepRestore(SensorRtcState* out)
+{
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) return false;
+    if (!rtcStateDeserialize(s_rtcBlob, sizeof(s_rtcBlob), out)) return false;
+    s_bootCount = ++out->bootCount;
+    return true;
+}
+
+uint32_t sleepBootCount()
+{
+    return s_bootCount;
+}
+
+void sleepEnter(SensorRtcState* st, uint32_t sleepMs)
+{
+    st->bootCount = s_bootCount;
+    if (!rtcStateSerialize(*st, s_rtcBlob, sizeof(s_rtcBlob)))
+        memset(s_rtcBlob, 0, sizeof(s_rtcBlob)); // nächster Start dann wie Kaltstart
+    LoRa.sleep();
+    Serial.printf("Deep-Sleep %lu ms\n", (unsigned long)sleepMs);
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+    esp_deep_sleep_start();
+}